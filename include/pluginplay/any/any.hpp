@@ -46,8 +46,9 @@ auto make_any_field(Args&&... args) {
     using pimpl_type = detail_::AnyFieldWrapper<T>;
     using clean_type = std::decay_t<T>;
     static_assert(!std::is_same_v<T, clean_type&>, "Can't wrap mutable ref");
-    auto pimpl = std::make_unique<pimpl_type>(T(std::forward<Args>(args)...));
-    return AnyField(std::move(pimpl));
+    // One allocation for the wrapper and the reference count of AnyField
+    auto pimpl = std::make_shared<pimpl_type>(T(std::forward<Args>(args)...));
+    return AnyField(AnyField::shared_pimpl_pointer(std::move(pimpl)));
 }
 
 /** @brief Returns the object wrapped in an AnyField.
@@ -99,6 +100,15 @@ T any_cast(AnyType&& da_any) {
     if(!da_any.has_value())
         throw std::runtime_error("Object to unwrap does not have a value.");
 
+    // A read/write reference must not be to a value other AnyFields share
+    using clean_t           = std::decay_t<T>;
+    using any_t             = std::remove_reference_t<AnyType>;
+    constexpr bool rw_ref   = std::is_same_v<T, clean_t&>;
+    constexpr bool rw_field = !std::is_const_v<any_t>;
+    if constexpr(rw_ref && rw_field) {
+        if(da_any.template is_convertible<T>()) da_any.make_unique_();
+    }
+
     return da_any.m_pimpl_->template cast<T>();
 }
 
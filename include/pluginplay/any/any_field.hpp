@@ -35,9 +35,19 @@ namespace pluginplay::any {
  *  Optionally the type may:
  *
  *  - overload std::ostream::operator<< for printing the value.
+ *  - be serializable with pluginplay::any::Serializer, which is needed for
+ *    the value to be stored outside of memory (e.g., by the cache).
  *
  *  AnyField defines default implementations for any optional properties the
  *  type does not satisfy.
+ *
+ *  Copies of an AnyField which owns its value share the value (it is held in
+ *  reference counted storage) until one of them is retrieved by read/write
+ *  reference (i.e., with `any_cast<T&>`). At that point the AnyField being
+ *  cast gets its own copy of the value first. Since a read/write reference
+ *  may outlive the cast, the value of an AnyField which has handed one out is
+ *  no longer shared; copies of it are deep copies again. Copying large values
+ *  such as bound inputs is thus cheap as long as they are only read.
  */
 class AnyField {
 public:
@@ -47,9 +57,21 @@ public:
     /// Type used for runtime type information (RTTI) purposes
     using rtti_type = typename pimpl_type::rtti_type;
 
+    /// Type of the buffer values are digested into
+    using digest_buffer = typename pimpl_type::digest_buffer;
+
+    /// Type of the buffer values are serialized into
+    using serial_buffer = typename pimpl_type::serial_buffer;
+
+    /// Type of a view of the bytes a value is deserialized from
+    using serial_view = typename pimpl_type::serial_view;
+
     /// Type of the smart pointer holding a PIMPL, typedef of unique_ptr
     using pimpl_pointer = typename pimpl_type::field_base_pointer;
 
+    /// How the PIMPL is held, so that copies can share it
+    using shared_pimpl_pointer = std::shared_ptr<pimpl_type>;
+
     /** @brief Creates an AnyField wrapping the provided value.
      *
      *  This ctor serves as both the default and value ctors. By default it will
@@ -63,13 +85,25 @@ public:
      */
     explicit AnyField(pimpl_pointer pimpl = nullptr) noexcept;
 
-    /** @brief Creates a new AnyField by deep copying an existing instance.
+    /** @brief Creates an AnyField wrapping the value in a shared PIMPL.
+     *
+     *  This ctor is primarily used by make_any_field, which allocates the
+     *  PIMPL and its reference count together. @p pimpl must not be shared
+     *  with anything other than AnyField instances.
+     *
+     *  @param[in] pimpl A pointer to the PIMPL which holds the wrapped value.
+     *
+     *  @throw None No throw guarantee.
+     */
+    explicit AnyField(shared_pimpl_pointer pimpl) noexcept;
+
+    /** @brief Creates a new AnyField by copying an existing instance.
      *
-     *  This ctor will deep copy the value held inside @p other. In particular,
-     *  this means that if @p other aliases its value the new AnyField will
-     *  hold a copy of the wrapped value, NOT an alias. If you want to avoid
-     *  deep copying the wrapped value work with references/pointers to an
-     *  AnyField and/or use move construction.
+     *  If @p other owns its value, and has not handed out a read/write
+     *  reference to it, the new AnyField shares the value with @p other (see
+     *  the class description). Otherwise the value is deep copied. In
+     *  particular, this means that if @p other aliases its value the new
+     *  AnyField will hold a copy of the wrapped value, NOT an alias.
      *
      *  @param[in] AnyField The instance we are copying.
      *
@@ -92,11 +126,12 @@ public:
      */
     AnyField(AnyField&& other) noexcept;
 
-    /** @brief Replaces the existing state with a deep copy of another AnyField
+    /** @brief Replaces the existing state with a copy of another AnyField
      *
-     *  This method deep copies the state of @p rhs, sets the current instance
-     *  to the copied state, and then releases the instance's old state. After
-     *  this call any references/pointers to the previous state are invalid.
+     *  This method copies the state of @p rhs (sharing the value if the copy
+     *  ctor would), sets the current instance to the copied state, and then
+     *  releases the instance's old state. After this call any
+     *  references/pointers to the previous state are invalid.
      *
      *  @param[in] AnyField The instance we are copying.
      *
@@ -217,6 +252,54 @@ public:
      */
     bool are_equal(const AnyField& rhs) const noexcept;
 
+    /** @brief Computes a hash of the wrapped value.
+     *
+     *  The hash is consistent with operator==, i.e., two AnyField instances
+     *  which compare value equal will have the same hash (how the value is
+     *  held is not considered). Instances which do not wrap a value all have
+     *  the same hash.
+     *
+     *  @return A hash of the wrapped value.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t hash() const noexcept;
+
+    /** @brief Computes how much memory the wrapped value occupies.
+     *
+     *  The footprint includes the memory owned by the wrapped value (e.g., the
+     *  buffer of a `std::vector`). It is computed with
+     *  pluginplay::any::MemoryFootprint, which can be specialized for types
+     *  the defaults do not measure well. Values held by const reference are
+     *  not owned by *this and have a footprint of 0, as do instances which do
+     *  not wrap a value.
+     *
+     *  @return The number of bytes the wrapped value occupies.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t memory_footprint() const noexcept;
+
+    /** @brief Appends a stable byte representation of the wrapped value to
+     *         @p buffer.
+     *
+     *  Unlike `hash`, the bytes are the same in every process and identify
+     *  the wrapped value (and its type), so they can be used to derive
+     *  content-addressed keys. They are computed with
+     *  pluginplay::any::Digester, which can be specialized to support more
+     *  types.
+     *
+     *  @param[in,out] buffer The buffer to append to.
+     *
+     *  @return True if the value was digested and false if *this does not wrap
+     *          a value or the wrapped type can not be digested (in which case
+     *          @p buffer is not modified).
+     *
+     *  @throw std::bad_alloc if there is a problem growing @p buffer. Weak
+     *                        throw guarantee.
+     */
+    bool digest(digest_buffer& buffer) const;
+
     /** @brief Adds a string representation of the wrapped object to the stream
      *
      *  Sometimes it's useful to have string representations of objects. If the
@@ -277,14 +360,72 @@ public:
      */
     bool owns_value() const noexcept;
 
+    /** @brief Does *this share its wrapped value with @p rhs?
+     *
+     *  Copies of an AnyField may share the wrapped value (see the class
+     *  description). This method determines if *this and @p rhs do.
+     *
+     *  @param[in] rhs The instance to compare against.
+     *
+     *  @return True if *this and @p rhs wrap the same object in memory and
+     *          false otherwise (including if either does not wrap a value).
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool shares_value(const AnyField& rhs) const noexcept;
+
+    /** @brief Can *this be serialized?
+     *
+     *  Values are serialized with pluginplay::any::Serializer, which can be
+     *  specialized to support more types. Python objects can not be
+     *  serialized.
+     *
+     *  @return True if *this wraps a value and the type of the value can be
+     *          serialized, false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_serializable() const noexcept;
+
+    /** @brief Serializes *this into @p ar.
+     *
+     *  The wrapped value is saved along with its type. Instances which do not
+     *  wrap a value can be saved too. How the value was held is not saved;
+     *  loading always gives an instance which owns its value.
+     *
+     *  @tparam Archive The type of the archive, e.g., a cereal archive.
+     *
+     *  @param[in,out] ar The archive to save *this to.
+     *
+     *  @throw std::runtime_error if *this wraps a value which can not be
+     *                            serialized (see is_serializable). Strong
+     *                            throw guarantee.
+     *  @throw ??? If @p ar throws. Same throw guarantee.
+     */
     template<typename Archive>
     void save(Archive& ar) const {
-        std::runtime_error("NYI");
+        ar(serialize_());
     }
 
+    /** @brief Replaces the state of *this with the state stored in @p ar.
+     *
+     *  The type of the saved value must be known to the current program,
+     *  which is the case once an AnyField wrapping a value of the type has
+     *  been created (e.g., by declaring an input or result of that type).
+     *
+     *  @tparam Archive The type of the archive, e.g., a cereal archive.
+     *
+     *  @param[in,out] ar The archive to load *this from.
+     *
+     *  @throw std::runtime_error if the saved type is not known or the saved
+     *                            bytes are malformed. Strong throw guarantee.
+     *  @throw ??? If @p ar throws. Strong throw guarantee.
+     */
     template<typename Archive>
     void load(Archive& ar) {
-        std::runtime_error("NYI");
+        serial_buffer buffer;
+        ar(buffer);
+        deserialize_(buffer);
     }
 
 private:
@@ -292,8 +433,21 @@ private:
     template<typename T, typename AnyType>
     friend T any_cast(AnyType&&);
 
-    /// The actual PIMPL
-    pimpl_pointer m_pimpl_;
+    /// Gives *this its own value and stops sharing it, before it is modified
+    void make_unique_();
+
+    /// Implements save, returns a has_value flag followed by the value
+    serial_buffer serialize_() const;
+
+    /// Implements load, undoes serialize_
+    void deserialize_(serial_view bytes);
+
+    /// The actual PIMPL, possibly shared with copies of *this
+    shared_pimpl_pointer m_pimpl_;
+
+    /// May copies of *this share m_pimpl_? (false once a read/write
+    /// reference to the value was handed out)
+    bool m_shareable_ = true;
 };
 
 template<typename T>
@@ -343,3 +497,16 @@ inline std::ostream& operator<<(std::ostream& os, const AnyField& any) {
 }
 
 } // namespace pluginplay::any
+
+namespace std {
+
+/// Allows AnyField instances to be used as keys in unordered containers
+template<>
+struct hash<pluginplay::any::AnyField> {
+    std::size_t operator()(
+      const pluginplay::any::AnyField& field) const noexcept {
+        return field.hash();
+    }
+};
+
+} // namespace std
@@ -15,11 +15,14 @@
  */
 
 #pragma once
-#include <boost/any.hpp>
 #include <exception>
 #include <memory>
 #include <ostream>
+#include <pluginplay/any/detail_/small_any.hpp>
+#include <pluginplay/any/digester.hpp>
+#include <pluginplay/any/serializer.hpp>
 #include <pluginplay/python/python_wrapper.hpp>
+#include <string>
 #include <typeindex>
 
 namespace pluginplay::any::detail_ {
@@ -43,8 +46,17 @@ public:
     /// A read-only reference to a Python object
     using const_python_reference = const python_value&;
 
-    /// The type used to store the value
-    using value_type = boost::any;
+    /// Type of the buffer values are digested into
+    using digest_buffer = pluginplay::any::digest_buffer;
+
+    /// Type of the buffer values are serialized into
+    using serial_buffer = pluginplay::any::serial_buffer;
+
+    /// Type of a view of the bytes a value is deserialized from
+    using serial_view = pluginplay::any::serial_view;
+
+    /// The type used to store the value (small values are stored inline)
+    using value_type = SmallAny;
 
     /** @brief Polymorphic copy
      *
@@ -232,6 +244,107 @@ public:
         return value_equal_(rhs);
     }
 
+    /** @brief Computes a hash of the wrapped value.
+     *
+     *  The hash is consistent with `value_equal`, i.e., if
+     *  `a.value_equal(b)` is true then `a.hash() == b.hash()`. In particular,
+     *  the hash only depends on the wrapped value and not on how the value is
+     *  held (by value, by const value, or by const reference). This makes it
+     *  suitable for use in hashed containers which rely on `value_equal` for
+     *  resolving collisions.
+     *
+     *  How the value is hashed can be customized by specializing
+     *  pluginplay::any::Hasher for the wrapped type. N.B. Wrapped types which
+     *  are not hashable (i.e., `is_hashable_v` is false) will all hash to a
+     *  value derived from their RTTI. This is still consistent with
+     *  `value_equal`, but means hashed lookups of such types degrade to
+     *  comparing against every value of that type.
+     *
+     *  @return A hash of the wrapped value.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t hash() const noexcept { return hash_(); }
+
+    /** @brief Computes how much memory the wrapped value occupies.
+     *
+     *  The footprint includes the memory the wrapped value owns (e.g., the
+     *  buffer of a `std::vector`), but not the overhead of *this. Values which
+     *  are held by const reference are owned by someone else, so their
+     *  footprint is 0.
+     *
+     *  How the footprint is computed can be customized by specializing
+     *  pluginplay::any::MemoryFootprint for the wrapped type.
+     *
+     *  @return The number of bytes the wrapped value occupies.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t memory_footprint() const noexcept {
+        return memory_footprint_();
+    }
+
+    /** @brief Appends a stable byte representation of the wrapped value to
+     *         @p buffer.
+     *
+     *  The bytes start with the name of the wrapped type, followed by the
+     *  bytes pluginplay::any::Digester appends for the wrapped value. Like
+     *  `value_equal`, the bytes do not depend on how the value is held. If
+     *  the wrapped type can not be digested (or is a Python object) nothing
+     *  is appended.
+     *
+     *  @param[in,out] buffer The buffer to append to.
+     *
+     *  @return True if the value was digested and false otherwise.
+     *
+     *  @throw std::bad_alloc if there is a problem growing @p buffer. Weak
+     *                        throw guarantee.
+     */
+    bool digest(digest_buffer& buffer) const { return digest_(buffer); }
+
+    /** @brief Can the wrapped value be serialized?
+     *
+     *  @return True if pluginplay::any::Serializer can serialize the wrapped
+     *          type and false otherwise (including for Python objects).
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_serializable() const noexcept { return is_serializable_(); }
+
+    /** @brief Appends the serialized wrapped value to @p buffer.
+     *
+     *  The bytes start with the name of the wrapped type, followed by the
+     *  bytes pluginplay::any::Serializer saves for the wrapped value. Like
+     *  `value_equal`, the bytes do not depend on how the value is held. The
+     *  bytes can be turned back into an AnyFieldBase (which owns the value)
+     *  with `deserialize`.
+     *
+     *  @param[in,out] buffer The buffer to append to.
+     *
+     *  @return True if the value was serialized and false if the wrapped type
+     *          can not be serialized (in which case nothing is appended).
+     *
+     *  @throw std::bad_alloc if there is a problem growing @p buffer. Weak
+     *                        throw guarantee.
+     */
+    bool serialize(serial_buffer& buffer) const { return serialize_(buffer); }
+
+    /** @brief Creates an AnyFieldBase from the bytes at the front of @p bytes.
+     *
+     *  Undoes `serialize`. The type is looked up by the name at the start of
+     *  @p bytes; a type is known once an AnyField wrapping it has been
+     *  created by the current program.
+     *
+     *  @param[in,out] bytes The bytes to deserialize. On return the consumed
+     *                       bytes have been removed from the front.
+     *
+     *  @return A newly allocated AnyFieldBase owning the deserialized value.
+     *
+     *  @throw std::runtime_error if the type is not known or the bytes are
+     *                            malformed. Weak throw guarantee.
+     */
+    static field_base_pointer deserialize(serial_view& bytes);
+
     /** @brief Adds a text representation of the wrapped object to @p os
      *
      *  This function is actually implemented by calling the virtual function
@@ -331,6 +444,21 @@ private:
     /// To be overridden by derived class to implemet value_equal
     virtual bool value_equal_(const AnyFieldBase& rhs) const noexcept = 0;
 
+    /// To be overridden by derived class to implement hash
+    virtual std::size_t hash_() const noexcept = 0;
+
+    /// To be overridden by derived class to implement memory_footprint
+    virtual std::size_t memory_footprint_() const noexcept = 0;
+
+    /// To be overridden by derived class to implement digest
+    virtual bool digest_(digest_buffer& buffer) const = 0;
+
+    /// To be overridden by derived class to implement is_serializable
+    virtual bool is_serializable_() const noexcept = 0;
+
+    /// To be overridden by derived class to implement serialize
+    virtual bool serialize_(serial_buffer& buffer) const = 0;
+
     /// To be overridden by derived class to implement printing
     virtual std::ostream& print_(std::ostream& os) const = 0;
 
@@ -357,6 +485,27 @@ private:
     value_type m_value_;
 };
 
+/// Type of a function which deserializes the value of a specific type
+using deserializer_type = AnyFieldBase::field_base_pointer (*)(
+  AnyFieldBase::serial_view&);
+
+/** @brief Registers the function deserializing values whose type is named
+ *         @p name.
+ *
+ *  Called by AnyFieldWrapper for every serializable type it wraps, so that
+ *  AnyFieldBase::deserialize can find the type. Registering a name twice is a
+ *  no-op.
+ *
+ *  @param[in] name The name of the type, as returned by `typeid().name()`.
+ *  @param[in] fxn The function deserializing values of that type.
+ *
+ *  @return True, so that it can be used to initialize static variables.
+ *
+ *  @throw std::bad_alloc if there is a problem allocating memory. Strong
+ *                        throw guarantee.
+ */
+bool register_deserializer(const std::string& name, deserializer_type fxn);
+
 } // namespace pluginplay::any::detail_
 
 #include "any_field_base.ipp"
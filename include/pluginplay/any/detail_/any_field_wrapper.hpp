@@ -17,6 +17,10 @@
 #pragma once
 #include "pluginplay/any/detail_/any_field_base.hpp"
 #include "pluginplay/any/detail_/any_field_wrapper_traits.hpp"
+#include "pluginplay/any/digester.hpp"
+#include "pluginplay/any/hasher.hpp"
+#include "pluginplay/any/memory_footprint.hpp"
+#include "pluginplay/any/serializer.hpp"
 
 namespace pluginplay::any::detail_ {
 
@@ -72,6 +76,12 @@ public:
     /// Type used to store values
     using typename base_type::value_type;
 
+    /// Type of the buffer values are serialized into
+    using typename base_type::serial_buffer;
+
+    /// Type of a view of the bytes a value is deserialized from
+    using typename base_type::serial_view;
+
     /// This is the type of the object actually in the any
     using wrapped_type = std::conditional_t<wrap_const_ref_v, ref_wrapper_t, T>;
 
@@ -117,6 +127,56 @@ protected:
     /// Implements AnyFieldBase::value_equal
     bool value_equal_(const AnyFieldBase& rhs) const noexcept override;
 
+    /** @brief Implements AnyFieldBase::hash
+     *
+     *  If `std::hash` is specialized for the wrapped type this function hashes
+     *  the wrapped value with it. Otherwise the hash of the wrapped type's RTTI
+     *  is returned.
+     *
+     *  @return A hash of the wrapped value.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t hash_() const noexcept override;
+
+    /** @brief Implements AnyFieldBase::memory_footprint
+     *
+     *  Uses MemoryFootprint to measure the wrapped value, unless the value is
+     *  held by const reference, in which case 0 is returned.
+     *
+     *  @return The number of bytes the wrapped value occupies.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t memory_footprint_() const noexcept override;
+
+    /** @brief Implements AnyFieldBase::digest
+     *
+     *  Appends the mangled name of the wrapped type and then uses Digester to
+     *  append the wrapped value.
+     *
+     *  @param[in,out] buffer The buffer to append to.
+     *
+     *  @return True if Digester can digest the wrapped type and false
+     *          otherwise.
+     */
+    bool digest_(digest_buffer& buffer) const override;
+
+    /// Implements AnyFieldBase::is_serializable
+    bool is_serializable_() const noexcept override;
+
+    /** @brief Implements AnyFieldBase::serialize
+     *
+     *  Appends the mangled name of the wrapped type and then uses Serializer
+     *  to append the wrapped value.
+     *
+     *  @param[in,out] buffer The buffer to append to.
+     *
+     *  @return True if Serializer can serialize the wrapped type and false
+     *          otherwise.
+     */
+    bool serialize_(serial_buffer& buffer) const override;
+
     /** @brief Implements AnyFieldBase::print
      *
      *  This function implements AnyFieldBase::print by determining if
@@ -151,6 +211,15 @@ private:
     /// Code factorization for wrapping an object of type @p U in an any
     template<typename U>
     value_type wrap_value_(U&& value2wrap) const;
+
+    /// Loads a clean_type from @p bytes, the function which gets registered
+    static field_base_pointer deserialize_(serial_view& bytes);
+
+    /// Registers deserialize_ under the name of clean_type, if serializable
+    static bool register_deserializer_();
+
+    /// Initialized (thus registering) once AnyFieldWrapper<T> is constructed
+    static inline const bool s_registered_ = register_deserializer_();
 };
 
 } // namespace pluginplay::any::detail_
@@ -25,7 +25,10 @@ namespace pluginplay::any::detail_ {
 
 TEMPLATE_PARAMS template<typename U, typename>
 ANY_FIELD_WRAPPER::AnyFieldWrapper(U&& value2wrap) :
-  base_type(wrap_value_(std::forward<U>(value2wrap))) {}
+  base_type(wrap_value_(std::forward<U>(value2wrap))) {
+    // Odr-using the variable is what makes sure it gets initialized
+    (void)s_registered_;
+}
 
 TEMPLATE_PARAMS
 typename ANY_FIELD_WRAPPER::field_base_pointer ANY_FIELD_WRAPPER::clone_()
@@ -66,6 +69,59 @@ bool ANY_FIELD_WRAPPER::value_equal_(const AnyFieldBase& rhs) const noexcept {
     return lhs_value == rhs_value;
 }
 
+TEMPLATE_PARAMS
+std::size_t ANY_FIELD_WRAPPER::hash_() const noexcept {
+    if constexpr(is_hashable_v<clean_type>) {
+        const auto& value = this->base_type::template cast<const_ref_type>();
+        return Hasher<clean_type>{}(value);
+    } else {
+        return rtti_type(typeid(clean_type)).hash_code();
+    }
+}
+
+TEMPLATE_PARAMS
+std::size_t ANY_FIELD_WRAPPER::memory_footprint_() const noexcept {
+    if constexpr(wrap_const_ref_v) {
+        return 0;
+    } else {
+        const auto& value = this->base_type::template cast<const_ref_type>();
+        return MemoryFootprint<clean_type>{}(value);
+    }
+}
+
+TEMPLATE_PARAMS
+bool ANY_FIELD_WRAPPER::digest_(digest_buffer& buffer) const {
+    if constexpr(is_digestible_v<clean_type>) {
+        // The type is part of the digest, e.g., so 1 and 1.0 differ
+        const std::string name = typeid(clean_type).name();
+        Digester<std::string>{}(name, buffer);
+        const auto& value = this->base_type::template cast<const_ref_type>();
+        Digester<clean_type>{}(value, buffer);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+TEMPLATE_PARAMS
+bool ANY_FIELD_WRAPPER::is_serializable_() const noexcept {
+    return is_serializable_v<clean_type>;
+}
+
+TEMPLATE_PARAMS
+bool ANY_FIELD_WRAPPER::serialize_(serial_buffer& buffer) const {
+    if constexpr(is_serializable_v<clean_type>) {
+        // Same name as used by register_deserializer_
+        const std::string name = typeid(clean_type).name();
+        Serializer<std::string>{}.save(name, buffer);
+        const auto& value = this->base_type::template cast<const_ref_type>();
+        Serializer<clean_type>{}.save(value, buffer);
+        return true;
+    } else {
+        return false;
+    }
+}
+
 TEMPLATE_PARAMS
 std::ostream& ANY_FIELD_WRAPPER::print_(std::ostream& os) const {
     using utilities::printing::operator<<;
@@ -107,7 +163,28 @@ TEMPLATE_PARAMS
 template<typename U>
 typename ANY_FIELD_WRAPPER::value_type ANY_FIELD_WRAPPER::wrap_value_(
   U&& value2wrap) const {
-    return boost::any(std::move(wrapped_type(std::forward<U>(value2wrap))));
+    return value_type(wrapped_type(std::forward<U>(value2wrap)));
+}
+
+TEMPLATE_PARAMS
+typename ANY_FIELD_WRAPPER::field_base_pointer ANY_FIELD_WRAPPER::deserialize_(
+  serial_view& bytes) {
+    if constexpr(is_serializable_v<clean_type>) {
+        using owning_type = AnyFieldWrapper<clean_type>;
+        auto value        = Serializer<clean_type>{}.load(bytes);
+        return std::make_unique<owning_type>(std::move(value));
+    } else {
+        throw std::runtime_error("Type can not be deserialized");
+    }
+}
+
+TEMPLATE_PARAMS
+bool ANY_FIELD_WRAPPER::register_deserializer_() {
+    if constexpr(is_serializable_v<clean_type>) {
+        return register_deserializer(typeid(clean_type).name(), deserialize_);
+    } else {
+        return false;
+    }
 }
 
 #undef ANY_FIELD_WRAPPER
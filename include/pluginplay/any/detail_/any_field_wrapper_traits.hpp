@@ -15,6 +15,7 @@
  */
 
 #pragma once
+#include <functional>
 #include <type_traits>
 
 namespace pluginplay::any::detail_ {
@@ -63,4 +64,30 @@ template<typename U, typename V = void>
 using disable_if_any_field_wrapper_t =
   std::enable_if_t<!is_any_field_wrapper<U>::value, V>;
 
+/** @brief Primary template for determining if @p T can be hashed with
+ *         `std::hash`.
+ *
+ *  This is the primary template which is selected when `std::hash<T>` is not
+ *  usable (in which case the standard requires it be a "disabled"
+ *  specialization, i.e., not default constructible).
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_std_hashable : std::false_type {};
+
+/** @brief Specialization of is_std_hashable for when `std::hash<T>` can be
+ *         used to hash an instance of @p T.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T>
+struct is_std_hashable<
+  T, std::void_t<decltype(std::hash<T>{}(std::declval<const T&>()))>>
+  : std::true_type {};
+
+/// Convenience variable for the value of is_std_hashable<T>
+template<typename T>
+static constexpr bool is_std_hashable_v = is_std_hashable<T>::value;
+
 } // namespace pluginplay::any::detail_
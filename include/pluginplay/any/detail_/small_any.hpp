@@ -0,0 +1,336 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace pluginplay::any::detail_ {
+
+/** @brief Type-erased holder of a copyable value, which keeps small values
+ *         inline.
+ *
+ *  SmallAny fills the same role as `boost::any`, but values which are small
+ *  enough (see `stored_inline_v`) live in a buffer inside the SmallAny
+ *  instead of on the heap. This includes arithmetic types, pointers, and
+ *  reference wrappers, as well as (with most standard libraries) strings,
+ *  i.e., the majority of module inputs. Larger values are heap allocated, as
+ *  with `boost::any`.
+ *
+ *  Like `boost::any`, the type of the held value is always decayed, and the
+ *  value is retrieved with small_any_cast.
+ */
+class SmallAny {
+public:
+    /// Size, in bytes, of the inline buffer
+    static constexpr std::size_t buffer_size = 4 * sizeof(void*);
+
+    /// Alignment of the inline buffer
+    static constexpr std::size_t buffer_align = alignof(std::max_align_t);
+
+    /** @brief Is an object of type @p T held inline?
+     *
+     *  Objects are held inline if they fit in the buffer and can be moved
+     *  without throwing (so that moving a SmallAny can not throw).
+     *
+     *  @tparam T The type of the held object.
+     */
+    template<typename T>
+    static constexpr bool stored_inline_v =
+      sizeof(T) <= buffer_size && buffer_align % alignof(T) == 0 &&
+      std::is_nothrow_move_constructible_v<T>;
+
+    /// Makes a SmallAny which does not hold a value
+    SmallAny() noexcept = default;
+
+    /** @brief Makes a SmallAny which holds @p value.
+     *
+     *  @tparam T The type of @p value. `std::decay_t<T>` must be copy
+     *            constructible.
+     *  @tparam <anonymous> Used to disable this ctor when @p T is a SmallAny.
+     *
+     *  @param[in] value The value to hold. Copied if @p value is an lvalue and
+     *                   moved otherwise.
+     *
+     *  @throw std::bad_alloc if the value is not held inline and there is a
+     *                        problem allocating it. Strong throw guarantee.
+     *  @throw ??? If copying/moving @p value throws. Same throw guarantee.
+     */
+    template<typename T, typename = std::enable_if_t<
+                           !std::is_same_v<std::decay_t<T>, SmallAny>>>
+    SmallAny(T&& value) {
+        using clean_type = std::decay_t<T>;
+        Ops<clean_type>::make(m_storage_, std::forward<T>(value));
+        m_ops_ = &Ops<clean_type>::table;
+    }
+
+    /** @brief Makes a SmallAny which holds a deep copy of @p other's value.
+     *
+     *  @param[in] other The instance to copy.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the copy. Strong
+     *                        throw guarantee.
+     *  @throw ??? If copying the value throws. Same throw guarantee.
+     */
+    SmallAny(const SmallAny& other) {
+        if(other.m_ops_ == nullptr) return;
+        other.m_ops_->copy(other.m_storage_, m_storage_);
+        m_ops_ = other.m_ops_;
+    }
+
+    /** @brief Takes the value of @p other.
+     *
+     *  @param[in,out] other The instance to take the value from. After this
+     *                       call @p other does not hold a value.
+     *
+     *  @throw None No throw guarantee.
+     */
+    SmallAny(SmallAny&& other) noexcept { take_(other); }
+
+    /** @brief Replaces the value of *this with a deep copy of @p rhs's value.
+     *
+     *  @param[in] rhs The instance to copy.
+     *
+     *  @return *this after replacing its value.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the copy. Strong
+     *                        throw guarantee.
+     *  @throw ??? If copying the value throws. Same throw guarantee.
+     */
+    SmallAny& operator=(const SmallAny& rhs) {
+        if(this != &rhs) SmallAny(rhs).swap(*this);
+        return *this;
+    }
+
+    /** @brief Replaces the value of *this with the value of @p rhs.
+     *
+     *  @param[in,out] rhs The instance to take the value from. After this call
+     *                     @p rhs does not hold a value.
+     *
+     *  @return *this after replacing its value.
+     *
+     *  @throw None No throw guarantee.
+     */
+    SmallAny& operator=(SmallAny&& rhs) noexcept {
+        if(this == &rhs) return *this;
+        reset();
+        take_(rhs);
+        return *this;
+    }
+
+    /// Releases the held value, if any
+    ~SmallAny() noexcept { reset(); }
+
+    /** @brief Exchanges the values of *this and @p other.
+     *
+     *  @param[in,out] other The instance to swap with.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void swap(SmallAny& other) noexcept {
+        SmallAny temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    /// Releases the held value, if any. After this call *this has no value.
+    void reset() noexcept {
+        if(m_ops_ == nullptr) return;
+        m_ops_->destroy(m_storage_);
+        m_ops_ = nullptr;
+    }
+
+    /// Does *this hold a value?
+    bool has_value() const noexcept { return m_ops_ != nullptr; }
+
+    /// Is the value of *this held in the inline buffer? (false if no value)
+    bool stored_inline() const noexcept {
+        return m_ops_ != nullptr && m_ops_->is_inline;
+    }
+
+    /// RTTI of the held value (`typeid(void)` if there is no value)
+    const std::type_info& type() const noexcept {
+        return m_ops_ == nullptr ? typeid(void) : m_ops_->type();
+    }
+
+    /** @brief Retrieves a pointer to the held value, if it is a @p T.
+     *
+     *  @tparam T The (decayed) type the value is expected to have.
+     *
+     *  @return A pointer to the held value if *this holds an object of type
+     *          @p T and nullptr otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    template<typename T>
+    T* get_if() noexcept {
+        if(type() != typeid(T)) return nullptr;
+        return Ops<T>::get(m_storage_);
+    }
+
+    /// Read-only version of get_if
+    template<typename T>
+    const T* get_if() const noexcept {
+        return const_cast<SmallAny&>(*this).get_if<T>();
+    }
+
+private:
+    /// Where the value lives: in the buffer or on the heap
+    union storage_type {
+        alignas(buffer_align) unsigned char m_buffer[buffer_size];
+        void* m_heap;
+    };
+
+    /// Type-dependent operations, filled in by Ops<T>
+    struct ops_type {
+        /// Returns the RTTI of the held type
+        const std::type_info& (*type)() noexcept;
+
+        /// Copies the value in the first storage into the second storage
+        void (*copy)(const storage_type&, storage_type&);
+
+        /// Moves the value in the first storage into the second storage and
+        /// releases the first storage
+        void (*move)(storage_type&, storage_type&) noexcept;
+
+        /// Releases the value in the storage
+        void (*destroy)(storage_type&) noexcept;
+
+        /// Is the value held inline?
+        bool is_inline;
+    };
+
+    /// Implements ops_type for objects of type @p T
+    template<typename T>
+    struct Ops {
+        static constexpr bool is_inline = stored_inline_v<T>;
+
+        static T* get(storage_type& s) noexcept {
+            if constexpr(is_inline) {
+                return std::launder(reinterpret_cast<T*>(s.m_buffer));
+            } else {
+                return static_cast<T*>(s.m_heap);
+            }
+        }
+
+        template<typename U>
+        static void make(storage_type& s, U&& value) {
+            if constexpr(is_inline) {
+                ::new(static_cast<void*>(s.m_buffer)) T(std::forward<U>(value));
+            } else {
+                s.m_heap = new T(std::forward<U>(value));
+            }
+        }
+
+        static const std::type_info& type() noexcept { return typeid(T); }
+
+        static void copy(const storage_type& from, storage_type& to) {
+            make(to, *get(const_cast<storage_type&>(from)));
+        }
+
+        static void move(storage_type& from, storage_type& to) noexcept {
+            if constexpr(is_inline) {
+                make(to, std::move(*get(from)));
+                get(from)->~T();
+            } else {
+                to.m_heap = from.m_heap;
+            }
+        }
+
+        static void destroy(storage_type& s) noexcept {
+            if constexpr(is_inline) {
+                get(s)->~T();
+            } else {
+                delete get(s);
+            }
+        }
+
+        static constexpr ops_type table{&type, &copy, &move, &destroy,
+                                        is_inline};
+    };
+
+    /// Code factorization for taking the value of @p other
+    void take_(SmallAny& other) noexcept {
+        if(other.m_ops_ == nullptr) return;
+        other.m_ops_->move(other.m_storage_, m_storage_);
+        m_ops_       = other.m_ops_;
+        other.m_ops_ = nullptr;
+    }
+
+    /// The held value
+    storage_type m_storage_;
+
+    /// Operations for the type of the held value (nullptr if no value)
+    const ops_type* m_ops_ = nullptr;
+};
+
+/** @brief Retrieves a pointer to the value held by @p operand.
+ *
+ *  Analogous to `boost::any_cast<T>(boost::any*)`.
+ *
+ *  @tparam T The (decayed) type the value is expected to have.
+ *
+ *  @param[in] operand The SmallAny to retrieve the value of.
+ *
+ *  @return A pointer to the value if @p operand is non-null and holds an
+ *          object of type @p T, and nullptr otherwise.
+ *
+ *  @throw None No throw guarantee.
+ */
+template<typename T>
+T* small_any_cast(SmallAny* operand) noexcept {
+    return operand == nullptr ? nullptr : operand->template get_if<T>();
+}
+
+/// Read-only version of small_any_cast(SmallAny*)
+template<typename T>
+const T* small_any_cast(const SmallAny* operand) noexcept {
+    return operand == nullptr ? nullptr : operand->template get_if<T>();
+}
+
+/** @brief Retrieves the value held by @p operand as an object of type @p T.
+ *
+ *  Analogous to `boost::any_cast<T>(boost::any&)`. @p T may be `U`,
+ *  `const U`, `U&`, or `const U&`, where `U` is the type of the held value.
+ *
+ *  @param[in] operand The SmallAny to retrieve the value of.
+ *
+ *  @return The held value, as an object of type @p T.
+ *
+ *  @throw std::bad_cast if @p operand does not hold an object of type
+ *                       `std::decay_t<T>`. Strong throw guarantee.
+ */
+template<typename T>
+T small_any_cast(SmallAny& operand) {
+    using clean_type = std::remove_cv_t<std::remove_reference_t<T>>;
+    auto* pvalue     = small_any_cast<clean_type>(&operand);
+    if(pvalue == nullptr) throw std::bad_cast();
+    return *pvalue;
+}
+
+/// Read-only version of small_any_cast(SmallAny&)
+template<typename T>
+T small_any_cast(const SmallAny& operand) {
+    using clean_type = std::remove_cv_t<std::remove_reference_t<T>>;
+    const auto* pvalue = small_any_cast<clean_type>(&operand);
+    if(pvalue == nullptr) throw std::bad_cast();
+    return *pvalue;
+}
+
+} // namespace pluginplay::any::detail_
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace pluginplay::any {
+
+/// Type of the buffer the bytes of a digested object are appended to
+using digest_buffer = std::string;
+
+/** @brief Customization point for digesting objects wrapped in an AnyField.
+ *
+ *  Digesting an object means appending a byte representation of the object to
+ *  a buffer. Unlike a hash, the byte representation is stable (the same
+ *  value gives the same bytes in every process) and identifies the value, so
+ *  that a digest (e.g., a name-based UUID) of the bytes can stand in for the
+ *  value. This is what allows content-addressed cache keys.
+ *
+ *  AnyField instances digest the objects they wrap by calling
+ *  `Digester<T>{}(value, buffer)`, where `T` is the unqualified type of the
+ *  wrapped object. This is the primary template, which is selected when we do
+ *  not know how to digest @p T. It intentionally does not define a call
+ *  operator, and AnyField will report that it can not be digested.
+ *
+ *  Out of the box we provide specializations for:
+ *  - arithmetic and enumeration types (their bytes are appended),
+ *  - containers whose elements can be digested (the number of elements and
+ *    then the elements, in order, are appended),
+ *  - `std::pair` instances whose members can be digested.
+ *
+ *  Users wishing to digest their own type `U` should specialize this class,
+ *  i.e. `template<> struct pluginplay::any::Digester<U> {...};`, before any
+ *  AnyField wrapping a `U` is created. The specialization must provide a
+ *  const call operator, which accepts a `const U&` and a `digest_buffer&`,
+ *  and appends to the buffer. Unequal objects must append different bytes.
+ *
+ *  @tparam T The type of object being digested.
+ *  @tparam <anonymous> Used to enable/disable partial specializations via
+ *                      SFINAE.
+ */
+template<typename T, typename = void>
+struct Digester {};
+
+/** @brief Primary template for determining if Digester<T> can digest @p T.
+ *
+ *  This is the primary template which is selected when Digester<T> does not
+ *  define a call operator accepting a `const T&` and a `digest_buffer&`.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_digestible : std::false_type {};
+
+/** @brief Specialization of is_digestible for when Digester<T> can be used to
+ *         digest an instance of @p T.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T>
+struct is_digestible<
+  T, std::void_t<decltype(Digester<T>{}(std::declval<const T&>(),
+                                        std::declval<digest_buffer&>()))>>
+  : std::true_type {};
+
+/// Convenience variable for the value of is_digestible<T>
+template<typename T>
+static constexpr bool is_digestible_v = is_digestible<T>::value;
+
+namespace detail_ {
+
+/// Appends the @p n bytes starting at @p data to @p buffer
+inline void append_bytes(const void* data, std::size_t n,
+                         digest_buffer& buffer) {
+    buffer.append(static_cast<const char*>(data), n);
+}
+
+/** @brief Primary template for determining if @p T is a container of
+ *         digestible elements.
+ *
+ *  This primary template is selected when @p T does not look like a container
+ *  (does not define `value_type`, or can not be iterated over).
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_digestible_range : std::false_type {};
+
+/** @brief Specialization of is_digestible_range for types which look like
+ *         containers.
+ *
+ *  @tparam T The type we are inspecting. Contains `true` if the elements of
+ *            @p T can be digested.
+ */
+template<typename T>
+struct is_digestible_range<
+  T, std::void_t<typename T::value_type,
+                 decltype(std::begin(std::declval<const T&>())),
+                 decltype(std::end(std::declval<const T&>()))>>
+  : std::bool_constant<
+      is_digestible_v<std::remove_cv_t<typename T::value_type>>> {};
+
+/// Convenience variable for the value of is_digestible_range<T>
+template<typename T>
+static constexpr bool is_digestible_range_v = is_digestible_range<T>::value;
+
+/** @brief Primary template for determining if @p T stores arithmetic elements
+ *         contiguously.
+ *
+ *  Selected when @p T has no `data()` member.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_contiguous_arithmetic : std::false_type {};
+
+/** @brief Specialization of is_contiguous_arithmetic for types with a
+ *         `data()` member.
+ *
+ *  @tparam T The type we are inspecting. Contains `true` if @p T's elements
+ *            are arithmetic (so their bytes can be appended in one go).
+ */
+template<typename T>
+struct is_contiguous_arithmetic<
+  T, std::void_t<decltype(std::declval<const T&>().data()),
+                 decltype(std::declval<const T&>().size())>>
+  : std::is_arithmetic<std::remove_cv_t<typename T::value_type>> {};
+
+} // namespace detail_
+
+/** @brief Specialization of Digester for arithmetic and enumeration types.
+ *
+ *  The bytes of the object are appended as is, so the digest depends on the
+ *  platform's byte order and type sizes.
+ *
+ *  @tparam T The type being digested.
+ */
+template<typename T>
+struct Digester<T,
+                std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>> {
+    void operator()(const T& value, digest_buffer& buffer) const {
+        detail_::append_bytes(&value, sizeof(T), buffer);
+    }
+};
+
+/** @brief Specialization of Digester for containers of digestible elements.
+ *
+ *  The number of elements is appended first, so that, e.g., nested
+ *  containers with the same elements split differently are distinguished.
+ *  For ordered containers (including `std::map`) equal containers iterate in
+ *  the same order and thus have the same digest. This includes strings.
+ *
+ *  @tparam T The type of the container being digested.
+ */
+template<typename T>
+struct Digester<T, std::enable_if_t<detail_::is_digestible_range_v<T>>> {
+    void operator()(const T& value, digest_buffer& buffer) const {
+        using element_type = std::remove_cv_t<typename T::value_type>;
+        const auto begin   = std::begin(value);
+        const auto end     = std::end(value);
+        const auto n = static_cast<std::uint64_t>(std::distance(begin, end));
+        detail_::append_bytes(&n, sizeof(n), buffer);
+        if constexpr(detail_::is_contiguous_arithmetic<T>::value) {
+            detail_::append_bytes(value.data(), n * sizeof(element_type),
+                                  buffer);
+        } else {
+            Digester<element_type> d;
+            for(const auto& x : value) d(x, buffer);
+        }
+    }
+};
+
+/** @brief Specialization of Digester for pairs of digestible objects.
+ *
+ *  Among other uses, this specialization allows map-like containers to be
+ *  digested.
+ *
+ *  @tparam T The type of the first element in the pair.
+ *  @tparam U The type of the second element in the pair.
+ */
+template<typename T, typename U>
+struct Digester<std::pair<T, U>,
+                std::enable_if_t<is_digestible_v<std::remove_cv_t<T>> &&
+                                 is_digestible_v<std::remove_cv_t<U>>>> {
+    void operator()(const std::pair<T, U>& value, digest_buffer& buffer) const {
+        Digester<std::remove_cv_t<T>>{}(value.first, buffer);
+        Digester<std::remove_cv_t<U>>{}(value.second, buffer);
+    }
+};
+
+} // namespace pluginplay::any
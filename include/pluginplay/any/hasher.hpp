@@ -0,0 +1,229 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "pluginplay/any/detail_/any_field_wrapper_traits.hpp"
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace pluginplay::any {
+
+/** @brief Customization point for hashing objects wrapped in an AnyField.
+ *
+ *  AnyField instances hash the objects they wrap by calling
+ *  `Hasher<T>{}(value)`, where `T` is the unqualified type of the wrapped
+ *  object. This is the primary template, which is selected when we do not know
+ *  how to hash @p T. It intentionally does not define a call operator, and
+ *  AnyField will fall back to hashing the type of the object (which is always
+ *  consistent with equality, but never distinguishes between values).
+ *
+ *  Out of the box we provide specializations for:
+ *  - types which can be hashed with `std::hash`,
+ *  - containers whose elements can be hashed (elements are hashed in order,
+ *    unless the container is unordered, e.g., `std::unordered_map`),
+ *  - `std::pair` instances whose members can be hashed.
+ *
+ *  Users wishing to hash their own type `U` should specialize this class, i.e.
+ *  `template<> struct pluginplay::any::Hasher<U> {...};`, before any AnyField
+ *  wrapping a `U` is created. The specialization must provide a const call
+ *  operator, which accepts a `const U&` and returns a `std::size_t`. The call
+ *  operator must not throw and the returned hash must be consistent with
+ *  `operator==`, i.e., equal objects must have equal hashes.
+ *
+ *  @tparam T The type of object being hashed.
+ *  @tparam <anonymous> Used to enable/disable partial specializations via
+ *                      SFINAE.
+ */
+template<typename T, typename = void>
+struct Hasher {};
+
+/** @brief Primary template for determining if Hasher<T> can hash @p T.
+ *
+ *  This is the primary template which is selected when Hasher<T> does not
+ *  define a call operator accepting a `const T&`.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_hashable : std::false_type {};
+
+/** @brief Specialization of is_hashable for when Hasher<T> can be used to
+ *         hash an instance of @p T.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T>
+struct is_hashable<
+  T, std::void_t<decltype(Hasher<T>{}(std::declval<const T&>()))>>
+  : std::true_type {};
+
+/// Convenience variable for the value of is_hashable<T>
+template<typename T>
+static constexpr bool is_hashable_v = is_hashable<T>::value;
+
+/** @brief Combines @p seed with another hash value.
+ *
+ *  This is the same mixing function used by `boost::hash_combine`. The result
+ *  depends on the order hashes are combined in.
+ *
+ *  @param[in] seed The hash accumulated so far.
+ *  @param[in] hash The hash to fold into @p seed.
+ *
+ *  @return The combined hash.
+ *
+ *  @throw None No throw guarantee.
+ */
+inline std::size_t hash_combine(std::size_t seed, std::size_t hash) noexcept {
+    return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+namespace detail_ {
+
+/** @brief Primary template for determining if @p T is a container of
+ *         hashable elements.
+ *
+ *  This primary template is selected when @p T does not look like a container
+ *  (does not define `value_type`, or can not be iterated over).
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_hashable_range : std::false_type {};
+
+/** @brief Specialization of is_hashable_range for types which look like
+ *         containers.
+ *
+ *  @tparam T The type we are inspecting. Contains `true` if the elements of
+ *            @p T can be hashed.
+ */
+template<typename T>
+struct is_hashable_range<
+  T, std::void_t<typename T::value_type,
+                 decltype(std::begin(std::declval<const T&>())),
+                 decltype(std::end(std::declval<const T&>()))>>
+  : std::bool_constant<
+      is_hashable_v<std::remove_cv_t<typename T::value_type>>> {};
+
+/// Convenience variable for the value of is_hashable_range<T>
+template<typename T>
+static constexpr bool is_hashable_range_v = is_hashable_range<T>::value;
+
+/** @brief Primary template for determining if @p T is an unordered container.
+ *
+ *  This primary template is selected when @p T does not define a `hasher`
+ *  member type.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_unordered_range : std::false_type {};
+
+/** @brief Specialization of is_unordered_range for types which define a
+ *         `hasher` member type (e.g., `std::unordered_set`).
+ *
+ *  Equal unordered containers need not iterate over their elements in the
+ *  same order, so they must be hashed in an order-independent manner.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T>
+struct is_unordered_range<T, std::void_t<typename T::hasher>>
+  : std::true_type {};
+
+/// Convenience variable for the value of is_unordered_range<T>
+template<typename T>
+static constexpr bool is_unordered_range_v = is_unordered_range<T>::value;
+
+} // namespace detail_
+
+/** @brief Specialization of Hasher for types which `std::hash` can hash.
+ *
+ *  @tparam T The type being hashed.
+ */
+template<typename T>
+struct Hasher<T, std::enable_if_t<detail_::is_std_hashable_v<T>>> {
+    std::size_t operator()(const T& value) const noexcept {
+        return std::hash<T>{}(value);
+    }
+};
+
+/** @brief Specialization of Hasher for containers of hashable elements.
+ *
+ *  The hash is formed by combining the hashes of the elements in iteration
+ *  order. For ordered containers (including `std::map`) equal containers
+ *  iterate in the same order and thus have the same hash. This specialization
+ *  is not selected if `std::hash` can hash @p T (e.g., `std::string`), or if
+ *  @p T is an unordered container.
+ *
+ *  @tparam T The type of the container being hashed.
+ */
+template<typename T>
+struct Hasher<T, std::enable_if_t<!detail_::is_std_hashable_v<T> &&
+                                  !detail_::is_unordered_range_v<T> &&
+                                  detail_::is_hashable_range_v<T>>> {
+    std::size_t operator()(const T& value) const noexcept {
+        using element_type = std::remove_cv_t<typename T::value_type>;
+        Hasher<element_type> h;
+        std::size_t seed = 0;
+        for(const auto& x : value) seed = hash_combine(seed, h(x));
+        return seed;
+    }
+};
+
+/** @brief Specialization of Hasher for unordered containers of hashable
+ *         elements.
+ *
+ *  Equal unordered containers (e.g., `std::unordered_map`) may iterate over
+ *  their elements in different orders, so the (mixed) hashes of the elements
+ *  are summed, which does not depend on the order.
+ *
+ *  @tparam T The type of the container being hashed.
+ */
+template<typename T>
+struct Hasher<T, std::enable_if_t<!detail_::is_std_hashable_v<T> &&
+                                  detail_::is_unordered_range_v<T> &&
+                                  detail_::is_hashable_range_v<T>>> {
+    std::size_t operator()(const T& value) const noexcept {
+        using element_type = std::remove_cv_t<typename T::value_type>;
+        Hasher<element_type> h;
+        std::size_t seed = 0;
+        for(const auto& x : value) seed += hash_combine(0, h(x));
+        return seed;
+    }
+};
+
+/** @brief Specialization of Hasher for pairs of hashable objects.
+ *
+ *  Among other uses, this specialization allows map-like containers to be
+ *  hashed.
+ *
+ *  @tparam T The type of the first element in the pair.
+ *  @tparam U The type of the second element in the pair.
+ */
+template<typename T, typename U>
+struct Hasher<std::pair<T, U>,
+              std::enable_if_t<is_hashable_v<std::remove_cv_t<T>> &&
+                               is_hashable_v<std::remove_cv_t<U>>>> {
+    std::size_t operator()(const std::pair<T, U>& value) const noexcept {
+        const auto h0 = Hasher<std::remove_cv_t<T>>{}(value.first);
+        const auto h1 = Hasher<std::remove_cv_t<U>>{}(value.second);
+        return hash_combine(hash_combine(0, h0), h1);
+    }
+};
+
+} // namespace pluginplay::any
@@ -0,0 +1,226 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace pluginplay::any {
+
+/** @brief Customization point for computing how much memory an object wrapped
+ *         in an AnyField occupies.
+ *
+ *  AnyField instances compute the memory footprint of the objects they wrap by
+ *  calling `MemoryFootprint<T>{}(value)`, where `T` is the unqualified type of
+ *  the wrapped object. The footprint is the number of bytes the object
+ *  occupies, including any memory it owns (e.g., the buffer of a
+ *  `std::vector`). This is the primary template, which is selected when we do
+ *  not know anything about @p T, and simply returns `sizeof(T)`. This is exact
+ *  for types which do not own memory and an underestimate for those that do.
+ *
+ *  Out of the box we provide specializations for:
+ *  - contiguous containers with a capacity (e.g., `std::vector` and
+ *    `std::string`), which count their capacity,
+ *  - `std::array`,
+ *  - other containers (e.g., `std::map`), which count their elements, but not
+ *    the bookkeeping of the nodes holding them,
+ *  - `std::pair`.
+ *
+ *  Containers also count the memory owned by their elements.
+ *
+ *  Users wishing to report the footprint of their own type `U` (e.g., a
+ *  tensor) should specialize this class, i.e.,
+ *  `template<> struct pluginplay::any::MemoryFootprint<U> {...};`, before any
+ *  AnyField wrapping a `U` is created. The specialization must provide a const
+ *  call operator, which accepts a `const U&`, returns a `std::size_t`, and
+ *  does not throw.
+ *
+ *  @tparam T The type of the object being measured.
+ *  @tparam <anonymous> Used to enable/disable partial specializations via
+ *                      SFINAE.
+ */
+template<typename T, typename = void>
+struct MemoryFootprint {
+    std::size_t operator()(const T&) const noexcept { return sizeof(T); }
+};
+
+/** @brief Wraps calling MemoryFootprint<T> for an object.
+ *
+ *  @tparam T The type of the object being measured.
+ *
+ *  @param[in] value The object being measured.
+ *
+ *  @return The number of bytes @p value occupies.
+ *
+ *  @throw None No throw guarantee.
+ */
+template<typename T>
+std::size_t memory_footprint(const T& value) noexcept {
+    return MemoryFootprint<std::remove_cv_t<T>>{}(value);
+}
+
+namespace detail_ {
+
+/// Memory owned by @p value, i.e., its footprint less its size
+template<typename T>
+std::size_t owned_memory(const T& value) noexcept {
+    const auto footprint = memory_footprint(value);
+    return footprint > sizeof(T) ? footprint - sizeof(T) : 0;
+}
+
+/** @brief Primary template for determining if @p T looks like a container.
+ *
+ *  This primary template is selected when @p T does not define `value_type`
+ *  or can not be iterated over.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_range : std::false_type {};
+
+/// Specialization of is_range for types which look like containers
+template<typename T>
+struct is_range<T, std::void_t<typename T::value_type,
+                               decltype(std::begin(std::declval<const T&>())),
+                               decltype(std::end(std::declval<const T&>()))>>
+  : std::true_type {};
+
+/** @brief Primary template for determining if @p T is a contiguous container
+ *         with a capacity.
+ *
+ *  This primary template is selected when @p T does not have `data` and
+ *  `capacity` members.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct has_capacity : std::false_type {};
+
+/// Specialization of has_capacity for types like std::vector
+template<typename T>
+struct has_capacity<
+  T, std::void_t<decltype(std::declval<const T&>().data()),
+                 decltype(std::declval<const T&>().capacity())>>
+  : std::true_type {};
+
+/// Primary template for determining if @p T is a std::array
+template<typename T>
+struct is_std_array : std::false_type {};
+
+/// Specialization of is_std_array for std::array
+template<typename T, std::size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type {};
+
+/// Is @p T a contiguous container with a capacity?
+template<typename T>
+static constexpr bool is_vector_like_v = is_range<T>::value &&
+                                         has_capacity<T>::value;
+
+/// Is @p T a container which stores its elements inline?
+template<typename T>
+static constexpr bool is_array_like_v = is_range<T>::value &&
+                                        is_std_array<T>::value;
+
+/// Is @p T a container which stores each element in its own node?
+template<typename T>
+static constexpr bool is_node_based_v = is_range<T>::value &&
+                                        !is_vector_like_v<T> &&
+                                        !is_array_like_v<T>;
+
+} // namespace detail_
+
+/** @brief Specialization of MemoryFootprint for contiguous containers with a
+ *         capacity (e.g., std::vector and std::string).
+ *
+ *  The footprint is the size of the container, plus its capacity, plus any
+ *  memory owned by the elements. If the buffer lives inside the container
+ *  (e.g., a short std::string) the capacity is already part of the size.
+ *
+ *  @tparam T The type of the container.
+ */
+template<typename T>
+struct MemoryFootprint<T, std::enable_if_t<detail_::is_vector_like_v<T>>> {
+    std::size_t operator()(const T& value) const noexcept {
+        using element_type = typename T::value_type;
+        const auto* begin  = reinterpret_cast<const char*>(&value);
+        const auto* buffer = reinterpret_cast<const char*>(value.data());
+        const bool inline_buffer =
+          std::less_equal<>{}(begin, buffer) &&
+          std::less<>{}(buffer, begin + sizeof(T));
+
+        std::size_t rv = sizeof(T);
+        if(!inline_buffer) rv += value.capacity() * sizeof(element_type);
+        for(const auto& x : value) rv += detail_::owned_memory(x);
+        return rv;
+    }
+};
+
+/** @brief Specialization of MemoryFootprint for std::array.
+ *
+ *  The elements are part of the array, so only the memory they own is added
+ *  to the size of the array.
+ *
+ *  @tparam T The type of the array.
+ */
+template<typename T>
+struct MemoryFootprint<T, std::enable_if_t<detail_::is_array_like_v<T>>> {
+    std::size_t operator()(const T& value) const noexcept {
+        std::size_t rv = sizeof(T);
+        for(const auto& x : value) rv += detail_::owned_memory(x);
+        return rv;
+    }
+};
+
+/** @brief Specialization of MemoryFootprint for other containers (e.g.,
+ *         std::map and std::list).
+ *
+ *  The footprint is the size of the container plus the footprints of the
+ *  elements. The bookkeeping of the nodes holding the elements (e.g.,
+ *  pointers to the neighboring nodes) is not counted.
+ *
+ *  @tparam T The type of the container.
+ */
+template<typename T>
+struct MemoryFootprint<T, std::enable_if_t<detail_::is_node_based_v<T>>> {
+    std::size_t operator()(const T& value) const noexcept {
+        std::size_t rv = sizeof(T);
+        for(const auto& x : value) rv += memory_footprint(x);
+        return rv;
+    }
+};
+
+/** @brief Specialization of MemoryFootprint for pairs.
+ *
+ *  Among other uses, this specialization measures the elements of map-like
+ *  containers.
+ *
+ *  @tparam T The type of the first element in the pair.
+ *  @tparam U The type of the second element in the pair.
+ */
+template<typename T, typename U>
+struct MemoryFootprint<std::pair<T, U>> {
+    std::size_t operator()(const std::pair<T, U>& value) const noexcept {
+        return sizeof(value) + detail_::owned_memory(value.first) +
+               detail_::owned_memory(value.second);
+    }
+};
+
+} // namespace pluginplay::any
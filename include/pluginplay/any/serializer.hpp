@@ -0,0 +1,261 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace pluginplay::any {
+
+/// Type of the buffer the bytes of a serialized object are appended to
+using serial_buffer = std::string;
+
+/// Type of a view of the bytes an object is deserialized from
+using serial_view = std::string_view;
+
+/** @brief Customization point for serializing objects wrapped in an AnyField.
+ *
+ *  AnyField instances serialize the objects they wrap by calling
+ *  `Serializer<T>{}.save(value, buffer)`, which appends the bytes of `value`
+ *  to `buffer`, and deserialize them by calling `Serializer<T>{}.load(bytes)`,
+ *  which consumes the bytes of one object from the front of `bytes` and
+ *  returns the object. Here `T` is the unqualified type of the wrapped object.
+ *  This is the primary template, which is selected when we do not know how to
+ *  serialize @p T. It intentionally does not define `save` or `load`, and
+ *  AnyField will report that it can not be serialized.
+ *
+ *  Out of the box we provide specializations for:
+ *  - arithmetic and enumeration types (their bytes are copied),
+ *  - default constructible containers whose elements can be serialized and
+ *    which can be filled with `insert(end(), element)` (the number of
+ *    elements and then the elements, in order, are saved),
+ *  - `std::pair` instances whose members can be serialized.
+ *
+ *  The bytes are only meant to be read back by the same build on the same
+ *  platform (e.g., the byte order is not converted).
+ *
+ *  Users wishing to serialize their own type `U` should specialize this class,
+ *  i.e. `template<> struct pluginplay::any::Serializer<U> {...};`, before any
+ *  AnyField wrapping a `U` is created. The specialization must provide const
+ *  `save` and `load` members with the signatures described above; `load`
+ *  should throw std::runtime_error if there are not enough bytes.
+ *
+ *  @tparam T The type of object being serialized.
+ *  @tparam <anonymous> Used to enable/disable partial specializations via
+ *                      SFINAE.
+ */
+template<typename T, typename = void>
+struct Serializer {};
+
+/** @brief Primary template for determining if Serializer<T> can serialize
+ *         @p T.
+ *
+ *  This is the primary template which is selected when Serializer<T> does not
+ *  define both `save` and `load`.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_serializable : std::false_type {};
+
+/** @brief Specialization of is_serializable for when Serializer<T> can be used
+ *         to serialize and deserialize an instance of @p T.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T>
+struct is_serializable<
+  T,
+  std::void_t<decltype(Serializer<T>{}.save(std::declval<const T&>(),
+                                            std::declval<serial_buffer&>())),
+              decltype(Serializer<T>{}.load(std::declval<serial_view&>()))>>
+  : std::is_same<decltype(Serializer<T>{}.load(std::declval<serial_view&>())),
+                 T> {};
+
+/// Convenience variable for the value of is_serializable<T>
+template<typename T>
+static constexpr bool is_serializable_v = is_serializable<T>::value;
+
+namespace detail_ {
+
+/** @brief Copies the first @p n bytes of @p bytes to @p data and removes them
+ *         from @p bytes.
+ *
+ *  @throw std::runtime_error if @p bytes holds less than @p n bytes. Strong
+ *                            throw guarantee.
+ */
+inline void read_bytes(void* data, std::size_t n, serial_view& bytes) {
+    if(bytes.size() < n)
+        throw std::runtime_error("Not enough bytes to deserialize the object");
+    std::memcpy(data, bytes.data(), n);
+    bytes.remove_prefix(n);
+}
+
+/** @brief Primary template for determining if @p T is a container which can be
+ *         serialized element by element.
+ *
+ *  This primary template is selected when @p T does not look like a container
+ *  (does not define `value_type`, can not be iterated over, or can not be
+ *  filled by inserting at the end).
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_serializable_range : std::false_type {};
+
+/** @brief Specialization of is_serializable_range for types which look like
+ *         containers.
+ *
+ *  @tparam T The type we are inspecting. Contains `true` if the elements of
+ *            @p T can be serialized and @p T is default constructible.
+ */
+template<typename T>
+struct is_serializable_range<
+  T, std::void_t<typename T::value_type,
+                 decltype(std::begin(std::declval<const T&>())),
+                 decltype(std::end(std::declval<const T&>())),
+                 decltype(std::declval<T&>().insert(
+                   std::declval<T&>().end(),
+                   std::declval<typename T::value_type>()))>>
+  : std::bool_constant<
+      std::is_default_constructible_v<T> &&
+      is_serializable_v<std::remove_cv_t<typename T::value_type>>> {};
+
+/// Convenience variable for the value of is_serializable_range<T>
+template<typename T>
+static constexpr bool is_serializable_range_v = is_serializable_range<T>::value;
+
+/** @brief Primary template for determining if the arithmetic elements of @p T
+ *         can be read in one go.
+ *
+ *  Selected when @p T has no (mutable) `data()` or `resize()` member.
+ *
+ *  @tparam T The type we are inspecting.
+ */
+template<typename T, typename = void>
+struct is_resizable_arithmetic : std::false_type {};
+
+/** @brief Specialization of is_resizable_arithmetic for types with `data()`
+ *         and `resize()` members.
+ *
+ *  @tparam T The type we are inspecting. Contains `true` if @p T's elements
+ *            are arithmetic.
+ */
+template<typename T>
+struct is_resizable_arithmetic<
+  T, std::void_t<decltype(std::declval<T&>().data()),
+                 decltype(std::declval<T&>().resize(std::size_t{}))>>
+  : std::is_arithmetic<typename T::value_type> {};
+
+} // namespace detail_
+
+/** @brief Specialization of Serializer for arithmetic and enumeration types.
+ *
+ *  @tparam T The type being serialized.
+ */
+template<typename T>
+struct Serializer<
+  T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>> {
+    void save(const T& value, serial_buffer& buffer) const {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    T load(serial_view& bytes) const {
+        T rv;
+        detail_::read_bytes(&rv, sizeof(T), bytes);
+        return rv;
+    }
+};
+
+/** @brief Specialization of Serializer for containers of serializable
+ *         elements.
+ *
+ *  The number of elements is saved first, followed by the elements in
+ *  iteration order. Elements are loaded back by inserting them at the end of a
+ *  default constructed container. Containers storing arithmetic elements
+ *  contiguously (e.g., `std::vector<double>`) are copied in one go.
+ *
+ *  @tparam T The type of the container being serialized.
+ */
+template<typename T>
+struct Serializer<T, std::enable_if_t<detail_::is_serializable_range_v<T>>> {
+    using element_type = std::remove_cv_t<typename T::value_type>;
+    using size_type    = std::uint64_t;
+
+    void save(const T& value, serial_buffer& buffer) const {
+        const auto begin = std::begin(value);
+        const auto end   = std::end(value);
+        const auto n     = static_cast<size_type>(std::distance(begin, end));
+        Serializer<size_type>{}.save(n, buffer);
+        if constexpr(detail_::is_resizable_arithmetic<T>::value) {
+            const auto* pdata = reinterpret_cast<const char*>(value.data());
+            buffer.append(pdata, n * sizeof(element_type));
+        } else {
+            Serializer<element_type> s;
+            for(const auto& x : value) s.save(x, buffer);
+        }
+    }
+
+    T load(serial_view& bytes) const {
+        const auto n = Serializer<size_type>{}.load(bytes);
+        T rv;
+        if constexpr(detail_::is_resizable_arithmetic<T>::value) {
+            // Checked first so that corrupt sizes don't allocate
+            if(bytes.size() / sizeof(element_type) < n)
+                throw std::runtime_error("Not enough bytes to deserialize");
+            rv.resize(n);
+            detail_::read_bytes(rv.data(), n * sizeof(element_type), bytes);
+        } else {
+            Serializer<element_type> s;
+            for(size_type i = 0; i < n; ++i) rv.insert(rv.end(), s.load(bytes));
+        }
+        return rv;
+    }
+};
+
+/** @brief Specialization of Serializer for pairs of serializable objects.
+ *
+ *  Among other uses, this specialization allows map-like containers to be
+ *  serialized.
+ *
+ *  @tparam T The type of the first element in the pair.
+ *  @tparam U The type of the second element in the pair.
+ */
+template<typename T, typename U>
+struct Serializer<std::pair<T, U>,
+                  std::enable_if_t<is_serializable_v<std::remove_cv_t<T>> &&
+                                   is_serializable_v<std::remove_cv_t<U>>>> {
+    void save(const std::pair<T, U>& value, serial_buffer& buffer) const {
+        Serializer<std::remove_cv_t<T>>{}.save(value.first, buffer);
+        Serializer<std::remove_cv_t<U>>{}.save(value.second, buffer);
+    }
+
+    std::pair<T, U> load(serial_view& bytes) const {
+        // N.B. the members must be loaded in order
+        auto first  = Serializer<std::remove_cv_t<T>>{}.load(bytes);
+        auto second = Serializer<std::remove_cv_t<U>>{}.load(bytes);
+        return std::pair<T, U>(std::move(first), std::move(second));
+    }
+};
+
+} // namespace pluginplay::any
@@ -15,10 +15,15 @@
  */
 
 #pragma once
+#include <chrono>
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <pluginplay/cache/module_manager_cache.hpp>
 #include <pluginplay/fields/fields.hpp>
 #include <pluginplay/types.hpp>
+#include <pluginplay/utility/latency_histogram.hpp>
 
 namespace pluginplay::cache {
 namespace detail_ {
@@ -48,6 +53,73 @@ public:
     /// Type of results, semantically similar to std::map<string, ModuleResult>
     using mapped_type = type::result_map;
 
+    /// Type of a callback which computes the results for a set of inputs
+    using compute_function = std::function<mapped_type()>;
+
+    /// Type used for counting
+    using size_type = std::size_t;
+
+    /// Type used for the times in metrics_type
+    using duration_type = std::chrono::nanoseconds;
+
+    /// Type of the latency histograms in metrics_type
+    using histogram_type = utility::LatencyHistogram;
+
+    /** @brief Counters and timings describing how the cache is used.
+     *
+     *  Whether memoizing a module pays off can be estimated from these: on
+     *  average, each hit saves `compute_time / n_computed`, while every call
+     *  costs `lookup_time / (n_hits + n_misses)` and each insert additionally
+     *  costs memory (see `bytes_inserted`).
+     *
+     *  The hits and misses are those of find_or_compute (i.e., of the module
+     *  memoizing itself). The inserts, bytes, and the proxy and backend times
+     *  cover all operations.
+     */
+    struct metrics_type {
+        /// Number of calls which found the results in the cache
+        size_type n_hits = 0;
+
+        /// Number of calls which did not find the results in the cache
+        size_type n_misses = 0;
+
+        /// Number of calls which computed the results
+        size_type n_computed = 0;
+
+        /// Number of calls which waited for another call computing the same
+        /// results, and then returned them (i.e., the calls that coalesced)
+        size_type n_coalesced = 0;
+
+        /// Number of results stored in the cache
+        size_type n_inserts = 0;
+
+        /// Total size of the results stored in the cache, in bytes
+        size_type bytes_inserted = 0;
+
+        /// Time find_or_compute spent on look ups and inserts (i.e., not
+        /// computing or waiting on another call computing)
+        duration_type lookup_time{0};
+
+        /// Time spent mapping inputs to proxies
+        duration_type proxy_time{0};
+
+        /// Time spent in the database holding the results
+        duration_type backend_time{0};
+
+        /// Time spent computing results which were then cached
+        duration_type compute_time{0};
+
+        /// Latencies of the find_or_compute calls which hit or computed
+        /// (excluding the time spent computing)
+        histogram_type lookup_latency;
+
+        /// Latencies of the individual proxy operations
+        histogram_type proxy_latency;
+
+        /// Latencies of the individual backend operations
+        histogram_type backend_latency;
+    };
+
     /// Type of the object holding the ModuleCache's state
     using pimpl_type = detail_::ModuleCachePIMPL;
 
@@ -128,6 +200,9 @@ public:
      *  the associated value. It is the caller's responsiblity to ensure that
      *  @p key includes all information that can possibly influence the result.
      *
+     *  The writes this call makes to long-term storage (if any) are grouped
+     *  into a single batch, which is committed before this call returns.
+     *
      *  @param[in] key The inputs which generated @p value.
      *
      *  @param[in] value The results generated by running the module with the
@@ -158,6 +233,88 @@ public:
      */
     mapped_type uncache(const_key_reference key);
 
+    /** @brief Retrieves previously cached results, if there are any.
+     *
+     *  This method is semantically equivalent to calling `count(key)` and,
+     *  if that returns true, `uncache(key)`. The difference is that @p key is
+     *  only looked up (and thus only proxied) once.
+     *
+     *  N.B. If this instance does not have a PIMPL this function will always
+     *       return an empty optional.
+     *
+     *  @param[in] key The inputs associated with the results we want.
+     *
+     *  @return The results which were cached under @p key, or an empty
+     *          optional if there are no results cached under @p key.
+     *
+     *  @throw ??? Throws if the database backend throws. Same throw guarantee.
+     */
+    std::optional<mapped_type> try_get(const_key_reference key) const;
+
+    /** @brief Retrieves previously cached results, computing and caching them
+     *         first if need be.
+     *
+     *  This method is semantically equivalent to:
+     *
+     *  @code
+     *  if(!count(key)) cache(key, fxn());
+     *  return uncache(key);
+     *  @endcode
+     *
+     *  However, @p key is only proxied once and that proxy is reused for the
+     *  look up and, on a miss, for storing the result. This is the method
+     *  modules use to memoize themselves.
+     *
+     *  This method is thread-safe and "single-flight": if another thread is
+     *  already computing the results for inputs equal to @p key, this call
+     *  waits for, and then returns, those results instead of calling @p fxn.
+     *  If that computation throws, the exception is rethrown here too. Calls
+     *  which coalesce in this manner are counted in metrics(). To avoid
+     *  deadlocks, a thread which is itself computing results (for any
+     *  module) never waits; it calls @p fxn instead.
+     *
+     *  @param[in] key The inputs associated with the results we want.
+     *  @param[in] fxn The callback used to compute the results if they have
+     *                 not been cached yet. It is only called on a miss.
+     *
+     *  @return The results which are cached under @p key.
+     *
+     *  @throw std::runtime_error if this instance does not contain a PIMPL.
+     *                            Strong throw guarantee.
+     *  @throw ??? Throws if @p fxn throws or if the backend throws. If @p fxn
+     *             throws no results are cached. Same throw guarantee.
+     */
+    mapped_type find_or_compute(const_key_reference key,
+                                const compute_function& fxn);
+
+    /** @brief Returns how the cache has been used.
+     *
+     *  The counters are updated atomically, but are not read atomically as a
+     *  set. They are not reset by clear.
+     *
+     *  N.B. If this instance does not have a PIMPL all counters are zero.
+     *
+     *  @return A snapshot of the counters.
+     *
+     *  @throw None No throw guarantee.
+     */
+    metrics_type metrics() const noexcept;
+
+    /** @brief How much memory do the cached results occupy?
+     *
+     *  This is the number of bytes the results held in memory occupy,
+     *  including the values they wrap (see AnyField::memory_footprint).
+     *  Results which were evicted to long-term storage, and the inputs (which
+     *  are shared by all caches), are not counted.
+     *
+     *  N.B. If this instance does not have a PIMPL the footprint is zero.
+     *
+     *  @return The number of bytes the cached results occupy.
+     *
+     *  @throw None No throw guarantee.
+     */
+    size_type memory_footprint() const noexcept;
+
     /** @brief Frees up the memory associated with this cache.
      *
      *  @warning This function will delete all results and will not save them.
@@ -171,6 +328,46 @@ public:
      */
     void clear();
 
+    /** @brief Copies the cached results to long-term storage.
+     *
+     *  Results normally only reach long-term storage when they are evicted
+     *  from memory. This method copies the results still held in memory too,
+     *  e.g., before exporting the long-term storage. The results stay in
+     *  memory. If there is no long-term storage this is a no-op.
+     *
+     *  N.B. This is a no-op if this instance does not contain a PIMPL.
+     *
+     *  @throw ??? Throws if the backend throws.
+     */
+    void backup();
+
+    /** @brief Sets whether results may be written to long-term storage.
+     *
+     *  By default, results are written to long-term storage when they are
+     *  evicted or backed up (if there is long-term storage). Results cached
+     *  while this is false are only ever held in memory: they are skipped by
+     *  backup and dropped (not spilled) when evicted. Results which were
+     *  cached before are not affected. Inputs are shared by all caches and
+     *  are always eligible for long-term storage.
+     *
+     *  N.B. This is a no-op if this instance does not contain a PIMPL.
+     *
+     *  @param[in] persistent True if results cached from now on may be
+     *                        written to long-term storage, false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void set_persistent(bool persistent) noexcept;
+
+    /** @brief May results cached from now on go to long-term storage?
+     *
+     *  @return The value last passed to set_persistent (true by default).
+     *          False if this instance does not contain a PIMPL.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_persistent() const noexcept;
+
 private:
     /// Type of a modifiable PIMPL
     using pimpl_reference = pimpl_type&;
@@ -15,7 +15,10 @@
  */
 
 #pragma once
+#include <cstddef>
 #include <memory>
+#include <parallelzone/runtime/runtime_view.hpp>
+#include <pluginplay/cache/rocksdb_options.hpp>
 #include <string>
 
 namespace pluginplay::cache {
@@ -26,6 +29,16 @@ struct ModuleManagerCachePIMPL;
 class ModuleCache;
 class UserCache;
 
+/** @brief How a memory-limited cache chooses the results to evict.
+ *
+ *  - lru. The results which were used least recently are evicted first.
+ *  - cost_aware. Weighs how long a result took to compute against how much
+ *    memory it occupies, so cheap-to-recompute, large results are evicted
+ *    before expensive, small ones. Results which have not been used for a
+ *    while are still evicted eventually.
+ */
+enum class EvictionPolicy { lru, cost_aware };
+
 /** @brief "The Cache". This object holds all of the data the ModuleManager
  *         needs to cache.
  *
@@ -47,11 +60,21 @@ class UserCache;
  *    the user's responsibility to choose whether all the processes see the
  *    same cache (for example by providing a path on a parallel filesystem), or
  *    if there multiple caches (for example by providing paths that are only
- *    visible to a proper subset of processes).
- *  - in most cases functions are not thread-safe. For memoization this may lead
- *    to cache-misses on account of data races (e.g., thread 1 is computing, but
- *    hasn't cached a result that thread 2 is looking for. The result is thread
- *    2 will duplicate the effort, but otherwise there's no harm done).
+ *    visible to a proper subset of processes). Several processes may only
+ *    use the same path at the same time if RocksDBOptions::shared is set,
+ *    in which case each process writes to its own database under the path
+ *    and reads what the others wrote.
+ *  - within a process the caches are thread-safe. Getting/making module and
+ *    user caches is guarded by a mutex, and the databases backing the caches
+ *    use reader/writer locks so concurrent cache hits do not block each other.
+ *    Concurrent misses on the same inputs are coalesced by the module caches
+ *    (see ModuleCache::find_or_compute).
+ *
+ *  By default the cache grows without bound. set_memory_budget limits the
+ *  memory the cached inputs/results may occupy. When the limit is exceeded
+ *  results are evicted. If the cache saves to disk, evicted results are
+ *  written to disk and read back when they are needed; otherwise they are
+ *  dropped (and will be recomputed if they are needed again).
  */
 class ModuleManagerCache {
 public:
@@ -73,14 +96,29 @@ public:
     /// Type of a shared pointer to a user_cache_type object
     using user_cache_pointer = std::shared_ptr<user_cache_type>;
 
+    /// Type used for sizes
+    using size_type = std::size_t;
+
+    /// Type of the policy used to evict results
+    using eviction_policy = EvictionPolicy;
+
+    /// Type of the options used to tune the on-disk databases
+    using rocksdb_options = RocksDBOptions;
+
+    /// Type of the runtime the cache can be distributed over
+    using runtime_type = parallelzone::runtime::RuntimeView;
+
     /** @brief Creates a new instance that does not save to disk.
      *
-     *  Default created ModuleManagerCache instances have no state and will
-     *  store their cached results in memory, with no option of backing up to
-     *  disk. Users can enable disk backups by calling change_save_location on
-     *  a ModuleManagerCache instance. .
+     *  Default created ModuleManagerCache instances will store their cached
+     *  results in memory, with no option of backing up to disk. Users can
+     *  enable disk backups by calling change_save_location on a
+     *  ModuleManagerCache instance.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the state.
+     *                        Strong throw guarantee.
      */
-    ModuleManagerCache() noexcept;
+    ModuleManagerCache();
 
     /** @brief Creates a new instance which does save to disk.
      *
@@ -95,9 +133,14 @@ public:
      *
      *  @param[in] disk_location The (ideally full) path to the directory where
      *                           cached results will be saved.
+     *  @param[in] options How to tune the databases living at
+     *                     @p disk_location. Defaults to RocksDB's defaults.
+     *                     If RocksDBOptions::shared is set, content-addressed
+     *                     keys are turned on (see change_save_location).
      *
      */
-    explicit ModuleManagerCache(path_type disk_location);
+    explicit ModuleManagerCache(path_type disk_location,
+                                rocksdb_options options = {});
 
     /** @brief Default dtor.
      *
@@ -118,9 +161,180 @@ public:
      *  (i.e., if you made some in memory-only caches, this method will not
      *  reallocate them/migrate their data to a cache which can save to disk).
      *
+     *  If RocksDBOptions::shared is set in @p options, this also turns on
+     *  content-addressed keys (see set_content_addressed_keys), since the
+     *  processes sharing the cache have to agree on the keys. Otherwise, each
+     *  process would store the results under keys only it knows.
+     *
      *  @param[in] disk_location Where the cache should be saved to.
+     *  @param[in] options How to tune the databases living at
+     *                     @p disk_location. Defaults to RocksDB's defaults.
+     */
+    void change_save_location(path_type disk_location,
+                              rocksdb_options options = {});
+
+    /** @brief Limits how much memory the cached inputs and results may use.
+     *
+     *  The limit applies to all of the module (and user) caches made by this
+     *  instance, including those which already exist. It is enforced the next
+     *  time a result is added to any of them. Sizes are estimated, so the
+     *  limit is approximate.
+     *
+     *  @param[in] max_bytes The maximum number of bytes. Zero means there is
+     *                       no limit, which is the default.
+     *  @param[in] policy How to choose the results to evict. Defaults to
+     *                    evicting the least recently used results.
+     *
+     *  @throw std::bad_alloc if this instance has no PIMPL and there is a
+     *                        problem making one. Strong throw guarantee.
+     */
+    void set_memory_budget(size_type max_bytes,
+                           eviction_policy policy = eviction_policy::lru);
+
+    /** @brief Should inputs and results be keyed by their content?
+     *
+     *  Cached inputs and results are stored under UUIDs. By default the UUIDs
+     *  are random, so two processes (or two runs) which see the same inputs
+     *  assign them different UUIDs and can only share an on-disk cache
+     *  through the persisted UUID database. With content-addressed keys the
+     *  UUIDs are derived from a digest of the values (see
+     *  pluginplay::any::Digester), so independent jobs writing to the same
+     *  on-disk cache reuse each other's results. Values whose types can not
+     *  be digested still get random UUIDs.
+     *
+     *  Like change_save_location, this only affects module (and user) caches
+     *  made after the call.
+     *
+     *  @param[in] content_addressed True for content-addressed keys and false
+     *                               for random keys (the default).
+     *
+     *  @throw std::bad_alloc if this instance has no PIMPL and there is a
+     *                        problem making one. Strong throw guarantee.
+     *  @throw std::runtime_error if @p content_addressed is false and the
+     *                            cache is shared with other processes (see
+     *                            change_save_location and open_snapshot) or
+     *                            ranks (see set_distributed). Strong throw
+     *                            guarantee.
+     */
+    void set_content_addressed_keys(bool content_addressed = true);
+
+    /** @brief Makes the ranks of @p runtime share one logical cache.
+     *
+     *  Instead of being saved to disk, the cached inputs and results are
+     *  spread over the ranks of @p runtime: each one is stored by the rank
+     *  its key hashes to, and the other ranks ask that rank for it. Hence
+     *  results are not replicated on every rank. Since the ranks have to
+     *  agree on the keys, this also turns on content-addressed keys (see
+     *  set_content_addressed_keys).
+     *
+     *  Inputs and results are sent to the rank storing them as soon as they
+     *  are cached, so the other ranks get hits for them right away. This
+     *  relies on serializing them; inputs and results which can't be
+     *  serialized are only cached by the rank which computed them.
+     *
+     *  This is a collective operation, and so is destroying *this afterwards.
+     *  If @p runtime has more than one rank, MPI must have been initialized
+     *  with MPI_THREAD_MULTIPLE, since each rank answers the others' requests
+     *  from a separate thread. Like change_save_location, this only affects
+     *  module (and user) caches made after the call.
+     *
+     *  @param[in] runtime The ranks sharing the cache.
+     *
+     *  @throw std::runtime_error if @p runtime has more than one rank and MPI
+     *                            does not support MPI_THREAD_MULTIPLE. Strong
+     *                            throw guarantee.
+     */
+    void set_distributed(const runtime_type& runtime);
+
+    /** @brief Backs up the results held by the module (and user) caches.
+     *
+     *  This calls ModuleCache::backup (UserCache::backup) on every module
+     *  (user) cache made by *this. When the cache saves to disk, this is a
+     *  durability point: once it returns, results which were queued for
+     *  writing in the background (see RocksDBOptions::write_behind_limit)
+     *  have been written.
+     *
+     *  @throw ??? Throws if writing to long-term storage fails, including
+     *             failures of earlier background writes.
+     */
+    void backup();
+
+    /** @brief Exports the cache to a read-only snapshot.
+     *
+     *  The results held in memory by the module (and user) caches are first
+     *  backed up, then the long-term storage is written to immutable snapshot
+     *  files in the directory @p path (which is created if needed). Other
+     *  instances can then serve cache hits straight from the files (see
+     *  open_snapshot). Since the files are memory-mapped and never modified,
+     *  many processes opening the same snapshot share its pages. Those
+     *  processes have to recompute the keys of the inputs, so the cache must
+     *  use content-addressed keys (see set_content_addressed_keys).
+     *
+     *  @param[in] path The directory the snapshot is written to. An existing
+     *                  snapshot in it is replaced.
+     *
+     *  @throw std::runtime_error if there is no long-term storage (e.g., the
+     *                            cache lives purely in memory), if the keys
+     *                            are not content-addressed, or if the files
+     *                            can't be written.
+     */
+    void export_snapshot(path_type path);
+
+    /** @brief Exports the cache of one module to a read-only snapshot.
+     *
+     *  This is the same as the other overload, except that only the results
+     *  of the module cache associated with @p key (and the inputs/results
+     *  they refer to) are exported.
+     *
+     *  @param[in] path The directory the snapshot is written to.
+     *  @param[in] key The module whose results are exported.
+     *
+     *  @throw std::runtime_error if there is no long-term storage, if the keys
+     *                            are not content-addressed, or if the files
+     *                            can't be written.
+     */
+    void export_snapshot(path_type path, const module_cache_key& key);
+
+    /** @brief Serves the cache from a snapshot made by export_snapshot.
+     *
+     *  The snapshot replaces the long-term storage. Its files are mapped
+     *  into memory, not read, so this is fast regardless of the snapshot's
+     *  size. The files are never modified; results cached afterwards are only
+     *  kept in memory. The snapshot was made by another instance, so this also
+     *  turns on content-addressed keys (see set_content_addressed_keys). Like
+     *  change_save_location, this only affects module (and user) caches made
+     *  after the call.
+     *
+     *  @param[in] path The directory holding the snapshot.
+     *
+     *  @throw std::runtime_error if @p path does not hold a snapshot. Strong
+     *                            throw guarantee.
+     */
+    void open_snapshot(path_type path);
+
+    /** @brief Returns the (estimated) memory used by the cached values.
+     *
+     *  @return The number of bytes the cached inputs and results occupy.
+     *
+     *  @throw None No throw guarantee.
+     */
+    size_type memory_in_use() const noexcept;
+
+    /** @brief Returns the memory used by the results cached for one module.
+     *
+     *  This is ModuleCache::memory_footprint for the module cache associated
+     *  with @p key. Unlike get_or_make_module_cache, this function does not
+     *  create the module cache if it does not exist.
+     *
+     *  @param[in] key The identifier for the module implementation whose
+     *                 cache we are measuring.
+     *
+     *  @return The number of bytes the results cached for @p key occupy, or 0
+     *          if there is no module cache for @p key.
+     *
+     *  @throw None No throw guarantee.
      */
-    void change_save_location(path_type disk_location);
+    size_type memory_footprint(const module_cache_key& key) const noexcept;
 
     /** @brief Retrieves the module cache for @p key.
      *
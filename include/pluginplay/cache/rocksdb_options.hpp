@@ -0,0 +1,138 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <cstddef>
+
+namespace pluginplay::cache {
+
+/** @brief Tuning knobs for the RocksDB databases backing on-disk caches.
+ *
+ *  When a ModuleManagerCache saves to disk, the cached inputs/results are
+ *  stored in RocksDB databases. This struct collects the RocksDB settings
+ *  which matter most for large caches. Members which are zero (or
+ *  `Compression::rocksdb_default`) leave RocksDB's own default in place.
+ *
+ *  N.B. These options only have an effect if PluginPlay was built with RocksDB
+ *       support.
+ */
+struct RocksDBOptions {
+    /// Type used for sizes
+    using size_type = std::size_t;
+
+    /// The compression algorithms which can be used for the on-disk data
+    enum class Compression { rocksdb_default, none, snappy, lz4, zstd };
+
+    /** @brief Size of the cache of uncompressed blocks, in bytes.
+     *
+     *  A bigger block cache means fewer reads from disk for frequently used
+     *  entries. Zero uses RocksDB's default (8 MiB at the time of writing).
+     */
+    size_type block_cache_size = 0;
+
+    /** @brief Bits per key used by the bloom filters.
+     *
+     *  Bloom filters let RocksDB skip reading files which can not contain a
+     *  key, which greatly reduces the cost of looking up keys which are not
+     *  in the cache. Ten bits per key gives about a 1% false-positive rate.
+     *  Zero disables the filters.
+     */
+    int bloom_bits_per_key = 10;
+
+    /** @brief How the on-disk data is compressed.
+     *
+     *  LZ4 is fast, ZSTD compresses better. The algorithm must have been
+     *  enabled when RocksDB was built, otherwise opening the database fails.
+     */
+    Compression compression = Compression::rocksdb_default;
+
+    /** @brief Size of the in-memory write buffer (memtable), in bytes.
+     *
+     *  Larger buffers mean fewer, larger files are written. Zero uses
+     *  RocksDB's default (64 MiB at the time of writing).
+     */
+    size_type write_buffer_size = 0;
+
+    /** @brief Number of background threads for flushing and compaction.
+     *
+     *  Zero uses RocksDB's default.
+     */
+    int parallelism = 0;
+
+    /** @brief Should each write wait for the write-ahead log to be synced?
+     *
+     *  If true, each write (or committed batch of writes) is durable once it
+     *  returns. If false, the log is flushed asynchronously, which is much
+     *  faster, but the most recent writes may be lost if the machine crashes.
+     */
+    bool sync_writes = false;
+
+    /** @brief Values bigger than this many bytes are stored in chunks.
+     *
+     *  RocksDB can't store values bigger than 4 GB (and recommends keeping
+     *  them under 3 GB), so larger values are split into chunks of at most
+     *  this many bytes. Smaller chunks also lower the peak memory needed to
+     *  stream a value in or out. Zero uses 3 GB.
+     */
+    size_type chunk_size = 0;
+
+    /** @brief Can several processes use the database at the same time?
+     *
+     *  RocksDB only lets one process at a time write to a database. If this
+     *  is false (the default) the database is opened for exclusive use and
+     *  opening it from a second process fails. If it is true, the database's
+     *  path is a directory holding one database per writer: each process
+     *  writes to the first database no other process is writing to, and
+     *  opens the others as read-only secondaries. Lookups which miss in the
+     *  process's own database have the secondaries catch up with their
+     *  writers and look there too, so entries written by any process are
+     *  seen by all of them. This is meant for ensembles of jobs, or the ranks
+     *  of an MPI job, sharing a cache directory (on a filesystem supporting
+     *  POSIX file locks).
+     *
+     *  N.B. Shared and exclusive databases are laid out differently on disk,
+     *       so a given path should always be opened with the same setting.
+     */
+    bool shared = false;
+
+    /** @brief Minimum time, in milliseconds, between looks at the other
+     *         writers' databases.
+     *
+     *  Only used if `shared` is true. Looking for new writers and having the
+     *  secondaries catch up with their writers reads from disk, so a process
+     *  does it at most once per this many milliseconds (lookups which miss in
+     *  the meantime only consult what was already read). Hence an entry
+     *  written by another process may take this long to be seen. Zero looks
+     *  on every miss.
+     */
+    size_type peer_refresh_ms = 100;
+
+    /** @brief How many bytes of results may wait to be written to disk.
+     *
+     *  If zero (the default), results are serialized and written to the
+     *  database by the thread which stores them (e.g., when a module's result
+     *  is evicted from memory). Otherwise, they are queued in memory and
+     *  written by a background thread, so the disk's latency does not slow
+     *  down running modules. Queued results are found by lookups right away.
+     *  Storing a result blocks while the queued results occupy more than
+     *  this many bytes. Queued results are written by the time the cache is
+     *  backed up (e.g., ModuleManagerCache::backup) or destroyed.
+     */
+    size_type write_behind_limit = 0;
+};
+
+} // namespace pluginplay::cache
@@ -174,6 +174,14 @@ public:
      */
     void reset_cache() { m_cache_.clear(); }
 
+    /** @brief Copies the cached entries to long-term storage.
+     *
+     *  See ModuleCache::backup.
+     *
+     *  @throw ??? Throws if the backend throws. Same throw guarantee.
+     */
+    void backup() { m_cache_.backup(); }
+
 private:
     /// Type of the keys in the wrapped ModuleCache
     using input_map_type = typename sub_cache_type::key_type;
@@ -81,6 +81,24 @@ public:
      */
     ModuleInput();
 
+    /** @brief Makes a copy of @p rhs.
+     *
+     *  The copy shares @p rhs's state (notably the bound value) until either
+     *  instance is modified, at which point the modified instance makes its
+     *  own copy of the state. Copying is thus cheap, which matters because
+     *  the inputs are copied every time a module is run. The exception is if
+     *  @p rhs ever handed out a read/write reference to its value, since the
+     *  value could then be modified behind our back; in that case the state
+     *  is copied right away.
+     *
+     *  @param[in] rhs The instance to copy.
+     *
+     *  @throw std::bad_alloc if the state has to be copied and there is a
+     *                        problem allocating the copy. Strong throw
+     *                        guarantee.
+     *  @throw ??? if the state has to be copied and copying the value throws.
+     *             Same throw guarantee.
+     */
     ModuleInput(const ModuleInput& rhs);
 
     ModuleInput& operator=(const ModuleInput& rhs);
@@ -175,6 +193,37 @@ public:
      */
     bool is_transparent() const noexcept;
 
+    /** @brief Computes a hash of the input's value.
+     *
+     *  The hash only depends on the value bound to this input (customizable
+     *  via pluginplay::any::Hasher) and is consistent with operator==, i.e.,
+     *  equal inputs have equal hashes. In particular, the hash does not take
+     *  into account whether the input is transparent; use `hash_inputs` to
+     *  hash a set of inputs for memoization purposes.
+     *
+     *  @return A hash of the bound value, or 0 if no value is bound.
+     *
+     *  @throw none No throw guarantee.
+     */
+    std::size_t hash() const noexcept;
+
+    /** @brief Appends a stable byte representation of the bound value to
+     *         @p buffer.
+     *
+     *  Like `hash`, the bytes only depend on the bound value. Unlike `hash`,
+     *  they are the same in every process, which makes them suitable for
+     *  content-addressed cache keys. See AnyField::digest for details.
+     *
+     *  @param[in,out] buffer The buffer to append to.
+     *
+     *  @return True if the bound value was digested and false if no value is
+     *          bound or its type can not be digested.
+     *
+     *  @throw std::bad_alloc if there is a problem growing @p buffer. Weak
+     *                        throw guarantee.
+     */
+    bool digest(type::any::digest_buffer& buffer) const;
+
     /** @brief Checks if an input value is ready to be given to a module.
      *
      *  An input is "ready" if it is optional (in which case the user does not
@@ -306,8 +355,11 @@ public:
      *
      * @return The current ModuleInput instance modified so that it contains
      *         @p desc. The returned value is thus suitable for chaining.
+     *
+     * @throw ??? if the state is shared with a copy and copying it throws.
+     *            Strong throw guarantee.
      */
-    ModuleInput& set_description(type::description desc) noexcept;
+    ModuleInput& set_description(type::description desc);
 
     /** @brief Overload for adding a pre-defined bounds check to the input
      *
@@ -380,9 +432,10 @@ public:
      *
      * @return The current ModuleInput instance flagged as optional.
      *
-     * @throw none No throw guarantee.
+     * @throw ??? if the state is shared with a copy and copying it throws.
+     *            Strong throw guarantee.
      */
-    ModuleInput& make_optional() noexcept;
+    ModuleInput& make_optional();
 
     /** @brief Flags the current input field as optional.
      *
@@ -393,9 +446,10 @@ public:
      *
      * @return The current ModuleInput instance flagged as optional.
      *
-     * @throw none No throw guarantee.
+     * @throw ??? if the state is shared with a copy and copying it throws.
+     *            Strong throw guarantee.
      */
-    ModuleInput& make_required() noexcept;
+    ModuleInput& make_required();
 
     /** @brief Flags the current input field as opaque.
      *
@@ -406,9 +460,10 @@ public:
      *
      *  @return The current instance flagged as opaque.
      *
-     *  @throw None no throw guarantee.
+     *  @throw ??? if the state is shared with a copy and copying it throws.
+     *             Strong throw guarantee.
      */
-    ModuleInput& make_opaque() noexcept;
+    ModuleInput& make_opaque();
 
     /** @brief Flags the current input field as transparent.
      *
@@ -417,9 +472,10 @@ public:
      *
      *  @return The current instance flagged as transparent.
      *
-     *  @throw None no throw guarantee.
+     *  @throw ??? if the state is shared with a copy and copying it throws.
+     *             Strong throw guarantee.
      */
-    ModuleInput& make_transparent() noexcept;
+    ModuleInput& make_transparent();
 
     std::string str() const;
 
@@ -520,7 +576,7 @@ public:
     bool operator!=(const ModuleInput& rhs) const noexcept;
 
 private:
-    /// Retrieves the any from the PIMPL
+    /// Retrieves the any from the PIMPL, after which *this stops sharing it
     type::any& get_();
 
     /// Retrieves a read-only any from the PIMPL
@@ -538,6 +594,9 @@ private:
     /// Adds a bounds check to the PIMPL
     ModuleInput& add_check_(any_check check, type::description desc);
 
+    /// Makes sure *this is the only owner of the PIMPL, then returns it
+    detail_::ModuleInputPIMPL& mutable_pimpl_();
+
     /// Generates a check that a value is of type @p T.
     template<typename T>
     auto& add_type_check_();
@@ -552,10 +611,44 @@ private:
     /// Do we actually have a const reference (we may have had to take a copy)
     bool m_is_actually_cref_ = false;
 
-    /// The object that stores the state of the class.
-    std::unique_ptr<detail_::ModuleInputPIMPL> m_pimpl_;
+    /// May copies of *this share m_pimpl_? (false once a read/write
+    /// reference to the value was handed out)
+    bool m_shareable_ = true;
+
+    /// The object that stores the state of the class, shared by copies
+    std::shared_ptr<detail_::ModuleInputPIMPL> m_pimpl_;
 };
 
+/** @brief Computes a hash of a set of inputs for memoization purposes.
+ *
+ *  The hash combines the keys and the hashes of the values of every opaque
+ *  input in @p inputs. Transparent inputs, by definition, do not influence
+ *  memoization and are skipped. Keys are hashed case-insensitively to match
+ *  the comparison used by type::input_map. Hence two input maps which are
+ *  equal, or which only differ in their transparent inputs, have the same
+ *  hash.
+ *
+ *  @param[in] inputs The inputs to hash.
+ *
+ *  @return A hash of the opaque inputs in @p inputs.
+ *
+ *  @throw none No throw guarantee.
+ */
+std::size_t hash_inputs(const type::input_map& inputs) noexcept;
+
 } // namespace pluginplay
 
+namespace std {
+
+/// Allows ModuleInput instances to be used in hashed containers
+template<>
+struct hash<pluginplay::ModuleInput> {
+    std::size_t operator()(
+      const pluginplay::ModuleInput& input) const noexcept {
+        return input.hash();
+    }
+};
+
+} // namespace std
+
 #include "module_input.ipp"
@@ -134,11 +134,6 @@ inline bool ModuleInput::operator!=(const ModuleInput& rhs) const noexcept {
     return !((*this) == rhs);
 }
 
-inline type::any& ModuleInput::get_() {
-    const auto& temp = const_cast<const ModuleInput&>(*this).get_();
-    return const_cast<type::any&>(temp);
-}
-
 template<typename T>
 type::any ModuleInput::wrap_value_(T&& new_value) const {
     using clean_type = std::decay_t<T>;
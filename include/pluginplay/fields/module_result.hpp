@@ -63,6 +63,21 @@ public:
      */
     ModuleResult();
 
+    /** @brief Creates a ModuleResult instance holding @p value.
+     *
+     *  The type of the field is the type of the object wrapped by @p value.
+     *  This ctor is used to rebuild results from the values the cache stores
+     *  (the descriptions aren't stored, so the field has none).
+     *
+     *  @param[in] value The value to bind to the field.
+     *
+     *  @throw std::runtime_error if @p value is null or wraps no object.
+     *                            Strong throw guarantee.
+     *  @throw std::bad_alloc if there is insufficient memory to make the pimpl.
+     *                        Strong throw guarantee.
+     */
+    explicit ModuleResult(shared_any value);
+
     /** @brief Creates and empty ModuleResult instance.
      *
      *  A ModuleResult instance created with this ctor has no type, value, or
@@ -110,6 +125,46 @@ public:
      */
     bool has_value() const noexcept;
 
+    /** @brief How much memory does the bound value occupy?
+     *
+     *  This function is used to account for the memory the module caches use.
+     *  See AnyField::memory_footprint for how the footprint is computed.
+     *
+     *  @return The number of bytes the bound value occupies, or 0 if no value
+     *          is bound to this field.
+     *
+     *  @throw none No throw guarantee.
+     */
+    std::size_t memory_footprint() const noexcept;
+
+    /** @brief Appends a stable byte representation of the bound value to
+     *         @p buffer.
+     *
+     *  This function is used to make content-addressed cache keys. See
+     *  AnyField::digest for how the bytes are computed.
+     *
+     *  @param[in,out] buffer The buffer to append to.
+     *
+     *  @return True if the bound value was digested and false if no value is
+     *          bound or its type can not be digested.
+     *
+     *  @throw std::bad_alloc if there is a problem growing @p buffer. Weak
+     *                        throw guarantee.
+     */
+    bool digest(type::any::digest_buffer& buffer) const;
+
+    /** @brief Can the bound value be serialized?
+     *
+     *  This function is used to decide whether the module caches can move
+     *  the bound value to long-term storage. See AnyField::is_serializable.
+     *
+     *  @return True if a value is bound and it can be serialized, false
+     *          otherwise.
+     *
+     *  @throw none No throw guarantee.
+     */
+    bool is_serializable() const noexcept;
+
     /** @brief Does this result have a description?
      *
      *  This function is used to determine if the developer has provided a
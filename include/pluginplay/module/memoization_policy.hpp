@@ -0,0 +1,174 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <pluginplay/cache/module_cache.hpp>
+
+namespace pluginplay {
+
+/** @brief Decides whether memoizing a module pays off.
+ *
+ *  Memoization is not free: every run proxies the inputs and looks them up,
+ *  and every miss stores the results. For cheap modules this can cost more
+ *  than just running them. A module whose memoization is adaptive asks its
+ *  MemoizationPolicy before each run whether to go through the cache, and
+ *  reports each run back to it.
+ *
+ *  The policy works in windows of `options_type::window` runs. At the end of
+ *  a window where the module was memoized, the policy compares (using the
+ *  metrics of the module's cache) the compute time the hits saved with the
+ *  time spent on look ups plus a cost for the bytes that were stored. If the
+ *  hits did not pay for the look ups (in particular if there were no hits),
+ *  memoization is turned off. If the hits paid for the look ups, but not also
+ *  for writing the results to long-term storage (charged per byte stored),
+ *  the module keeps being memoized, but its results are only kept in memory
+ *  (see `persist`); they are written to long-term storage again once the hits
+ *  pay for that too. At the end of a window where the module was not
+ *  memoized, memoization is turned back on (in memory only) if the runs took
+ *  on average more than `options_type::regrowth` times the compute time
+ *  measured when it was turned off.
+ *
+ *  The policy is guarded by a mutex, so runs may report concurrently. The
+ *  metrics of a cache are shared by all modules memoizing into it (e.g.,
+ *  copies), so the decision accounts for all of them.
+ */
+class MemoizationPolicy {
+public:
+    /// Type used for counting
+    using size_type = std::size_t;
+
+    /// Type used for durations
+    using duration_type = std::chrono::nanoseconds;
+
+    /// Type of the cache whose metrics the decisions are based on
+    using cache_type = cache::ModuleCache;
+
+    /// Type of the metrics the decisions are based on
+    using metrics_type = typename cache_type::metrics_type;
+
+    /// Tunables of the policy
+    struct options_type {
+        /// Number of runs between decisions
+        size_type window = 16;
+
+        /// Factor the compute time must grow by to turn memoization back on
+        double regrowth = 2.0;
+
+        /// Cost, in nanoseconds, charged per byte of results stored
+        double ns_per_byte = 0.05;
+
+        /// Additional cost, in nanoseconds, charged per byte of results
+        /// written to long-term storage
+        double ns_per_persisted_byte = 1.0;
+    };
+
+    /// Makes a policy which starts out memoizing, with the default options
+    MemoizationPolicy() = default;
+
+    /// Makes a policy which starts out memoizing, with options @p options
+    explicit MemoizationPolicy(options_type options) noexcept :
+      m_options_(options) {}
+
+    /// Copies the state of @p other (the mutex is not copied)
+    MemoizationPolicy(const MemoizationPolicy& other);
+
+    /// Replaces the state of *this with a copy of the state of @p rhs
+    MemoizationPolicy& operator=(const MemoizationPolicy& rhs);
+
+    /// The options *this was made with
+    const options_type& options() const noexcept { return m_options_; }
+
+    /** @brief Should the next run go through the cache?
+     *
+     *  @return True if the next run should be memoized and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool memoize() const noexcept;
+
+    /** @brief Should results of the next run go to long-term storage?
+     *
+     *  Only meaningful if the next run is memoized. Results which are not
+     *  persisted are still cached in memory, but are never written to
+     *  long-term storage (and are dropped if they are evicted).
+     *
+     *  @return True if the next run is memoized and its results may be
+     *          written to long-term storage, and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool persist() const noexcept;
+
+    /** @brief Records a run which went through @p cache.
+     *
+     *  If this run ends a window, the metrics of @p cache are read and
+     *  memoization is turned off if it did not pay off during the window, or
+     *  persisting is turned on or off depending on whether it paid off.
+     *
+     *  @param[in] cache The cache the run went through.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void memoized(const cache_type& cache) noexcept;
+
+    /** @brief Records a run which bypassed @p cache.
+     *
+     *  If this run ends a window, memoization is turned back on if the runs
+     *  in the window took long enough (see the class description).
+     *
+     *  @param[in] cache The cache the run bypassed.
+     *  @param[in] compute How long the run took.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void bypassed(const cache_type& cache, duration_type compute) noexcept;
+
+private:
+    /// Type of a lock on m_mutex_
+    using lock_type = std::lock_guard<std::mutex>;
+
+    /// Guards the state
+    mutable std::mutex m_mutex_;
+
+    /// The tunables
+    options_type m_options_;
+
+    /// Are runs currently memoized?
+    bool m_memoize_ = true;
+
+    /// Are the results of memoized runs written to long-term storage?
+    bool m_persist_ = true;
+
+    /// Runs in the current window
+    size_type m_n_runs_ = 0;
+
+    /// Metrics of the cache when the current window started
+    metrics_type m_baseline_;
+
+    /// Was m_baseline_ read (it's read lazily by the first memoized run)
+    bool m_has_baseline_ = false;
+
+    /// Average compute time when memoization was turned off
+    duration_type m_off_compute_{0};
+
+    /// Total compute time of the bypassed runs in the current window
+    duration_type m_bypass_compute_{0};
+};
+
+} // namespace pluginplay
@@ -19,8 +19,10 @@
 #include <parallelzone/runtime/runtime_view.hpp>
 #include <pluginplay/cache/cache.hpp>
 #include <pluginplay/fields/fields.hpp>
+#include <pluginplay/module/module_tracer.hpp>
 #include <pluginplay/python/python_wrapper.hpp>
 #include <pluginplay/submodule_request.hpp>
+#include <pluginplay/utility/task_pool.hpp>
 #include <pluginplay/utility/uuid.hpp>
 #include <utilities/containers/case_insensitive_map.hpp>
 
@@ -75,6 +77,18 @@ public:
     /// A pointer to a runtime
     using runtime_ptr = std::shared_ptr<runtime_type>;
 
+    /// The type of the pool used to run tasks asynchronously
+    using task_pool_type = utility::TaskPool;
+
+    /// A pointer to a task pool
+    using task_pool_ptr = std::shared_ptr<task_pool_type>;
+
+    /// The type of the tracer runs are recorded with
+    using tracer_type = ModuleTracer;
+
+    /// A pointer to a tracer
+    using tracer_ptr = std::shared_ptr<tracer_type>;
+
     /// Deleted to avoid errors
     ModuleBase() = delete;
 
@@ -107,6 +121,10 @@ public:
      * attempted. Ultimately all calls to run a module funnel to this
      * function.
      *
+     * The inputs and submodules are taken by value, but copies of
+     * ModuleInput and SubmoduleRequest share their state until they are
+     * modified, so passing them does not copy the bound values.
+     *
      * @param[in] inputs The values the module should use as input.
      * @param[in] submods The submodules the module should use.
      *
@@ -300,6 +318,51 @@ public:
      */
     runtime_type& get_runtime() const;
 
+    /** @brief Sets the pool used to run the module's tasks asynchronously.
+     *
+     *  @param[in] pool A shared_ptr to the @p task_pool_type instance which
+     *                  asynchronous runs of the module should be submitted to.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void set_task_pool(task_pool_ptr pool) noexcept { m_task_pool_ = pool; }
+
+    /** @brief Does the module have a task pool?
+     *
+     *  @return True if a task pool has been set and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool has_task_pool() const noexcept {
+        return static_cast<bool>(m_task_pool_);
+    }
+
+    /** @brief Provides the pool used to run the module's tasks asynchronously.
+     *
+     *  @return The task pool with which the module is currently associated.
+     *
+     *  @throw std::runtime_error if there is no task pool. Strong throw
+     *                            guarantee.
+     */
+    task_pool_type& get_task_pool() const;
+
+    /** @brief Sets the tracer runs of the module are recorded with.
+     *
+     *  @param[in] tracer The tracer to record runs with. If null, runs are not
+     *                    traced.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void set_tracer(tracer_ptr tracer) noexcept { m_tracer_ = tracer; }
+
+    /** @brief Provides the tracer runs of the module are recorded with.
+     *
+     *  @return A pointer to the tracer, or null if runs are not traced.
+     *
+     *  @throw None No throw guarantee.
+     */
+    tracer_type* tracer() const noexcept { return m_tracer_.get(); }
+
     // Is this a Python module?
     bool is_python() const { return m_is_python_; }
 
@@ -567,6 +630,12 @@ private:
     /// Pointer to this modules current runtime
     runtime_ptr m_runtime_;
 
+    /// Pointer to the pool asynchronous runs are submitted to
+    task_pool_ptr m_task_pool_;
+
+    /// Pointer to the tracer runs are recorded with (null if not tracing)
+    tracer_ptr m_tracer_;
+
     /// Is this module implemented in Python?
     bool m_is_python_ = false;
 }; // class ModuleBase
@@ -647,6 +716,13 @@ inline typename ModuleBase::runtime_type& ModuleBase::get_runtime() const {
     return *m_runtime_.get();
 }
 
+inline typename ModuleBase::task_pool_type& ModuleBase::get_task_pool()
+  const {
+    if(!m_task_pool_)
+        throw std::runtime_error("Module does not have a task pool");
+    return *m_task_pool_.get();
+}
+
 inline void ModuleBase::reset_internal_cache() const {
     if(m_cache_) m_cache_->reset_cache();
 }
@@ -16,8 +16,13 @@
 
 #pragma once
 #include "pluginplay/types.hpp"
+#include <pluginplay/cache/module_cache.hpp>
 #include <pluginplay/fields/fields.hpp>
+#include <pluginplay/module/memoization_policy.hpp>
+#include <pluginplay/module/module_profile.hpp>
+#include <pluginplay/utility/task_pool.hpp>
 #include <pluginplay/utility/uuid.hpp>
+#include <tuple>
 #include <utilities/containers/case_insensitive_map.hpp>
 
 namespace pluginplay {
@@ -63,6 +68,13 @@ public:
     /// Type of a submodule to UUID map
     using submod_uuid_map = std::map<type::key, uuid_type>;
 
+    /// Type of the fingerprint of the submodule tree
+    using fingerprint_type = std::string;
+
+    /// Type of the object returned by run_as_async
+    template<typename T>
+    using future_type = utility::TaskFuture<T>;
+
     /** @brief Makes a module with no implementation.
      *
      *  The Module instance resulting from this ctor wraps no algorithm, has no
@@ -325,6 +337,21 @@ public:
      */
     void reset_cache();
 
+    /** @brief How the cache memoizing this module has been used.
+     *
+     *  The metrics count the cache hits and misses, the results inserted
+     *  (and their size), and the time spent looking results up. Comparing the
+     *  time saved by the hits with the time spent on look ups tells whether
+     *  memoizing this module pays off. The cache is shared by all instances of
+     *  this module (e.g., copies), so are the metrics.
+     *
+     *  @return The metrics of this module's cache. If the module does not have
+     *          a cache all of the metrics are zero.
+     *
+     *  @throw None No throw guarantee.
+     */
+    cache::ModuleCache::metrics_type cache_metrics() const noexcept;
+
     /** @brief Resets the implementation internal cache.
      *
      *  This function will reset cache.
@@ -360,6 +387,8 @@ public:
     void turn_off_memoization();
 
     /** @brief Turns on memoization for this module
+     *
+     *  This also turns off adaptive memoization (i.e., every run is memoized).
      *
      *  @warning If the module doesn't have a cache, results will not be cached
      *  even if this function is called and `is_memoizable` is true .
@@ -369,6 +398,36 @@ public:
      */
     void turn_on_memoization();
 
+    /** @brief Turns on memoization for this module, but only when it pays off.
+     *
+     *  Many cheap modules spend more time looking their inputs up in the cache
+     *  than computing their results. With adaptive memoization the module
+     *  measures the cost of its cache misses against the cost of the look ups
+     *  and of storing the results. Memoization is turned off when it's a net
+     *  loss and turned back on when the module becomes more expensive. When
+     *  the hits pay for the look ups, but not for writing the results to
+     *  long-term storage, results are only cached in memory. See
+     *  MemoizationPolicy for the details. Calling turn_on_memoization or
+     *  turn_off_memoization ends adaptive memoization.
+     *
+     *  @param[in] options The tunables of the policy. Defaults to the default
+     *                     options.
+     *
+     *  @throw std::runtime_error if the current module does not have an
+     *                            implementation. Strong throw guarantee.
+     */
+    void turn_on_adaptive_memoization(
+      MemoizationPolicy::options_type options = {});
+
+    /** @brief Is memoization of this module adaptive?
+     *
+     *  @return True if memoization was last turned on with
+     *          turn_on_adaptive_memoization and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_memoization_adaptive() const noexcept;
+
     /** @brief Locks the module and all submodules
      *
      *  A locked module can no longer have its inputs or submodules modified.
@@ -617,6 +676,36 @@ public:
     template<typename property_type, typename... Args>
     auto run_as(Args&&... args);
 
+    /** @brief Runs the module asynchronously.
+     *
+     *  This function is the asynchronous version of run_as. The run is
+     *  submitted to the task pool of the ModuleManager the module came from,
+     *  and this function returns immediately. Runs still go through the
+     *  module's cache, so if another run (asynchronous or not) computed a
+     *  result for the same inputs, the cached result is returned. If the
+     *  module does not have a task pool (e.g., it was not made by a
+     *  ModuleManager) the module is run before this function returns.
+     *
+     *  @tparam property_type The class codifying the property type that the
+     *                        module should be run as.
+     *  @tparam Args The types of the input arguments. Must be implicitly
+     *               convertible to the input types defined by the property
+     *               type.
+     *
+     *  @param[in] args The input values. Unlike run_as, @p args are copied (or
+     *                  moved) into the task, so they need not outlive this
+     *                  call. *this must outlive the returned future.
+     *
+     *  @return A future which will hold what run_as would have returned. If
+     *          the run throws, the exception is rethrown from the future's
+     *          `get` method.
+     *
+     *  @throw std::bad_alloc if there is a problem making the task. Strong
+     *                        throw guarantee.
+     */
+    template<typename property_type, typename... Args>
+    auto run_as_async(Args&&... args);
+
     /** @brief The advanced API for running the module.
      *
      *  This member allows you to set whatever inputs you would like and gives
@@ -662,8 +751,36 @@ public:
      */
     std::string profile_info() const;
 
+    /** @brief Returns the structured timing data for this module.
+     *
+     *  The profile aggregates all runs of this module (not just the most
+     *  recent one), e.g., how many runs were served from the cache and
+     *  percentiles of the wall times. Submodules have their own profiles.
+     *
+     *  @return A read-only reference to the profile of this module.
+     *
+     *  @throw None No throw guarantee.
+     */
+    const ModuleProfile& profile() const noexcept;
+
     submod_uuid_map submod_uuids() const;
 
+    /** @brief Returns a hash identifying this module's submodule tree.
+     *
+     *  Modules whose submodules (and their submodules, etc.) have the same
+     *  keys and UUIDs have the same fingerprint. The fingerprint is a
+     *  formatted UUID, so its size doesn't depend on the tree. Memoization
+     *  uses the fingerprint to tell runs with different submodules apart. It
+     *  is computed when the module is locked and reused until a submodule is
+     *  changed.
+     *
+     *  @return The fingerprint, or an empty string if *this has no PIMPL.
+     *
+     *  @throw std::runtime_error if a submodule is not ready. Strong throw
+     *                            guarantee.
+     */
+    fingerprint_type submod_fingerprint() const;
+
     uuid_type uuid() const;
 
     /** @brief Compares two Module instances for equality
@@ -720,6 +837,13 @@ private:
     /// Hides the check of the property type
     void check_property_type_(type::rtti prop_type);
 
+    /// Returns the task pool to use for asynchronous runs (may be null)
+    utility::TaskPool* task_pool_() const noexcept;
+
+    /// Implements run, @p prop_type is the property type run_as was called
+    /// with (null if called through run)
+    type::result_map run_(type::input_map ps, const type::rtti* prop_type);
+
     /// The instance that actually does everything for us.
     pimpl_ptr m_pimpl_;
 
@@ -762,15 +886,16 @@ void Module::add_property_type() {
 
 template<typename property_type, typename... Args>
 auto Module::run_as(Args&&... args) {
-    check_property_type_(type::rtti{typeid(property_type)});
+    const type::rtti prop_type{typeid(property_type)};
+    check_property_type_(prop_type);
     auto temp = inputs();
     temp      = property_type::wrap_inputs(temp, std::forward<Args>(args)...);
     using r_type  = decltype(property_type::unwrap_results(run(temp)));
     using clean_t = std::decay_t<r_type>;
     if constexpr(std::is_same_v<clean_t, void>) {
-        property_type::unwrap_results(run(temp));
+        property_type::unwrap_results(run_(temp, &prop_type));
     } else {
-        auto rv = property_type::unwrap_results(run(temp));
+        auto rv = property_type::unwrap_results(run_(temp, &prop_type));
 
         if constexpr(std::tuple_size_v<clean_t> == 1) {
             return std::get<0>(rv);
@@ -780,6 +905,18 @@ auto Module::run_as(Args&&... args) {
     }
 }
 
+template<typename property_type, typename... Args>
+auto Module::run_as_async(Args&&... args) {
+    auto fxn = [this, args = std::make_tuple(std::forward<Args>(args)...)]() {
+        auto run = [this](const auto&... xs) {
+            return this->template run_as<property_type>(xs...);
+        };
+        return std::apply(run, args);
+    };
+    if(auto* pool = task_pool_()) return pool->async(std::move(fxn));
+    return utility::run_inline(std::move(fxn));
+}
+
 inline void Module::assert_not_locked_() {
     if(locked()) throw std::runtime_error("Locked modules can not be modified");
 }
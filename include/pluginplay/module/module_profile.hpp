@@ -0,0 +1,215 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <pluginplay/utility/latency_histogram.hpp>
+#include <string>
+#include <vector>
+
+namespace pluginplay {
+
+/** @brief Aggregated timing data for the runs of a module.
+ *
+ *  Every time a module is run, it records the run in its ModuleProfile. The
+ *  profile keeps:
+ *
+ *  - counters (the number of runs, and how many of them were served from, or
+ *    missed, the cache),
+ *  - the total, minimum, and maximum wall time of the runs,
+ *  - a histogram of the wall times, which is used to estimate percentiles,
+ *  - the most recent runs (up to `max_recent_calls()` of them).
+ *
+ *  Recording a run only reads the clocks and updates the above under a mutex;
+ *  in particular time stamps are not formatted until the profile is
+ *  exported (see write_profiles).
+ *
+ *  The histogram is a utility::LatencyHistogram, so the percentiles are
+ *  accurate to within about 20%.
+ */
+class ModuleProfile {
+public:
+    /// Type used for counting
+    using size_type = std::size_t;
+
+    /// Clock used to time the runs
+    using clock_type = std::chrono::steady_clock;
+
+    /// Type used for durations
+    using duration_type = std::chrono::nanoseconds;
+
+    /// Type of the (wall clock) time a run started at
+    using time_point_type = std::chrono::system_clock::time_point;
+
+    /// How a run was satisfied
+    enum class outcome_type { not_memoized, cache_hit, cache_miss };
+
+    /// A single run
+    struct call_type {
+        /// When the run started
+        time_point_type m_start;
+
+        /// How long the run took
+        duration_type m_duration;
+
+        /// How the run was satisfied
+        outcome_type m_outcome;
+
+        /// Hash of the ID of the thread which ran the module
+        size_type m_thread;
+    };
+
+    /// A snapshot of the aggregated data
+    struct stats_type {
+        /// Number of runs
+        size_type n_calls = 0;
+
+        /// Number of runs whose results were found in the cache
+        size_type n_hits = 0;
+
+        /// Number of runs whose results were computed and then cached
+        size_type n_misses = 0;
+
+        /// Sum of the wall times of the runs
+        duration_type total{0};
+
+        /// Shortest wall time (zero if there were no runs)
+        duration_type min{0};
+
+        /// Longest wall time
+        duration_type max{0};
+
+        /// Estimated median wall time
+        duration_type p50{0};
+
+        /// Estimated 90th percentile of the wall times
+        duration_type p90{0};
+
+        /// Estimated 99th percentile of the wall times
+        duration_type p99{0};
+
+        /// When the first run started (only meaningful if n_calls > 0)
+        time_point_type first_call;
+
+        /// When the most recent run started
+        time_point_type last_call;
+
+        /// How long the most recent run took
+        duration_type last_duration{0};
+    };
+
+    /// The formats profiles can be exported in
+    enum class format_type { json, chrome_trace };
+
+    /// Makes an empty profile
+    ModuleProfile() = default;
+
+    /// Copies the data of @p other (the mutex is not copied)
+    ModuleProfile(const ModuleProfile& other);
+
+    /// Replaces the data of *this with a copy of the data of @p rhs
+    ModuleProfile& operator=(const ModuleProfile& rhs);
+
+    /// The number of recent runs which are kept
+    static constexpr size_type max_recent_calls() noexcept { return 256; }
+
+    /** @brief Records a run.
+     *
+     *  @param[in] start When the run started.
+     *  @param[in] duration How long the run took.
+     *  @param[in] outcome How the run was satisfied.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void record(time_point_type start, duration_type duration,
+                outcome_type outcome) noexcept;
+
+    /** @brief Returns a snapshot of the aggregated data.
+     *
+     *  @throw None No throw guarantee.
+     */
+    stats_type stats() const noexcept;
+
+    /** @brief Estimates a percentile of the wall times.
+     *
+     *  @param[in] p The percentile, in the range [0, 100].
+     *
+     *  @return The estimated percentile, or zero if there were no runs.
+     *
+     *  @throw None No throw guarantee.
+     */
+    duration_type percentile(double p) const noexcept;
+
+    /** @brief Returns the most recent runs, oldest first.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the return.
+     *                        Strong throw guarantee.
+     */
+    std::vector<call_type> recent_calls() const;
+
+    /// Discards all recorded data
+    void reset() noexcept;
+
+private:
+    /// Type of a lock on m_mutex_
+    using lock_type = std::lock_guard<std::mutex>;
+
+    /// Implements percentile (caller must hold m_mutex_)
+    duration_type percentile_(double p) const noexcept;
+
+    /// Guards the data
+    mutable std::mutex m_mutex_;
+
+    /// The aggregated data, except the percentiles
+    stats_type m_stats_;
+
+    /// Histogram of the wall times
+    utility::LatencyHistogram m_histogram_;
+
+    /// Ring buffer of the most recent runs
+    std::vector<call_type> m_recent_;
+
+    /// Where the next run goes in m_recent_, once it is full
+    size_type m_next_ = 0;
+};
+
+/** @brief Exports the profiles of several modules.
+ *
+ *  In JSON format the output is an object whose keys are the module names,
+ *  each mapped to an object holding the module's stats (times are in
+ *  milliseconds and time stamps are ISO 8601, UTC). In Chrome trace format
+ *  the output is a trace with one complete ("X") event per recent run, which
+ *  can be loaded into `chrome://tracing` or Perfetto.
+ *
+ *  @param[in] os The stream to write to.
+ *  @param[in] profiles The profiles to write, keyed by module name.
+ *  @param[in] format Which format to write.
+ *
+ *  @return @p os, after writing to it.
+ *
+ *  @throw std::bad_alloc if there is a problem allocating memory. Weak throw
+ *                        guarantee.
+ */
+std::ostream& write_profiles(
+  std::ostream& os, const std::map<std::string, const ModuleProfile*>& profiles,
+  ModuleProfile::format_type format = ModuleProfile::format_type::json);
+
+} // namespace pluginplay
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <pluginplay/module/module_profile.hpp>
+#include <pluginplay/types.hpp>
+#include <vector>
+
+namespace pluginplay {
+
+/** @brief Records the begin and end of every module run on a timeline.
+ *
+ *  Where a ModuleProfile aggregates the runs of a single module, a
+ *  ModuleTracer records an event when each run begins and when it ends, for
+ *  all of the modules it is given to. Since a module's submodules run
+ *  between the begin and end events of the module, the events form the call
+ *  tree of the workflow. The events can be written in the Chrome Trace Event
+ *  format, which chrome://tracing and Perfetto (ui.perfetto.dev) can open.
+ *
+ *  Tracing is opt-in (see ModuleManager::enable_tracing). Modules which have
+ *  not been given a tracer pay a single branch per run. Recording an event
+ *  reads the clock, copies the module's key, and appends the event under a
+ *  mutex; the names of the property types are only worked out when the trace
+ *  is written.
+ */
+class ModuleTracer {
+public:
+    /// Type used for counting
+    using size_type = std::size_t;
+
+    /// Clock the events are timed with
+    using clock_type = std::chrono::steady_clock;
+
+    /// How a run was satisfied
+    using outcome_type = ModuleProfile::outcome_type;
+
+    /// The kinds of events
+    enum class phase_type { begin, end };
+
+    /// A single event
+    struct event_type {
+        /// Whether the event is the begin or the end of the run
+        phase_type m_phase;
+
+        /// The key of the module (empty if the module has no name)
+        type::key m_name;
+
+        /// The property type the module was run as, if known
+        std::optional<type::rtti> m_property_type;
+
+        /// When the event happened
+        clock_type::time_point m_time;
+
+        /// Hash of the ID of the thread which ran the module
+        size_type m_thread;
+
+        /// For end events of runs which returned, how the run was satisfied
+        std::optional<outcome_type> m_outcome;
+    };
+
+    /// Makes a tracer with no events, the trace starts now
+    ModuleTracer();
+
+    /** @brief Records the beginning of a run.
+     *
+     *  @param[in] name The key of the module, or null if it has none.
+     *  @param[in] property_type The property type the module is run as, or
+     *                           null if it is not known.
+     *
+     *  @throw std::bad_alloc if there is a problem recording the event. Strong
+     *                        throw guarantee.
+     */
+    void begin(const type::key* name, const type::rtti* property_type);
+
+    /** @brief Records the end of a run.
+     *
+     *  @param[in] name The key of the module, or null if it has none.
+     *  @param[in] property_type The property type the module is run as, or
+     *                           null if it is not known.
+     *  @param[in] outcome How the run was satisfied, or nullopt if the run
+     *                     threw.
+     *
+     *  @throw std::bad_alloc if there is a problem recording the event. Strong
+     *                        throw guarantee.
+     */
+    void end(const type::key* name, const type::rtti* property_type,
+             std::optional<outcome_type> outcome);
+
+    /// The number of events recorded so far
+    size_type size() const noexcept;
+
+    /** @brief Returns a copy of the events, in the order they were recorded.
+     *
+     *  @throw std::bad_alloc if there is a problem copying the events. Strong
+     *                        throw guarantee.
+     */
+    std::vector<event_type> events() const;
+
+    /// Discards the events recorded so far
+    void clear() noexcept;
+
+    /** @brief Writes the events in the Chrome Trace Event format.
+     *
+     *  Time stamps are in microseconds since *this was made. Threads are
+     *  numbered in the order they first appear in the trace.
+     *
+     *  @param[in] os The stream to write the trace to.
+     *
+     *  @return @p os, after the trace has been written to it.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating memory. Weak
+     *                        throw guarantee (@p os may be partially written).
+     */
+    std::ostream& write(std::ostream& os) const;
+
+private:
+    /// Type of a lock on m_mutex_
+    using lock_type = std::lock_guard<std::mutex>;
+
+    /// Code factorization for begin and end
+    void record_(phase_type phase, const type::key* name,
+                 const type::rtti* property_type,
+                 std::optional<outcome_type> outcome);
+
+    /// When the trace started
+    clock_type::time_point m_start_;
+
+    /// Guards m_events_
+    mutable std::mutex m_mutex_;
+
+    /// The recorded events
+    std::vector<event_type> m_events_;
+};
+
+} // namespace pluginplay
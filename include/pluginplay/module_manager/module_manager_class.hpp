@@ -16,6 +16,7 @@
 
 #pragma once
 #include <memory>
+#include <ostream>
 #include <parallelzone/runtime/runtime_view.hpp>
 #include <pluginplay/cache/module_manager_cache.hpp>
 #include <pluginplay/module/module_base.hpp>
@@ -30,6 +31,12 @@ struct ModuleManagerPIMPL;
 
 /** @brief Class responsible for holding and managing modules.
  *
+ *  The cache given to the ModuleManager can be shared by the ranks of a
+ *  runtime (see ModuleManagerCache::set_distributed). Each rank then answers
+ *  the other ranks' cache requests from a separate thread, so if the runtime
+ *  has more than one rank, the program must initialize MPI with
+ *  MPI_THREAD_MULTIPLE (i.e., call MPI_Init_thread) before it makes the
+ *  runtime. Otherwise set_distributed throws.
  */
 class ModuleManager {
 public:
@@ -57,13 +64,26 @@ public:
     /// Type of a pointer to the cache
     using cache_pointer = std::shared_ptr<cache_type>;
 
+    /// Type of the pool used to run modules asynchronously
+    using task_pool_type = utility::TaskPool;
+
+    /// Type of a pointer to the task pool
+    using task_pool_pointer = std::shared_ptr<task_pool_type>;
+
+    /// Type of the formats profiles can be written in
+    using format_type = ModuleProfile::format_type;
+
+    /// Type of the metrics describing how a module's cache is used
+    using cache_metrics_type = cache::ModuleCache::metrics_type;
+
     ///@{
     /** @name Ctors and assignment operators
      *
      */
     ModuleManager();
-    ModuleManager(runtime_ptr runtime,
-                  cache_pointer cache = std::make_shared<cache_type>());
+    ModuleManager(
+      runtime_ptr runtime, cache_pointer cache = std::make_shared<cache_type>(),
+      task_pool_pointer task_pool = std::make_shared<task_pool_type>());
     // ModuleManager(const ModuleManager& rhs);
     // ModuleManager& operator=(const ModuleManager& rhs) {
     //     return *this = std::move(ModuleManager(rhs));
@@ -242,6 +262,18 @@ public:
      */
     runtime_type& get_runtime() const noexcept;
 
+    /** @brief Provides the pool modules submit asynchronous runs to.
+     *
+     *  Modules added to *this submit the tasks made by `run_as_async` to this
+     *  pool. The pool's threads are only started once the first task is
+     *  submitted.
+     *
+     *  @return The task pool owned by *this.
+     *
+     *  @throw None No throw guarantee.
+     */
+    task_pool_type& get_task_pool() const noexcept;
+
     /** @brief Returns the keys of all the modules in the module manager.
      *
      * @return A vector of keys for all the modules in the module manager.
@@ -260,6 +292,88 @@ public:
      */
     bool has_cache() const noexcept;
 
+    /** @brief How the cache memoizing a module has been used.
+     *
+     *  See Module::cache_metrics for the details.
+     *
+     *  @param[in] module_key The key of the module.
+     *
+     *  @return The metrics of the module's cache (all zero if the module does
+     *          not have a cache).
+     *
+     *  @throw std::out_of_range if there is no module with key @p module_key.
+     *                           Strong throw guarantee.
+     */
+    cache_metrics_type cache_metrics(const type::key& module_key) const;
+
+    /** @brief Writes the profiles of the modules in *this to @p os.
+     *
+     *  The JSON format maps each module key to the aggregated data of its
+     *  profile (call counts, cache hits and misses, and wall time statistics
+     *  in milliseconds). The Chrome trace format contains the recent runs of
+     *  each module and can be loaded by chrome://tracing or Perfetto.
+     *
+     *  @param[in] os The stream to write the profiles to.
+     *  @param[in] format The format to write the profiles in. Defaults to
+     *                    JSON.
+     *
+     *  @return @p os, after the profiles have been written to it.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating memory. Weak
+     *                        throw guarantee (@p os may be partially written).
+     */
+    std::ostream& write_profile(std::ostream& os,
+                                format_type format = format_type::json) const;
+
+    /** @brief Starts recording the runs of the modules in *this.
+     *
+     *  Each run of a module in *this (including modules added later, and runs
+     *  as submodules) records a begin and an end event, carrying the module's
+     *  key, the property type it was run as, the thread it ran on, and whether
+     *  it was a cache hit. Calling this function discards the previous trace.
+     *
+     *  Tracing is off by default; when it is off, the only cost to a run is a
+     *  single branch. Tracing should not be enabled or disabled while modules
+     *  are running.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the tracer.
+     *                        Strong throw guarantee.
+     */
+    void enable_tracing();
+
+    /** @brief Stops recording the runs of the modules in *this.
+     *
+     *  The events recorded so far are kept and can still be written with
+     *  write_trace.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void disable_tracing() noexcept;
+
+    /** @brief Are the runs of the modules in *this being recorded?
+     *
+     *  @return True if enable_tracing was called after the last call to
+     *          disable_tracing and false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_tracing() const noexcept;
+
+    /** @brief Writes the recorded runs in the Chrome Trace Event format.
+     *
+     *  The result is a JSON document which chrome://tracing and Perfetto can
+     *  open. Nested runs (e.g., submodules) show up as nested slices.
+     *
+     *  @param[in] os The stream to write the trace to.
+     *
+     *  @return @p os, after the trace has been written to it. If tracing was
+     *          never enabled the trace has no events.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating memory. Weak
+     *                        throw guarantee (@p os may be partially written).
+     */
+    std::ostream& write_trace(std::ostream& os) const;
+
 private:
     /** @brief Does *this have a PIMPL?
      *
@@ -65,30 +65,31 @@ public:
      */
     SubmoduleRequest();
 
-    /** @brief Sets the current request's state to a deep copy of @p rhs
+    /** @brief Sets the current request's state to a copy of @p rhs
      *
-     *  This funciton will make a deep copy of another SubmoduleRequest's
-     *  state. This includes any bound module, if it exists.
+     *  The copy shares @p rhs's state until either instance's type,
+     *  description, or module is changed, at which point the changed instance
+     *  makes its own copy of the state. Like before, the bound module itself
+     *  is shared by the copies. Copying is thus cheap, which matters because
+     *  the submodules are copied every time a module is run.
      *
      *  @param[in] rhs The instance's state to copy.
      *
-     *  @throw std::bad_alloc if there is insufficient memory for the copy.
-     *                        Strong throw guarantee.
+     *  @throw None No throw guarantee.
      */
     SubmoduleRequest(const SubmoduleRequest& rhs);
 
-    /** @brief Sets the current request's state to a deep copy of @p rhs
+    /** @brief Sets the current request's state to a copy of @p rhs
      *
-     *  This function will overwrite the current instance's state with a deep
-     *  copy of another SubmoduleRequest's state. This includes any bound
-     *  module, if it exists.
+     *  This function will overwrite the current instance's state with a copy
+     *  of another SubmoduleRequest's state (see the copy ctor for how the
+     *  state is shared).
      *
      *  @param[in] rhs The instance's state to copy.
      *
-     *  @return The current instance containing a deep copy of @p rhs's state.
+     *  @return The current instance containing a copy of @p rhs's state.
      *
-     *  @throw std::bad_alloc if there is insufficient memory for the copy.
-     *                        Strong throw guarantee.
+     *  @throw None No throw guarantee.
      */
     SubmoduleRequest& operator=(const SubmoduleRequest& rhs);
 
@@ -293,9 +294,10 @@ public:
      *
      *  @return The current instance with the description set to @p desc
      *
-     *  @throw none No throw guarantee.
+     *  @throw ??? if the state is shared with a copy and copying it throws.
+     *             Strong throw guarantee.
      */
-    SubmoduleRequest& set_description(type::description desc) noexcept;
+    SubmoduleRequest& set_description(type::description desc);
 
     /** @brief Get the RTTI of the property type this submodule must satisfy
      *
@@ -433,6 +435,40 @@ public:
     template<typename property_type, typename... Args>
     auto run_as(Args&&... args);
 
+    /** @brief Runs the submodule asynchronously
+     *
+     * This function is the asynchronous version of run_as. It is semantically
+     * the same as calling:
+     *
+     * ```
+     * this->value().run_as_async<T>(args...);
+     * ```
+     *
+     * aside from the fact that it also asserts that the submodule is being run
+     * as the correct property type. Independent submodule calls can be
+     * overlapped by calling run_as_async for each of them and then calling
+     * `get` on the returned futures. See Module::run_as_async for details.
+     *
+     * @tparam property_type The class defining the property type that the
+     *         submodule should be run as.
+     * @tparam Args The types of the arguments to the property type
+     *
+     * @param[in] args The values for the arguments. They are copied (or moved)
+     *                 into the task.
+     *
+     * @return A future which will hold whatever the property type returns.
+     *
+     * @throw std::bad_optional_access if the type has not been set yet. Strong
+     *                                 throw guarantee.
+     * @throw std::invalid_argument if the submodule is being run as a property
+     *                             type other than the one it should be. Strong
+     *                             throw guarantee.
+     * @throw std::runtime_error if the submodule has not been set yet. Strong
+     *                             throw guarantee.
+     */
+    template<typename property_type, typename... Args>
+    auto run_as_async(Args&&... args);
+
     /** @brief Compares two SubmoduleRequest instances for equality
      *
      * Two SubmoduleRequest instances are equivalent if they both:
@@ -467,8 +503,11 @@ public:
     bool operator!=(const SubmoduleRequest& rhs) const;
 
 private:
-    /// Object actually storing the state of this class
-    std::unique_ptr<detail_::SubmoduleRequestPIMPL> m_pimpl_;
+    /// Makes sure *this is the only owner of the PIMPL, then returns it
+    detail_::SubmoduleRequestPIMPL& mutable_pimpl_();
+
+    /// Object actually storing the state of this class, shared by copies
+    std::shared_ptr<detail_::SubmoduleRequestPIMPL> m_pimpl_;
 };
 
 //----------------------Implementations-----------------------------------------
@@ -500,6 +539,13 @@ auto SubmoduleRequest::run_as(Args&&... args) {
     return value().run_as<property_type>(std::forward<Args>(args)...);
 }
 
+template<typename property_type, typename... Args>
+auto SubmoduleRequest::run_as_async(Args&&... args) {
+    if(type() != rtti_type(typeid(property_type)))
+        throw std::invalid_argument("Wrong property type");
+    return value().run_as_async<property_type>(std::forward<Args>(args)...);
+}
+
 inline bool SubmoduleRequest::operator!=(const SubmoduleRequest& rhs) const {
     return !((*this) == rhs);
 }
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace pluginplay::utility {
+
+/** @brief A histogram of latencies, used to estimate their percentiles.
+ *
+ *  Latencies under 4 ns get a bucket each. Past that there are four buckets
+ *  per power of two nanoseconds: the leading bit of the latency picks the
+ *  power, and the next two bits pick the bucket. Buckets are thus at most
+ *  25% wide, and the estimated percentiles are accurate to within about 20%.
+ *
+ *  Every PluginPlay report of latency percentiles (e.g., ModuleProfile and
+ *  the metrics of the ModuleCache) goes through this class, so they agree
+ *  on the same data.
+ */
+struct LatencyHistogram {
+    /// Type used for counting
+    using size_type = std::size_t;
+
+    /// Type of the latencies
+    using duration_type = std::chrono::nanoseconds;
+
+    /// The number of buckets
+    static constexpr size_type n_buckets = 256;
+
+    /// How many latencies landed in each bucket
+    std::array<size_type, n_buckets> counts{};
+
+    /** @brief The bucket @p latency lands in.
+     *
+     *  @param[in] latency The latency to bucket. Negative latencies land in
+     *                     bucket 0.
+     *
+     *  @throw None No throw guarantee.
+     */
+    static size_type bucket(duration_type latency) noexcept;
+
+    /** @brief The shortest latency which lands in @p bucket.
+     *
+     *  @param[in] bucket The bucket of interest.
+     *
+     *  @return The lower edge of @p bucket, or duration_type::max() for the
+     *          buckets no latency can reach.
+     *
+     *  @throw None No throw guarantee.
+     */
+    static duration_type lower_bound(size_type bucket) noexcept;
+
+    /// Adds @p latency to the histogram
+    void add(duration_type latency) noexcept { ++counts[bucket(latency)]; }
+
+    /// The total number of latencies in the histogram
+    size_type count() const noexcept;
+
+    /** @brief Estimates the @p p-th percentile of the latencies.
+     *
+     *  @param[in] p The percentile, in the range [0, 100].
+     *
+     *  @return The middle of the bucket the percentile lands in, or zero if
+     *          the histogram is empty.
+     *
+     *  @throw None No throw guarantee.
+     */
+    duration_type percentile(double p) const noexcept;
+
+    /// Empties the histogram
+    void reset() noexcept { counts.fill(0); }
+};
+
+} // namespace pluginplay::utility
@@ -0,0 +1,297 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <pluginplay/utility/wait_edge.hpp>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace pluginplay::utility {
+namespace detail_ {
+class TaskPoolPIMPL;
+}
+
+class TaskPool;
+
+/** @brief Handle to the result of a task submitted to a TaskPool.
+ *
+ *  TaskFuture is a thin wrapper around `std::future`. The difference is that
+ *  while a TaskFuture waits for its result, the waiting thread runs tasks
+ *  which are queued in the TaskPool. This means that tasks may themselves
+ *  submit tasks and wait on them (e.g., a module asynchronously running
+ *  submodules, which asynchronously run their submodules) without
+ *  deadlocking the pool, even if every worker is waiting. While it is
+ *  blocked, the waiting thread records a WaitEdge to the thread running the
+ *  task, so that other threads can tell if waiting on it would deadlock.
+ *
+ *  @tparam T The type of the result.
+ */
+template<typename T>
+class TaskFuture {
+public:
+    /// Type of the result
+    using value_type = T;
+
+    /// Type of the wrapped future
+    using future_type = std::future<T>;
+
+    /// Type of the (shared) id of the thread running the task
+    using runner_pointer = std::shared_ptr<const std::atomic<std::thread::id>>;
+
+    /** @brief Wraps @p future.
+     *
+     *  @param[in] future The future holding the result of the task.
+     *  @param[in] pool The pool the task was submitted to. If null, waiting
+     *                  simply blocks. The pool must outlive *this.
+     *  @param[in] runner Where the task stores the id of the thread running
+     *                    it, once it starts. May be null, e.g., if the task
+     *                    already ran.
+     *
+     *  @throw None No throw guarantee.
+     */
+    TaskFuture(future_type future, TaskPool* pool = nullptr,
+               runner_pointer runner = nullptr) noexcept :
+      m_future_(std::move(future)),
+      m_pool_(pool),
+      m_runner_(std::move(runner)) {}
+
+    /** @brief Does *this refer to a result?
+     *
+     *  @return False if *this was moved from or if `get` was called, and true
+     *          otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool valid() const noexcept { return m_future_.valid(); }
+
+    /** @brief Has the task finished?
+     *
+     *  @return True if the result (or exception) is available and false
+     *          otherwise.
+     *
+     *  @throw std::future_error if *this is not valid. Strong throw guarantee.
+     */
+    bool ready() const;
+
+    /** @brief Waits for the task to finish.
+     *
+     *  While waiting, the calling thread runs tasks queued in the pool.
+     *
+     *  @throw std::future_error if *this is not valid. Strong throw guarantee.
+     *  @throw std::bad_alloc if there is a problem recording the WaitEdge.
+     *                        Strong throw guarantee.
+     */
+    void wait();
+
+    /** @brief Waits for, and then returns, the result of the task.
+     *
+     *  @return The result of the task.
+     *
+     *  @throw ??? Rethrows the exception thrown by the task, if it threw.
+     *  @throw std::future_error if *this is not valid. Strong throw guarantee.
+     */
+    T get() {
+        wait();
+        return m_future_.get();
+    }
+
+private:
+    /// The future we are wrapping
+    future_type m_future_;
+
+    /// The pool to run tasks from while waiting (may be null)
+    TaskPool* m_pool_;
+
+    /// The thread running the task (may be null)
+    runner_pointer m_runner_;
+};
+
+/** @brief A pool of threads for running tasks asynchronously.
+ *
+ *  Each worker has its own queue of tasks. Tasks submitted from a worker are
+ *  added to that worker's queue, and the worker runs its own tasks in
+ *  last-in-first-out order (so a task's children run while their data is
+ *  still in cache). Idle workers steal the oldest tasks from other workers'
+ *  queues. Tasks submitted from outside the pool are distributed round-robin
+ *  over the queues.
+ *
+ *  The workers are only started when the first task is submitted, so making
+ *  a TaskPool which is never used is cheap.
+ */
+class TaskPool {
+public:
+    /// Type used for counting workers
+    using size_type = std::size_t;
+
+    /// Type of a task, as stored in the queues
+    using task_type = std::function<void()>;
+
+    /// Type returned by async for a task returning a @p T
+    template<typename T>
+    using future_type = TaskFuture<T>;
+
+    /** @brief The number of workers a default constructed pool has.
+     *
+     *  @return The number of hardware threads, or 1 if that can't be
+     *          determined.
+     *
+     *  @throw None No throw guarantee.
+     */
+    static size_type default_size() noexcept;
+
+    /** @brief Makes a pool with @p n_workers workers.
+     *
+     *  @param[in] n_workers The number of threads in the pool. If 0, tasks are
+     *                       only run by threads waiting on a TaskFuture.
+     *                       Defaults to default_size().
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the queues.
+     *                        Strong throw guarantee.
+     */
+    explicit TaskPool(size_type n_workers = default_size());
+
+    /// Deleted because threads can not be copied
+    TaskPool(const TaskPool&) = delete;
+
+    /// Deleted because threads can not be copied
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    /** @brief Finishes all queued tasks and then stops the workers.
+     *
+     *  @throw None No throw guarantee.
+     */
+    ~TaskPool() noexcept;
+
+    /** @brief The number of worker threads.
+     *
+     *  @return The number of worker threads *this will use.
+     *
+     *  @throw None No throw guarantee.
+     */
+    size_type size() const noexcept;
+
+    /** @brief Runs @p fxn asynchronously.
+     *
+     *  @tparam FxnType The type of the functor. Must be callable with no
+     *                  arguments.
+     *
+     *  @param[in] fxn The functor to run. @p fxn is moved (or copied) into the
+     *                 task, so anything it captures by reference must live
+     *                 until the task finishes.
+     *
+     *  @return A TaskFuture which will hold the result of calling @p fxn (or
+     *          the exception it threw).
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the task. Strong
+     *                        throw guarantee.
+     *  @throw std::system_error if the workers need to be started and a
+     *                           thread can not be made. Strong throw
+     *                           guarantee.
+     */
+    template<typename FxnType>
+    auto async(FxnType&& fxn);
+
+    /** @brief Runs one queued task on the calling thread.
+     *
+     *  This is how waiting threads help the workers.
+     *
+     *  @return True if a task was run and false if there were no queued
+     *          tasks.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool run_pending_task() noexcept;
+
+private:
+    /// Adds @p task to a queue, starting the workers if needed
+    void submit_(task_type task);
+
+    /// The object actually implementing the pool
+    std::unique_ptr<detail_::TaskPoolPIMPL> m_pimpl_;
+};
+
+/** @brief Runs @p fxn now, on the calling thread.
+ *
+ *  This function is for when there is no TaskPool to submit @p fxn to. It
+ *  returns the result the same way TaskPool::async would, so callers don't
+ *  need to distinguish between the two cases.
+ *
+ *  @tparam FxnType The type of the functor.
+ *
+ *  @param[in] fxn The functor to run.
+ *
+ *  @return A ready TaskFuture holding the result of @p fxn (or the exception
+ *          it threw).
+ *
+ *  @throw std::bad_alloc if there is a problem allocating the result. Strong
+ *                        throw guarantee.
+ */
+template<typename FxnType>
+auto run_inline(FxnType&& fxn) {
+    using result_type = std::invoke_result_t<std::decay_t<FxnType>&>;
+    std::packaged_task<result_type()> task(std::forward<FxnType>(fxn));
+    TaskFuture<result_type> rv(task.get_future());
+    task();
+    return rv;
+}
+
+//------------------------------------------------------------------------------
+//                          Inline Implementations
+//------------------------------------------------------------------------------
+
+template<typename T>
+bool TaskFuture<T>::ready() const {
+    if(!valid()) throw std::future_error(std::future_errc::no_state);
+    const auto zero = std::chrono::seconds(0);
+    return m_future_.wait_for(zero) == std::future_status::ready;
+}
+
+template<typename T>
+void TaskFuture<T>::wait() {
+    // The task may be queued behind tasks we can run, or may be running on
+    // another thread, in which case we nap briefly before checking again
+    const auto nap = std::chrono::microseconds(50);
+    while(!ready()) {
+        if(m_pool_ && m_pool_->run_pending_task()) continue;
+        WaitEdge edge(m_runner_ ? m_runner_->load() : std::thread::id{});
+        m_future_.wait_for(nap);
+    }
+}
+
+template<typename FxnType>
+auto TaskPool::async(FxnType&& fxn) {
+    using result_type = std::invoke_result_t<std::decay_t<FxnType>&>;
+    using task_type   = std::packaged_task<result_type()>;
+
+    // std::function needs to be copyable, std::packaged_task isn't
+    auto ptask  = std::make_shared<task_type>(std::forward<FxnType>(fxn));
+    auto runner = std::make_shared<std::atomic<std::thread::id>>();
+    future_type<result_type> rv(ptask->get_future(), this, runner);
+    submit_([ptask, runner]() {
+        runner->store(std::this_thread::get_id());
+        (*ptask)();
+    });
+    return rv;
+}
+
+} // namespace pluginplay::utility
@@ -15,6 +15,9 @@
  */
 
 #pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace pluginplay::utility {
@@ -22,6 +25,9 @@ namespace pluginplay::utility {
 /// Type used for universally unique identifiers (UUIDs)
 using uuid_type = std::string;
 
+/// Type of a UUID in binary form, i.e., its 16 raw bytes
+using binary_uuid_type = std::array<std::uint8_t, 16>;
+
 /** @brief Generates a UUID
  *
  *  N.B. This function takes no input. That's because UUIDs are tied to the
@@ -32,4 +38,38 @@ using uuid_type = std::string;
  */
 uuid_type generate_uuid();
 
+/** @brief Generates a UUID in binary form
+ *
+ *  Same as generate_uuid, but the UUID is not formatted. Binary UUIDs are
+ *  cheaper to make, compare, and store, so they should be preferred for UUIDs
+ *  which are only used as keys (see to_string for displaying them).
+ *
+ *  @return A freshly generated UUID.
+ */
+binary_uuid_type generate_binary_uuid();
+
+/** @brief Generates a name-based UUID for a piece of content
+ *
+ *  Unlike the overload taking no input, the UUID is derived from (a SHA-1
+ *  digest of) the @p n bytes starting at @p data. The same bytes always give
+ *  the same UUID, in every process, so the UUID can be used as a
+ *  content-addressed key. UUIDs made by this overload (RFC 4122 version 5)
+ *  never collide with random ones (version 4).
+ *
+ *  @param[in] data The first byte of the content.
+ *  @param[in] n The number of bytes in the content.
+ *
+ *  @return The UUID for the content, in binary form.
+ */
+binary_uuid_type generate_binary_uuid(const void* data, std::size_t n);
+
+/** @brief Formats a binary UUID
+ *
+ *  @param[in] uuid The UUID to format.
+ *
+ *  @return @p uuid in the canonical 36 character form (e.g.,
+ *          "123e4567-e89b-12d3-a456-426614174000").
+ */
+uuid_type to_string(const binary_uuid_type& uuid);
+
 } // namespace pluginplay::utility
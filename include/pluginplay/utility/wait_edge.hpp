@@ -0,0 +1,86 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <thread>
+
+namespace pluginplay::utility {
+
+/** @brief Records that the calling thread is blocked on another thread.
+ *
+ *  PluginPlay keeps a process-wide "wait-for" graph: while a WaitEdge lives,
+ *  the graph has an edge from the thread which made it to the thread it
+ *  waits on (e.g., the thread running the task a TaskFuture is waiting for,
+ *  or the thread computing results a cache is waiting for). Before a thread
+ *  blocks on another thread it can call `would_deadlock` to find out if the
+ *  other thread is, directly or through other waiting threads, waiting on
+ *  it.
+ *
+ *  A thread only blocks on one thing at a time, but waits nest (e.g., a
+ *  thread waiting on a TaskFuture runs a queued task, which waits on a
+ *  cache). WaitEdge instances must therefore be destroyed in the reverse
+ *  order they were made in, which restores the outer edge.
+ */
+class WaitEdge {
+public:
+    /// Type used to identify threads
+    using id_type = std::thread::id;
+
+    /** @brief Records that the calling thread waits on @p waitee.
+     *
+     *  @param[in] waitee The thread the calling thread is about to block on.
+     *                    If @p waitee is a default constructed id (e.g.,
+     *                    because it is not known yet) *this records that the
+     *                    calling thread waits on no thread.
+     *
+     *  @throw std::bad_alloc if there is a problem adding the edge. Strong
+     *                        throw guarantee.
+     */
+    explicit WaitEdge(id_type waitee);
+
+    /// Deleted because edges are tied to the scope they were made in
+    WaitEdge(const WaitEdge&) = delete;
+
+    /// Deleted because edges are tied to the scope they were made in
+    WaitEdge& operator=(const WaitEdge&) = delete;
+
+    /** @brief Restores the edge the calling thread had before *this.
+     *
+     *  @throw None No throw guarantee.
+     */
+    ~WaitEdge() noexcept;
+
+    /** @brief Would the calling thread waiting on @p waitee deadlock?
+     *
+     *  @param[in] waitee The thread the calling thread would block on.
+     *
+     *  @return True if @p waitee is the calling thread, or if following the
+     *          edges from @p waitee leads back to the calling thread, and
+     *          false otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    static bool would_deadlock(id_type waitee) noexcept;
+
+private:
+    /// Sets the calling thread's edge to @p waitee, returning the old one
+    static id_type exchange_(id_type waitee);
+
+    /// The edge the calling thread had before *this
+    id_type m_previous_;
+};
+
+} // namespace pluginplay::utility
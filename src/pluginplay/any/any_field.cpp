@@ -16,8 +16,50 @@
 
 #include "pluginplay/any/any_field.hpp"
 #include "pluginplay/any/detail_/any_field_base.hpp"
+#include <map>
+#include <mutex>
 
 namespace pluginplay::any {
+namespace detail_ {
+namespace {
+
+// Maps the names of the types to the functions deserializing them
+struct DeserializerRegistry {
+    std::mutex mutex;
+    std::map<std::string, deserializer_type> fxns;
+};
+
+DeserializerRegistry& registry() {
+    // N.B. function static, so it exists before types register at start up
+    static DeserializerRegistry rv;
+    return rv;
+}
+
+} // namespace
+
+bool register_deserializer(const std::string& name, deserializer_type fxn) {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.fxns.emplace(name, fxn);
+    return true;
+}
+
+typename AnyFieldBase::field_base_pointer AnyFieldBase::deserialize(
+  serial_view& bytes) {
+    const auto name = Serializer<std::string>{}.load(bytes);
+
+    deserializer_type fxn = nullptr;
+    {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        auto itr = r.fxns.find(name);
+        if(itr != r.fxns.end()) fxn = itr->second;
+    }
+    if(!fxn) throw std::runtime_error("Can not deserialize type " + name);
+    return fxn(bytes);
+}
+
+} // namespace detail_
 
 // -----------------------------------------------------------------------------
 // -- CTors and Assignment
@@ -25,8 +67,17 @@ namespace pluginplay::any {
 
 AnyField::AnyField(pimpl_pointer pimpl) noexcept : m_pimpl_(std::move(pimpl)) {}
 
-AnyField::AnyField(const AnyField& other) :
-  m_pimpl_(other.has_value() ? other.m_pimpl_->clone() : nullptr) {}
+AnyField::AnyField(shared_pimpl_pointer pimpl) noexcept :
+  m_pimpl_(std::move(pimpl)) {}
+
+AnyField::AnyField(const AnyField& other) {
+    if(!other.has_value()) return;
+    // Aliased values are copied so that the copy owns its value
+    if(other.m_shareable_ && other.owns_value())
+        m_pimpl_ = other.m_pimpl_;
+    else
+        m_pimpl_ = other.m_pimpl_->clone();
+}
 
 AnyField::AnyField(AnyField&& other) noexcept = default;
 
@@ -39,9 +90,15 @@ AnyField& AnyField::operator=(AnyField&& rhs) noexcept = default;
 
 AnyField::~AnyField() noexcept = default;
 
-void AnyField::swap(AnyField& other) noexcept { m_pimpl_.swap(other.m_pimpl_); }
+void AnyField::swap(AnyField& other) noexcept {
+    m_pimpl_.swap(other.m_pimpl_);
+    std::swap(m_shareable_, other.m_shareable_);
+}
 
-void AnyField::reset() noexcept { m_pimpl_.reset(); }
+void AnyField::reset() noexcept {
+    m_pimpl_.reset();
+    m_shareable_ = true;
+}
 
 typename AnyField::rtti_type AnyField::type() const noexcept {
     if(!has_value()) return rtti_type{typeid(nullptr)};
@@ -70,6 +127,42 @@ bool AnyField::are_equal(const AnyField& rhs) const noexcept {
     return m_pimpl_->are_equal(*rhs.m_pimpl_);
 }
 
+std::size_t AnyField::hash() const noexcept {
+    if(!has_value()) return 0;
+    return m_pimpl_->hash();
+}
+
+bool AnyField::is_serializable() const noexcept {
+    return has_value() && m_pimpl_->is_serializable();
+}
+
+typename AnyField::serial_buffer AnyField::serialize_() const {
+    serial_buffer rv;
+    Serializer<bool>{}.save(has_value(), rv);
+    if(has_value() && !m_pimpl_->serialize(rv))
+        throw std::runtime_error("The wrapped type can not be serialized");
+    return rv;
+}
+
+void AnyField::deserialize_(serial_view bytes) {
+    AnyField rv;
+    if(Serializer<bool>{}.load(bytes))
+        rv = AnyField(pimpl_type::deserialize(bytes));
+    if(!bytes.empty())
+        throw std::runtime_error("Unexpected bytes after the AnyField");
+    rv.swap(*this);
+}
+
+bool AnyField::digest(digest_buffer& buffer) const {
+    if(!has_value()) return false;
+    return m_pimpl_->digest(buffer);
+}
+
+std::size_t AnyField::memory_footprint() const noexcept {
+    if(!has_value()) return 0;
+    return m_pimpl_->memory_footprint();
+}
+
 std::ostream& AnyField::print(std::ostream& os) const {
     if(!has_value()) return os;
     return m_pimpl_->print(os);
@@ -86,4 +179,13 @@ bool AnyField::owns_value() const noexcept {
     return !m_pimpl_->storing_const_reference();
 }
 
+bool AnyField::shares_value(const AnyField& rhs) const noexcept {
+    return has_value() && m_pimpl_ == rhs.m_pimpl_;
+}
+
+void AnyField::make_unique_() {
+    if(m_pimpl_.use_count() > 1) m_pimpl_ = m_pimpl_->clone();
+    m_shareable_ = false;
+}
+
 } // namespace pluginplay::any
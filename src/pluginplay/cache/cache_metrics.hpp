@@ -0,0 +1,213 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <pluginplay/cache/module_cache.hpp>
+#include <utility>
+
+namespace pluginplay::cache::detail_ {
+
+/** @brief Records the metrics ModuleCache::metrics reports.
+ *
+ *  A ModuleCache and the KeyProxyMapper in its database share an instance of
+ *  this class. The cache records the hits, misses, inserts, and the time it
+ *  spends looking results up, while the KeyProxyMapper records how that time
+ *  splits between proxying the inputs and the database holding the results.
+ *
+ *  Everything is recorded with relaxed atomics, so recording is lock-free and
+ *  may be done concurrently.
+ */
+class CacheMetrics {
+public:
+    /// Type of the snapshot this class makes
+    using metrics_type = ModuleCache::metrics_type;
+
+    /// Type used for counting
+    using size_type = ModuleCache::size_type;
+
+    /// Type of a recorded time
+    using duration_type = ModuleCache::duration_type;
+
+    /// Clock used for timing
+    using clock_type = std::chrono::steady_clock;
+
+    /// Records a find_or_compute call which found the results
+    void hit(duration_type latency) noexcept {
+        add_(m_n_hits_, 1);
+        looked_up_(latency);
+    }
+
+    /// Records a find_or_compute call which computed the results
+    void computed(duration_type latency, duration_type compute) noexcept {
+        add_(m_n_misses_, 1);
+        add_(m_n_computed_, 1);
+        add_(m_compute_time_, compute.count());
+        looked_up_(latency);
+    }
+
+    /// Records a find_or_compute call which used another call's results
+    void coalesced() noexcept {
+        add_(m_n_misses_, 1);
+        add_(m_n_coalesced_, 1);
+    }
+
+    /// Records a find_or_compute call which missed and then threw
+    void failed() noexcept { add_(m_n_misses_, 1); }
+
+    /// Records that a result of @p bytes bytes was stored
+    void inserted(size_type bytes) noexcept {
+        add_(m_n_inserts_, 1);
+        add_(m_bytes_inserted_, bytes);
+    }
+
+    /// Calls @p fxn, recording the time it took as proxying time
+    template<typename FxnType>
+    decltype(auto) time_proxy(FxnType&& fxn) {
+        Timer t(m_proxy_time_, m_proxy_latency_);
+        return std::forward<FxnType>(fxn)();
+    }
+
+    /// Calls @p fxn, recording the time it took as backend time
+    template<typename FxnType>
+    decltype(auto) time_backend(FxnType&& fxn) {
+        Timer t(m_backend_time_, m_backend_latency_);
+        return std::forward<FxnType>(fxn)();
+    }
+
+    /// Reads the counters (each atomically, but not as a set)
+    metrics_type snapshot() const noexcept {
+        metrics_type rv;
+        rv.n_hits          = load_(m_n_hits_);
+        rv.n_misses        = load_(m_n_misses_);
+        rv.n_computed      = load_(m_n_computed_);
+        rv.n_coalesced     = load_(m_n_coalesced_);
+        rv.n_inserts       = load_(m_n_inserts_);
+        rv.bytes_inserted  = load_(m_bytes_inserted_);
+        rv.lookup_time     = duration_type(load_(m_lookup_time_));
+        rv.proxy_time      = duration_type(load_(m_proxy_time_));
+        rv.backend_time    = duration_type(load_(m_backend_time_));
+        rv.compute_time    = duration_type(load_(m_compute_time_));
+        rv.lookup_latency  = snapshot_(m_lookup_latency_);
+        rv.proxy_latency   = snapshot_(m_proxy_latency_);
+        rv.backend_latency = snapshot_(m_backend_latency_);
+        return rv;
+    }
+
+private:
+    /// Type of a counter
+    using counter_type = std::atomic<size_type>;
+
+    /// Type of a time, in nanoseconds
+    using time_type = std::atomic<duration_type::rep>;
+
+    /// Type of a histogram in a snapshot
+    using histogram_type = ModuleCache::histogram_type;
+
+    /// Type of a histogram whose buckets can be bumped concurrently
+    using atomic_histogram_type =
+      std::array<counter_type, histogram_type::n_buckets>;
+
+    /// Adds the time between its construction and destruction to a time
+    /// and a histogram
+    class Timer {
+    public:
+        Timer(time_type& total, atomic_histogram_type& histogram) noexcept :
+          m_total_(total),
+          m_histogram_(histogram),
+          m_start_(clock_type::now()) {}
+
+        ~Timer() noexcept {
+            const auto dt = clock_type::now() - m_start_;
+            const auto ns = std::chrono::duration_cast<duration_type>(dt);
+            add_(m_total_, ns.count());
+            bump_(m_histogram_, ns);
+        }
+
+    private:
+        /// The time to add to
+        time_type& m_total_;
+
+        /// The histogram to add to
+        atomic_histogram_type& m_histogram_;
+
+        /// When timing started
+        clock_type::time_point m_start_;
+    };
+
+    /// Adds @p n to @p x
+    template<typename T, typename U>
+    static void add_(std::atomic<T>& x, U n) noexcept {
+        x.fetch_add(static_cast<T>(n), std::memory_order_relaxed);
+    }
+
+    /// Reads @p x
+    template<typename T>
+    static T load_(const std::atomic<T>& x) noexcept {
+        return x.load(std::memory_order_relaxed);
+    }
+
+    /// Adds @p dt to @p histogram
+    static void bump_(atomic_histogram_type& histogram,
+                      duration_type dt) noexcept {
+        add_(histogram[histogram_type::bucket(dt)], 1);
+    }
+
+    /// Reads the buckets of @p histogram
+    static histogram_type snapshot_(
+      const atomic_histogram_type& histogram) noexcept {
+        histogram_type rv;
+        for(std::size_t i = 0; i < histogram.size(); ++i)
+            rv.counts[i] = load_(histogram[i]);
+        return rv;
+    }
+
+    /// Records the latency of a find_or_compute call
+    void looked_up_(duration_type latency) noexcept {
+        add_(m_lookup_time_, latency.count());
+        bump_(m_lookup_latency_, latency);
+    }
+
+    /// The counters, see metrics_type for their meanings
+    ///@{
+    counter_type m_n_hits_{0};
+    counter_type m_n_misses_{0};
+    counter_type m_n_computed_{0};
+    counter_type m_n_coalesced_{0};
+    counter_type m_n_inserts_{0};
+    counter_type m_bytes_inserted_{0};
+    ///@}
+
+    /// The times, in nanoseconds, see metrics_type for their meanings
+    ///@{
+    time_type m_lookup_time_{0};
+    time_type m_proxy_time_{0};
+    time_type m_backend_time_{0};
+    time_type m_compute_time_{0};
+    ///@}
+
+    /// The histograms, see metrics_type for their meanings
+    ///@{
+    atomic_histogram_type m_lookup_latency_{};
+    atomic_histogram_type m_proxy_latency_{};
+    atomic_histogram_type m_backend_latency_{};
+    ///@}
+};
+
+} // namespace pluginplay::cache::detail_
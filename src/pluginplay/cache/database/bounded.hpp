@@ -0,0 +1,304 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "database_api.hpp"
+#include "memory_budget.hpp"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+namespace pluginplay::cache::database {
+
+/** @brief An in memory database whose size is limited by a MemoryBudget.
+ *
+ *  This class is a drop-in replacement for Native, which additionally reports
+ *  the size of each entry to a MemoryBudget. When the budget is exceeded the
+ *  budget asks the databases sharing it to evict their lowest priority
+ *  entries. Evicted entries are moved to the "spill" database, if one was
+ *  provided, and are otherwise dropped.
+ *
+ *  Unlike the backup database, the spill database holds entries which are
+ *  logically still in *this. Hence count, at, try_at, and keys also consider
+ *  the spill database. Entries found in the spill database are brought back
+ *  into memory.
+ *
+ *  Using an entry (inserting it or looking it up) updates its priority. To
+ *  keep hits cheap, looking an entry up only records its new priority (and
+ *  only if the budget has a limit); the entry is moved to its new place in
+ *  the eviction order lazily, when the budget looks for something to evict.
+ *  Hits only take a shared lock, so any number of threads may look values up
+ *  at the same time. Values are shared with the caller (see DBValue), rather
+ *  than copied, which keeps them alive even if they are evicted. Other
+ *  operations should be guarded by the caller (e.g., by wrapping *this in
+ *  Synchronized).
+ *
+ *  If there is no backup database, but there is a spill database, entries
+ *  are backed up to the spill database. After the entries are copied, backup
+ *  is also called on that database.
+ *
+ *  Normally, entries only reach the spill database when they are evicted (or
+ *  backed up). If the spill database is shared with others (e.g., it is
+ *  spread over the ranks of a runtime), *this can instead write entries
+ *  through to it when they are inserted, so others see them right away. The
+ *  entries are still kept in memory, and evicting them merely drops them.
+ *
+ *  The most recently inserted entry is never evicted. This ensures a value
+ *  can always be retrieved right after it is inserted.
+ *
+ *  Some values may not be storable outside of memory (e.g., because they can
+ *  not be serialized). If a predicate telling such values apart is provided,
+ *  entries it rejects are never moved out of memory: evicting them drops
+ *  them (even if there is a spill database), and they are not backed up and
+ *  not released by dump. Dropping them keeps the budget enforceable when
+ *  there is nowhere to put them; a dropped entry is simply no longer found
+ *  (for a cache, its value will be recomputed).
+ *
+ *  @tparam KeyType The type of the keys we are storing.
+ *  @tparam ValueType The type of the values that the keys map to.
+ */
+template<typename KeyType, typename ValueType>
+class Bounded : public DatabaseAPI<KeyType, ValueType>, public Evictable {
+private:
+    /// Type the class implements
+    using base_type = DatabaseAPI<KeyType, ValueType>;
+
+public:
+    /// Type of the keys to this database, typedef of KeyType
+    using typename base_type::key_type;
+
+    /// Ultimately typedef of DatabaseAPI::key_set_type
+    using typename base_type::key_set_type;
+
+    /// Type of a read-only reference to a key, typedef of const KeyType&
+    using typename base_type::const_key_reference;
+
+    /// Type of the mapped values, typedef of ValueType
+    using typename base_type::mapped_type;
+
+    /// Type of an object holding a read-only reference to a value
+    using typename base_type::const_mapped_reference;
+
+    /// Type used for sizes
+    using typename Evictable::size_type;
+
+    /// Type of a priority
+    using typename Evictable::priority_type;
+
+    /// Type of the budget *this reports to
+    using budget_type = MemoryBudget;
+
+    /// Type of a pointer to the budget
+    using budget_pointer = std::shared_ptr<budget_type>;
+
+    /// Type of a callable which returns the size of a value in bytes
+    using size_function = std::function<size_type(const mapped_type&)>;
+
+    /// Type of the spill and backup databases
+    using sub_db_type = DatabaseAPI<key_type, mapped_type>;
+
+    /// Type of a pointer to the spill or the backup database
+    using sub_db_pointer = std::unique_ptr<sub_db_type>;
+
+    /// Type of a callable which says if a value may leave memory
+    using can_spill_function = std::function<bool(const mapped_type&)>;
+
+    /** @brief Creates a new, empty instance.
+     *
+     *  @param[in] budget The budget to report to. Must be non-null.
+     *  @param[in] size A callable which returns the size of a value in bytes.
+     *                  Must be non-null.
+     *  @param[in] spill Where evicted entries are moved to. If null, evicted
+     *                   entries are dropped.
+     *  @param[in] backup Where entries are backed up to. If null, entries are
+     *                    backed up to @p spill (and if that is also null
+     *                    backing up is a no-op).
+     *  @param[in] can_spill A callable which returns false for values which
+     *                       can't leave memory (they are dropped when
+     *                       evicted). If null, every value may be moved out
+     *                       of memory.
+     *  @param[in] use_cost Should inserting consume the recompute cost set
+     *                      on the calling thread (see
+     *                      MemoryBudget::set_recompute_cost)? Databases which
+     *                      are written to while a value is being inserted
+     *                      elsewhere (e.g., the database of the inputs) should
+     *                      pass false, so the cost reaches the value's
+     *                      database. Defaults to true.
+     *  @param[in] write_through Should inserted entries (which may spill) be
+     *                           written to @p spill right away? Defaults to
+     *                           false.
+     *
+     *  @throw std::runtime_error if @p budget or @p size is null. Strong throw
+     *                            guarantee.
+     *  @throw std::bad_alloc if there is a problem registering with
+     *                        @p budget. Strong throw guarantee.
+     */
+    Bounded(budget_pointer budget, size_function size,
+            sub_db_pointer spill = {}, sub_db_pointer backup = {},
+            can_spill_function can_spill = {}, bool use_cost = true,
+            bool write_through = false);
+
+    /// Deleted because the budget holds a pointer to *this
+    Bounded(const Bounded&) = delete;
+
+    /// Deleted because the budget holds a pointer to *this
+    Bounded& operator=(const Bounded&) = delete;
+
+    /// Unregisters from the budget and returns our memory to it
+    ~Bounded() noexcept override;
+
+    /// The number of bytes the entries held in memory occupy
+    size_type size() const noexcept;
+
+    /// Implements Evictable::lowest_priority
+    bool lowest_priority(priority_type& priority) const noexcept override;
+
+    /// Implements Evictable::evict_lowest
+    size_type evict_lowest() override;
+
+protected:
+    /// Union of the keys in memory and the keys in the spill database
+    key_set_type keys_() const override;
+
+    /// Checks memory and then the spill database
+    bool count_(const_key_reference key) const noexcept override;
+
+    /// Adds the value to memory, then asks the budget to reclaim memory
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Removes the key from memory and from the spill database
+    void free_(const_key_reference key) override;
+
+    /// Shares the value, loading it from the spill database if needed
+    const_mapped_reference at_(const_key_reference key) const override;
+
+    /// Shares the value, if found, loading it from the spill DB if needed
+    const_mapped_reference try_at_(const_key_reference key) const override;
+
+    /// Pushes the entries in memory to, then backs up, the backup database
+    void backup_() override;
+
+    /// Calls backup, then releases the entries in memory which may spill
+    void dump_() override;
+
+    /// Same as size(), entries in the spill database are not counted
+    std::size_t memory_footprint_() const noexcept override;
+
+    /// Calls begin_batch on the spill and backup databases
+    void begin_batch_() override;
+
+    /// Calls commit_batch on the spill and backup databases
+    void commit_batch_() override;
+
+    /// Calls abort_batch on the spill and backup databases
+    void abort_batch_() override;
+
+private:
+    /// Type of the map from priorities to the keys of the entries
+    using priority_map = std::multimap<priority_type, const key_type*>;
+
+    /// How values are held, so they can be shared with callers
+    using value_pointer = std::shared_ptr<const mapped_type>;
+
+    /// What we store for each key
+    struct entry_type {
+        entry_type(value_pointer value, size_type size, double cost,
+                   bool can_spill, priority_type priority,
+                   typename priority_map::iterator where) :
+          m_value(std::move(value)),
+          m_size(size),
+          m_cost(cost),
+          m_can_spill(can_spill),
+          m_priority(priority),
+          m_where(where) {}
+
+        value_pointer m_value;
+        size_type m_size;
+        double m_cost;
+        bool m_can_spill;
+        std::atomic<priority_type> m_priority; // Updated by hits
+        typename priority_map::iterator m_where; // Where it is filed
+    };
+
+    /// Type of the map from keys to entries
+    using map_type = std::map<key_type, entry_type>;
+
+    /// Type of the lock used while modifying the state
+    using lock_type = std::unique_lock<std::shared_mutex>;
+
+    /// Type of the lock used while reading the state
+    using read_lock_type = std::shared_lock<std::shared_mutex>;
+
+    /// Adds an entry (caller must hold a lock_type). Returns the value.
+    const value_pointer& emplace_(key_type key, mapped_type value,
+                                  double cost) const;
+
+    /// Records that @p entry was used (a read_lock_type suffices)
+    void touch_(entry_type& entry) const noexcept;
+
+    /// Finds the evictable entry with the lowest priority, filing entries
+    /// used since they were filed first (caller must hold a lock_type)
+    typename priority_map::iterator lowest_() const noexcept;
+
+    /// Removes @p itr (caller must hold a lock_type)
+    void erase_(typename map_type::iterator itr) const;
+
+    /// Looks up the key in memory, then in the spill database
+    const_mapped_reference find_(const_key_reference key) const;
+
+    /// Guards the state of this class
+    mutable std::shared_mutex m_mutex_;
+
+    /// The entries held in memory
+    mutable map_type m_map_;
+
+    /// The keys of m_map_ ordered by the priority they were filed with
+    mutable priority_map m_priorities_;
+
+    /// The entry which was added last, it won't be evicted
+    mutable const key_type* m_newest_ = nullptr;
+
+    /// The number of bytes m_map_ occupies
+    mutable size_type m_size_ = 0;
+
+    /// The budget we report to
+    budget_pointer m_budget_;
+
+    /// Computes the sizes of the values
+    size_function m_size_fxn_;
+
+    /// Where evicted entries go
+    sub_db_pointer m_spill_;
+
+    /// Where entries are backed up to
+    sub_db_pointer m_backup_;
+
+    /// Says which values may leave memory, null means all of them
+    can_spill_function m_can_spill_;
+
+    /// Do inserts consume the calling thread's recompute cost?
+    bool m_use_cost_;
+
+    /// Are inserted entries written to m_spill_ right away?
+    bool m_write_through_;
+};
+
+} // namespace pluginplay::cache::database
+
+#include "bounded.ipp"
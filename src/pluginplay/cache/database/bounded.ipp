@@ -0,0 +1,279 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// File to be included from bounded.hpp only
+
+namespace pluginplay::cache::database {
+
+#define TPARAMS template<typename KeyType, typename ValueType>
+#define BOUNDED Bounded<KeyType, ValueType>
+
+TPARAMS
+BOUNDED::Bounded(budget_pointer budget, size_function size,
+                 sub_db_pointer spill, sub_db_pointer backup,
+                 can_spill_function can_spill, bool use_cost,
+                 bool write_through) :
+  m_budget_(std::move(budget)),
+  m_size_fxn_(std::move(size)),
+  m_spill_(std::move(spill)),
+  m_backup_(std::move(backup)),
+  m_can_spill_(std::move(can_spill)),
+  m_use_cost_(use_cost),
+  m_write_through_(write_through && m_spill_) {
+    if(!m_budget_ || !m_size_fxn_)
+        throw std::runtime_error("Was expecting a budget and a size function");
+    m_budget_->register_db(this);
+}
+
+TPARAMS
+BOUNDED::~Bounded() noexcept {
+    m_budget_->unregister_db(this);
+    m_budget_->remove(m_size_);
+}
+
+TPARAMS
+typename BOUNDED::size_type BOUNDED::size() const noexcept {
+    read_lock_type lock(m_mutex_);
+    return m_size_;
+}
+
+TPARAMS
+bool BOUNDED::lowest_priority(priority_type& priority) const noexcept {
+    lock_type lock(m_mutex_);
+    auto itr = lowest_();
+    if(itr == m_priorities_.end()) return false;
+    priority = itr->first;
+    return true;
+}
+
+TPARAMS
+typename BOUNDED::size_type BOUNDED::evict_lowest() {
+    lock_type lock(m_mutex_);
+    auto pitr = lowest_();
+    if(pitr == m_priorities_.end()) return 0;
+    auto itr  = m_map_.find(*pitr->second);
+    auto size = itr->second.m_size;
+    // N.B. we spill while holding the lock so a concurrent look up either
+    //      finds the entry in memory or in the spill database. Entries which
+    //      can't spill are dropped.
+    if(m_spill_ && !m_write_through_ && itr->second.m_can_spill)
+        m_spill_->insert(itr->first, *itr->second.m_value);
+    erase_(itr);
+    return size;
+}
+
+TPARAMS
+typename BOUNDED::key_set_type BOUNDED::keys_() const {
+    read_lock_type lock(m_mutex_);
+    key_set_type rv;
+    for(const auto& [k, _] : m_map_) rv.push_back(k);
+    if(!m_spill_) return rv;
+    for(auto& k : m_spill_->keys())
+        if(!m_map_.count(k)) rv.push_back(std::move(k));
+    return rv;
+}
+
+TPARAMS
+bool BOUNDED::count_(const_key_reference key) const noexcept {
+    read_lock_type lock(m_mutex_);
+    if(m_map_.count(key)) return true;
+    return m_spill_ && m_spill_->count(key);
+}
+
+TPARAMS
+void BOUNDED::insert_(key_type key, mapped_type value) {
+    const auto cost = m_use_cost_ ? budget_type::take_recompute_cost() : 0.0;
+    // N.B. written before the entry is in memory, so that once it can be
+    //      found here it can also be found in the spill database
+    if(m_write_through_ && (!m_can_spill_ || m_can_spill_(value)))
+        m_spill_->insert(key, value);
+    {
+        lock_type lock(m_mutex_);
+        emplace_(std::move(key), std::move(value), cost);
+    }
+    m_budget_->reclaim();
+}
+
+TPARAMS
+void BOUNDED::free_(const_key_reference key) {
+    lock_type lock(m_mutex_);
+    auto itr = m_map_.find(key);
+    if(itr != m_map_.end()) erase_(itr);
+    if(m_spill_) m_spill_->free(key);
+}
+
+TPARAMS
+typename BOUNDED::const_mapped_reference BOUNDED::at_(
+  const_key_reference key) const {
+    auto rv = try_at_(key);
+    if(rv.has_value()) return rv;
+    throw std::out_of_range("Key was not found in the database");
+}
+
+TPARAMS
+typename BOUNDED::const_mapped_reference BOUNDED::try_at_(
+  const_key_reference key) const {
+    return find_(key);
+}
+
+TPARAMS
+void BOUNDED::backup_() {
+    auto* backup = m_backup_ ? m_backup_.get() : m_spill_.get();
+    if(!backup) return;
+    if(!m_backup_ && m_write_through_) { // Already has the entries
+        backup->backup();
+        return;
+    }
+    BatchScope<sub_db_type> batch(*backup);
+    {
+        read_lock_type lock(m_mutex_);
+        for(const auto& [k, v] : m_map_)
+            if(v.m_can_spill) backup->insert(k, *v.m_value);
+    }
+    batch.commit();
+    // So layers below (e.g., WriteBehind) also reach their durability point
+    backup->backup();
+}
+
+TPARAMS
+void BOUNDED::dump_() {
+    backup_();
+    lock_type lock(m_mutex_);
+    for(auto itr = m_map_.begin(); itr != m_map_.end();) {
+        auto next = std::next(itr);
+        if(itr->second.m_can_spill) erase_(itr);
+        itr = next;
+    }
+}
+
+TPARAMS
+std::size_t BOUNDED::memory_footprint_() const noexcept { return size(); }
+
+TPARAMS
+void BOUNDED::begin_batch_() {
+    if(m_spill_) m_spill_->begin_batch();
+    if(m_backup_) m_backup_->begin_batch();
+}
+
+TPARAMS
+void BOUNDED::commit_batch_() {
+    if(m_backup_) m_backup_->commit_batch();
+    if(m_spill_) m_spill_->commit_batch();
+}
+
+TPARAMS
+void BOUNDED::abort_batch_() {
+    if(m_backup_) m_backup_->abort_batch();
+    if(m_spill_) m_spill_->abort_batch();
+}
+
+TPARAMS
+const typename BOUNDED::value_pointer& BOUNDED::emplace_(key_type key,
+                                                         mapped_type value,
+                                                         double cost) const {
+    auto itr = m_map_.find(key);
+    if(itr != m_map_.end()) erase_(itr);
+
+    const auto size      = m_size_fxn_(value);
+    const bool can_spill = !m_can_spill_ || m_can_spill_(value);
+    const auto priority  = m_budget_->priority(size, cost);
+    auto pvalue = std::make_shared<const mapped_type>(std::move(value));
+    itr         = m_map_
+            .try_emplace(std::move(key), std::move(pvalue), size, cost,
+                         can_spill, priority, m_priorities_.end())
+            .first;
+    itr->second.m_where = m_priorities_.emplace(priority, &itr->first);
+    m_newest_ = &itr->first;
+    m_size_ += size;
+    m_budget_->add(size);
+    return itr->second.m_value;
+}
+
+TPARAMS
+void BOUNDED::touch_(entry_type& entry) const noexcept {
+    // Priorities only matter if something may have to be evicted
+    if(m_budget_->limit() == 0) return;
+    entry.m_priority = m_budget_->priority(entry.m_size, entry.m_cost);
+}
+
+TPARAMS
+typename BOUNDED::priority_map::iterator BOUNDED::lowest_() const noexcept {
+    auto itr = m_priorities_.begin();
+    while(itr != m_priorities_.end()) {
+        auto& entry         = m_map_.find(*itr->second)->second;
+        const auto priority = entry.m_priority.load();
+        if(priority != itr->first) {
+            // Used since it was filed. Re-filing reuses the node, so it
+            // doesn't allocate. The entry may now come before itr's
+            // successor, so we start over.
+            auto node     = m_priorities_.extract(itr);
+            node.key()    = priority;
+            entry.m_where = m_priorities_.insert(std::move(node));
+            itr           = m_priorities_.begin();
+            continue;
+        }
+        if(itr->second != m_newest_) return itr;
+        ++itr;
+    }
+    return itr;
+}
+
+TPARAMS
+void BOUNDED::erase_(typename map_type::iterator itr) const {
+    if(m_newest_ == &itr->first) m_newest_ = nullptr;
+    m_size_ -= itr->second.m_size;
+    m_budget_->remove(itr->second.m_size);
+    m_priorities_.erase(itr->second.m_where);
+    m_map_.erase(itr);
+}
+
+TPARAMS
+typename BOUNDED::const_mapped_reference BOUNDED::find_(
+  const_key_reference key) const {
+    {
+        read_lock_type lock(m_mutex_);
+        auto itr = m_map_.find(key);
+        if(itr != m_map_.end()) {
+            touch_(itr->second);
+            return const_mapped_reference(itr->second.m_value);
+        }
+        if(!m_spill_) return const_mapped_reference{};
+    }
+
+    value_pointer rv;
+    {
+        lock_type lock(m_mutex_);
+        // Another thread may have brought the entry back in the meantime
+        auto itr = m_map_.find(key);
+        if(itr != m_map_.end()) {
+            touch_(itr->second);
+            return const_mapped_reference(itr->second.m_value);
+        }
+
+        auto spilled = m_spill_->try_at(key);
+        if(!spilled.has_value()) return const_mapped_reference{};
+        // N.B. the cost of a spilled entry is not known
+        rv = emplace_(key, spilled.get(), 0.0);
+    }
+    // Bringing the entry back from the spill database may put us over budget
+    m_budget_->reclaim();
+    return const_mapped_reference(std::move(rv));
+}
+
+#undef BOUNDED
+#undef TPARAMS
+
+} // namespace pluginplay::cache::database
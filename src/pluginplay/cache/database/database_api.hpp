@@ -16,7 +16,10 @@
 
 #pragma once
 #include "db_value.hpp"
+#include <cstddef>
+#include <functional>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace pluginplay::cache::database {
@@ -80,6 +83,9 @@ public:
      */
     using const_mapped_reference = ConstDBValue<mapped_type>;
 
+    /// Type of a callback which computes a value which is not in the database
+    using compute_function = std::function<mapped_type()>;
+
     /// No-op, no-throw default ctor
     DatabaseAPI() noexcept = default;
 
@@ -222,6 +228,76 @@ public:
      */
     const_mapped_reference operator[](const_key_reference key) const;
 
+    /** @brief Returns the value associated with a key, if there is one.
+     *
+     *  This method combines `count` and `at` into a single look up, which for
+     *  databases relying on proxies avoids proxying @p key twice. Like `at`,
+     *  this function only considers the database it was called on and not any
+     *  subdatabases.
+     *
+     *  N.B. This function is implemented by try_at_
+     *
+     *  @param[in] key The label of the value we want.
+     *
+     *  @return An object whose `.get()` method returns an immutable reference
+     *          to the value associated with @p key. If @p key is not in the
+     *          database the returned object's `has_value()` is false.
+     *
+     *  @throw ??? Throws if the backend throws. Same throw guarantee.
+     */
+    const_mapped_reference try_at(const_key_reference key) const {
+        return try_at_(key);
+    }
+
+    /** @brief Returns the value associated with a key, computing and storing
+     *         it first if needed.
+     *
+     *  If @p key is in the database this is the same as calling `at(key)`.
+     *  Otherwise, @p fxn is called, its result is inserted under @p key, and
+     *  the newly stored value is returned. Derived classes are encouraged to
+     *  implement this such that any work needed to look up @p key (e.g.,
+     *  proxying it) is done once and reused for the insertion.
+     *
+     *  N.B. This function is implemented by find_or_compute_
+     *
+     *  @param[in] key The label of the value we want.
+     *  @param[in] fxn The callback used to compute the value if @p key is not
+     *                 in the database.
+     *
+     *  @return An object whose `.get()` method returns an immutable reference
+     *          to the value associated with @p key.
+     *
+     *  @throw ??? Throws if @p fxn throws or if the backend throws. If @p fxn
+     *             throws nothing is added to the database.
+     */
+    const_mapped_reference find_or_compute(const_key_reference key,
+                                           const compute_function& fxn) {
+        return find_or_compute_(key, fxn);
+    }
+
+    /** @brief Adds a key/value pair to the database, unless the key is
+     *         already in use.
+     *
+     *  Unlike `insert`, this method will not overwrite the value currently
+     *  associated with @p key. This is useful when several callers may race
+     *  to assign a value to @p key and all of them must agree on the value
+     *  (e.g., assigning UUIDs).
+     *
+     *  N.B. This function is implemented by try_insert_
+     *
+     *  @param[in] key The label @p value will be stored under.
+     *  @param[in] value The object to store under @p key, if @p key is not
+     *                   already in use.
+     *
+     *  @return An object whose `.get()` method returns an immutable reference
+     *          to the value now associated with @p key.
+     *
+     *  @throw ??? Throws if the backend throws. Same guarantee as the backend.
+     */
+    const_mapped_reference try_insert(KeyType key, ValueType value) {
+        return try_insert_(std::move(key), std::move(value));
+    }
+
     /** @brief Checkpoints the database.
      *
      *  This function is called when the user wants the database to be
@@ -257,6 +333,71 @@ public:
      */
     void dump() { dump_(); }
 
+    /** @brief How much memory do the entries held in memory occupy?
+     *
+     *  Databases which hold their entries in memory and know how big they are
+     *  report the number of bytes here. Databases which wrap other databases
+     *  report the footprint of the wrapped database. The default reports 0,
+     *  which is also the answer for databases which store their entries
+     *  elsewhere (e.g., on disk).
+     *
+     *  N.B. This function's implementation relies on memory_footprint_
+     *
+     *  @return The number of bytes the in-memory entries occupy.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t memory_footprint() const noexcept {
+        return memory_footprint_();
+    }
+
+    /** @brief Starts grouping writes into a batch.
+     *
+     *  Between a call to begin_batch and the matching call to commit_batch
+     *  the database may defer writing to long-term storage, and then write
+     *  all of the deferred changes at once when the batch is committed. For
+     *  backends where every write has a high latency (e.g., RocksDB on a
+     *  parallel filesystem) this is much faster than writing one entry at a
+     *  time. Deferred writes are still visible to count, at, etc.
+     *
+     *  Batches nest, i.e., only the outermost commit_batch writes the
+     *  changes. Every call to begin_batch must be followed by a call to
+     *  commit_batch or to abort_batch, even if an exception is thrown in
+     *  between; BatchScope (below) does this for you. Databases which wrap
+     *  other databases forward these calls to the wrapped databases.
+     *
+     *  N.B. This function is actually implemented by begin_batch_. The
+     *       default implementation is a no-op.
+     *
+     *  @throw ??? Throws if the backend throws.
+     */
+    void begin_batch() { begin_batch_(); }
+
+    /** @brief Ends a batch started by begin_batch.
+     *
+     *  If this ends the outermost batch, the deferred changes are written.
+     *
+     *  N.B. This function is actually implemented by commit_batch_. The
+     *       default implementation is a no-op.
+     *
+     *  @throw ??? Throws if the backend throws while writing the changes.
+     */
+    void commit_batch() { commit_batch_(); }
+
+    /** @brief Ends a batch started by begin_batch, discarding its changes.
+     *
+     *  A batch is all or nothing: if this ends a nested batch, the changes
+     *  deferred by the enclosing batches are discarded too, when the
+     *  outermost batch ends (even if it ends with commit_batch). Only
+     *  deferred changes are discarded, e.g., entries held in memory stay.
+     *
+     *  N.B. This function is actually implemented by abort_batch_. The
+     *       default implementation is a no-op.
+     *
+     *  @throw ??? Throws if the backend throws.
+     */
+    void abort_batch() { abort_batch_(); }
+
 protected:
     /** @brief Hook for derived class to implement keys.
      *
@@ -318,6 +459,57 @@ protected:
      */
     virtual const_mapped_reference at_(const_key_reference key) const = 0;
 
+    /** @brief Hook for derived class to implement try_at
+     *
+     *  The default implementation calls count_ and then at_. Derived classes
+     *  should override it if they can look @p key up in a single step.
+     *
+     *  @param[in] key The key whose associated value will be returned.
+     *
+     *  @throw ??? The backend may choose to throw if appropriate.
+     */
+    virtual const_mapped_reference try_at_(const_key_reference key) const {
+        if(!count_(key)) return const_mapped_reference{};
+        return at_(key);
+    }
+
+    /** @brief Hook for derived class to implement find_or_compute
+     *
+     *  The default implementation calls try_at_ and, if the value is missing,
+     *  insert_ followed by at_. Derived classes should override it if they can
+     *  reuse work between the look up and the insertion.
+     *
+     *  @param[in] key The key whose associated value will be returned.
+     *  @param[in] fxn The callback to use if @p key is not in the database.
+     *
+     *  @throw ??? The backend may choose to throw if appropriate.
+     */
+    virtual const_mapped_reference find_or_compute_(
+      const_key_reference key, const compute_function& fxn) {
+        auto rv = try_at_(key);
+        if(rv.has_value()) return rv;
+        insert_(key, fxn());
+        return at_(key);
+    }
+
+    /** @brief Hook for derived class to implement try_insert
+     *
+     *  The default implementation calls try_at_ and, if @p key is not found,
+     *  insert_. Derived classes must override it if that is not atomic for
+     *  them.
+     *
+     *  @param[in] key The key that @p value will be stored under.
+     *  @param[in] value The object to store under @p key.
+     *
+     *  @throw ??? The backend may choose to throw if appropriate.
+     */
+    virtual const_mapped_reference try_insert_(KeyType key, ValueType value) {
+        auto rv = try_at_(key);
+        if(rv.has_value()) return rv;
+        insert_(std::move(key), value);
+        return const_mapped_reference(std::move(value));
+    }
+
     /** @brief Hook for derived class to implement backup
      *
      *  The derived class is responsible for overriding this method with a
@@ -335,6 +527,97 @@ protected:
      *  @throw ??? The backend may choose to throw if appropriate.
      */
     virtual void dump_() = 0;
+
+    /** @brief Hook for derived class to implement memory_footprint
+     *
+     *  The default implementation returns 0. Derived classes which hold
+     *  entries in memory, or which wrap a database, should override it.
+     *
+     *  @throw None No throw guarantee.
+     */
+    virtual std::size_t memory_footprint_() const noexcept { return 0; }
+
+    /** @brief Hook for derived class to implement begin_batch
+     *
+     *  The default implementation is a no-op. Backends which can group writes,
+     *  and databases which wrap other databases, should override it.
+     *
+     *  @throw ??? The backend may choose to throw if appropriate.
+     */
+    virtual void begin_batch_() {}
+
+    /** @brief Hook for derived class to implement commit_batch
+     *
+     *  The default implementation is a no-op. Derived classes overriding
+     *  begin_batch_ must also override this method.
+     *
+     *  @throw ??? The backend may choose to throw if appropriate.
+     */
+    virtual void commit_batch_() {}
+
+    /** @brief Hook for derived class to implement abort_batch
+     *
+     *  The default implementation is a no-op. Derived classes overriding
+     *  begin_batch_ must also override this method.
+     *
+     *  @throw ??? The backend may choose to throw if appropriate.
+     */
+    virtual void abort_batch_() {}
+};
+
+/** @brief Groups the writes made during its lifetime into a batch.
+ *
+ *  BatchScope calls begin_batch on construction and commit_batch when commit
+ *  is called. If *this is destroyed without commit having been called (e.g.,
+ *  because an exception is unwinding the stack) the batch is aborted, so the
+ *  partial set of writes never reaches long-term storage. Either way every
+ *  batch is ended. Exceptions thrown by abort_batch from the dtor are
+ *  swallowed.
+ *
+ *  @tparam DBType The type of the database. Must have begin_batch,
+ *                 commit_batch, and abort_batch methods.
+ */
+template<typename DBType>
+class BatchScope {
+public:
+    /** @brief Starts a batch on @p db.
+     *
+     *  @param[in] db The database to group writes for. Must outlive *this.
+     *
+     *  @throw ??? Throws if begin_batch throws. Strong throw guarantee.
+     */
+    explicit BatchScope(DBType& db) : m_db_(&db) { m_db_->begin_batch(); }
+
+    /// Deleted to ensure each batch is ended once
+    BatchScope(const BatchScope&) = delete;
+
+    /// Deleted to ensure each batch is ended once
+    BatchScope& operator=(const BatchScope&) = delete;
+
+    /// Aborts the batch, if commit was not called
+    ~BatchScope() noexcept {
+        if(!m_db_) return;
+        try {
+            m_db_->abort_batch();
+        } catch(...) {}
+    }
+
+    /** @brief Commits the batch now.
+     *
+     *  Subsequent calls (including the one from the dtor) are no-ops.
+     *
+     *  @throw ??? Throws if commit_batch throws. The batch is considered
+     *             committed regardless.
+     */
+    void commit() {
+        if(!m_db_) return;
+        auto* db = std::exchange(m_db_, nullptr);
+        db->commit_batch();
+    }
+
+private:
+    /// The database with the open batch (null once committed)
+    DBType* m_db_;
 };
 
 #define TPARAMS template<typename KeyType, typename ValueType>
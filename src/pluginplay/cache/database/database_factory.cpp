@@ -15,15 +15,25 @@
  */
 
 #include "database_factory.hpp"
+#include "bounded.hpp"
+#include "distributed.hpp"
+#include "footprint.hpp"
 #include "key_injector.hpp"
 #include "key_proxy_mapper.hpp"
 #include "make_any.hpp"
 #include "native.hpp"
 #include "rocksdb/rocksdb.hpp"
 #include "serialized.hpp"
+#include "snapshot.hpp"
+#include "synchronized.hpp"
 #include "transposer.hpp"
 #include "type_eraser.hpp"
 #include "value_proxy_mapper.hpp"
+#include "write_behind.hpp"
+#include <cereal/types/array.hpp>
+#include <pluginplay/utility/uuid.hpp>
+#include <set>
+#include <sstream>
 
 namespace pluginplay::cache::database {
 
@@ -36,68 +46,242 @@ using proxy_map     = typename DatabaseFactory::proxy_map_type;
 using any_field     = typename DatabaseFactory::any_type;
 using uuid          = typename DatabaseFactory::uuid_type;
 using binary_type   = typename DatabaseFactory::binary_type;
+using size_type     = typename DatabaseFactory::size_type;
+
+namespace {
+
+// Key injected into proxy maps to say which module the results belong to
+const std::string module_key = "__CACHE__ MODULE NAME __CACHE__";
+
+// Value injected under module_key, a UUID derived from the module's UUID
+uuid module_proxy(const DatabaseFactory::module_uuid_type& id) {
+    return utility::generate_binary_uuid(id.data(), id.size());
+}
+
+// How many bytes an AnyField occupies, including the value it wraps
+size_type any_size(const any_field& value) {
+    return sizeof(any_field) + value.memory_footprint();
+}
+
+// Can @p value be moved to long-term storage?
+bool can_spill_any(const any_field& value) { return value.is_serializable(); }
+
+// Can @p results be moved to long-term storage? (their values must be)
+bool can_spill_results(const result_map& results) {
+    for(const auto& [_, result] : results)
+        if(!result.is_serializable()) return false;
+    return true;
+}
+
+// How many bytes a proxy map occupies
+size_type proxy_map_size(const proxy_map& pm) {
+    size_type rv = sizeof(proxy_map);
+    for(const auto& [k, v] : pm) {
+        rv += sizeof(typename proxy_map::value_type);
+        rv += k.capacity(); // UUIDs are stored inline
+    }
+    return rv;
+}
+
+// Serializes @p value the same way the Serialized layers do
+template<typename T>
+binary_type to_binary(const T& value) {
+    std::ostringstream os;
+    {
+        cereal::BinaryOutputArchive ar(os);
+        ar << value;
+    }
+    return os.str();
+}
+
+// Undoes to_binary
+template<typename T>
+T from_binary(const binary_type& bytes) {
+    std::istringstream is(bytes);
+    cereal::BinaryInputArchive ar(is);
+    T rv;
+    ar >> rv;
+    return rv;
+}
+
+} // namespace
 
 DatabaseFactory::DatabaseFactory() { set_type_eraser_backend(); }
 
 DatabaseFactory::DatabaseFactory(const std::string& cache_path,
-                                 const std::string& uuid_path) {
-    set_serialized_pm_to_pm(cache_path);
-    set_type_eraser_backend(uuid_path);
+                                 const std::string& uuid_path,
+                                 const rocksdb_options_type& options) {
+    set_serialized_pm_to_pm(cache_path, options);
+    set_type_eraser_backend(uuid_path, options);
 }
 
 typename DatabaseFactory::module_db_pointer DatabaseFactory::default_module_db(
-  uuid_type module_uuid) const {
+  module_uuid_type module_uuid, metrics_pointer metrics,
+  persist_pointer persist) const {
     using input_2_any = TypeEraser<module_input, uuid>;
     auto pi2any       = std::make_unique<input_2_any>(m_any2uuid_);
 
     using input_2_uuid = UUIDMapper<module_input>;
-    auto pi2uuid       = std::make_unique<input_2_uuid>(std::move(pi2any));
+    auto pi2uuid       = std::make_unique<input_2_uuid>(
+      std::move(pi2any), m_content_addressed_, m_uuid2any_);
 
     using input_2_pm = ProxyMapMaker<input_map>;
     auto pi2pm       = std::make_unique<input_2_pm>(std::move(pi2uuid));
 
     using key_proxy_mapper = KeyProxyMapper<input_map, result_map>;
-    return std::make_unique<key_proxy_mapper>(std::move(pi2pm),
-                                              pm2result_db(module_uuid));
+    auto pkpm = std::make_unique<key_proxy_mapper>(
+      std::move(pi2pm), pm2result_db(module_uuid, std::move(persist)),
+      std::move(metrics));
+
+    using synchronized = Synchronized<input_map, result_map>;
+    return std::make_unique<synchronized>(std::move(pkpm));
 }
 
 typename DatabaseFactory::pm_2_result_map_pointer DatabaseFactory::pm2result_db(
-  uuid_type module_uuid) const {
+  module_uuid_type module_uuid, persist_pointer persist) const {
     // Short-term storage type
-    using pm_2_result = Native<proxy_map, result_map>;
+    using pm_2_result = Bounded<proxy_map, result_map>;
 
     if(m_serial_pm_) { // This pointer means we have long-term storage
-        const std::string key = "__CACHE__ MODULE NAME __CACHE__";
-
-        using injector_type = KeyInjector<proxy_map, proxy_map>;
-        auto pinjector      = std::make_unique<injector_type>(
-          key, std::move(module_uuid), m_serial_pm_);
+        // Makes a DB which proxies results and stores them long-term
+        auto make_archive = [&]() {
+            using injector_type = KeyInjector<proxy_map, proxy_map>;
+            auto pinjector      = std::make_unique<injector_type>(
+              module_key, module_proxy(module_uuid), m_serial_pm_);
 
-        using result_2_any = TypeEraser<module_result, uuid>;
-        auto pr2any        = std::make_unique<result_2_any>(m_any2uuid_);
+            using result_2_any = TypeEraser<module_result, uuid>;
+            auto pr2any        = std::make_unique<result_2_any>(m_any2uuid_);
 
-        using result_2_uuid = UUIDMapper<module_result>;
-        auto pr2uuid = std::make_unique<result_2_uuid>(std::move(pr2any));
+            using result_2_uuid = UUIDMapper<module_result>;
+            auto pr2uuid = std::make_unique<result_2_uuid>(
+              std::move(pr2any), m_content_addressed_, m_uuid2any_);
 
-        using result_2_pm = ProxyMapMaker<result_map>;
-        auto pr2pm        = std::make_unique<result_2_pm>(std::move(pr2uuid));
+            using result_2_pm = ProxyMapMaker<result_map>;
+            auto pr2pm = std::make_unique<result_2_pm>(std::move(pr2uuid));
 
-        using value_proxy_mapper = ValueProxyMapper<proxy_map, result_map>;
-        auto ppm2r = std::make_unique<value_proxy_mapper>(std::move(pr2pm),
-                                                          std::move(pinjector));
+            using value_proxy_mapper = ValueProxyMapper<proxy_map, result_map>;
+            return std::make_unique<value_proxy_mapper>(std::move(pr2pm),
+                                                        std::move(pinjector));
+        };
 
-        return std::make_unique<pm_2_result>(std::move(ppm2r));
+        // Evicted results are spilled to long-term storage too (or written
+        // to it right away, if m_pm_write_through_ is set). Results which
+        // can't be serialized, or which were inserted while persist was off,
+        // are dropped, and recomputed if needed again.
+        auto can_spill = [persist = std::move(persist)](const result_map& r) {
+            if(persist && !persist->load(std::memory_order_relaxed))
+                return false;
+            return can_spill_results(r);
+        };
+        return std::make_unique<pm_2_result>(
+          m_budget_, result_map_footprint, make_archive(), make_archive(),
+          std::move(can_spill), true, m_pm_write_through_);
     }
     // There's no long-term storage, so we don't actually need the module's uuid
-    return std::make_unique<pm_2_result>();
+    return std::make_unique<pm_2_result>(m_budget_, result_map_footprint);
 }
 
-void DatabaseFactory::set_serialized_pm_to_pm(const std::string& path) {
+void DatabaseFactory::set_serialized_pm_to_pm(
+  const std::string& path, const rocksdb_options_type& options) {
     using rocks_db = RocksDB<binary_type, binary_type>;
-    auto pRDB_io   = std::make_unique<rocks_db>(path);
+    auto pdb       = std::make_unique<rocks_db>(path, options);
+    set_serialized_pm_to_pm_(std::move(pdb), options.write_behind_limit);
+}
+
+void DatabaseFactory::set_distributed_backend(const runtime_type& runtime) {
+    // N.B. Constructing a Distributed is collective, so every rank must make
+    //      them in the same order
+    auto ppm   = std::make_unique<Distributed>(runtime);
+    auto puuid = std::make_unique<Distributed>(runtime);
+
+    // The other ranks only see what is written to the Distributed databases
+    set_serialized_pm_to_pm_(std::move(ppm), 0, true);
+    set_type_eraser_backend_(std::move(puuid), 0, true);
+}
 
+void DatabaseFactory::set_snapshot_backend(const path_type& cache_path,
+                                           const path_type& uuid_path) {
+    // Open both before changing anything, for the strong throw guarantee
+    auto pcache = std::make_unique<Snapshot>(cache_path);
+    auto puuid  = std::make_unique<Snapshot>(uuid_path);
+    set_serialized_pm_to_pm_(std::move(pcache));
+    set_type_eraser_backend_(std::move(puuid));
+}
+
+void DatabaseFactory::export_snapshot(
+  const path_type& cache_path, const path_type& uuid_path,
+  std::optional<module_uuid_type> module_uuid) const {
+    if(!m_pm_binary_ || !m_uuid_binary_)
+        throw std::runtime_error("There is no long-term storage to export");
+    if(!m_content_addressed_)
+        throw std::runtime_error("Only content-addressed UUIDs can be found "
+                                 "after exporting them");
+
+    // Backing up the results of a module adds their inputs/results to the
+    // shared uuid database, which may not have reached long-term storage yet.
+    // Backing up the shared databases also waits for queued writes.
+    m_any2uuid_->backup();
+    m_serial_pm_->backup();
+
+    if(!module_uuid) {
+        Snapshot::write(cache_path, *m_pm_binary_);
+        Snapshot::write(uuid_path, *m_uuid_binary_);
+        return;
+    }
+
+    // Collect the module's results, and the UUIDs they refer to
+    using binary_db = Native<binary_type, binary_type>;
+    binary_db pm2pm, uuid2any;
+    const auto module_id = module_proxy(*module_uuid);
+    std::set<uuid> uuids;
+    auto add_uuids = [&](const proxy_map& pm) {
+        for(const auto& [_, id] : pm) uuids.insert(id);
+    };
+    for(const auto& key : m_pm_binary_->keys()) {
+        auto inputs = from_binary<proxy_map>(key);
+        auto itr    = inputs.find(module_key);
+        if(itr == inputs.end() || itr->second != module_id) continue;
+        inputs.erase(itr);
+
+        auto results = m_pm_binary_->at(key);
+        add_uuids(inputs);
+        add_uuids(from_binary<proxy_map>(results.get()));
+        pm2pm.insert(key, results.get());
+    }
+
+    for(const auto& id : uuids) {
+        auto key   = to_binary(id);
+        auto value = m_uuid_binary_->try_at(key);
+        if(value.has_value()) uuid2any.insert(std::move(key), value.get());
+    }
+
+    Snapshot::write(cache_path, pm2pm);
+    Snapshot::write(uuid_path, uuid2any);
+}
+
+void DatabaseFactory::set_serialized_pm_to_pm_(binary_db_pointer db,
+                                               size_type write_behind_limit,
+                                               bool write_through) {
+    m_pm_binary_        = db.get();
+    m_pm_write_through_ = write_through;
     using serial_pm = Serialized<proxy_map, proxy_map>;
-    m_serial_pm_    = std::make_shared<serial_pm>(std::move(pRDB_io));
+    std::unique_ptr<pm_2_pm> pserial_pm =
+      std::make_unique<serial_pm>(std::move(db));
+
+    if(write_behind_limit) { // Serialize and write in the background
+        using write_behind = WriteBehind<proxy_map, proxy_map>;
+        pserial_pm         = std::make_unique<write_behind>(
+          std::move(pserial_pm), write_behind_limit, proxy_map_size);
+    }
+
+    // Shared by all module caches, so it must be synchronized
+    using synchronized = Synchronized<proxy_map, proxy_map>;
+    m_serial_pm_       = std::make_shared<synchronized>(std::move(pserial_pm));
+}
+
+void DatabaseFactory::set_memory_budget(size_type max_bytes,
+                                        policy_type policy) noexcept {
+    m_budget_->set_limit(max_bytes, policy);
 }
 
 void DatabaseFactory::set_type_eraser_backend() {
@@ -105,21 +289,55 @@ void DatabaseFactory::set_type_eraser_backend() {
     auto puuid2any   = std::make_unique<uuid_2_any>();
 
     using transposer = Transposer<any_field, uuid>;
-    m_any2uuid_      = std::make_shared<transposer>(std::move(puuid2any));
+    auto pany2uuid   = std::make_unique<transposer>(std::move(puuid2any));
+
+    // Shared by all module caches, so it must be synchronized
+    using synchronized = Synchronized<any_field, uuid>;
+    m_any2uuid_        = std::make_shared<synchronized>(std::move(pany2uuid));
+    m_uuid2any_        = nullptr;
+    m_uuid_binary_     = nullptr;
 }
 
-void DatabaseFactory::set_type_eraser_backend(const std::string& path) {
+void DatabaseFactory::set_type_eraser_backend(
+  const std::string& path, const rocksdb_options_type& options) {
     using rocks_db = RocksDB<binary_type, binary_type>;
-    auto pRDB_uuid = std::make_unique<rocks_db>(path);
+    auto pdb       = std::make_unique<rocks_db>(path, options);
+    set_type_eraser_backend_(std::move(pdb), options.write_behind_limit);
+}
 
+void DatabaseFactory::set_type_eraser_backend_(binary_db_pointer db,
+                                               size_type write_behind_limit,
+                                               bool write_through) {
+    m_uuid_binary_        = db.get();
     using serial_uuid2any = Serialized<uuid, any_field>;
-    auto pserial_uuid = std::make_unique<serial_uuid2any>(std::move(pRDB_uuid));
+    using uuid_2_any_db   = DatabaseAPI<uuid, any_field>;
+    std::unique_ptr<uuid_2_any_db> pserial_uuid =
+      std::make_unique<serial_uuid2any>(std::move(db));
 
-    using uuid_2_any = Native<uuid, any_field>;
-    auto puuid2any   = std::make_unique<uuid_2_any>(std::move(pserial_uuid));
+    if(write_behind_limit) { // Serialize and write in the background
+        using write_behind = WriteBehind<uuid, any_field>;
+        pserial_uuid       = std::make_unique<write_behind>(
+          std::move(pserial_uuid), write_behind_limit, any_size);
+    }
+
+    // Inputs/results can be evicted since they can be read back from disk.
+    // Those which can't be serialized are dropped; the Transposer then no
+    // longer finds them, so they get new UUIDs (and their results are
+    // recomputed) if they are used again. Inputs are inserted after a result is
+    // computed, but before the result is, so they must not take its cost.
+    // Bounded is thread-safe on its own, so it can also be read directly
+    using uuid_2_any = Bounded<uuid, any_field>;
+    auto puuid2any   = std::make_shared<uuid_2_any>(
+      m_budget_, any_size, std::move(pserial_uuid), nullptr, can_spill_any,
+      false, write_through);
+    m_uuid2any_ = puuid2any;
 
     using transposer = Transposer<any_field, uuid>;
-    m_any2uuid_      = std::make_shared<transposer>(std::move(puuid2any));
+    auto pany2uuid   = std::make_unique<transposer>(std::move(puuid2any));
+
+    // Shared by all module caches, so it must be synchronized
+    using synchronized = Synchronized<any_field, uuid>;
+    m_any2uuid_        = std::make_shared<synchronized>(std::move(pany2uuid));
 }
 
 } // namespace pluginplay::cache::database
@@ -15,9 +15,15 @@
  */
 
 #pragma once
+#include "../cache_metrics.hpp"
 #include "../proxy_map_maker.hpp"
 #include "database_api.hpp"
+#include "memory_budget.hpp"
+#include <atomic>
 #include <memory>
+#include <optional>
+#include <parallelzone/runtime/runtime_view.hpp>
+#include <pluginplay/cache/rocksdb_options.hpp>
 #include <pluginplay/fields/fields.hpp>
 #include <pluginplay/types.hpp>
 
@@ -46,6 +52,37 @@ namespace pluginplay::cache::database {
  *  Each factory maintains its own copies of these pointers and injects the
  *  copies it holds.
  *
+ *  The in-memory pieces of the databases share a MemoryBudget. By default the
+ *  budget has no limit. If a limit is set (see set_memory_budget) and it is
+ *  exceeded, cached results are evicted. When long-term storage is enabled,
+ *  evicted results (and the inputs/results backing the UUID database) are
+ *  moved to the long-term storage instead of being dropped, and are read
+ *  back in when they are needed again. A module's database can be told to
+ *  keep the results it caches in memory only (see default_module_db).
+ *
+ *  By default the UUIDs inputs and results are proxied with are random. If
+ *  the factory is content-addressed (see set_content_addressed), databases
+ *  it makes afterwards derive the UUIDs from the inputs/results, so that
+ *  independent processes sharing the long-term storage agree on them and
+ *  can reuse each other's results.
+ *
+ *  Instead of RocksDB, the long-term storage can be spread over the ranks of
+ *  a runtime (see set_distributed_backend). Each key is then stored by one
+ *  rank, and the other ranks ask that rank for it.
+ *
+ *  Writing to RocksDB can be moved to background threads (see
+ *  RocksDBOptions::write_behind_limit). Results are then queued in memory and
+ *  are written by the time the databases are backed up or destroyed.
+ *
+ *  The long-term storage can also be exported to read-only snapshot files
+ *  (see export_snapshot), which later factories can serve cache hits from
+ *  (see set_snapshot_backend).
+ *
+ *  The databases made by this factory are safe to use from multiple threads.
+ *  The two shared pieces, as well as each module's database, are wrapped in
+ *  Synchronized layers (reader/writer locks), so concurrent cache hits do not
+ *  block each other.
+ *
  */
 class DatabaseFactory {
 public:
@@ -79,6 +116,15 @@ public:
     /// The type used for proxying an input/result
     using uuid_type = typename proxy_map_type::mapped_type;
 
+    /// Type of the (formatted) UUIDs identifying modules
+    using module_uuid_type = std::string;
+
+    /// Type of a pointer to the object recording a module cache's metrics
+    using metrics_pointer = std::shared_ptr<cache::detail_::CacheMetrics>;
+
+    /// Type of a pointer to a switch saying if results may be persisted
+    using persist_pointer = std::shared_ptr<const std::atomic<bool>>;
+
     /// Type type that inputs and results get serialized to
     using binary_type = std::string;
 
@@ -94,12 +140,45 @@ public:
     /// Type of a pointer to the DB satisfying any_2_uuid
     using any_2_uuid_pointer = std::shared_ptr<any_2_uuid>;
 
+    /// Type of the DB storing the inputs/results under their UUIDs
+    using value_db_type = DatabaseAPI<uuid_type, any_type>;
+
+    /// Type of a read-only pointer to a DB satisfying value_db_type
+    using value_db_pointer = std::shared_ptr<const value_db_type>;
+
     /// Type of a DB that can map proxy maps to result maps
     using pm_2_result_map = DatabaseAPI<proxy_map_type, result_map_type>;
 
     /// Type of a pointer to a pm_2_result_map DB
     using pm_2_result_map_pointer = std::unique_ptr<pm_2_result_map>;
 
+    /// Type used for sizes
+    using size_type = typename MemoryBudget::size_type;
+
+    /// Type of the object limiting how much memory the databases use
+    using budget_type = MemoryBudget;
+
+    /// Type of a pointer to the budget
+    using budget_pointer = std::shared_ptr<budget_type>;
+
+    /// Type of the eviction policy
+    using policy_type = typename budget_type::policy_type;
+
+    /// Type of the options used to tune the RocksDB databases
+    using rocksdb_options_type = RocksDBOptions;
+
+    /// Type of the runtime the long-term storage can be spread over
+    using runtime_type = parallelzone::runtime::RuntimeView;
+
+    /// Type of a database of serialized objects
+    using binary_db_type = DatabaseAPI<binary_type, binary_type>;
+
+    /// Type of a pointer to a database of serialized objects
+    using binary_db_pointer = std::unique_ptr<binary_db_type>;
+
+    /// Type used for specifying where files live
+    using path_type = std::string;
+
     /** @brief Creates a new DatabaseFactory which doesn't have any long-term
      *         storage.
      *
@@ -125,21 +204,36 @@ public:
      *                        be archived to.
      *  @param[in] uuid_path Where the input to UUID (and result to UUID)
      *                       databases will be archived to.
+     *  @param[in] options How to tune the RocksDB databases living at
+     *                     @p cache_path and @p uuid_path. Defaults to
+     *                     RocksDB's defaults.
      *
      */
-    DatabaseFactory(const std::string& cache_path,
-                    const std::string& uuid_path);
+    DatabaseFactory(const std::string& cache_path, const std::string& uuid_path,
+                    const rocksdb_options_type& options = {});
 
     /** @brief Makes the default Database backend for the specified module.
      *
      *  N.B. This class is not responsible for assigning UUIDs to modules. How
      *       that's done is up to the caller.
      *
+     *  N.B. The returned database is wrapped in a Synchronized layer and may be
+     *       used from multiple threads.
+     *
      *  @param[in] module_uuid This method generates a database backend specific
      *                         to the module with this UUID.
+     *  @param[in] metrics Where the returned database records the time spent
+     *                     proxying inputs and the time spent in the database
+     *                     holding the results. If null, nothing is recorded.
+     *  @param[in] persist Read as each result is inserted. If it is false
+     *                     the result is only held in memory, i.e., it is
+     *                     never written to long-term storage. If null, every
+     *                     result may be written to long-term storage.
      *
      */
-    module_db_pointer default_module_db(uuid_type module_uuid) const;
+    module_db_pointer default_module_db(module_uuid_type module_uuid,
+                                        metrics_pointer metrics = {},
+                                        persist_pointer persist = {}) const;
 
     /** @brief Wraps the process of making a DB that can go from proxy maps to
      *         result maps.
@@ -149,9 +243,11 @@ public:
      *  of databse returned from this method depends on whether or not
      *  long-term archival of proxy-map to proxy-map databases has been enabled.
      *
-     *
+     *  @param[in] module_uuid The UUID of the module whose results are stored.
+     *  @param[in] persist See default_module_db.
      */
-    pm_2_result_map_pointer pm2result_db(uuid_type module_uuid) const;
+    pm_2_result_map_pointer pm2result_db(module_uuid_type module_uuid,
+                                         persist_pointer persist = {}) const;
 
     /** @brief Allows the user to change where the proxy map to proxy map
      *         database is stored.
@@ -161,9 +257,12 @@ public:
      *       created databases.
      *
      *  @param[in] path Where on the filesystem the database should live.
+     *  @param[in] options How to tune the database. Defaults to RocksDB's
+     *                     defaults.
      *
      */
-    void set_serialized_pm_to_pm(const std::string& path);
+    void set_serialized_pm_to_pm(const std::string& path,
+                                 const rocksdb_options_type& options = {});
 
     /** @brief Creates a uuid database with no long-term storage
      *
@@ -179,15 +278,161 @@ public:
      *       created databases.
      *
      *  @param[in] path Where on the filesystem the database should live.
+     *  @param[in] options How to tune the database. Defaults to RocksDB's
+     *                     defaults.
+     */
+    void set_type_eraser_backend(const std::string& path,
+                                 const rocksdb_options_type& options = {});
+
+    /** @brief Spreads the long-term storage over the ranks of @p runtime.
+     *
+     *  This replaces both the proxy map to proxy map database and the uuid
+     *  database with Distributed databases, i.e., each key is stored by the
+     *  rank it hashes to. For the ranks to agree on where a key lives, the
+     *  UUIDs should be content-addressed (see set_content_addressed).
+     *
+     *  So that the other ranks find them right away, inputs/results are
+     *  written to the Distributed databases as soon as they are cached (the
+     *  rank which cached them also keeps them in memory). Values which can't
+     *  be serialized are only kept by the rank which cached them.
+     *
+     *  This is a collective operation, and so is destroying *this (and the
+     *  databases made by it) afterwards.
+     *
+     *  N.B. As with set_serialized_pm_to_pm, databases made before this call
+     *       keep using the old storage.
+     *
+     *  @param[in] runtime The ranks to spread the storage over.
+     *
+     *  @throw std::runtime_error if @p runtime has more than one rank and
+     *                            MPI does not support MPI_THREAD_MULTIPLE.
+     */
+    void set_distributed_backend(const runtime_type& runtime);
+
+    /** @brief Serves the long-term storage from snapshot files.
+     *
+     *  This replaces both the proxy map to proxy map database and the uuid
+     *  database with Snapshot databases, i.e., the files are memory-mapped
+     *  and values are deserialized straight from the mappings. The files are
+     *  never modified; entries added afterwards are only kept in memory. The
+     *  snapshot's UUIDs were made by another process, so they can only be
+     *  found if the UUIDs are content-addressed (see set_content_addressed).
+     *
+     *  N.B. As with set_serialized_pm_to_pm, databases made before this call
+     *       keep using the old storage.
+     *
+     *  @param[in] cache_path The snapshot of the proxy map to proxy map
+     *                        database, see export_snapshot.
+     *  @param[in] uuid_path The snapshot of the uuid database.
+     *
+     *  @throw std::runtime_error if either file can't be mapped or is not a
+     *                            snapshot. Strong throw guarantee.
+     */
+    void set_snapshot_backend(const path_type& cache_path,
+                              const path_type& uuid_path);
+
+    /** @brief Exports the long-term storage to snapshot files.
+     *
+     *  Only what is in long-term storage is exported, so results still held
+     *  in memory should be backed up first (see ModuleCache::backup). Whoever
+     *  opens the snapshot has to recompute the UUIDs of the inputs/results, so
+     *  the UUIDs must be content-addressed (see set_content_addressed).
+     *
+     *  @param[in] cache_path Where the snapshot of the proxy map to proxy map
+     *                        database should go.
+     *  @param[in] uuid_path Where the snapshot of the uuid database should go.
+     *  @param[in] module_uuid If provided, only the results of the module
+     *                         with this UUID (and the inputs/results they
+     *                         refer to) are exported. Otherwise everything
+     *                         is. Defaults to everything.
+     *
+     *  @throw std::runtime_error if there is no long-term storage, if the
+     *                            UUIDs are not content-addressed, or if the
+     *                            files can't be written.
+     */
+    void export_snapshot(
+      const path_type& cache_path, const path_type& uuid_path,
+      std::optional<module_uuid_type> module_uuid = {}) const;
+
+    /** @brief Limits the memory the databases made by *this may use.
+     *
+     *  The budget is shared by all databases made by *this, including those
+     *  made before calling this method, and is enforced the next time an
+     *  entry is added to any of them. Sizes are estimates.
+     *
+     *  @param[in] max_bytes The maximum number of bytes the cached inputs and
+     *                       results may occupy. Zero means there is no limit.
+     *  @param[in] policy How to decide which results to evict.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void set_memory_budget(size_type max_bytes, policy_type policy) noexcept;
+
+    /** @brief The budget shared by the databases made by *this.
+     *
+     *  @return The budget, e.g., for querying how much memory is in use.
+     *
+     *  @throw None No throw guarantee.
+     */
+    const budget_type& memory_budget() const noexcept { return *m_budget_; }
+
+    /** @brief Sets whether the UUIDs of inputs/results are content-addressed.
+     *
+     *  Only databases made after calling this method are affected.
+     *
+     *  @param[in] content_addressed True to derive the UUIDs from digests of
+     *                               the inputs/results and false to use
+     *                               random UUIDs.
+     *
+     *  @throw None No throw guarantee.
      */
-    void set_type_eraser_backend(const std::string& path);
+    void set_content_addressed(bool content_addressed) noexcept {
+        m_content_addressed_ = content_addressed;
+    }
+
+    /// Are the UUIDs of inputs/results content-addressed?
+    bool is_content_addressed() const noexcept { return m_content_addressed_; }
 
 private:
+    // Makes the proxy map to proxy map database, which serializes into @p db.
+    // If @p write_behind_limit is nonzero, it writes in the background. If
+    // @p write_through is set, results are written to it as they are cached.
+    void set_serialized_pm_to_pm_(binary_db_pointer db,
+                                  size_type write_behind_limit = 0,
+                                  bool write_through           = false);
+
+    // Makes the uuid database, which serializes into @p db. If
+    // @p write_behind_limit is nonzero, it writes in the background. If
+    // @p write_through is set, values are written to it as they are cached.
+    void set_type_eraser_backend_(binary_db_pointer db,
+                                  size_type write_behind_limit = 0,
+                                  bool write_through           = false);
+
+    // The budget shared by the in-memory parts of all databases
+    budget_pointer m_budget_ = std::make_shared<budget_type>();
+
     // The common proxy map to proxy map database used by each module's cache
     serial_pm_pointer m_serial_pm_;
 
     // The common AnyField to UUID database
     any_2_uuid_pointer m_any2uuid_;
+
+    // The database m_any2uuid_ stores the inputs/results in, if it may hold
+    // entries written by other processes. N.B. only read from, so it's read
+    // without going through m_any2uuid_ (and its lock).
+    value_db_pointer m_uuid2any_;
+
+    // The binary database m_serial_pm_ serializes into (owned by it), if any
+    binary_db_type* m_pm_binary_ = nullptr;
+
+    // The binary database m_any2uuid_ serializes into (owned by it), if any
+    binary_db_type* m_uuid_binary_ = nullptr;
+
+    // Are results written to m_serial_pm_ as soon as they are cached?
+    bool m_pm_write_through_ = false;
+
+    // Are the UUIDs of inputs/results derived from their contents?
+    bool m_content_addressed_ = false;
 };
 
 } // namespace pluginplay::cache::database
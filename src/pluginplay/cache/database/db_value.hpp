@@ -15,6 +15,7 @@
  */
 
 #pragma once
+#include <memory>
 #include <optional>
 #include <utility>
 
@@ -35,9 +36,9 @@ namespace pluginplay::cache::database {
  *  trying to modify a temporary owned by the Value class and expecting the
  *  changes to propagate back.
  *
- *  N.B. Right now this uses raw pointers. When the upstream classes are written
- *       this decision will be revisited to better manage the lifetime. Most
- *       likely by also templating on the pointer type.
+ *  A database may also share ownership of the value with the Value, which
+ *  avoids the copy while keeping the value alive, even if the database drops
+ *  it (e.g., because it was evicted).
  *
  *  @tparam T The type of the object being wrapped. Expected to be a non
  *            qualified type or a const qualified type.
@@ -84,8 +85,29 @@ public:
      */
     explicit DBValue(pointer p = nullptr) : m_ptr_(p) {}
 
+    /** @brief Shared ownership ctor
+     *
+     *  The resulting instance wraps the value @p p points to and keeps it
+     *  alive for as long as the instance (or a copy of it) exists.
+     *
+     *  @param[in] p A pointer to the object being wrapped.
+     *
+     *  @throw None No throw guarantee.
+     */
+    explicit DBValue(std::shared_ptr<value_type> p) noexcept :
+      m_ptr_(p.get()), m_shared_(std::move(p)) {}
+
     bool has_value() const noexcept;
 
+    /** @brief Is the lifetime of the wrapped object managed by someone else?
+     *
+     *  @return True if *this wraps an object through the aliasing ctor and
+     *          false otherwise (including if *this wraps nothing).
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_alias() const noexcept;
+
     /** @brief Returns the wrapped object.
      *
      *  This method allows you to get a (possibly) read/write reference to the
@@ -114,8 +136,11 @@ private:
     /// If we own the value it's in the optional
     std::optional<T> m_value_;
 
-    /// If we alias it this is it's address
+    /// If we alias it (or share it) this is it's address
     pointer m_ptr_;
+
+    /// If we share ownership of the value, this keeps it alive
+    std::shared_ptr<value_type> m_shared_;
 };
 
 /// Type of a Value which wraps an immutable object of type @p T
@@ -131,6 +156,11 @@ bool DBValue<T>::has_value() const noexcept {
     return m_value_ || m_ptr_;
 }
 
+template<typename T>
+bool DBValue<T>::is_alias() const noexcept {
+    return m_ptr_ && !m_shared_;
+}
+
 template<typename T>
 typename DBValue<T>::reference DBValue<T>::get() {
     return m_value_ ? *m_value_ : *m_ptr_;
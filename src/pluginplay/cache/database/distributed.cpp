@@ -0,0 +1,399 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "distributed.hpp"
+#include "native.hpp"
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <mpi.h>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+namespace pluginplay::cache::database {
+namespace detail_ {
+
+/** @brief Implements the Distributed class.
+ *
+ *  Requests are sent to the owner of a key over m_request_comm_, and replies
+ *  come back over m_comm_. Since nothing else is sent over m_request_comm_,
+ *  the server can block on it until a request arrives. A request is made
+ *  of:
+ *
+ *  - the operation (one byte),
+ *  - the tag the reply should be sent with (four bytes),
+ *  - the size of the key (eight bytes),
+ *  - the key, and
+ *  - for inserts, the value.
+ *
+ *  Each request gets its own reply tag, so threads of a rank can have
+ *  requests in flight at the same time. Replies to count are a single byte,
+ *  replies to at are a byte saying if the key was found followed by the
+ *  value, and replies to insert/free are empty (they only acknowledge the
+ *  request, so that once insert returns every rank sees the value).
+ *
+ *  Requests for keys the current rank owns never go through MPI. The only
+ *  request a rank sends itself is a stop request (a lone operation byte),
+ *  which wakes its server up so it can exit.
+ */
+class DistributedPIMPL {
+public:
+    using parent_type      = Distributed;
+    using binary_type      = typename parent_type::binary_type;
+    using size_type        = typename parent_type::size_type;
+    using local_db_pointer = typename parent_type::local_db_pointer;
+
+    DistributedPIMPL(MPI_Comm comm, local_db_pointer local);
+
+    ~DistributedPIMPL() noexcept;
+
+    size_type rank() const noexcept { return m_rank_; }
+
+    size_type size() const noexcept { return m_size_; }
+
+    size_type owner(const binary_type& key) const noexcept;
+
+    bool count(const binary_type& key);
+
+    void insert(binary_type key, binary_type value);
+
+    void free(const binary_type& key);
+
+    std::optional<binary_type> try_at(const binary_type& key);
+
+    void backup();
+
+    void dump();
+
+    std::size_t memory_footprint() const noexcept;
+
+private:
+    /// Type of a lock on m_mutex_
+    using lock_type = std::lock_guard<std::mutex>;
+
+    /// The operations a rank can ask a key's owner to perform
+    enum class Operation : char { count, insert, free, at, stop };
+
+    /// Sends a request to @p owner and waits for the reply
+    binary_type request_(int owner, Operation op, const binary_type& key,
+                         const binary_type& value = {});
+
+    /// Blocks until a message from @p source with @p tag arrives
+    binary_type receive_(int source, int tag);
+
+    /// Sends @p message to @p dest with @p tag over @p comm
+    void send_(const binary_type& message, int dest, int tag, MPI_Comm comm);
+
+    /// Answers requests until it gets a stop request, run by m_server_
+    void serve_();
+
+    /// Performs the request in @p message, returning the reply
+    binary_type handle_(const binary_type& message);
+
+    /// Tag requests are sent with
+    static constexpr int request_tag_ = 0;
+
+    /// Duplicate of the runtime's communicator, used for the replies (so our
+    /// messages can't match anyone else's)
+    MPI_Comm m_comm_ = MPI_COMM_NULL;
+
+    /// Another duplicate of the runtime's communicator, used for the requests
+    MPI_Comm m_request_comm_ = MPI_COMM_NULL;
+
+    /// This rank
+    int m_rank_ = 0;
+
+    /// The number of ranks
+    int m_size_ = 1;
+
+    /// The largest tag MPI allows
+    int m_max_tag_ = SHRT_MAX;
+
+    /// Used to give each request its own reply tag
+    std::atomic<unsigned int> m_n_requests_{0};
+
+    /// Guards m_local_, which is used by the caller's threads and the server
+    mutable std::mutex m_mutex_;
+
+    /// The key/value pairs this rank owns
+    local_db_pointer m_local_;
+
+    /// Answers the other ranks' requests (only if there are other ranks)
+    std::thread m_server_;
+};
+
+DistributedPIMPL::DistributedPIMPL(MPI_Comm comm, local_db_pointer local) :
+  m_local_(std::move(local)) {
+    if(!m_local_)
+        m_local_ = std::make_unique<Native<binary_type, binary_type>>();
+
+    MPI_Comm_size(comm, &m_size_);
+    if(m_size_ > 1) {
+        int provided = MPI_THREAD_SINGLE;
+        MPI_Query_thread(&provided);
+        if(provided < MPI_THREAD_MULTIPLE)
+            throw std::runtime_error(
+              "A distributed cache needs MPI to be initialized with "
+              "MPI_THREAD_MULTIPLE");
+    }
+
+    MPI_Comm_dup(comm, &m_comm_);
+    MPI_Comm_dup(comm, &m_request_comm_);
+    MPI_Comm_rank(m_comm_, &m_rank_);
+
+    int* max_tag = nullptr;
+    int has_max  = 0;
+    MPI_Comm_get_attr(m_comm_, MPI_TAG_UB, &max_tag, &has_max);
+    if(has_max) m_max_tag_ = *max_tag;
+
+    if(m_size_ > 1) m_server_ = std::thread([this]() { serve_(); });
+}
+
+DistributedPIMPL::~DistributedPIMPL() noexcept {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if(finalized) { // Nothing we can do, except not hang
+        if(m_server_.joinable()) m_server_.detach();
+        return;
+    }
+
+    // Once every rank gets here, no more requests can come in
+    MPI_Barrier(m_comm_);
+    if(m_server_.joinable()) {
+        // N.B. Non-blocking, since our own server has to receive it
+        const auto stop = static_cast<char>(Operation::stop);
+        MPI_Request request;
+        MPI_Isend(&stop, 1, MPI_BYTE, m_rank_, request_tag_, m_request_comm_,
+                  &request);
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+        m_server_.join();
+    }
+    MPI_Comm_free(&m_request_comm_);
+    MPI_Comm_free(&m_comm_);
+}
+
+typename DistributedPIMPL::size_type DistributedPIMPL::owner(
+  const binary_type& key) const noexcept {
+    // N.B. std::hash may differ among builds, so we use 64-bit FNV-1a
+    std::uint64_t hash = 14695981039346656037ull;
+    for(unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash % m_size_;
+}
+
+bool DistributedPIMPL::count(const binary_type& key) {
+    const auto dest = static_cast<int>(owner(key));
+    if(dest != m_rank_) return request_(dest, Operation::count, key) == "1";
+    lock_type lock(m_mutex_);
+    return m_local_->count(key);
+}
+
+void DistributedPIMPL::insert(binary_type key, binary_type value) {
+    const auto dest = static_cast<int>(owner(key));
+    if(dest != m_rank_) {
+        request_(dest, Operation::insert, key, value);
+        return;
+    }
+    lock_type lock(m_mutex_);
+    m_local_->insert(std::move(key), std::move(value));
+}
+
+void DistributedPIMPL::free(const binary_type& key) {
+    const auto dest = static_cast<int>(owner(key));
+    if(dest != m_rank_) {
+        request_(dest, Operation::free, key);
+        return;
+    }
+    lock_type lock(m_mutex_);
+    m_local_->free(key);
+}
+
+std::optional<typename DistributedPIMPL::binary_type> DistributedPIMPL::try_at(
+  const binary_type& key) {
+    const auto dest = static_cast<int>(owner(key));
+    if(dest != m_rank_) {
+        auto reply = request_(dest, Operation::at, key);
+        if(reply.empty() || reply[0] != '1') return std::nullopt;
+        return reply.substr(1);
+    }
+    lock_type lock(m_mutex_);
+    auto value = m_local_->try_at(key);
+    if(!value.has_value()) return std::nullopt;
+    return value.get();
+}
+
+void DistributedPIMPL::backup() {
+    lock_type lock(m_mutex_);
+    m_local_->backup();
+}
+
+void DistributedPIMPL::dump() {
+    lock_type lock(m_mutex_);
+    m_local_->dump();
+}
+
+std::size_t DistributedPIMPL::memory_footprint() const noexcept {
+    lock_type lock(m_mutex_);
+    return m_local_->memory_footprint();
+}
+
+typename DistributedPIMPL::binary_type DistributedPIMPL::request_(
+  int owner, Operation op, const binary_type& key, const binary_type& value) {
+    // Tags 1 through m_max_tag_ are for replies
+    const int tag = 1 + static_cast<int>(m_n_requests_++ % m_max_tag_);
+
+    const std::uint64_t key_size = key.size();
+    binary_type message(1 + sizeof(tag) + sizeof(key_size), '\0');
+    message[0] = static_cast<char>(op);
+    std::memcpy(message.data() + 1, &tag, sizeof(tag));
+    std::memcpy(message.data() + 1 + sizeof(tag), &key_size, sizeof(key_size));
+    message.reserve(message.size() + key.size() + value.size());
+    message += key;
+    message += value;
+
+    send_(message, owner, request_tag_, m_request_comm_);
+    return receive_(owner, tag);
+}
+
+typename DistributedPIMPL::binary_type DistributedPIMPL::receive_(int source,
+                                                                  int tag) {
+    // N.B. A matched probe, so no other thread can receive the message
+    //      between probing for it and receiving it
+    MPI_Message message;
+    MPI_Status status;
+    MPI_Mprobe(source, tag, m_comm_, &message, &status);
+    int n = 0;
+    MPI_Get_count(&status, MPI_BYTE, &n);
+    binary_type rv(n, '\0');
+    MPI_Mrecv(rv.data(), n, MPI_BYTE, &message, MPI_STATUS_IGNORE);
+    return rv;
+}
+
+void DistributedPIMPL::send_(const binary_type& message, int dest, int tag,
+                             MPI_Comm comm) {
+    if(message.size() > static_cast<std::size_t>(INT_MAX))
+        throw std::runtime_error("Values larger than 2 GB can not be sent to "
+                                 "other ranks");
+    const auto n = static_cast<int>(message.size());
+    MPI_Send(message.data(), n, MPI_BYTE, dest, tag, comm);
+}
+
+void DistributedPIMPL::serve_() {
+    while(true) {
+        // N.B. Blocks until a request arrives
+        MPI_Message message;
+        MPI_Status status;
+        MPI_Mprobe(MPI_ANY_SOURCE, request_tag_, m_request_comm_, &message,
+                   &status);
+
+        int n = 0;
+        MPI_Get_count(&status, MPI_BYTE, &n);
+        binary_type request(n, '\0');
+        MPI_Mrecv(request.data(), n, MPI_BYTE, &message, MPI_STATUS_IGNORE);
+        if(static_cast<Operation>(request[0]) == Operation::stop) return;
+
+        int tag = 0;
+        std::memcpy(&tag, request.data() + 1, sizeof(tag));
+        send_(handle_(request), status.MPI_SOURCE, tag, m_comm_);
+    }
+}
+
+typename DistributedPIMPL::binary_type DistributedPIMPL::handle_(
+  const binary_type& message) {
+    const auto op     = static_cast<Operation>(message[0]);
+    const auto offset = 1 + sizeof(int) + sizeof(std::uint64_t);
+    std::uint64_t key_size = 0;
+    std::memcpy(&key_size, message.data() + 1 + sizeof(int), sizeof(key_size));
+    binary_type key = message.substr(offset, key_size);
+
+    lock_type lock(m_mutex_);
+    switch(op) {
+        case Operation::count: return m_local_->count(key) ? "1" : "0";
+        case Operation::insert:
+            m_local_->insert(std::move(key), message.substr(offset + key_size));
+            return {};
+        case Operation::free: m_local_->free(key); return {};
+        case Operation::at: {
+            auto value = m_local_->try_at(key);
+            if(!value.has_value()) return "0";
+            return "1" + value.get();
+        }
+        case Operation::stop: break; // Handled by serve_
+    }
+    return {};
+}
+
+} // namespace detail_
+
+Distributed::Distributed(const runtime_type& runtime, local_db_pointer local) :
+  m_pimpl_(std::make_unique<pimpl_type>(runtime.mpi_comm(), std::move(local))) {
+}
+
+Distributed::~Distributed() noexcept = default;
+
+typename Distributed::size_type Distributed::rank() const noexcept {
+    return m_pimpl_->rank();
+}
+
+typename Distributed::size_type Distributed::size() const noexcept {
+    return m_pimpl_->size();
+}
+
+typename Distributed::size_type Distributed::owner(
+  const_key_reference key) const noexcept {
+    return m_pimpl_->owner(key);
+}
+
+bool Distributed::count_(const_key_reference key) const noexcept {
+    try {
+        return m_pimpl_->count(key);
+    } catch(...) { return false; }
+}
+
+void Distributed::insert_(key_type key, mapped_type value) {
+    m_pimpl_->insert(std::move(key), std::move(value));
+}
+
+void Distributed::free_(const_key_reference key) { m_pimpl_->free(key); }
+
+typename Distributed::const_mapped_reference Distributed::at_(
+  const_key_reference key) const {
+    auto rv = try_at_(key);
+    if(rv.has_value()) return rv;
+    throw std::out_of_range("Key was not found in the database");
+}
+
+typename Distributed::const_mapped_reference Distributed::try_at_(
+  const_key_reference key) const {
+    auto value = m_pimpl_->try_at(key);
+    if(!value) return const_mapped_reference{};
+    return const_mapped_reference(std::move(*value));
+}
+
+void Distributed::backup_() { m_pimpl_->backup(); }
+
+void Distributed::dump_() { m_pimpl_->dump(); }
+
+std::size_t Distributed::memory_footprint_() const noexcept {
+    return m_pimpl_->memory_footprint();
+}
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "database_api.hpp"
+#include <memory>
+#include <parallelzone/runtime/runtime_view.hpp>
+#include <string>
+
+namespace pluginplay::cache::database {
+namespace detail_ {
+class DistributedPIMPL;
+} // namespace detail_
+
+/** @brief A binary database spread over the ranks of a runtime.
+ *
+ *  Each key is owned by exactly one rank, which is found by hashing the key's
+ *  bytes. The owner stores the key/value pair in its local database; the
+ *  other ranks forward their lookups and inserts for the key to the owner.
+ *  Hence all ranks see one logical database, but each value lives in the
+ *  memory of only one rank.
+ *
+ *  Like RocksDB, this class stores binary keys and values and is meant to be
+ *  wrapped in a Serialized layer. Since the owner is found from the
+ *  serialized key, keys should serialize to the same bytes on every rank
+ *  (for the caches, this means using content-addressed UUIDs).
+ *
+ *  To answer requests while the rank's own threads are busy, each rank runs
+ *  a thread which serves the requests of the other ranks. That thread makes
+ *  MPI calls concurrently with the rest of the program, so if the runtime
+ *  has more than one rank, MPI must have been initialized with
+ *  MPI_THREAD_MULTIPLE. The thread blocks in MPI until a request arrives, so
+ *  requests are answered as soon as they come in.
+ *
+ *  N.B. Constructing and destroying instances are collective operations:
+ *       every rank of the runtime must construct (destroy) its instance, in
+ *       the same order relative to other collective operations. Destruction
+ *       waits until every rank is done using the database.
+ */
+class Distributed : public DatabaseAPI<std::string, std::string> {
+private:
+    /// Type this class implements
+    using base_type = DatabaseAPI<std::string, std::string>;
+
+public:
+    /// Type of the keys and values
+    using binary_type = std::string;
+
+    /// Type of the runtime the database is spread over
+    using runtime_type = parallelzone::runtime::RuntimeView;
+
+    /// Type used for ranks and numbers of ranks
+    using size_type = std::size_t;
+
+    /// Type of the database holding the key/value pairs this rank owns
+    using local_db_type = base_type;
+
+    /// Type of a pointer to the local database
+    using local_db_pointer = std::unique_ptr<local_db_type>;
+
+    /// Typedef of binary_type
+    using base_type::key_type;
+
+    /// Type of a container of keys
+    using base_type::key_set_type;
+
+    /// Typedef of const binary_type&
+    using base_type::const_key_reference;
+
+    /// Typedef of binary_type
+    using base_type::mapped_type;
+
+    /// Type of an object holding a read-only value
+    using base_type::const_mapped_reference;
+
+    /** @brief Spreads a new, empty database over the ranks of @p runtime.
+     *
+     *  This is a collective operation.
+     *
+     *  @param[in] runtime The ranks the database is spread over.
+     *  @param[in] local Where this rank stores the key/value pairs it owns.
+     *                   Defaults to an in-memory database.
+     *
+     *  @throw std::runtime_error if @p runtime has more than one rank and
+     *                            MPI does not support MPI_THREAD_MULTIPLE.
+     */
+    explicit Distributed(const runtime_type& runtime,
+                         local_db_pointer local = {});
+
+    /// Deleted because the database is a collective resource
+    Distributed(const Distributed&) = delete;
+
+    /// Deleted because the database is a collective resource
+    Distributed& operator=(const Distributed&) = delete;
+
+    /** @brief Waits for all ranks to be done, then stops serving requests.
+     *
+     *  This is a collective operation.
+     *
+     *  @throw None No throw guarantee.
+     */
+    ~Distributed() noexcept override;
+
+    /// The rank of the current process
+    size_type rank() const noexcept;
+
+    /// The number of ranks the database is spread over
+    size_type size() const noexcept;
+
+    /** @brief Determines which rank stores @p key.
+     *
+     *  @param[in] key The key we want the owner of.
+     *
+     *  @return The rank storing @p key. Every rank agrees on it.
+     *
+     *  @throw None No throw guarantee.
+     */
+    size_type owner(const_key_reference key) const noexcept;
+
+protected:
+    /// Asks the owner of @p key if it has @p key
+    bool count_(const_key_reference key) const noexcept override;
+
+    /// Sends @p key and @p value to the owner of @p key
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Asks the owner of @p key to free it
+    void free_(const_key_reference key) override;
+
+    /// Gets the value of @p key from its owner, throws if it has none
+    const_mapped_reference at_(const_key_reference key) const override;
+
+    /// Gets the value of @p key from its owner in one round trip
+    const_mapped_reference try_at_(const_key_reference key) const override;
+
+    /// Backs up the key/value pairs this rank owns
+    void backup_() override;
+
+    /// Dumps the key/value pairs this rank owns
+    void dump_() override;
+
+    /// The memory used by the key/value pairs this rank owns
+    std::size_t memory_footprint_() const noexcept override;
+
+private:
+    /// Type of the object implementing this class
+    using pimpl_type = detail_::DistributedPIMPL;
+
+    /// The object implementing this class
+    std::unique_ptr<pimpl_type> m_pimpl_;
+};
+
+} // namespace pluginplay::cache::database
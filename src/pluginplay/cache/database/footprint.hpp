@@ -0,0 +1,49 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <cstddef>
+#include <pluginplay/any/any.hpp>
+#include <pluginplay/fields/fields.hpp>
+#include <pluginplay/types.hpp>
+
+namespace pluginplay::cache::database {
+
+/** @brief How many bytes a result map occupies.
+ *
+ *  This includes the keys and the values the results wrap (see
+ *  AnyField::memory_footprint). It is what Bounded databases holding results
+ *  report to their MemoryBudget, and what ModuleCache reports as the bytes
+ *  inserted.
+ *
+ *  @param[in] results The result map to size.
+ *
+ *  @return The number of bytes @p results occupies.
+ *
+ *  @throw None No throw guarantee.
+ */
+inline std::size_t result_map_footprint(const type::result_map& results) {
+    using any_field = any::AnyField;
+    std::size_t rv  = sizeof(type::result_map);
+    for(const auto& [k, v] : results) {
+        rv += sizeof(typename type::result_map::value_type) + k.capacity();
+        if(v.has_value()) rv += sizeof(any_field) + v.memory_footprint();
+    }
+    return rv;
+}
+
+} // namespace pluginplay::cache::database
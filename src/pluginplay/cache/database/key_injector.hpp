@@ -119,6 +119,15 @@ protected:
     /// just calls m_db_->dump
     void dump_() override { m_db_->dump(); }
 
+    /// just calls m_db_->begin_batch
+    void begin_batch_() override { m_db_->begin_batch(); }
+
+    /// just calls m_db_->commit_batch
+    void commit_batch_() override { m_db_->commit_batch(); }
+
+    /// just calls m_db_->abort_batch
+    void abort_batch_() override { m_db_->abort_batch(); }
+
 private:
     /// Wraps the process of injecting the key/value pair into @p key
     key_type inject_(key_type key) const;
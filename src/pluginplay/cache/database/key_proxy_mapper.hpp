@@ -15,6 +15,7 @@
  */
 
 #pragma once
+#include "../cache_metrics.hpp"
 #include "../proxy_map_maker.hpp"
 #include "database_api.hpp"
 
@@ -52,6 +53,9 @@ public:
     /// Type of an object holding a read-only reference to a value
     using typename base_type::const_mapped_reference;
 
+    /// Type of the callback used by find_or_compute
+    using typename base_type::compute_function;
+
     /// Type the ProxyMapMaker used for assigning proxies
     using proxy_map_maker = ProxyMapMaker<key_type>;
 
@@ -67,6 +71,9 @@ public:
     /// Type of a pointer to the database we wrap
     using sub_db_pointer = std::unique_ptr<sub_db_type>;
 
+    /// Type of a pointer to the object recording the metrics
+    using metrics_pointer = std::shared_ptr<cache::detail_::CacheMetrics>;
+
     /** @brief Creates a new KeyProxyMapper with the provided state.
      *
      *  @param[in] proxy_mapper A non-null pointer to the ProxyMapMaker instance
@@ -75,8 +82,12 @@ public:
      *  @param[in] sub_db A non-null pointer to a database satisfying the API
      *                    `sub_db_type`. This is the database where the proxy
      *                    map to value relationships will be stored.
+     *  @param[in] metrics Where to record the time spent proxying keys and
+     *                     the time spent in @p sub_db. If null, nothing is
+     *                     recorded.
      */
-    KeyProxyMapper(proxy_map_maker_pointer proxy_mapper, sub_db_pointer sub_db);
+    KeyProxyMapper(proxy_map_maker_pointer proxy_mapper, sub_db_pointer sub_db,
+                   metrics_pointer metrics = {});
 
 protected:
     /// Returns the keys in the wrapped proxy_mapper
@@ -94,18 +105,49 @@ protected:
     /// Uses proxy_mapper to map key, before calling sub_db
     const_mapped_reference at_(const_key_reference key) const override;
 
+    /// Proxies key once, then calls try_at on sub_db
+    const_mapped_reference try_at_(const_key_reference key) const override;
+
+    /// Proxies key once, reusing the proxy for the look up and the insert.
+    /// The writes of a miss are grouped into one batch.
+    const_mapped_reference find_or_compute_(
+      const_key_reference key, const compute_function& fxn) override;
+
     /// Just calls backup on both proxy_mapper and sub_db
     void backup_() override;
 
     /// backs proxy_mapper up and dumps sub_db
     void dump_() override;
 
+    /// Calls begin_batch on both proxy_mapper and sub_db
+    void begin_batch_() override;
+
+    /// Calls commit_batch on both proxy_mapper and sub_db
+    void commit_batch_() override;
+
+    /// Calls abort_batch on both proxy_mapper and sub_db
+    void abort_batch_() override;
+
+    /// Footprint of sub_db (the proxy maps are not counted)
+    std::size_t memory_footprint_() const noexcept override;
+
 private:
+    /// Calls @p fxn, timing it as proxying if we're recording metrics
+    template<typename FxnType>
+    decltype(auto) proxy_(FxnType&& fxn) const;
+
+    /// Calls @p fxn, timing it as backend time if we're recording metrics
+    template<typename FxnType>
+    decltype(auto) backend_(FxnType&& fxn) const;
+
     /// Used to map keys to proxy maps
     proxy_map_maker_pointer m_proxy_mapper_;
 
     /// Stores proxy map to value relationships
     sub_db_pointer m_sub_db_;
+
+    /// Where metrics are recorded (may be null)
+    metrics_pointer m_metrics_;
 };
 
 } // namespace pluginplay::cache::database
@@ -22,8 +22,11 @@ namespace pluginplay::cache ::database {
 
 TPARAMS
 KEY_PROXY_MAPPER::KeyProxyMapper(proxy_map_maker_pointer proxy_mapper,
-                                 sub_db_pointer sub_db) :
-  m_proxy_mapper_(std::move(proxy_mapper)), m_sub_db_(std::move(sub_db)) {
+                                 sub_db_pointer sub_db,
+                                 metrics_pointer metrics) :
+  m_proxy_mapper_(std::move(proxy_mapper)),
+  m_sub_db_(std::move(sub_db)),
+  m_metrics_(std::move(metrics)) {
     if(m_proxy_mapper_ && m_sub_db_) return;
     throw std::runtime_error("Expected non-null databases");
 }
@@ -36,26 +39,67 @@ typename KEY_PROXY_MAPPER::key_set_type KEY_PROXY_MAPPER::keys_() const {
 TPARAMS
 bool KEY_PROXY_MAPPER::count_(const_key_reference key) const noexcept {
     // Each part of key needs to be in proxy_mapper or it can't be in sub_db
-    if(!m_proxy_mapper_->count(key)) return false;
-    // TODO: I think the at call can throw
-    return m_sub_db_->count(m_proxy_mapper_->at(key));
+    // TODO: I think the try_at call can throw
+    auto proxy = proxy_([&]() { return m_proxy_mapper_->try_at(key); });
+    return proxy && backend_([&]() { return m_sub_db_->count(*proxy); });
 }
 
 TPARAMS
 void KEY_PROXY_MAPPER::insert_(key_type key, mapped_type value) {
-    m_proxy_mapper_->insert(key);
-    m_sub_db_->insert(m_proxy_mapper_->at(key), std::move(value));
+    auto proxy = proxy_([&]() { return m_proxy_mapper_->insert(key); });
+    backend_([&]() { m_sub_db_->insert(std::move(proxy), std::move(value)); });
 }
 
 TPARAMS
 void KEY_PROXY_MAPPER::free_(const_key_reference key) {
-    m_sub_db_->free(m_proxy_mapper_->at(key));
+    auto proxy = proxy_([&]() { return m_proxy_mapper_->at(key); });
+    backend_([&]() { m_sub_db_->free(proxy); });
 }
 
 TPARAMS
 typename KEY_PROXY_MAPPER::const_mapped_reference KEY_PROXY_MAPPER::at_(
   const_key_reference key) const {
-    return m_sub_db_->at(m_proxy_mapper_->at(key));
+    auto proxy = proxy_([&]() { return m_proxy_mapper_->at(key); });
+    return backend_([&]() { return m_sub_db_->at(proxy); });
+}
+
+TPARAMS
+typename KEY_PROXY_MAPPER::const_mapped_reference KEY_PROXY_MAPPER::try_at_(
+  const_key_reference key) const {
+    auto proxy = proxy_([&]() { return m_proxy_mapper_->try_at(key); });
+    if(!proxy) return const_mapped_reference{};
+    return backend_([&]() { return m_sub_db_->try_at(*proxy); });
+}
+
+TPARAMS
+typename KEY_PROXY_MAPPER::const_mapped_reference
+KEY_PROXY_MAPPER::find_or_compute_(const_key_reference key,
+                                   const compute_function& fxn) {
+    auto proxy = proxy_([&]() { return m_proxy_mapper_->try_at(key); });
+    if(proxy) {
+        auto rv = backend_([&]() { return m_sub_db_->try_at(*proxy); });
+        if(rv.has_value()) return rv;
+    }
+
+    // Only assign proxies once fxn has succeeded. If every part of key
+    // already had one, the proxy we looked up is reused as is
+    auto value = fxn();
+
+    // The proxies of the inputs, the results, and anything evicted to make
+    // room for them are written to long-term storage together (or not at all)
+    BatchScope batch(*this);
+    auto new_proxy = proxy_([&]() {
+        if(proxy) return m_proxy_mapper_->insert(key, std::move(*proxy));
+        return m_proxy_mapper_->insert(key);
+    });
+
+    // N.B. if a value was stored under key while fxn ran (possible if our
+    //      caller released its lock, see Synchronized), we return that value
+    auto rv = backend_([&]() {
+        return m_sub_db_->try_insert(std::move(new_proxy), std::move(value));
+    });
+    batch.commit();
+    return rv;
 }
 
 TPARAMS
@@ -72,6 +116,43 @@ void KEY_PROXY_MAPPER::dump_() {
     m_sub_db_->dump();
 }
 
+TPARAMS
+std::size_t KEY_PROXY_MAPPER::memory_footprint_() const noexcept {
+    return m_sub_db_->memory_footprint();
+}
+
+TPARAMS
+void KEY_PROXY_MAPPER::begin_batch_() {
+    m_proxy_mapper_->begin_batch();
+    m_sub_db_->begin_batch();
+}
+
+TPARAMS
+void KEY_PROXY_MAPPER::commit_batch_() {
+    m_sub_db_->commit_batch();
+    m_proxy_mapper_->commit_batch();
+}
+
+TPARAMS
+void KEY_PROXY_MAPPER::abort_batch_() {
+    m_sub_db_->abort_batch();
+    m_proxy_mapper_->abort_batch();
+}
+
+TPARAMS
+template<typename FxnType>
+decltype(auto) KEY_PROXY_MAPPER::proxy_(FxnType&& fxn) const {
+    if(!m_metrics_) return fxn();
+    return m_metrics_->time_proxy(std::forward<FxnType>(fxn));
+}
+
+TPARAMS
+template<typename FxnType>
+decltype(auto) KEY_PROXY_MAPPER::backend_(FxnType&& fxn) const {
+    if(!m_metrics_) return fxn();
+    return m_metrics_->time_backend(std::forward<FxnType>(fxn));
+}
+
 #undef KEY_PROXY_MAPPER
 #undef TPARAMS
 
@@ -37,6 +37,11 @@ struct MakeAny<ModuleResult> {
         using shared_any = typename ModuleResult::shared_any;
         return *v.template value<shared_any>();
     }
+
+    // N.B. results don't store their descriptions, so they're lost
+    static ModuleResult revert(const any::AnyField& v) {
+        return ModuleResult(std::make_shared<const any::AnyField>(v));
+    }
 };
 
 } // namespace pluginplay::cache::database
@@ -0,0 +1,296 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <pluginplay/cache/module_manager_cache.hpp>
+#include <set>
+#include <utility>
+
+namespace pluginplay::cache::database {
+
+/** @brief API for databases whose entries a MemoryBudget may evict.
+ *
+ *  Each entry of an Evictable database has a priority. When the budget is
+ *  exceeded, the entry with the lowest priority across all of the databases
+ *  sharing the budget is evicted first. Priorities are computed by the
+ *  databases using MemoryBudget::priority, so they are comparable across
+ *  databases.
+ */
+class Evictable {
+public:
+    /// Type used for sizes
+    using size_type = std::size_t;
+
+    /// Type of a priority
+    using priority_type = double;
+
+    /// No-op polymorphic dtor
+    virtual ~Evictable() noexcept = default;
+
+    /** @brief Returns the lowest priority of the entries which can be evicted.
+     *
+     *  @param[out] priority Set to the lowest priority, if there is an entry
+     *                       which can be evicted.
+     *
+     *  @return True if there is an entry which can be evicted and false
+     *          otherwise.
+     *
+     *  @throw None No throw guarantee.
+     */
+    virtual bool lowest_priority(priority_type& priority) const noexcept = 0;
+
+    /** @brief Evicts the entry with the lowest priority.
+     *
+     *  @return The number of bytes which were freed.
+     *
+     *  @throw ??? Throws if moving the entry to long-term storage throws.
+     */
+    virtual size_type evict_lowest() = 0;
+};
+
+/** @brief Tracks the memory used by a set of databases and evicts from them
+ *         when they use too much.
+ *
+ *  A MemoryBudget is shared by the databases it governs (in practice all of the
+ *  module caches made by a DatabaseFactory). The databases report the sizes of
+ *  the entries they add and remove, and, after adding entries, ask the budget
+ *  to reclaim memory. If more than `limit()` bytes are in use, reclaim evicts
+ *  entries, lowest priority first, until the usage is back under the limit.
+ *
+ *  How priorities are computed depends on the policy:
+ *
+ *  - EvictionPolicy::lru. The priority is a counter which is bumped whenever an
+ *    entry is used, i.e., the least recently used entry is evicted first.
+ *  - EvictionPolicy::cost_aware. The "GreedyDual-Size" algorithm is used: the
+ *    priority is the time it took to compute the entry divided by its size,
+ *    plus an inflation value. Every eviction raises the inflation value to the
+ *    priority of the evicted entry, so entries which have not been used
+ *    recently eventually lose to new entries, no matter how expensive they
+ *    were.
+ *
+ *  The time it took to compute an entry is handed to the database through
+ *  set_recompute_cost (see below) since the database API has no other way to
+ *  pass it along.
+ *
+ *  A limit of zero means there is no limit. Usage is always tracked.
+ *
+ *  N.B. reclaim holds the budget's mutex while calling into the databases.
+ *       Databases must not register or unregister while holding a lock which
+ *       evicting from them requires.
+ */
+class MemoryBudget {
+public:
+    /// Type used for sizes
+    using size_type = Evictable::size_type;
+
+    /// Type of a priority
+    using priority_type = Evictable::priority_type;
+
+    /// Type of the eviction policy
+    using policy_type = EvictionPolicy;
+
+    /** @brief Makes a new budget.
+     *
+     *  @param[in] limit The maximum number of bytes which may be used. Zero,
+     *                   the default, means there is no limit.
+     *  @param[in] policy How to decide what to evict. Defaults to LRU.
+     *
+     *  @throw None No throw guarantee.
+     */
+    explicit MemoryBudget(size_type limit     = 0,
+                          policy_type policy = policy_type::lru) noexcept :
+      m_limit_(limit), m_policy_(policy) {}
+
+    /// The maximum number of bytes which may be used (0 means no limit)
+    size_type limit() const noexcept { return m_limit_; }
+
+    /// The eviction policy
+    policy_type policy() const noexcept { return m_policy_; }
+
+    /// The number of bytes currently in use
+    size_type used() const noexcept { return m_used_; }
+
+    /** @brief Changes the limit and the policy.
+     *
+     *  The new limit is enforced the next time reclaim is called. Changing the
+     *  policy only affects priorities computed after the change.
+     *
+     *  @param[in] limit The new maximum number of bytes (0 means no limit).
+     *  @param[in] policy The new eviction policy.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void set_limit(size_type limit, policy_type policy) noexcept {
+        m_limit_  = limit;
+        m_policy_ = policy;
+    }
+
+    /// Records that @p n more bytes are in use
+    void add(size_type n) noexcept { m_used_ += n; }
+
+    /// Records that @p n fewer bytes are in use
+    void remove(size_type n) noexcept { m_used_ -= n; }
+
+    /** @brief Computes the priority of an entry which was just used.
+     *
+     *  @param[in] size The size of the entry, in bytes.
+     *  @param[in] cost How long the entry took to compute, in seconds.
+     *
+     *  @return The priority the entry should now have.
+     *
+     *  @throw None No throw guarantee.
+     */
+    priority_type priority(size_type size, double cost) noexcept {
+        if(m_policy_ == policy_type::lru) return ++m_clock_;
+        return m_inflation_.load() + cost / std::max<size_type>(size, 1);
+    }
+
+    /** @brief Adds @p db to the databases which memory is reclaimed from.
+     *
+     *  @param[in] db The database to add. Must remain alive until it is
+     *                unregistered.
+     *
+     *  @throw std::bad_alloc if there is a problem adding @p db. Strong throw
+     *                        guarantee.
+     */
+    void register_db(Evictable* db) {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        m_dbs_.insert(db);
+    }
+
+    /// Removes @p db from the databases which memory is reclaimed from
+    void unregister_db(Evictable* db) noexcept {
+        std::lock_guard<std::mutex> lock(m_mutex_);
+        m_dbs_.erase(db);
+    }
+
+    /** @brief Evicts entries until the memory in use is under the limit.
+     *
+     *  If the limit can not be satisfied (e.g., a single entry is bigger than
+     *  the limit), entries are evicted until there are no more entries which
+     *  can be evicted.
+     *
+     *  The limit is "soft". If another thread is already reclaiming memory
+     *  this call returns immediately, trusting the other thread to bring the
+     *  usage down (it checks the usage after every eviction). Likewise, if
+     *  evicting an entry inserts into a database governed by *this (e.g., an
+     *  evicted result is moved into the database holding inputs and results),
+     *  the nested call returns immediately. This also means callers may hold
+     *  locks when calling reclaim without risking a deadlock.
+     *
+     *  @throw ??? Throws if evicting an entry throws. Basic throw guarantee.
+     */
+    void reclaim() {
+        if(m_limit_ == 0 || m_used_ <= m_limit_) return;
+        auto& reclaiming = reclaiming_();
+        if(reclaiming) return;
+        std::unique_lock<std::mutex> lock(m_mutex_, std::try_to_lock);
+        if(!lock.owns_lock()) return;
+
+        reclaiming = true;
+        try {
+            while(m_limit_ != 0 && m_used_ > m_limit_) {
+                if(!evict_one_()) break;
+            }
+        } catch(...) {
+            reclaiming = false;
+            throw;
+        }
+        reclaiming = false;
+    }
+
+    /** @brief Records how long the value about to be inserted took to compute.
+     *
+     *  The value is stored per thread and is consumed by the next database on
+     *  this thread to call take_recompute_cost (i.e., the database the value
+     *  is inserted into).
+     *
+     *  @param[in] seconds How long the value took to compute.
+     *
+     *  @throw None No throw guarantee.
+     */
+    static void set_recompute_cost(double seconds) noexcept {
+        recompute_cost_() = seconds;
+    }
+
+    /** @brief Returns, and then resets, the value set by set_recompute_cost.
+     *
+     *  @return The cost set on this thread, or 0 if none was set.
+     *
+     *  @throw None No throw guarantee.
+     */
+    static double take_recompute_cost() noexcept {
+        return std::exchange(recompute_cost_(), 0.0);
+    }
+
+private:
+    /// Evicts the lowest priority entry (caller must hold m_mutex_)
+    bool evict_one_() {
+        Evictable* victim = nullptr;
+        priority_type lowest{};
+        for(auto* db : m_dbs_) {
+            priority_type p;
+            if(!db->lowest_priority(p)) continue;
+            if(victim && p >= lowest) continue;
+            victim = db;
+            lowest = p;
+        }
+        if(!victim) return false;
+        if(m_policy_ == policy_type::cost_aware) m_inflation_ = lowest;
+        victim->evict_lowest();
+        return true;
+    }
+
+    /// Is the calling thread reclaiming memory?
+    static bool& reclaiming_() noexcept {
+        static thread_local bool reclaiming = false;
+        return reclaiming;
+    }
+
+    /// The calling thread's recompute cost
+    static double& recompute_cost_() noexcept {
+        static thread_local double cost = 0.0;
+        return cost;
+    }
+
+    /// The maximum number of bytes which may be used
+    std::atomic<size_type> m_limit_;
+
+    /// How to choose what to evict
+    std::atomic<policy_type> m_policy_;
+
+    /// The number of bytes in use
+    std::atomic<size_type> m_used_{0};
+
+    /// Counter used for LRU priorities
+    std::atomic<std::uint64_t> m_clock_{0};
+
+    /// The GreedyDual-Size inflation value
+    std::atomic<priority_type> m_inflation_{0.0};
+
+    /// Guards m_dbs_ and serializes reclaiming
+    std::mutex m_mutex_;
+
+    /// The databases we can evict from
+    std::set<Evictable*> m_dbs_;
+};
+
+} // namespace pluginplay::cache::database
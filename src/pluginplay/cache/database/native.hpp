@@ -118,12 +118,24 @@ protected:
     /// Calls at on the wrapped map
     const_mapped_reference at_(const_key_reference key) const override;
 
+    /// Looks up key with a single find
+    const_mapped_reference try_at_(const_key_reference key) const override;
+
     /// If a backup database was set, pushes keys to it
     void backup_() override;
 
     /// Calls backup then clear on m_map_
     void dump_() override;
 
+    /// If a backup database was set, calls begin_batch on it
+    void begin_batch_() override;
+
+    /// If a backup database was set, calls commit_batch on it
+    void commit_batch_() override;
+
+    /// If a backup database was set, calls abort_batch on it
+    void abort_batch_() override;
+
 private:
     /// The key/values the user gave to us
     map_type m_map_;
@@ -55,10 +55,20 @@ typename NATIVE::const_mapped_reference NATIVE::at_(
     return const_mapped_reference(&m_map_.at(key));
 }
 
+TPARAMS
+typename NATIVE::const_mapped_reference NATIVE::try_at_(
+  const_key_reference key) const {
+    auto itr = m_map_.find(key);
+    if(itr == m_map_.end()) return const_mapped_reference{};
+    return const_mapped_reference(&itr->second);
+}
+
 TPARAMS
 void NATIVE::backup_() {
     if(!m_backup_) return;
+    BatchScope<backup_db_type> batch(*m_backup_);
     for(const auto& [k, v] : m_map_) m_backup_->insert(k, v);
+    batch.commit();
 }
 
 TPARAMS
@@ -67,6 +77,21 @@ void NATIVE::dump_() {
     m_map_.clear();
 }
 
+TPARAMS
+void NATIVE::begin_batch_() {
+    if(m_backup_) m_backup_->begin_batch();
+}
+
+TPARAMS
+void NATIVE::commit_batch_() {
+    if(m_backup_) m_backup_->commit_batch();
+}
+
+TPARAMS
+void NATIVE::abort_batch_() {
+    if(m_backup_) m_backup_->abort_batch();
+}
+
 #undef NATIVE
 #undef TPARAMS
 
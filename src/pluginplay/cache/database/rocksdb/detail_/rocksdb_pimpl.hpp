@@ -15,7 +15,23 @@
  */
 
 #include "../rocksdb.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <rocksdb/cache.h>
 #include <rocksdb/db.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/table.h>
+#include <rocksdb/utilities/write_batch_with_index.h>
+#include <set>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
 namespace pluginplay::cache::database::detail_ {
 
 /** @brief Implements the RocksDB class when RocksDB support is enabled.
@@ -30,7 +46,36 @@ namespace pluginplay::cache::database::detail_ {
  *  data is stored in the database as a string we can circumvent this problem
  *  by splitting the value into smaller chunks. The splitting and reassembling
  *  of values happens automatically and users of this database should act as if
- *  it doesn't happen.
+ *  it doesn't happen. The chunks live in their own column family under keys
+ *  made of the chunk's index (8 bytes, big endian) followed by the value's
+ *  key. A third column family maps the value's key to its "manifest", i.e.,
+ *  the value's size and number of chunks (8 bytes each, big endian). Since all
+ *  of this is stored in the database, chunked values survive restarts.
+ *
+ *  When a value is replaced or freed the manifest is removed before the
+ *  chunks, and when a value is written the manifest is written after the
+ *  chunks. Hence, if the program dies part way through, the value is
+ *  either fully readable or missing (the leftover chunks are unreachable).
+ *
+ *  While a batch is open (see begin_batch) writes are staged in a
+ *  rocksdb::WriteBatchWithIndex and written with a single call to
+ *  `DB::Write` when the batch is committed. The index lets reads see the
+ *  staged writes. Batches belong to the thread which opened them: each
+ *  thread stages its writes in its own batch, other threads neither see
+ *  them nor write into them, and a thread without an open batch writes
+ *  straight to the database.
+ *
+ *  If RocksDBOptions::shared is set, the path is a directory of databases,
+ *  named "writer-0", "writer-1", etc. This instance writes to the first one
+ *  whose lock is free (each writer's database is locked by RocksDB while it
+ *  is open), and reads the others through secondary instances. Reads which
+ *  miss in our database try the secondaries. Looking for new writers and
+ *  having the secondaries catch up with their writers (tailing their logs)
+ *  reads from disk, so it is done at most once per
+ *  RocksDBOptions::peer_refresh_ms, by whichever miss finds it due; errors
+ *  doing so are ignored until the next time. Writes (including free) only
+ *  ever touch our database, so a value freed here may still be found in
+ *  another writer's database.
  */
 class RocksDBPIMPL {
 public:
@@ -40,6 +85,9 @@ public:
     /// Type of a read-only reference to a file path
     using const_path_reference = typename parent_type::const_path_reference;
 
+    /// Type of the tuning options
+    using config_type = typename parent_type::config_type;
+
     /// Type used for database keys
     using key_type = typename parent_type::key_type;
 
@@ -54,6 +102,9 @@ public:
 
     using const_mapped_reference = typename parent_type::const_mapped_reference;
 
+    /// Type of a container holding all of the keys in the database
+    using key_set_type = typename parent_type::key_set_type;
+
     /** @brief Creates (or opens) a RocksDB database with the specified path
      *
      *  This Ctor is used to open an existing database (if @p path already
@@ -63,22 +114,37 @@ public:
      *  if the backend can not create the database. If this call is sucessful
      *  then the database is ready for business.
      *
-     *  At the moment, construction uses the default RocksDB options for the
-     *  database. No tuning has been performed.
+     *  The RocksDB options are set from @p config; anything @p config leaves
+     *  at its default is left at RocksDB's default.
      *
      *  @param[in] path For new databases this is where the database should
      *                  live, for existing databases this is where it lives.
+     *  @param[in] config How to tune the database. See RocksDBOptions.
      *
      *  @throws None No throw guarantee. At the moment, if an error occurs an
      *               assertion is tripped.
      */
-    explicit RocksDBPIMPL(const_path_reference path);
+    explicit RocksDBPIMPL(const_path_reference path,
+                          const config_type& config = {});
+
+    /** @brief Returns the keys in the database.
+     *
+     *  The keys are found by iterating over the column families holding
+     *  unchunked values and manifests, so the values are not read. In shared
+     *  mode, the keys of the other writers' databases are included as well.
+     *
+     *  @return The keys, in lexicographical order.
+     *
+     *  @throw std::runtime_error if the database can't be iterated over.
+     */
+    key_set_type keys() const;
 
     /** @brief Returns the number of times a key appears in the database.
      *
      *  Keys either appear or don't appear in a RocksDB database. Meaning, this
      *  method will return true if @p key appears in the database and false
-     *  otherwise.
+     *  otherwise. The value is not copied out of RocksDB, and the bloom
+     *  filters usually rule out missing keys without reading from disk.
      *
      *  @param[in] key The key we are looking for.
      *
@@ -134,6 +200,83 @@ public:
      */
     const_mapped_reference at(const_key_reference key) const;
 
+    /** @brief Adds a new entry whose value is read from a stream.
+     *
+     *  The value is read, and written to the database, a chunk at a time. So,
+     *  unlike insert, the full value never needs to be in memory (unless a
+     *  batch is open, in which case the batch holds the staged chunks).
+     *
+     *  @param[in] key The label for the new entry.
+     *  @param[in] is The stream to read the value from. Read until its end.
+     *
+     *  @throw std::runtime_error if there is a problem writing to the
+     *                            database. The entry is left unset.
+     */
+    void write_stream(key_type key, std::istream& is);
+
+    /** @brief Writes the value associated with @p key to a stream.
+     *
+     *  The value is written a chunk at a time, so the full value never needs
+     *  to be in memory.
+     *
+     *  @param[in] key The label of the value to retrieve.
+     *  @param[in] os The stream to write the value to.
+     *
+     *  @throw std::out_of_range if @p key is not in the database. Strong throw
+     *                           guarantee.
+     *  @throw std::runtime_error if a chunk is missing. Nothing is known about
+     *                            the state of @p os.
+     */
+    void read_stream(const_key_reference key, std::ostream& os) const;
+
+    /** @brief Calls @p fxn with a view of the value associated with @p key.
+     *
+     *  Values which aren't chunked are read into a rocksdb::PinnableSlice, so
+     *  the view refers to RocksDB's memory and nothing is copied. Chunked
+     *  values are reassembled into a buffer first.
+     *
+     *  @param[in] key The label of the value to view.
+     *  @param[in] fxn Called with a std::string_view of the value. The view is
+     *                 only valid during the call.
+     *
+     *  @return True if @p key is in the database and false otherwise.
+     *
+     *  @throw std::runtime_error if a chunk is missing.
+     *  @throw ??? Throws if @p fxn throws. Same throw guarantee.
+     */
+    template<typename FxnType>
+    bool view(const_key_reference key, FxnType&& fxn) const;
+
+    /** @brief Starts staging the calling thread's writes in a batch.
+     *
+     *  Batches nest; writes are staged until the outermost batch is
+     *  committed. Only the calling thread's writes are staged.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the batch.
+     *                        Strong throw guarantee.
+     */
+    void begin_batch();
+
+    /** @brief Ends the calling thread's batch, writing the staged writes if
+     *         it is the outermost.
+     *
+     *  If one of the batches nested in the outermost one was aborted, the
+     *  staged writes are discarded instead.
+     *
+     *  @throw std::runtime_error if the calling thread has no open batch, or
+     *                            if RocksDB fails to write the batch. In the
+     *                            latter case the staged writes are discarded.
+     */
+    void commit_batch();
+
+    /** @brief Ends the calling thread's batch, discarding the staged writes
+     *         once the outermost batch ends.
+     *
+     *  @throw std::runtime_error if the calling thread has no open batch.
+     *                            Strong throw guarantee.
+     */
+    void abort_batch();
+
 private:
     /// Type RocksDB uses for databases
     using db_type = rocksdb::DB;
@@ -156,85 +299,216 @@ private:
     /// Type of the pointer holding a RocksDB database
     using db_pointer = std::unique_ptr<db_type, Deleter>;
 
-    /// Wraps the process of setting the default RocksDB options
-    options_type options_();
+    /// Type RocksDB uses for column families
+    using cf_type = rocksdb::ColumnFamilyHandle;
 
-    /// Wraps the process of allocating the RocksDB database
-    raw_db_pointer allocate_(const_path_reference path, options_type opts);
+    /// Type of the pointer holding a column family
+    using cf_pointer = std::unique_ptr<cf_type>;
 
-    /// Asserts that the RocksDB database has been allocated
-    void assert_ptr_() const;
+    /// Type of a pointer to a secondary instance of another writer's database
+    using peer_pointer = std::unique_ptr<RocksDBPIMPL>;
+
+    /// Type of the map from the other writers' names to their databases
+    using peer_map = std::map<std::string, peer_pointer>;
+
+    /// Type used for sizes and chunk indices
+    using size_type = typename config_type::size_type;
+
+    /// Type RocksDB uses for batches of writes which can be read back
+    using batch_type = rocksdb::WriteBatchWithIndex;
+
+    /// A thread's open batch
+    struct batch_state {
+        /// The number of batches the thread has open
+        std::size_t m_depth = 0;
+
+        /// Was one of the batches aborted?
+        bool m_aborted = false;
 
-    /** @brief Wraps the process of splitting a large value
+        /// The writes the thread staged
+        batch_type m_batch{rocksdb::BytewiseComparator(), 0, true};
+    };
+
+    /// Type of the map from threads to their open batches
+    using batch_map = std::map<std::thread::id, batch_state>;
+
+    /** @brief Opens another writer's database as a secondary instance.
      *
-     *  This function will take a large value (as defined by m_max_value_size_)
-     *  and split it up into chunks that are smaller than equal to
-     *  m_max_value_size_. This method simply computes pointers to where the
-     *  splits should occur and does not actually split value.
+     *  @param[in] path Where the other writer's database lives.
+     *  @param[in] secondary_path Where the secondary instance keeps its own
+     *                            files (e.g., its logs).
+     *  @param[in] config How to tune the database. Must not be shared.
+     *
+     *  @throw std::runtime_error if the database can't be opened, e.g.,
+     *                            because the writer is still creating it.
+     */
+    RocksDBPIMPL(const_path_reference path, const_path_reference secondary_path,
+                 const config_type& config);
+
+    /// Wraps the process of setting the RocksDB options from m_config_
+    options_type options_() const;
+
+    /// Wraps the process of setting the options for writing
+    rocksdb::WriteOptions write_options_() const;
+
+    /// The calling thread's open batch, or nullptr if it has none
+    batch_type* batch_() const;
+
+    /// Reads @p key from @p cf, taking staged writes into account
+    rocksdb::Status get_(cf_type* cf, const_key_reference key,
+                         rocksdb::PinnableSlice* value) const;
+
+    /// Writes @p key/@p value to @p cf, or stages it if a batch is open
+    void put_(cf_type* cf, const_key_reference key, rocksdb::Slice value);
+
+    /// Deletes @p key from @p cf, or stages it if a batch is open
+    void delete_(cf_type* cf, const_key_reference key);
+
+    /** @brief Opens the database and the column families.
      *
-     *  @param[in] value The large value we are splitting. It won't be modified
-     *                   at this point; however, we take it by mutable reference
-     *                   so that the resulting iterators are modifiable
+     *  @param[in] path Where the database lives.
+     *  @param[in] secondary_path If non-empty, the database is opened as a
+     *                            secondary instance keeping its files here.
      *
-     *  @return A container of iterator pairs. Each pair is such that the first
-     *          iterator points to the first element in that slice, and the
-     *          second iterator points ot the first element not in that slice.
+     *  @return The status of opening the database. If it is not ok, *this is
+     *          unchanged.
      */
-    auto split_value_(mapped_reference value);
+    rocksdb::Status open_(const_path_reference path,
+                          const_path_reference secondary_path = "");
 
-    /** @brief Wraps the process of inserting a large value
+    /// Opens the first writer database under @p path no one else is using
+    void open_shared_(const_path_reference path);
+
+    /** @brief Calls @p fxn with each of the other writers' databases.
      *
-     *  This method is responsible for actually inserting a large value. This
-     *  entails: splitting the value, creating "subkeys" for the chunks, and
-     *  then storing the subkey/chunk pairs in the database.
+     *  Before calling @p fxn, the other writers' databases are refreshed if
+     *  it is due (see refresh_peers_). Does nothing unless the database is
+     *  shared.
      *
-     *  N.B. Since ownership of the value is being transferred to the database
-     *       it's important to move the value into this function in order to
-     *       avoid a very large copy. Of course, if you don't want to actually
-     *       give up ownership for some reason then a copy is what you want.
+     *  @param[in] fxn Called with a read-only reference to a database. Should
+     *                 return true to stop the search.
      *
-     *  @param[in] key The key for the large value. This is the key we pretend
-     *                 that the large value is stored under (it's actually
-     *                 stored under a series of subkeys).
-     *  @param[in] value The large value we are putting into the database.
+     *  @return True if @p fxn returned true, and false otherwise.
      */
-    void large_value_insert_(key_type key, mapped_type value);
+    template<typename FxnType>
+    bool any_peer_(FxnType&& fxn) const;
 
-    /** @brief Wraps the process of taking a large value out of the database.
-     *
-     *  This method undoes large_value_insert_, meaning it retrieves the subkeys
-     *  for @p key, retrieves the chunks associated with those subkeys, and then
-     *  merges the chunks back together.
+    /** @brief Opens the databases of writers which appeared since the last
+     *         refresh, and has all of them catch up with their writers.
      *
-     *  @param[in] key The key associated with the large value.
+     *  Does nothing if the last refresh was less than
+     *  RocksDBOptions::peer_refresh_ms ago, or if another thread is already
+     *  refreshing. Takes m_peers_mutex_ exclusively while refreshing.
      *
-     *  @return The large value associated with @p key. The value will be
-     *          restored to the state it was in prior to calling
-     *          large_value_insert_.
+     *  @throw None No throw guarantee. Errors are ignored; what failed is
+     *              tried again by the next refresh.
      */
-    const_mapped_reference large_value_at_(const_key_reference key) const;
+    void refresh_peers_() const noexcept;
 
-    void large_value_free_(const_key_reference key);
+    /// Does @p s mean we failed because someone else holds the database?
+    static bool is_lock_error_(const rocksdb::Status& s);
 
-    void check_status_(rocksdb::Status s) const;
+    /// Asserts that the RocksDB database has been allocated
+    void assert_ptr_() const;
+
+    /// Adds the keys in column family @p cf (and staged writes) to @p keys
+    void append_keys_(cf_type* cf, std::set<key_type>& keys) const;
+
+    /// The configured chunk size, or the default if none was configured
+    size_type chunk_size_() const noexcept;
+
+    /** @brief Wraps the process of reading a (possibly chunked) value.
+     *
+     *  @param[in] key The key of the value to read.
+     *  @param[in] fxn Called with each piece of the value, in order, and the
+     *                 total size of the value. The pieces are only valid for
+     *                 the duration of the call.
+     *
+     *  @return False if @p key is not in the database and true otherwise.
+     *
+     *  @throw std::runtime_error if a chunk is missing.
+     */
+    template<typename FxnType>
+    bool read_(const_key_reference key, FxnType&& fxn) const;
 
-    /** @brief Maximum size a value can be.
+    /** @brief Removes the manifest and the chunks for @p key, if any.
      *
-     *  RocksDB can't handle values which are larger than 4 GB; they recommend
-     *  that values be less than 3 GB. To circumvent this we split large values
-     *  into @p m_max_value_size_ chunks (values for RocksDB are always things
-     *  that adhere to random-access containers so this is no problem). This
-     *  attribute controls the chunk size and could concievably be set as part
-     *  of the API for the class if desired. For now it's just hard-coded to
-     *  3 GB.
+     *  The manifest is removed first, so that a failure part way through
+     *  leaves unreachable chunks, rather than a value with missing chunks.
      */
-    const std::size_t m_max_value_size_ = 3E9;
+    void free_chunks_(const_key_reference key);
+
+    /// Encodes @p n as 8 big-endian bytes
+    static std::string encode_size_(size_type n);
+
+    /// Makes the key chunk @p i of the value stored under @p key lives under
+    static key_type chunk_key_(const_key_reference key, size_type i);
+
+    /// Serializes the size and the number of chunks of a value
+    static mapped_type encode_manifest_(size_type size, size_type n_chunks);
+
+    /// Undoes encode_manifest_, returning the size and the number of chunks
+    static std::pair<size_type, size_type> decode_manifest_(
+      const rocksdb::Slice& manifest);
+
+    void check_status_(rocksdb::Status s) const;
+
+    /// Chunk size used when the config doesn't specify one (3 GB)
+    static constexpr size_type default_chunk_size_ = 3000000000;
+
+    /// Name of the column family holding the manifests of chunked values
+    static constexpr const char* manifests_cf_name_ = "pluginplay_manifests";
+
+    /// Name of the column family holding the chunks of chunked values
+    static constexpr const char* chunks_cf_name_ = "pluginplay_chunks";
+
+    /// In shared mode, prefix of the names of the writers' databases
+    static constexpr const char* writer_prefix_ = "writer-";
+
+    /// In shared mode, subdirectory holding the secondary instances' files
+    static constexpr const char* secondaries_dir_ = "secondaries";
+
+    /// How the database is tuned
+    config_type m_config_;
+
+    /// In shared mode, the directory holding the writers' databases
+    std::string m_shared_root_;
+
+    /// In shared mode, the name of the database we write to
+    std::string m_writer_name_;
+
+    /// Guards m_peers_, which is updated by const methods
+    mutable std::shared_mutex m_peers_mutex_;
+
+    /// When the next refresh of m_peers_ is due (steady clock, in ns)
+    mutable std::atomic<std::int64_t> m_next_refresh_{0};
+
+    /// In shared mode, the other writers' databases
+    mutable peer_map m_peers_;
+
+    /// Guards m_batches_ (but not the batches, only their owners use them)
+    mutable std::mutex m_batches_mutex_;
+
+    /// The open batches (mutable because reading a batch isn't const)
+    mutable batch_map m_batches_;
+
+    /// The size of m_batches_, lets reads skip the lock if no batch is open
+    std::atomic<std::size_t> m_n_batches_{0};
 
     /// The pointer to the RocksDB database
     db_pointer m_db_;
 
-    /// Maps keys for large values to the keys for the pieces
-    std::map<key_type, std::vector<key_type>> m_split_values_;
+    // N.B. The column families must be released before the database is closed,
+    //      so they must be declared after m_db_
+
+    /// The column family holding values which aren't chunked
+    cf_pointer m_default_cf_;
+
+    /// The column family holding the manifests of chunked values
+    cf_pointer m_manifests_cf_;
+
+    /// The column family holding the chunks of chunked values
+    cf_pointer m_chunks_cf_;
 };
 
 } // namespace pluginplay::cache::database::detail_
@@ -15,6 +15,8 @@
  */
 
 // This file is meant only for inclusion from rocksdb_pimpl.hpp
+#include <filesystem>
+
 namespace pluginplay::cache::database::detail_ {
 
 // Macro which hides inline, but could be used to hid template parameters
@@ -24,75 +26,397 @@ namespace pluginplay::cache::database::detail_ {
 #define ROCKSDB_PIMPL RocksDBPIMPL
 
 TPARAMS
-ROCKSDB_PIMPL::ROCKSDB_PIMPL(const_path_reference path) :
-  m_db_(allocate_(path, options_())) {}
+ROCKSDB_PIMPL::ROCKSDB_PIMPL(const_path_reference path,
+                             const config_type& config) :
+  m_config_(config) {
+    if(m_config_.shared)
+        open_shared_(path);
+    else
+        check_status_(open_(path));
+}
 
 TPARAMS
-bool ROCKSDB_PIMPL::count(const_key_reference key) const noexcept {
-    assert_ptr_();
-    if(m_split_values_.count(key)) return true;
-    auto opts = rocksdb::ReadOptions();
+ROCKSDB_PIMPL::ROCKSDB_PIMPL(const_path_reference path,
+                             const_path_reference secondary_path,
+                             const config_type& config) :
+  m_config_(config) {
+    check_status_(open_(path, secondary_path));
+}
 
-    mapped_type buffer;
+TPARAMS
+typename ROCKSDB_PIMPL::key_set_type ROCKSDB_PIMPL::keys() const {
+    assert_ptr_();
+    std::set<key_type> keys;
+    append_keys_(m_default_cf_.get(), keys);
+    append_keys_(m_manifests_cf_.get(), keys);
+    any_peer_([&](const RocksDBPIMPL& peer) {
+        for(auto& key : peer.keys()) keys.insert(std::move(key));
+        return false; // Keep going so we visit every peer
+    });
+    return key_set_type(keys.begin(), keys.end());
+}
 
-    // Rule out that it definitely doesn't exist
-    if(!m_db_->KeyMayExist(opts, key, &buffer)) return false;
+TPARAMS
+bool ROCKSDB_PIMPL::count(const_key_reference key) const noexcept {
+    assert_ptr_();
 
-    auto status = m_db_->Get(opts, key, &buffer);
-    return mapped_type{} != buffer;
+    // N.B. Get consults the bloom filters before reading from disk, and a
+    //      PinnableSlice refers to the value in the block cache (or memtable)
+    //      instead of copying it
+    rocksdb::PinnableSlice value;
+    auto status = get_(m_default_cf_.get(), key, &value);
+    if(status.ok() && !value.empty()) return true;
+    value.Reset();
+    if(get_(m_manifests_cf_.get(), key, &value).ok()) return true;
+    return any_peer_([&](const RocksDBPIMPL& peer) { return peer.count(key); });
 }
 
 TPARAMS
 void ROCKSDB_PIMPL::insert(key_type key, mapped_type value) {
     assert_ptr_();
-    if(value.size() > m_max_value_size_) {
-        large_value_insert_(std::move(key), std::move(value));
+    free_chunks_(key);
+    const auto chunk_size = chunk_size_();
+    if(value.size() <= chunk_size) {
+        put_(m_default_cf_.get(), key, value);
         return;
     }
-    auto opts = rocksdb::WriteOptions();
-    check_status_(
-      m_db_->Put(std::move(opts), std::move(key), std::move(value)));
+
+    delete_(m_default_cf_.get(), key);
+    size_type n_chunks = 0;
+    for(size_type offset = 0; offset < value.size(); offset += chunk_size) {
+        const auto n = std::min(chunk_size, value.size() - offset);
+        rocksdb::Slice chunk(value.data() + offset, n);
+        put_(m_chunks_cf_.get(), chunk_key_(key, n_chunks++), chunk);
+    }
+    put_(m_manifests_cf_.get(), key, encode_manifest_(value.size(), n_chunks));
 }
 
 TPARAMS
 void ROCKSDB_PIMPL::free(const_key_reference key) {
     assert_ptr_();
-    if(m_split_values_.count(key)) {
-        large_value_free_(key);
-        return;
-    }
-    auto opts = rocksdb::WriteOptions();
-    check_status_(m_db_->Delete(opts, std::move(key)));
+    free_chunks_(key);
+    delete_(m_default_cf_.get(), key);
 }
 
 TPARAMS
 typename ROCKSDB_PIMPL::const_mapped_reference ROCKSDB_PIMPL::at(
   const_key_reference key) const {
     assert_ptr_();
-    if(!count(key)) return const_mapped_reference();
-    if(m_split_values_.count(key)) { return large_value_at_(key); }
+    mapped_type buffer;
+    auto append = [&buffer](const rocksdb::Slice& piece, size_type size) {
+        if(buffer.empty()) buffer.reserve(size);
+        buffer.append(piece.data(), piece.size());
+    };
+    if(!read_(key, append)) return const_mapped_reference();
+    return const_mapped_reference(std::move(buffer));
+}
+
+TPARAMS
+void ROCKSDB_PIMPL::write_stream(key_type key, std::istream& is) {
+    assert_ptr_();
+    free(key);
 
-    auto opts = rocksdb::ReadOptions();
+    // Reads up to chunk_size bytes, a bounded amount at a time, so small
+    // streams don't allocate a full chunk
+    const auto chunk_size = chunk_size_();
+    const size_type max_read = 1 << 20;
     mapped_type buffer;
-    auto status = m_db_->Get(opts, key, &buffer);
+    auto fill = [&]() {
+        buffer.clear();
+        while(buffer.size() < chunk_size && is) {
+            const auto old_size = buffer.size();
+            buffer.resize(old_size + std::min(max_read, chunk_size - old_size));
+            is.read(buffer.data() + old_size, buffer.size() - old_size);
+            buffer.resize(old_size + is.gcount());
+        }
+        return !buffer.empty();
+    };
 
-    if(!status.ok()) throw std::out_of_range(status.ToString());
-    return const_mapped_reference(std::move(buffer));
+    fill();
+    if(!is) { // Fit in one chunk
+        put_(m_default_cf_.get(), key, buffer);
+        return;
+    }
+
+    size_type size = 0, n_chunks = 0;
+    do {
+        size += buffer.size();
+        put_(m_chunks_cf_.get(), chunk_key_(key, n_chunks++), buffer);
+    } while(fill());
+    put_(m_manifests_cf_.get(), key, encode_manifest_(size, n_chunks));
+}
+
+TPARAMS
+void ROCKSDB_PIMPL::read_stream(const_key_reference key,
+                                std::ostream& os) const {
+    assert_ptr_();
+    auto write = [&os](const rocksdb::Slice& piece, size_type) {
+        os.write(piece.data(), piece.size());
+    };
+    if(!read_(key, write))
+        throw std::out_of_range("Key was not found in the database");
+}
+
+template<typename FxnType>
+bool ROCKSDB_PIMPL::view(const_key_reference key, FxnType&& fxn) const {
+    assert_ptr_();
+    mapped_type buffer;
+    auto visit = [&](const rocksdb::Slice& piece, size_type size) {
+        // Only one piece, so we can hand out RocksDB's memory
+        if(piece.size() == size) {
+            fxn(std::string_view(piece.data(), piece.size()));
+            return;
+        }
+        if(buffer.empty()) buffer.reserve(size);
+        buffer.append(piece.data(), piece.size());
+    };
+    if(!read_(key, visit)) return false;
+    if(!buffer.empty()) fxn(std::string_view(buffer));
+    return true;
+}
+
+TPARAMS
+void ROCKSDB_PIMPL::begin_batch() {
+    std::lock_guard<std::mutex> lock(m_batches_mutex_);
+    auto [itr, is_new] = m_batches_.try_emplace(std::this_thread::get_id());
+    if(is_new) ++m_n_batches_;
+    ++itr->second.m_depth;
 }
 
 TPARAMS
-typename ROCKSDB_PIMPL::options_type ROCKSDB_PIMPL::options_() {
+void ROCKSDB_PIMPL::commit_batch() {
+    assert_ptr_();
+    std::unique_lock<std::mutex> lock(m_batches_mutex_);
+    auto itr = m_batches_.find(std::this_thread::get_id());
+    if(itr == m_batches_.end())
+        throw std::runtime_error("commit_batch called without begin_batch");
+    if(--itr->second.m_depth > 0) return;
+
+    // Write without holding the lock, other threads may use their batches
+    auto node = m_batches_.extract(itr);
+    --m_n_batches_;
+    lock.unlock();
+
+    auto* batch = node.mapped().m_batch.GetWriteBatch();
+    if(node.mapped().m_aborted || batch->Count() == 0) return;
+    check_status_(m_db_->Write(write_options_(), batch));
+}
+
+TPARAMS
+void ROCKSDB_PIMPL::abort_batch() {
+    std::lock_guard<std::mutex> lock(m_batches_mutex_);
+    auto itr = m_batches_.find(std::this_thread::get_id());
+    if(itr == m_batches_.end())
+        throw std::runtime_error("abort_batch called without begin_batch");
+    itr->second.m_aborted = true;
+    if(--itr->second.m_depth > 0) return;
+    m_batches_.erase(itr);
+    --m_n_batches_;
+}
+
+TPARAMS
+typename ROCKSDB_PIMPL::options_type ROCKSDB_PIMPL::options_() const {
+    using compression_type = typename config_type::Compression;
+
     options_type options;
     options.create_if_missing = true; // Make DB if it DNE
+    if(m_config_.parallelism > 0)
+        options.IncreaseParallelism(m_config_.parallelism);
+    if(m_config_.write_buffer_size > 0)
+        options.write_buffer_size = m_config_.write_buffer_size;
+
+    switch(m_config_.compression) {
+        case compression_type::none:
+            options.compression = rocksdb::kNoCompression;
+            break;
+        case compression_type::snappy:
+            options.compression = rocksdb::kSnappyCompression;
+            break;
+        case compression_type::lz4:
+            options.compression = rocksdb::kLZ4Compression;
+            break;
+        case compression_type::zstd:
+            options.compression = rocksdb::kZSTD;
+            break;
+        default: break;
+    }
+
+    rocksdb::BlockBasedTableOptions table;
+    if(m_config_.block_cache_size > 0)
+        table.block_cache = rocksdb::NewLRUCache(m_config_.block_cache_size);
+    if(m_config_.bloom_bits_per_key > 0)
+        table.filter_policy.reset(
+          rocksdb::NewBloomFilterPolicy(m_config_.bloom_bits_per_key));
+    options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table));
+    return options;
+}
+
+TPARAMS
+rocksdb::WriteOptions ROCKSDB_PIMPL::write_options_() const {
+    rocksdb::WriteOptions options;
+    options.sync = m_config_.sync_writes;
     return options;
 }
 
 TPARAMS
-typename ROCKSDB_PIMPL::raw_db_pointer ROCKSDB_PIMPL::allocate_(
-  const_path_reference path, options_type opts) {
-    raw_db_pointer db;
-    check_status_(rocksdb::DB::Open(std::move(opts), path, &db));
-    return db;
+typename ROCKSDB_PIMPL::batch_type* ROCKSDB_PIMPL::batch_() const {
+    if(m_n_batches_ == 0) return nullptr; // Only we could have opened ours
+    std::lock_guard<std::mutex> lock(m_batches_mutex_);
+    auto itr = m_batches_.find(std::this_thread::get_id());
+    // N.B. the batch stays put until we commit it, so we can drop the lock
+    return itr == m_batches_.end() ? nullptr : &itr->second.m_batch;
+}
+
+TPARAMS
+rocksdb::Status ROCKSDB_PIMPL::get_(cf_type* cf, const_key_reference key,
+                                    rocksdb::PinnableSlice* value) const {
+    auto opts   = rocksdb::ReadOptions();
+    auto* batch = batch_();
+    if(!batch || batch->GetWriteBatch()->Count() == 0)
+        return m_db_->Get(opts, cf, key, value);
+    return batch->GetFromBatchAndDB(m_db_.get(), opts, cf, key, value);
+}
+
+TPARAMS
+void ROCKSDB_PIMPL::put_(cf_type* cf, const_key_reference key,
+                         rocksdb::Slice value) {
+    if(auto* batch = batch_()) {
+        check_status_(batch->Put(cf, key, value));
+        return;
+    }
+    check_status_(m_db_->Put(write_options_(), cf, key, value));
+}
+
+TPARAMS
+void ROCKSDB_PIMPL::delete_(cf_type* cf, const_key_reference key) {
+    if(auto* batch = batch_()) {
+        check_status_(batch->Delete(cf, key));
+        return;
+    }
+    check_status_(m_db_->Delete(write_options_(), cf, key));
+}
+
+TPARAMS
+rocksdb::Status ROCKSDB_PIMPL::open_(const_path_reference path,
+                                     const_path_reference secondary_path) {
+    auto options                           = options_();
+    options.create_missing_column_families = true;
+
+    rocksdb::ColumnFamilyOptions cf_options(options);
+    std::vector<rocksdb::ColumnFamilyDescriptor> cfs{
+      {rocksdb::kDefaultColumnFamilyName, cf_options},
+      {manifests_cf_name_, cf_options},
+      {chunks_cf_name_, cf_options}};
+
+    std::vector<cf_type*> handles;
+    raw_db_pointer db = nullptr;
+    rocksdb::Status status;
+    if(secondary_path.empty()) {
+        status = rocksdb::DB::Open(options, path, cfs, &handles, &db);
+    } else {
+        // Secondaries need to keep all of the writer's files open
+        options.max_open_files = -1;
+        status = rocksdb::DB::OpenAsSecondary(options, path, secondary_path,
+                                              cfs, &handles, &db);
+    }
+    if(!status.ok()) return status;
+
+    m_db_.reset(db);
+    m_default_cf_.reset(handles[0]);
+    m_manifests_cf_.reset(handles[1]);
+    m_chunks_cf_.reset(handles[2]);
+    return status;
+}
+
+TPARAMS
+void ROCKSDB_PIMPL::open_shared_(const_path_reference path) {
+    std::filesystem::create_directories(path);
+    m_shared_root_ = path;
+
+    // N.B. RocksDB locks a database while it's open (also against other
+    //      instances in the same process), so we keep trying writer databases
+    //      until we find one no one else has open
+    for(std::size_t i = 0;; ++i) {
+        m_writer_name_ = writer_prefix_ + std::to_string(i);
+        auto writer    = std::filesystem::path(path) / m_writer_name_;
+        auto status    = open_(writer.string());
+        if(status.ok()) return;
+        if(!is_lock_error_(status)) check_status_(status);
+    }
+}
+
+template<typename FxnType>
+bool ROCKSDB_PIMPL::any_peer_(FxnType&& fxn) const {
+    if(!m_config_.shared) return false;
+
+    refresh_peers_();
+    std::shared_lock<std::shared_mutex> lock(m_peers_mutex_);
+    for(const auto& [_, peer] : m_peers_)
+        if(fxn(*peer)) return true;
+    return false;
+}
+
+TPARAMS
+void ROCKSDB_PIMPL::refresh_peers_() const noexcept {
+    namespace fs = std::filesystem;
+    using clock = std::chrono::steady_clock;
+    using ns    = std::chrono::nanoseconds;
+
+    // Claim the refresh if it's due, so only one thread does it
+    const auto now = std::chrono::duration_cast<ns>(
+                       clock::now().time_since_epoch())
+                       .count();
+    auto due = m_next_refresh_.load();
+    if(now < due) return;
+    const auto interval = std::chrono::duration_cast<ns>(
+      std::chrono::milliseconds(m_config_.peer_refresh_ms));
+    if(!m_next_refresh_.compare_exchange_strong(due, now + interval.count()))
+        return;
+
+    try {
+        std::unique_lock<std::shared_mutex> lock(m_peers_mutex_);
+
+        // Open the databases of writers which have appeared since the last
+        // refresh. N.B. we increment by hand since operator++ may throw
+        std::error_code ec;
+        fs::directory_iterator itr(m_shared_root_, ec), end;
+        for(; !ec && itr != end; itr.increment(ec)) {
+            auto name = itr->path().filename().string();
+            if(name.rfind(writer_prefix_, 0) != 0) continue; // Not a writer
+            if(name == m_writer_name_ || m_peers_.count(name)) continue;
+
+            auto secondary = fs::path(m_shared_root_) / secondaries_dir_ /
+                             (m_writer_name_ + "-" + name);
+            std::error_code mkdir_ec;
+            fs::create_directories(secondary, mkdir_ec);
+
+            // The secondaries don't look for writers themselves
+            auto config   = m_config_;
+            config.shared = false;
+            try {
+                const auto path           = itr->path().string();
+                const auto secondary_path = secondary.string();
+                peer_pointer peer(
+                  new RocksDBPIMPL(path, secondary_path, config));
+                m_peers_.emplace(std::move(name), std::move(peer));
+            } catch(const std::runtime_error&) {
+                // Most likely the writer hasn't finished creating its
+                // database, we'll try again next time
+            }
+        }
+
+        // N.B. If catching up fails we just won't see the newest entries
+        for(auto& [_, peer] : m_peers_) peer->m_db_->TryCatchUpWithPrimary();
+    } catch(...) {
+        // E.g., out of memory, we'll try again next time
+    }
+}
+
+TPARAMS
+bool ROCKSDB_PIMPL::is_lock_error_(const rocksdb::Status& s) {
+    // RocksDB reports failing to lock the database as an IO error whose
+    // message mentions the lock
+    return s.IsIOError() && s.ToString().find("lock") != std::string::npos;
 }
 
 TPARAMS
@@ -103,56 +427,100 @@ void ROCKSDB_PIMPL::assert_ptr_() const {
 }
 
 TPARAMS
-auto ROCKSDB_PIMPL::split_value_(mapped_reference value) {
-    // We just make iterator pairs in this function to avoid copies
-    using itr_type  = typename mapped_type::iterator;
-    using pair_type = std::pair<itr_type, itr_type>;
-    std::vector<pair_type> new_vals;
-    std::size_t chunk_end = m_max_value_size_;
-    auto begin_itr        = value.begin();
-    while(chunk_end < value.size()) {
-        auto end_itr = begin_itr + m_max_value_size_;
-        new_vals.emplace_back(std::make_pair(begin_itr, end_itr));
-        begin_itr += m_max_value_size_;
-        chunk_end += m_max_value_size_;
-    }
+void ROCKSDB_PIMPL::append_keys_(cf_type* cf,
+                                 std::set<key_type>& keys) const {
+    std::unique_ptr<rocksdb::Iterator> itr(
+      m_db_->NewIterator(rocksdb::ReadOptions(), cf));
+    auto* batch = batch_();
+    if(batch && batch->GetWriteBatch()->Count() != 0)
+        itr.reset(batch->NewIteratorWithBase(cf, itr.release()));
 
-    // Still have one more write
-    new_vals.emplace_back(std::make_pair(begin_itr, value.end()));
-    return new_vals;
+    // N.B. an empty value in the default column family marks a missing key
+    for(itr->SeekToFirst(); itr->Valid(); itr->Next())
+        if(!itr->value().empty()) keys.insert(itr->key().ToString());
+    check_status_(itr->status());
 }
 
 TPARAMS
-void ROCKSDB_PIMPL::large_value_insert_(key_type key, mapped_type value) {
-    auto chunks = split_value_(value);
+typename ROCKSDB_PIMPL::size_type ROCKSDB_PIMPL::chunk_size_() const noexcept {
+    const auto size = m_config_.chunk_size;
+    return size > 0 ? size : default_chunk_size_;
+}
 
-    // TODO: Use better sub keys (e.g. UUIDs)
-    std::vector<key_type> sub_keys(chunks.size(), key);
+template<typename FxnType>
+bool ROCKSDB_PIMPL::read_(const_key_reference key, FxnType&& fxn) const {
+    rocksdb::PinnableSlice value;
+    auto status = get_(m_default_cf_.get(), key, &value);
+    if(status.ok() && !value.empty()) {
+        fxn(value, value.size());
+        return true;
+    }
 
-    for(std::size_t i = 0; i < chunks.size(); ++i) {
-        auto& [begin, end] = chunks[i];
-        sub_keys[i] += std::to_string(i);
-        // TODO: Can we avoid the creation of a new mapped_type?
-        insert(sub_keys[i], mapped_type(begin, end));
+    value.Reset();
+    if(!get_(m_manifests_cf_.get(), key, &value).ok()) {
+        return any_peer_(
+          [&](const RocksDBPIMPL& peer) { return peer.read_(key, fxn); });
     }
-    m_split_values_.emplace(std::move(key), std::move(sub_keys));
+    const auto [size, n_chunks] = decode_manifest_(value);
+
+    for(size_type i = 0; i < n_chunks; ++i) {
+        value.Reset();
+        status = get_(m_chunks_cf_.get(), chunk_key_(key, i), &value);
+        if(!status.ok())
+            throw std::runtime_error("Chunk " + std::to_string(i) +
+                                     " is missing: " + status.ToString());
+        fxn(value, size);
+    }
+    return true;
 }
 
 TPARAMS
-typename ROCKSDB_PIMPL::const_mapped_reference ROCKSDB_PIMPL::large_value_at_(
-  const_key_reference key) const {
-    mapped_type buffer;
-    for(const auto& sub_key : m_split_values_.at(key)) {
-        auto sub_value = at(sub_key);
-        buffer += std::move(sub_value.get());
-    }
-    return const_mapped_reference(std::move(buffer));
+void ROCKSDB_PIMPL::free_chunks_(const_key_reference key) {
+    rocksdb::PinnableSlice manifest;
+    if(!get_(m_manifests_cf_.get(), key, &manifest).ok()) return;
+    const auto n_chunks = decode_manifest_(manifest).second;
+
+    delete_(m_manifests_cf_.get(), key);
+    for(size_type i = 0; i < n_chunks; ++i)
+        delete_(m_chunks_cf_.get(), chunk_key_(key, i));
+}
+
+TPARAMS
+std::string ROCKSDB_PIMPL::encode_size_(size_type n) {
+    std::string rv(sizeof(std::uint64_t), '\0');
+    for(auto byte = rv.size(); byte-- > 0; n >>= 8)
+        rv[byte] = static_cast<char>(n & 0xFF);
+    return rv;
 }
 
 TPARAMS
-void ROCKSDB_PIMPL::large_value_free_(const_key_reference key) {
-    for(const auto& sub_key : m_split_values_.at(key)) free(sub_key);
-    m_split_values_.erase(key);
+typename ROCKSDB_PIMPL::key_type ROCKSDB_PIMPL::chunk_key_(
+  const_key_reference key, size_type i) {
+    // N.B. the index comes first and has a fixed width, so chunk keys of
+    //      different values can't collide
+    return encode_size_(i) + key;
+}
+
+TPARAMS
+typename ROCKSDB_PIMPL::mapped_type ROCKSDB_PIMPL::encode_manifest_(
+  size_type size, size_type n_chunks) {
+    return encode_size_(size) + encode_size_(n_chunks);
+}
+
+TPARAMS
+std::pair<typename ROCKSDB_PIMPL::size_type, typename ROCKSDB_PIMPL::size_type>
+ROCKSDB_PIMPL::decode_manifest_(const rocksdb::Slice& manifest) {
+    constexpr auto width = sizeof(std::uint64_t);
+    if(manifest.size() != 2 * width)
+        throw std::runtime_error("Manifest of a chunked value is corrupted");
+
+    auto decode = [&](std::size_t offset) {
+        size_type rv = 0;
+        for(std::size_t byte = offset; byte < offset + width; ++byte)
+            rv = (rv << 8) | static_cast<unsigned char>(manifest[byte]);
+        return rv;
+    };
+    return {decode(0), decode(width)};
 }
 
 TPARAMS
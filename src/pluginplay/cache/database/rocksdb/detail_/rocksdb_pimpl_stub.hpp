@@ -15,6 +15,7 @@
  */
 
 #include "../rocksdb.hpp"
+#include <iosfwd>
 #include <stdexcept>
 
 namespace pluginplay::cache::database::detail_ {
@@ -37,9 +38,15 @@ public:
     /// Type of an immutable reference to the path where the database should go
     using const_path_reference = typename parent_type::const_path_reference;
 
+    /// Type of the tuning options
+    using config_type = typename parent_type::config_type;
+
     /// Type used for keys in the database
     using key_type = typename parent_type::key_type;
 
+    /// Type of a container of keys
+    using key_set_type = typename parent_type::key_set_type;
+
     /// Type of an immutable reference to a key
     using const_key_reference = typename parent_type::const_key_reference;
 
@@ -53,7 +60,12 @@ public:
     using const_mapped_reference = typename parent_type::const_mapped_reference;
 
     /// Raises runtime_error if called
-    RocksDBPIMPLStub(const_path_reference) { raise_error_(); }
+    RocksDBPIMPLStub(const_path_reference, const config_type& = {}) {
+        raise_error_();
+    }
+
+    /// Raises runtime_error if called
+    key_set_type keys() const;
 
     /// Raises runtime_error if called
     bool count(const_key_reference) const;
@@ -67,6 +79,30 @@ public:
     /// Raises runtime_error if called
     const_mapped_reference at(const_key_reference) const;
 
+    /// Raises runtime_error if called
+    void write_stream(key_type, std::istream&) { raise_error_(); }
+
+    /// Raises runtime_error if called
+    void read_stream(const_key_reference, std::ostream&) const {
+        raise_error_();
+    }
+
+    /// Raises runtime_error if called
+    template<typename FxnType>
+    bool view(const_key_reference, FxnType&&) const {
+        raise_error_();
+        return false;
+    }
+
+    /// Raises runtime_error if called
+    void begin_batch() { raise_error_(); }
+
+    /// Raises runtime_error if called
+    void commit_batch() { raise_error_(); }
+
+    /// Raises runtime_error if called
+    void abort_batch() { raise_error_(); }
+
 private:
     /// Code factorization for raising the runtime_error
     void raise_error_() const;
@@ -75,6 +111,12 @@ private:
 // -----------------------------------------------------------------------------
 // -- Inline Implementations
 // -----------------------------------------------------------------------------
+inline typename RocksDBPIMPLStub::key_set_type RocksDBPIMPLStub::keys()
+  const {
+    raise_error_();
+    return key_set_type{};
+}
+
 inline bool RocksDBPIMPLStub::count(const_key_reference) const {
     raise_error_();
     return false;
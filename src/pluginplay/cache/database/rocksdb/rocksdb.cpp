@@ -36,12 +36,32 @@ TPARAMS
 ROCKS_DB::RocksDB() noexcept = default;
 
 TPARAMS
-ROCKS_DB::RocksDB(const_path_reference path) :
-  m_pimpl_(std::make_unique<pimpl_type>(path)) {}
+ROCKS_DB::RocksDB(const_path_reference path, const config_type& config) :
+  m_pimpl_(std::make_unique<pimpl_type>(path, config)) {}
 
 TPARAMS
 ROCKS_DB::~RocksDB() noexcept = default;
 
+TPARAMS
+void ROCKS_DB::write_stream(key_type key, std::istream& is) {
+    pimpl_().write_stream(std::move(key), is);
+}
+
+TPARAMS
+void ROCKS_DB::read_stream(const_key_reference key, std::ostream& os) const {
+    pimpl_().read_stream(key, os);
+}
+
+TPARAMS
+bool ROCKS_DB::view(const_key_reference key, const visitor_type& fxn) const {
+    return pimpl_().view(key, fxn);
+}
+
+TPARAMS
+typename ROCKS_DB::key_set_type ROCKS_DB::keys_() const {
+    return pimpl_().keys();
+}
+
 TPARAMS
 bool ROCKS_DB::count_(const_key_reference key) const noexcept {
     if(!m_pimpl_) return false;
@@ -68,6 +88,15 @@ void ROCKS_DB::backup_() {}
 TPARAMS
 void ROCKS_DB::dump_() {}
 
+TPARAMS
+void ROCKS_DB::begin_batch_() { pimpl_().begin_batch(); }
+
+TPARAMS
+void ROCKS_DB::commit_batch_() { pimpl_().commit_batch(); }
+
+TPARAMS
+void ROCKS_DB::abort_batch_() { pimpl_().abort_batch(); }
+
 TPARAMS
 void ROCKS_DB::assert_pimpl_() const {
     if(m_pimpl_) return;
@@ -17,7 +17,10 @@
 #pragma once
 #include "../../../config/config_impl.hpp" // For with_rockdb_v
 #include "../database_api.hpp"
+#include "../viewable.hpp"
+#include <iosfwd>
 #include <memory>
+#include <pluginplay/cache/rocksdb_options.hpp>
 #include <string>
 
 namespace pluginplay::cache::database {
@@ -44,11 +47,15 @@ class RocksDBPIMPLStub;
  *                    type holding binary data.
  */
 template<typename KeyType, typename ValueType>
-class RocksDB : public DatabaseAPI<KeyType, ValueType> {
+class RocksDB : public DatabaseAPI<KeyType, ValueType>,
+                public Viewable<KeyType> {
 private:
     /// Type this class implements
     using base_type = DatabaseAPI<KeyType, ValueType>;
 
+    /// Type of the Viewable API this class also implements
+    using viewable_type = Viewable<KeyType>;
+
 public:
     /// Type used for specifying the disk location of the database
     using path_type = std::string;
@@ -56,9 +63,15 @@ public:
     /// Type of a read-only reference to the disk location
     using const_path_reference = const path_type&;
 
+    /// Type of the object holding the tuning options
+    using config_type = RocksDBOptions;
+
     /// @copydoc base_type::key_type
     using key_type = typename base_type::key_type;
 
+    /// @copydoc base_type::key_set_type
+    using key_set_type = typename base_type::key_set_type;
+
     /// @copydoc base_type::const_key_reference
     using const_key_reference = typename base_type::const_key_reference;
 
@@ -68,6 +81,9 @@ public:
     /// @copydoc base_type::const_mapped_reference
     using const_mapped_reference = typename base_type::const_mapped_reference;
 
+    /// Type of the callback passed to view
+    using visitor_type = typename viewable_type::visitor_type;
+
     /** @brief Creates a stub RocksDB instance.
      *
      *  The instance resulting from this ctor has no PIMPL and can not be used
@@ -91,11 +107,13 @@ public:
      *                  is an already existing RocksDB database the resulting
      *                  instance will open it. If @p path is not an existing
      *                  database then a new database will be created and opend.
+     *  @param[in] config How RocksDB should be tuned. See RocksDBOptions.
+     *                    Defaults to a default constructed RocksDBOptions.
      *
      *  @throw std::bad_alloc if the PIMPL can not be created. Strong throw
      *                        guarantee.
      */
-    explicit RocksDB(const_path_reference path);
+    explicit RocksDB(const_path_reference path, const config_type& config = {});
 
     /** @brief Default Dtor
      *
@@ -103,7 +121,56 @@ public:
      */
     ~RocksDB() noexcept;
 
+    /** @brief Adds a new entry whose value is read from a stream.
+     *
+     *  Values bigger than RocksDBOptions::chunk_size are stored in chunks.
+     *  This method reads and writes the value a chunk at a time, so that very
+     *  large values can be stored without holding the whole value in memory.
+     *
+     *  @param[in] key The label for the new entry.
+     *  @param[in] is The stream to read the value from. Read until its end.
+     *
+     *  @throw std::runtime_error if *this has no PIMPL or if there is a
+     *                            problem writing to the database.
+     */
+    void write_stream(key_type key, std::istream& is);
+
+    /** @brief Writes the value associated with @p key to a stream.
+     *
+     *  This is the counterpart to write_stream. The value is written a chunk
+     *  at a time, so the whole value is never held in memory.
+     *
+     *  @param[in] key The label of the value to retrieve.
+     *  @param[in] os The stream to write the value to.
+     *
+     *  @throw std::out_of_range if @p key is not in the database.
+     *  @throw std::runtime_error if *this has no PIMPL or if part of the value
+     *                            is missing.
+     */
+    void read_stream(const_key_reference key, std::ostream& os) const;
+
+    /** @brief Calls @p fxn with a view of the value associated with @p key.
+     *
+     *  For values which are not chunked the view refers to RocksDB's own
+     *  memory (e.g., the block cache), so no copy is made. Chunked values are
+     *  reassembled into a buffer first.
+     *
+     *  @param[in] key The key of the value to view.
+     *  @param[in] fxn Called with the value's bytes, if @p key is in the
+     *                 database. The view is only valid during the call.
+     *
+     *  @return True if @p key is in the database and false otherwise.
+     *
+     *  @throw std::runtime_error if *this has no PIMPL. Strong throw
+     *                            guarantee.
+     *  @throw ??? Throws if @p fxn throws. Same throw guarantee.
+     */
+    bool view(const_key_reference key, const visitor_type& fxn) const override;
+
 protected:
+    /// Implements keys method
+    key_set_type keys_() const override;
+
     /// Implements count method
     bool count_(const_key_reference key) const noexcept override;
 
@@ -122,6 +189,15 @@ protected:
     /// Implements dump (which ATM is a no-op)
     void dump_() override;
 
+    /// Starts staging the calling thread's writes in a rocksdb::WriteBatch
+    void begin_batch_() override;
+
+    /// Writes the staged writes with a single call to RocksDB
+    void commit_batch_() override;
+
+    /// Discards the staged writes (once the outermost batch ends)
+    void abort_batch_() override;
+
 private:
     /// Type of the implementation
     using pimpl_type = std::conditional_t<with_rocksdb_v, detail_::RocksDBPIMPL,
@@ -15,7 +15,12 @@
  */
 
 #include "database_api.hpp"
+#include "viewable.hpp"
+#include <istream>
+#include <optional>
+#include <ostream>
 #include <parallelzone/serialization.hpp>
+#include <streambuf>
 
 namespace pluginplay::cache::database {
 
@@ -29,6 +34,12 @@ namespace pluginplay::cache::database {
  *  of this database only deal with objects. This class handles the
  *  serialization/deserialization of the objects under the hood.
  *
+ *  Serialization writes straight into the buffer which is handed to the
+ *  wrapped database (keys which are only used for look ups are written into a
+ *  per-thread buffer which is reused). If the wrapped database is Viewable,
+ *  values are deserialized directly from the wrapped database's memory,
+ *  otherwise from the copy returned by its `at` method.
+ *
  *  @note This class should be thought of as a wrapper around the managed
  *        databse. In particular, this means this instance does not maintain
  *        separate records of the keys/values; rather, all interactions actually
@@ -55,6 +66,9 @@ public:
     /// Type of a managed pointer to an instance of sub_db_type
     using sub_db_pointer = std::unique_ptr<sub_db_type>;
 
+    /// Type of a wrapped database which can lend out its values' bytes
+    using viewable_type = Viewable<binary_type>;
+
     /// Typedef of KeyType
     using typename base_type::key_type;
 
@@ -84,7 +98,9 @@ public:
      *
      *  @throw None No throw guarantee.
      */
-    Serialized(sub_db_pointer p) : m_db_(std::move(p)) {}
+    Serialized(sub_db_pointer p) :
+      m_db_(std::move(p)),
+      m_viewable_(dynamic_cast<const viewable_type*>(m_db_.get())) {}
 
 protected:
     /// returns a container with the deserialized keys
@@ -108,17 +124,70 @@ protected:
     /// Implements dump by calling dump on the wrapped database
     void dump_() override { m_db_->dump(); }
 
+    /// Implements begin_batch by calling it on the wrapped database
+    void begin_batch_() override { m_db_->begin_batch(); }
+
+    /// Implements commit_batch by calling it on the wrapped database
+    void commit_batch_() override { m_db_->commit_batch(); }
+
+    /// Implements abort_batch by calling it on the wrapped database
+    void abort_batch_() override { m_db_->abort_batch(); }
+
 private:
+    /// Type of a read-only view of serialized bytes
+    using view_type = typename viewable_type::view_type;
+
+    /// Stream buffer which appends what is written to it to a string
+    class AppendBuffer : public std::streambuf {
+    public:
+        explicit AppendBuffer(binary_type& buffer) : m_buffer_(buffer) {}
+
+    protected:
+        int_type overflow(int_type c) override {
+            if(traits_type::eq_int_type(c, traits_type::eof())) return c;
+            m_buffer_.push_back(traits_type::to_char_type(c));
+            return c;
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            m_buffer_.append(s, n);
+            return n;
+        }
+
+    private:
+        binary_type& m_buffer_;
+    };
+
+    /// Stream buffer which reads from memory it does not own
+    class ViewBuffer : public std::streambuf {
+    public:
+        explicit ViewBuffer(view_type view) {
+            // N.B. get areas are only read from, so the const_cast is safe
+            auto* begin = const_cast<char*>(view.data());
+            setg(begin, begin, begin + view.size());
+        }
+    };
+
+    /// Serializes @p serialize_me into @p buffer, overwriting its contents
+    template<typename T>
+    void serialize_(T&& serialize_me, binary_type& buffer) const;
+
     /// Wraps the process of serializing an object of type @p T
     template<typename T>
     binary_type serialize_(T&& serialize_me) const;
 
+    /// Serializes @p key into the calling thread's reusable key buffer
+    const binary_type& serialize_key_(const_key_reference key) const;
+
     /// Wraps the process of deserializing to an object of type @p T
     template<typename T>
-    T deserialize_(const binary_type& deserialize_me) const;
+    T deserialize_(view_type deserialize_me) const;
 
     /// The binary database we are serializing in to/out of
     sub_db_pointer m_db_;
+
+    /// m_db_ if it is Viewable, otherwise null
+    const viewable_type* m_viewable_;
 };
 
 } // namespace pluginplay::cache::database
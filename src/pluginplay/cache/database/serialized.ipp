@@ -31,7 +31,7 @@ typename SERIALIZED::key_set_type SERIALIZED::keys_() const {
 TPARAMS
 bool SERIALIZED::count_(const_key_reference key) const noexcept {
     try {
-        return m_db_->count(serialize_(key));
+        return m_db_->count(serialize_key_(key));
     } catch(...) { return false; }
 }
 
@@ -44,33 +44,63 @@ void SERIALIZED::insert_(key_type key, mapped_type value) {
 
 TPARAMS
 void SERIALIZED::free_(const_key_reference key) {
-    m_db_->free(serialize_(key));
+    m_db_->free(serialize_key_(key));
 }
 
 TPARAMS
 typename SERIALIZED::const_mapped_reference SERIALIZED::at_(
   const_key_reference key) const {
-    auto serialized_key = serialize_(key);
-    auto serialized_val = m_db_->at(serialized_key);
-    auto rv             = deserialize_<mapped_type>(serialized_val.get());
-    return const_mapped_reference(std::move(rv));
+    const auto& serialized_key = serialize_key_(key);
+    if(!m_viewable_) {
+        auto serialized_val = m_db_->at(serialized_key);
+        auto rv             = deserialize_<mapped_type>(serialized_val.get());
+        return const_mapped_reference(std::move(rv));
+    }
+
+    std::optional<mapped_type> rv;
+    auto deserialize = [&](view_type value) {
+        rv.emplace(deserialize_<mapped_type>(value));
+    };
+    if(!m_viewable_->view(serialized_key, deserialize))
+        throw std::out_of_range("Key was not found in the database");
+    return const_mapped_reference(std::move(*rv));
+}
+
+TPARAMS
+template<typename T>
+void SERIALIZED::serialize_(T&& serialize_me, binary_type& buffer) const {
+    buffer.clear();
+    AppendBuffer append(buffer);
+    std::ostream os(&append);
+    cereal::BinaryOutputArchive ar(os);
+    ar << std::forward<T>(serialize_me);
 }
 
 TPARAMS
 template<typename T>
 typename SERIALIZED::binary_type SERIALIZED::serialize_(
   T&& serialize_me) const {
-    std::stringstream ss;
-    cereal::BinaryOutputArchive ar(ss);
-    ar << std::forward<T>(serialize_me);
-    return ss.str();
+    binary_type rv;
+    serialize_(std::forward<T>(serialize_me), rv);
+    return rv;
+}
+
+TPARAMS
+const typename SERIALIZED::binary_type& SERIALIZED::serialize_key_(
+  const_key_reference key) const {
+    // N.B. the buffer keeps its capacity, so after the first few keys this
+    //      doesn't allocate
+    static thread_local binary_type buffer;
+    serialize_(key, buffer);
+    return buffer;
 }
 
 TPARAMS
 template<typename T>
-T SERIALIZED::deserialize_(const binary_type& deserialize_me) const {
-    std::stringstream ss(deserialize_me);
-    cereal::BinaryInputArchive ar(ss);
+T SERIALIZED::deserialize_(view_type deserialize_me) const {
+    ViewBuffer view(deserialize_me);
+    std::istream is(&view);
+    cereal::BinaryInputArchive ar(is);
     T rv;
     ar >> rv;
     return rv;
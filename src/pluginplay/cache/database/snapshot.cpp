@@ -0,0 +1,437 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "native.hpp"
+#include "snapshot.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace pluginplay::cache::database {
+namespace detail_ {
+namespace {
+
+/// Type of the integers in the file
+using word_type = std::uint64_t;
+
+/// First bytes of every snapshot file
+constexpr char magic[8] = "PPSNAP1";
+
+/// Values, the entry table, and the index start at multiples of this
+constexpr word_type alignment = 64;
+
+/// The first bytes of the file
+struct Header {
+    char magic[8];
+    word_type n_entries;
+    word_type n_slots;
+    word_type entries_offset;
+    word_type slots_offset;
+    char padding[alignment - 8 - 4 * sizeof(word_type)];
+};
+static_assert(sizeof(Header) == alignment);
+
+/// Where an entry's key and value are in the file
+struct Entry {
+    word_type key_offset;
+    word_type key_size;
+    word_type value_offset;
+    word_type value_size;
+};
+
+/// A slot of the index, entry is one plus the entry's position (0 if empty)
+struct Slot {
+    word_type hash;
+    word_type entry;
+};
+
+/// FNV-1a hash of @p bytes
+word_type hash(std::string_view bytes) noexcept {
+    word_type rv = 14695981039346656037ull;
+    for(auto c : bytes) {
+        rv ^= static_cast<unsigned char>(c);
+        rv *= 1099511628211ull;
+    }
+    return rv;
+}
+
+/// Rounds @p n up to a multiple of alignment
+word_type round_up(word_type n) noexcept {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+/// Makes the message for an error the OS reported (via errno)
+std::string os_error(const std::string& what, const std::string& path) {
+    return what + " " + path + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+/** @brief Implements the Snapshot class.
+ *
+ *  The entry table and the index are used in place, i.e., they are cast from
+ *  the mapping. That's fine since mappings start on a page boundary and both
+ *  tables start at a multiple of alignment.
+ *
+ *  The file is immutable, so reading it needs no synchronization. The overlay
+ *  and the freed keys are guarded by a reader/writer lock.
+ */
+class SnapshotPIMPL {
+public:
+    using parent_type     = Snapshot;
+    using binary_type     = typename parent_type::binary_type;
+    using size_type       = typename parent_type::size_type;
+    using key_set_type    = typename parent_type::key_set_type;
+    using overlay_pointer = typename parent_type::overlay_pointer;
+
+    SnapshotPIMPL(const std::string& path, overlay_pointer overlay);
+
+    ~SnapshotPIMPL() noexcept { unmap_(); }
+
+    size_type size() const noexcept { return m_n_entries_; }
+
+    key_set_type keys() const;
+
+    bool count(const binary_type& key) const;
+
+    void insert(binary_type key, binary_type value);
+
+    void free(const binary_type& key);
+
+    template<typename FxnType>
+    bool view(const binary_type& key, FxnType&& fxn) const;
+
+private:
+    /// Type of a lock for reading the overlay
+    using read_lock_type = std::shared_lock<std::shared_mutex>;
+
+    /// Type of a lock for modifying the overlay
+    using write_lock_type = std::unique_lock<std::shared_mutex>;
+
+    /// Finds @p key in the file, ignoring the overlay and the freed keys
+    std::optional<std::string_view> find_(const binary_type& key) const;
+
+    /// The @p size bytes at @p offset, or nullopt if they're past the end
+    std::optional<std::string_view> bytes_(word_type offset,
+                                           word_type size) const noexcept;
+
+    /// Throws, after unmapping the file, if the header is inconsistent
+    void check_header_(const Header& header, const std::string& path);
+
+    /// Unmaps the file, if it is mapped
+    void unmap_() noexcept;
+
+    /// The start of the mapping
+    const char* m_data_ = nullptr;
+
+    /// The size of the mapping (and the file)
+    std::size_t m_size_ = 0;
+
+    /// The number of entries in the file
+    word_type m_n_entries_ = 0;
+
+    /// The number of slots in the index
+    word_type m_n_slots_ = 0;
+
+    /// The entry table, in the mapping
+    const Entry* m_entries_ = nullptr;
+
+    /// The index, in the mapping
+    const Slot* m_slots_ = nullptr;
+
+    /// Guards m_overlay_ and m_freed_
+    mutable std::shared_mutex m_mutex_;
+
+    /// Entries added after opening the file
+    overlay_pointer m_overlay_;
+
+    /// Keys of the file which have been freed
+    std::set<binary_type> m_freed_;
+};
+
+SnapshotPIMPL::SnapshotPIMPL(const std::string& path, overlay_pointer overlay) :
+  m_overlay_(std::move(overlay)) {
+    using native_type = Native<binary_type, binary_type>;
+    if(!m_overlay_) m_overlay_ = std::make_unique<native_type>();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) throw std::runtime_error(os_error("Could not open", path));
+
+    struct stat info;
+    if(::fstat(fd, &info) != 0) {
+        auto msg = os_error("Could not stat", path);
+        ::close(fd);
+        throw std::runtime_error(msg);
+    }
+    m_size_ = static_cast<std::size_t>(info.st_size);
+    if(m_size_ < sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error(path + " is not a snapshot file");
+    }
+
+    // N.B. the mapping stays valid after the file is closed
+    void* mapping = ::mmap(nullptr, m_size_, PROT_READ, MAP_SHARED, fd, 0);
+    if(mapping == MAP_FAILED) {
+        auto msg = os_error("Could not map", path);
+        ::close(fd);
+        throw std::runtime_error(msg);
+    }
+    ::close(fd);
+    m_data_ = static_cast<const char*>(mapping);
+
+    Header header;
+    std::memcpy(&header, m_data_, sizeof(header));
+    check_header_(header, path);
+
+    const auto* entries = m_data_ + header.entries_offset;
+    const auto* slots   = m_data_ + header.slots_offset;
+    m_n_entries_        = header.n_entries;
+    m_n_slots_          = header.n_slots;
+    m_entries_          = reinterpret_cast<const Entry*>(entries);
+    m_slots_            = reinterpret_cast<const Slot*>(slots);
+}
+
+typename SnapshotPIMPL::key_set_type SnapshotPIMPL::keys() const {
+    read_lock_type lock(m_mutex_);
+    auto rv = m_overlay_->keys();
+    for(word_type i = 0; i < m_n_entries_; ++i) {
+        auto key = bytes_(m_entries_[i].key_offset, m_entries_[i].key_size);
+        if(!key) continue;
+        binary_type k(*key);
+        if(m_freed_.count(k) || m_overlay_->count(k)) continue;
+        rv.push_back(std::move(k));
+    }
+    return rv;
+}
+
+bool SnapshotPIMPL::count(const binary_type& key) const {
+    read_lock_type lock(m_mutex_);
+    if(m_overlay_->count(key)) return true;
+    return !m_freed_.count(key) && find_(key).has_value();
+}
+
+void SnapshotPIMPL::insert(binary_type key, binary_type value) {
+    write_lock_type lock(m_mutex_);
+    m_freed_.erase(key);
+    m_overlay_->insert(std::move(key), std::move(value));
+}
+
+void SnapshotPIMPL::free(const binary_type& key) {
+    write_lock_type lock(m_mutex_);
+    m_overlay_->free(key);
+    if(find_(key)) m_freed_.insert(key);
+}
+
+template<typename FxnType>
+bool SnapshotPIMPL::view(const binary_type& key, FxnType&& fxn) const {
+    read_lock_type lock(m_mutex_);
+    auto value = m_overlay_->try_at(key);
+    if(value.has_value()) {
+        fxn(std::string_view(value.get()));
+        return true;
+    }
+    if(m_freed_.count(key)) return false;
+
+    auto bytes = find_(key);
+    if(!bytes) return false;
+    fxn(*bytes);
+    return true;
+}
+
+std::optional<std::string_view> SnapshotPIMPL::find_(
+  const binary_type& key) const {
+    if(m_n_slots_ == 0) return std::nullopt;
+
+    // N.B. the index is at most half full, so probing ends at an empty slot
+    const auto h    = hash(key);
+    const auto mask = m_n_slots_ - 1;
+    for(auto i = h & mask; m_slots_[i].entry != 0; i = (i + 1) & mask) {
+        const auto& slot = m_slots_[i];
+        if(slot.hash != h || slot.entry > m_n_entries_) continue;
+
+        const auto& entry = m_entries_[slot.entry - 1];
+        auto entry_key    = bytes_(entry.key_offset, entry.key_size);
+        if(!entry_key || *entry_key != key) continue;
+        return bytes_(entry.value_offset, entry.value_size);
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string_view> SnapshotPIMPL::bytes_(
+  word_type offset, word_type size) const noexcept {
+    if(offset > m_size_ || size > m_size_ - offset) return std::nullopt;
+    return std::string_view(m_data_ + offset, size);
+}
+
+void SnapshotPIMPL::check_header_(const Header& header,
+                                  const std::string& path) {
+    auto fits = [&](word_type offset, word_type n, std::size_t width) {
+        if(offset % alignment || offset > m_size_) return false;
+        return n <= (m_size_ - offset) / width;
+    };
+
+    const auto n_slots = header.n_slots;
+    bool good          = std::memcmp(header.magic, magic, sizeof(magic)) == 0;
+    good = good && fits(header.entries_offset, header.n_entries, sizeof(Entry));
+    good = good && fits(header.slots_offset, n_slots, sizeof(Slot));
+    good = good && (n_slots & (n_slots - 1)) == 0; // Power of two (or zero)
+    good = good && n_slots >= 2 * header.n_entries;
+    if(good) return;
+
+    unmap_();
+    throw std::runtime_error(path + " is not a snapshot file");
+}
+
+void SnapshotPIMPL::unmap_() noexcept {
+    if(!m_data_) return;
+    ::munmap(const_cast<char*>(m_data_), m_size_);
+    m_data_ = nullptr;
+}
+
+} // namespace detail_
+
+Snapshot::Snapshot(const_path_reference path, overlay_pointer overlay) :
+  m_pimpl_(std::make_unique<pimpl_type>(path, std::move(overlay))) {}
+
+Snapshot::~Snapshot() noexcept = default;
+
+void Snapshot::write(const_path_reference path, const base_type& db) {
+    using namespace detail_;
+    namespace fs = std::filesystem;
+
+    // N.B. the pid keeps processes writing the same snapshot from clobbering
+    //      each other's temporary file
+    const auto tmp_path = path + ".tmp-" + std::to_string(::getpid());
+    std::ofstream os(tmp_path, std::ios::binary | std::ios::trunc);
+    if(!os) throw std::runtime_error(os_error("Could not create", tmp_path));
+
+    word_type offset = 0;
+    auto append      = [&](const void* bytes, word_type size) {
+        os.write(static_cast<const char*>(bytes), size);
+        offset += size;
+    };
+    auto pad = [&]() {
+        const std::string zeros(round_up(offset) - offset, '\0');
+        append(zeros.data(), zeros.size());
+    };
+
+    try {
+        Header header{};
+        append(&header, sizeof(header)); // Filled in once we know the sizes
+
+        // Keys and values, one entry at a time
+        std::vector<Entry> entries;
+        std::vector<word_type> hashes;
+        for(const auto& key : db.keys()) {
+            auto value       = db.at(key);
+            const auto& data = value.get();
+
+            Entry entry{offset, key.size(), 0, data.size()};
+            append(key.data(), key.size());
+            pad();
+            entry.value_offset = offset;
+            append(data.data(), data.size());
+            entries.push_back(entry);
+            hashes.push_back(hash(key));
+        }
+        pad();
+
+        header.n_entries      = entries.size();
+        header.entries_offset = offset;
+        append(entries.data(), entries.size() * sizeof(Entry));
+        pad();
+
+        // The index, at most half full
+        word_type n_slots = entries.empty() ? 0 : 1;
+        while(n_slots < 2 * entries.size()) n_slots *= 2;
+        std::vector<Slot> slots(n_slots, Slot{0, 0});
+        for(word_type i = 0; i < entries.size(); ++i) {
+            auto j = hashes[i] & (n_slots - 1);
+            while(slots[j].entry != 0) j = (j + 1) & (n_slots - 1);
+            slots[j] = Slot{hashes[i], i + 1};
+        }
+        header.n_slots      = n_slots;
+        header.slots_offset = offset;
+        append(slots.data(), slots.size() * sizeof(Slot));
+
+        std::memcpy(header.magic, magic, sizeof(magic));
+        os.seekp(0);
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.close();
+        if(!os) throw std::runtime_error(os_error("Could not write", tmp_path));
+
+        fs::rename(tmp_path, path);
+    } catch(...) {
+        std::error_code ec;
+        os.close();
+        fs::remove(tmp_path, ec);
+        throw;
+    }
+}
+
+typename Snapshot::size_type Snapshot::size() const noexcept {
+    return m_pimpl_->size();
+}
+
+bool Snapshot::view(const_key_reference key, const visitor_type& fxn) const {
+    return m_pimpl_->view(key, fxn);
+}
+
+typename Snapshot::key_set_type Snapshot::keys_() const {
+    return m_pimpl_->keys();
+}
+
+bool Snapshot::count_(const_key_reference key) const noexcept {
+    try {
+        return m_pimpl_->count(key);
+    } catch(...) { return false; }
+}
+
+void Snapshot::insert_(key_type key, mapped_type value) {
+    m_pimpl_->insert(std::move(key), std::move(value));
+}
+
+void Snapshot::free_(const_key_reference key) { m_pimpl_->free(key); }
+
+typename Snapshot::const_mapped_reference Snapshot::at_(
+  const_key_reference key) const {
+    auto rv = try_at_(key);
+    if(rv.has_value()) return rv;
+    throw std::out_of_range("Key was not found in the database");
+}
+
+typename Snapshot::const_mapped_reference Snapshot::try_at_(
+  const_key_reference key) const {
+    std::optional<mapped_type> value;
+    auto copy = [&](std::string_view bytes) { value.emplace(bytes); };
+    if(!m_pimpl_->view(key, copy)) return const_mapped_reference{};
+    return const_mapped_reference(std::move(*value));
+}
+
+} // namespace pluginplay::cache::database
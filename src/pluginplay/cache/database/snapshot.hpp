@@ -0,0 +1,192 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "database_api.hpp"
+#include "viewable.hpp"
+#include <memory>
+#include <string>
+
+namespace pluginplay::cache::database {
+namespace detail_ {
+class SnapshotPIMPL;
+} // namespace detail_
+
+/** @brief A binary database served from a memory-mapped, read-only file.
+ *
+ *  Snapshot files are written once (see Snapshot::write) and never modified.
+ *  Opening one maps the file into memory; lookups hash the key, probe the
+ *  file's index, and hand out the value's bytes straight from the mapping
+ *  (see view), so nothing is read or parsed up front and processes opening
+ *  the same file share its pages through the OS page cache.
+ *
+ *  Since the file is read-only, entries added after opening the snapshot go
+ *  to an in-memory "overlay" database, which is consulted before the file.
+ *  Freeing an entry of the file hides it. Neither survives the instance.
+ *
+ *  The file is laid out as:
+ *
+ *  - a 64 byte header: the magic string "PPSNAP1", then the number of
+ *    entries, the number of index slots, and the offsets of the entry table
+ *    and of the index (all 8 byte unsigned integers),
+ *  - the keys and values; each value starts at a 64 byte boundary,
+ *  - the entry table: the offset and size of each entry's key and value,
+ *  - the index: an open-addressing hash table (linear probing, power of two
+ *    number of slots, at most half full) whose slots hold a key's hash and
+ *    one plus the key's position in the entry table (zero for empty slots).
+ *
+ *  Integers are stored in the byte order of the machine writing the file.
+ *
+ *  Like RocksDB, this class stores binary keys and values and is meant to be
+ *  wrapped in a Serialized layer.
+ */
+class Snapshot : public DatabaseAPI<std::string, std::string>,
+                 public Viewable<std::string> {
+private:
+    /// Type this class implements
+    using base_type = DatabaseAPI<std::string, std::string>;
+
+    /// Type of the Viewable API this class also implements
+    using viewable_type = Viewable<std::string>;
+
+public:
+    /// Type of the keys and values
+    using binary_type = std::string;
+
+    /// Type used for specifying where the file lives
+    using path_type = std::string;
+
+    /// Type of a read-only reference to the file's location
+    using const_path_reference = const path_type&;
+
+    /// Type used for counting entries
+    using size_type = std::size_t;
+
+    /// Type of the database holding entries added after opening the file
+    using overlay_type = base_type;
+
+    /// Type of a pointer to the overlay database
+    using overlay_pointer = std::unique_ptr<overlay_type>;
+
+    /// Typedef of binary_type
+    using base_type::key_type;
+
+    /// Type of a container of keys
+    using base_type::key_set_type;
+
+    /// Typedef of const binary_type&
+    using base_type::const_key_reference;
+
+    /// Typedef of binary_type
+    using base_type::mapped_type;
+
+    /// Type of an object holding a read-only value
+    using base_type::const_mapped_reference;
+
+    /// Type of the callback passed to view
+    using visitor_type = typename viewable_type::visitor_type;
+
+    /** @brief Maps the snapshot file at @p path into memory.
+     *
+     *  @param[in] path The snapshot file, made by Snapshot::write.
+     *  @param[in] overlay Where entries added after opening the file go.
+     *                     Defaults to an in-memory database.
+     *
+     *  @throw std::runtime_error if the file can't be opened or mapped, or if
+     *                            it is not a snapshot file. Strong throw
+     *                            guarantee.
+     */
+    explicit Snapshot(const_path_reference path, overlay_pointer overlay = {});
+
+    /// Deleted because the mapping is not copyable
+    Snapshot(const Snapshot&) = delete;
+
+    /// Deleted because the mapping is not copyable
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    /// Unmaps the file
+    ~Snapshot() noexcept override;
+
+    /** @brief Writes the entries of @p db to a new snapshot file.
+     *
+     *  The file is written to a temporary file next to @p path, which is then
+     *  renamed to @p path. Hence, readers never see a partially written file
+     *  and instances which already mapped an older file at @p path keep
+     *  seeing the older file. Values are read from @p db one at a time, so
+     *  @p db does not need to fit in memory.
+     *
+     *  @param[in] path Where the snapshot file should go.
+     *  @param[in] db The database whose entries are written.
+     *
+     *  @throw std::runtime_error if the file can't be written. No file is
+     *                            created at @p path in that case.
+     *  @throw ??? Throws if @p db throws while listing its keys or reading
+     *             its values.
+     */
+    static void write(const_path_reference path, const base_type& db);
+
+    /// The number of entries in the file (ignoring the overlay)
+    size_type size() const noexcept;
+
+    /** @brief Calls @p fxn with a view of the value associated with @p key.
+     *
+     *  For entries of the file the view refers to the mapping, so no copy is
+     *  made.
+     *
+     *  @param[in] key The key of the value to view.
+     *  @param[in] fxn Called with the value's bytes, if @p key is in the
+     *                 database. The view is only valid during the call.
+     *
+     *  @return True if @p key is in the database and false otherwise.
+     *
+     *  @throw ??? Throws if @p fxn throws. Same throw guarantee.
+     */
+    bool view(const_key_reference key, const visitor_type& fxn) const override;
+
+protected:
+    /// The keys of the file and of the overlay
+    key_set_type keys_() const override;
+
+    /// Looks for @p key in the overlay, then in the file
+    bool count_(const_key_reference key) const noexcept override;
+
+    /// Adds @p key and @p value to the overlay
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Frees @p key from the overlay and hides it in the file
+    void free_(const_key_reference key) override;
+
+    /// Copies the value of @p key out of the overlay or the file
+    const_mapped_reference at_(const_key_reference key) const override;
+
+    /// Like at_, but returns an empty value if @p key is not present
+    const_mapped_reference try_at_(const_key_reference key) const override;
+
+    /// No-op, the file is read-only and the overlay has nowhere to go
+    void backup_() override {}
+
+    /// No-op, the file is read-only and the overlay has nowhere to go
+    void dump_() override {}
+
+private:
+    /// Type of the object implementing this class
+    using pimpl_type = detail_::SnapshotPIMPL;
+
+    /// The object implementing this class
+    std::unique_ptr<pimpl_type> m_pimpl_;
+};
+
+} // namespace pluginplay::cache::database
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "database_api.hpp"
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+namespace pluginplay::cache::database {
+
+/** @brief Makes the wrapped database safe to use from multiple threads.
+ *
+ *  None of the other database layers perform any synchronization. This class
+ *  wraps a database and guards every call to it with a reader/writer lock.
+ *  Operations which do not modify the database (count, at, try_at, keys) only
+ *  take a shared lock, so any number of threads may look values up at the same
+ *  time. Operations which modify the database (insert, free, backup, dump)
+ *  take an exclusive lock.
+ *
+ *  Since the wrapped database may return values which alias its internal
+ *  state, and that state may change as soon as the lock is released, values
+ *  returned by this class are copies made while the lock is held, unless the
+ *  wrapped database shares ownership of them (see DBValue), in which case
+ *  they stay valid regardless and are handed out as is.
+ *
+ *  find_or_compute holds the shared lock while the wrapped database looks the
+ *  key up, releases it to run the callback, and takes the exclusive lock
+ *  before the wrapped database inserts the result. The callback runs without
+ *  the lock, so an expensive (or recursive) computation does not block other
+ *  threads. Since the key is only looked up once, the wrapped database's
+ *  find_or_compute must tolerate another thread storing a value for the key
+ *  while the callback runs (KeyProxyMapper, e.g., keeps that value and
+ *  returns it to both threads). try_insert is atomic.
+ *
+ *  @tparam KeyType The type of the keys.
+ *  @tparam ValueType The type of the values.
+ */
+template<typename KeyType, typename ValueType>
+class Synchronized : public DatabaseAPI<KeyType, ValueType> {
+private:
+    /// Type of the API this class implements
+    using base_type = DatabaseAPI<KeyType, ValueType>;
+
+public:
+    /// Type of the keys, typedef of KeyType
+    using typename base_type::key_type;
+
+    /// Type of a read-only reference to a key, typedef of const KeyType&
+    using typename base_type::const_key_reference;
+
+    /// Type that the keys map to, typedef of ValueType
+    using typename base_type::mapped_type;
+
+    /// Type of an object holding a read-only reference
+    using typename base_type::const_mapped_reference;
+
+    /// Ultimately a typedef of DatabaseAPI::key_set_type
+    using typename base_type::key_set_type;
+
+    /// Type of the callback used by find_or_compute
+    using typename base_type::compute_function;
+
+    /// Type of the database this instance guards
+    using wrapped_db = base_type;
+
+    /// Type of a pointer to the database this instance guards
+    using wrapped_db_pointer = std::unique_ptr<wrapped_db>;
+
+    /** @brief Makes a new Synchronized instance which guards @p db.
+     *
+     *  @param[in] db A non-null pointer to the database to guard. All access
+     *                to @p db must go through the created instance.
+     *
+     *  @throw std::runtime_error if @p db is a null pointer. Strong throw
+     *                            guarantee.
+     */
+    explicit Synchronized(wrapped_db_pointer db);
+
+protected:
+    /// Calls m_db_->keys() under a shared lock
+    key_set_type keys_() const override;
+
+    /// Calls m_db_->count() under a shared lock
+    bool count_(const_key_reference key) const noexcept override;
+
+    /// Calls m_db_->insert() under an exclusive lock
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Calls m_db_->free() under an exclusive lock
+    void free_(const_key_reference key) override;
+
+    /// Copies m_db_->operator[]() under a shared lock
+    const_mapped_reference at_(const_key_reference key) const override;
+
+    /// Copies m_db_->try_at() under a shared lock
+    const_mapped_reference try_at_(const_key_reference key) const override;
+
+    /// Looks up under a shared lock, computes unlocked, inserts exclusively
+    const_mapped_reference find_or_compute_(
+      const_key_reference key, const compute_function& fxn) override;
+
+    /// Calls m_db_->try_insert() under an exclusive lock
+    const_mapped_reference try_insert_(key_type key,
+                                       mapped_type value) override;
+
+    /// Calls m_db_->backup() under an exclusive lock
+    void backup_() override;
+
+    /// Calls m_db_->dump() under an exclusive lock
+    void dump_() override;
+
+    /// Calls m_db_->memory_footprint() under a shared lock
+    std::size_t memory_footprint_() const noexcept override;
+
+    /// Calls m_db_->begin_batch() under an exclusive lock
+    void begin_batch_() override;
+
+    /// Calls m_db_->commit_batch() under an exclusive lock
+    void commit_batch_() override;
+
+    /// Calls m_db_->abort_batch() under an exclusive lock
+    void abort_batch_() override;
+
+private:
+    /// Type of the lock used for reading
+    using read_lock = std::shared_lock<std::shared_mutex>;
+
+    /// Type of the lock used for writing
+    using write_lock = std::unique_lock<std::shared_mutex>;
+
+    /// Code factorization for copying a value, if it is aliased
+    static const_mapped_reference copy_(const_mapped_reference value);
+
+    /// Guards m_db_
+    mutable std::shared_mutex m_mutex_;
+
+    /// The database being guarded
+    wrapped_db_pointer m_db_;
+};
+
+} // namespace pluginplay::cache::database
+
+#include "synchronized.ipp"
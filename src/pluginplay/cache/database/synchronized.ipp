@@ -0,0 +1,139 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// File meant only for inclusion from synchronized.hpp
+
+namespace pluginplay::cache::database {
+
+#define TPARAMS template<typename KeyType, typename ValueType>
+#define SYNCHRONIZED Synchronized<KeyType, ValueType>
+
+TPARAMS
+SYNCHRONIZED::Synchronized(wrapped_db_pointer db) : m_db_(std::move(db)) {
+    if(m_db_) return;
+    throw std::runtime_error("Was expecting a non-null database.");
+}
+
+TPARAMS
+typename SYNCHRONIZED::key_set_type SYNCHRONIZED::keys_() const {
+    read_lock lock(m_mutex_);
+    return m_db_->keys();
+}
+
+TPARAMS
+bool SYNCHRONIZED::count_(const_key_reference key) const noexcept {
+    read_lock lock(m_mutex_);
+    return m_db_->count(key);
+}
+
+TPARAMS
+void SYNCHRONIZED::insert_(key_type key, mapped_type value) {
+    write_lock lock(m_mutex_);
+    m_db_->insert(std::move(key), std::move(value));
+}
+
+TPARAMS
+void SYNCHRONIZED::free_(const_key_reference key) {
+    write_lock lock(m_mutex_);
+    m_db_->free(key);
+}
+
+TPARAMS
+typename SYNCHRONIZED::const_mapped_reference SYNCHRONIZED::at_(
+  const_key_reference key) const {
+    read_lock lock(m_mutex_);
+    return copy_((*m_db_)[key]);
+}
+
+TPARAMS
+typename SYNCHRONIZED::const_mapped_reference SYNCHRONIZED::try_at_(
+  const_key_reference key) const {
+    read_lock lock(m_mutex_);
+    return copy_(m_db_->try_at(key));
+}
+
+TPARAMS
+typename SYNCHRONIZED::const_mapped_reference SYNCHRONIZED::find_or_compute_(
+  const_key_reference key, const compute_function& fxn) {
+    // The wrapped database looks key up once and, on a miss, reuses what it
+    // learned for the insert. Looking up only needs the shared lock, which we
+    // trade for the exclusive lock around fxn. So fxn runs without the lock
+    // (it may be expensive or reentrant) and the insert runs with it.
+    read_lock rlock(m_mutex_);
+    write_lock wlock(m_mutex_, std::defer_lock);
+    auto unlocked_fxn = [&]() {
+        rlock.unlock();
+        auto value = fxn();
+        wlock.lock();
+        return value;
+    };
+    return copy_(m_db_->find_or_compute(key, unlocked_fxn));
+}
+
+TPARAMS
+typename SYNCHRONIZED::const_mapped_reference SYNCHRONIZED::try_insert_(
+  key_type key, mapped_type value) {
+    write_lock lock(m_mutex_);
+    return copy_(m_db_->try_insert(std::move(key), std::move(value)));
+}
+
+TPARAMS
+void SYNCHRONIZED::backup_() {
+    write_lock lock(m_mutex_);
+    m_db_->backup();
+}
+
+TPARAMS
+void SYNCHRONIZED::dump_() {
+    write_lock lock(m_mutex_);
+    m_db_->dump();
+}
+
+TPARAMS
+std::size_t SYNCHRONIZED::memory_footprint_() const noexcept {
+    read_lock lock(m_mutex_);
+    return m_db_->memory_footprint();
+}
+
+TPARAMS
+void SYNCHRONIZED::begin_batch_() {
+    write_lock lock(m_mutex_);
+    m_db_->begin_batch();
+}
+
+TPARAMS
+void SYNCHRONIZED::commit_batch_() {
+    write_lock lock(m_mutex_);
+    m_db_->commit_batch();
+}
+
+TPARAMS
+void SYNCHRONIZED::abort_batch_() {
+    write_lock lock(m_mutex_);
+    m_db_->abort_batch();
+}
+
+TPARAMS
+typename SYNCHRONIZED::const_mapped_reference SYNCHRONIZED::copy_(
+  const_mapped_reference value) {
+    if(!value.is_alias()) return value;
+    return const_mapped_reference(value.get());
+}
+
+#undef SYNCHRONIZED
+#undef TPARAMS
+
+} // namespace pluginplay::cache::database
@@ -16,7 +16,8 @@
 
 #pragma once
 #include "database_api.hpp"
-#include <set>
+#include <functional>
+#include <unordered_map>
 
 namespace pluginplay::cache::database {
 
@@ -42,6 +43,16 @@ namespace pluginplay::cache::database {
  *  This class does nothing to prevent this from happening (in case that's the
  *  user's desired behvior).
  *
+ *  To avoid having to search the wrapped database for a value, Transposer
+ *  maintains an index from the hash of each key to the value it is stored
+ *  under. Lookups hash the key, and then only compare the key against the
+ *  (usually one) key stored with that hash. Hence @p KeyType must be hashable
+ *  with `std::hash` and the hash must be consistent with `operator==`.
+ *
+ *  The wrapped database may drop entries on its own (e.g., a Bounded database
+ *  evicting values which can't be spilled). Keys whose entries were dropped
+ *  are treated as if they had been freed.
+ *
  *  @tparam KeyType The type of the keys. Will actually be the values in the
  *                  wrapped database.
  *  @tparam ValueType The types of the values. Will actually be the keys in the
@@ -72,8 +83,15 @@ public:
     /// Type of the API the wrapped database satisfies
     using wrapped_db_type = DatabaseAPI<mapped_type, key_type>;
 
-    /// Type of a smart pointer to a database suitable for wrapping
-    using wrapped_db_pointer = std::unique_ptr<wrapped_db_type>;
+    /// Type of a smart pointer to a database suitable for wrapping. Shared,
+    /// so the wrapped database can also be read directly (e.g., by UUIDMapper)
+    using wrapped_db_pointer = std::shared_ptr<wrapped_db_type>;
+
+    /// Type of the functor used to hash keys
+    using hasher_type = std::hash<key_type>;
+
+    /// Type of the index mapping hashes of keys to the values they map to
+    using index_type = std::unordered_multimap<std::size_t, mapped_type>;
 
     /** @brief Creates a new Transposer instance by wrapping the provided
      *         database.
@@ -96,30 +114,57 @@ public:
     explicit Transposer(wrapped_db_pointer p);
 
 protected:
-    /// Returns a copy of m_keys_
+    /// Retrieves the key for each value in m_index_ from the wrapped database
     key_set_type keys_() const override;
 
-    /// Loops over m_keys_ looking for a "key" whose value is @p key
+    /// Uses m_index_ to look for a "key" whose value is @p key
     bool count_(const_key_reference key) const noexcept override;
 
     /// Adds @p key to the wrapped database under the "key" @p value
     void insert_(key_type key, mapped_type value) override;
 
-    /// Loops over m_keys_ and if a value maps to @p key that value is freed
+    /// Uses m_index_ to find the value that maps to @p key and frees it
     void free_(const_key_reference key) override;
 
-    /// Loops over m_keys_ returning the value that maps to @p key
+    /// Uses m_index_ to return the value that maps to @p key
     const_mapped_reference at_(const_key_reference key) const override;
 
+    /// Looks up key in the index once
+    const_mapped_reference try_at_(const_key_reference key) const override;
+
     /// Calls backup on the wrapped databse
     void backup_() override { m_db_->backup(); }
 
-    /// Calls dump on the wrapped database and clear on m_keys_
+    /// Calls dump on the wrapped database and clear on m_index_
     void dump_() override;
 
+    /// Footprint of the wrapped database (m_index_ is not counted)
+    std::size_t memory_footprint_() const noexcept override;
+
+    /// Calls begin_batch on the wrapped database
+    void begin_batch_() override;
+
+    /// Calls commit_batch on the wrapped database
+    void commit_batch_() override;
+
+    /// Calls abort_batch on the wrapped database
+    void abort_batch_() override;
+
 private:
-    /// The values the user has provided, they are keys in the wrapped database
-    std::set<mapped_type> m_keys_;
+    /// Type of an iterator to an entry in m_index_
+    using index_iterator = typename index_type::const_iterator;
+
+    /// Returns the entry of m_index_ for @p key (or m_index_.end())
+    index_iterator find_(const_key_reference key) const;
+
+    /// Removes the entry of m_index_ for @p value, if it has one
+    void erase_value_(const mapped_type& value);
+
+    /// Removes the entries of m_index_ with @p hash the wrapped DB dropped
+    void erase_dropped_(std::size_t hash);
+
+    /// Maps the hashes of the user's keys to the values they map to
+    index_type m_index_;
 
     /// The wrapped database
     wrapped_db_pointer m_db_;
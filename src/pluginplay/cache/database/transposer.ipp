@@ -29,45 +29,111 @@ TRANSPOSER::Transposer(wrapped_db_pointer p) : m_db_(std::move(p)) {
 TPARAMS
 typename TRANSPOSER::key_set_type TRANSPOSER::keys_() const {
     key_set_type rv;
-    for(const auto& val : m_keys_) rv.push_back(m_db_->at(val).get());
+    for(const auto& [_, val] : m_index_) {
+        auto key = m_db_->try_at(val);
+        if(key.has_value()) rv.push_back(key.get());
+    }
     return rv;
 }
 
 TPARAMS
 bool TRANSPOSER::count_(const_key_reference key) const noexcept {
-    for(const auto& val : m_keys_)
-        if(m_db_->at(val).get() == key) return true;
-    return false;
+    return find_(key) != m_index_.end();
 }
 
 TPARAMS
 void TRANSPOSER::insert_(key_type key, mapped_type value) {
-    m_keys_.insert(value);
-    m_db_->insert(std::move(value), std::move(key));
+    // If key is already stored, release the value it used to be stored under
+    auto itr = find_(key);
+    if(itr != m_index_.end()) {
+        if(itr->second != value) m_db_->free(itr->second);
+        m_index_.erase(itr);
+    }
+
+    // If value is already in use, the key stored under it is overwritten
+    erase_value_(value);
+
+    const auto hash = hasher_type{}(key);
+    erase_dropped_(hash);
+    m_db_->insert(value, std::move(key));
+    m_index_.emplace(hash, std::move(value));
 }
 
 TPARAMS
 void TRANSPOSER::free_(const_key_reference key) {
-    for(const auto& val : m_keys_)
-        if(m_db_->at(val).get() == key) {
-            m_db_->free(val);
-            m_keys_.erase(val);
-            return;
-        }
+    auto itr = find_(key);
+    if(itr == m_index_.end()) return;
+    m_db_->free(itr->second);
+    m_index_.erase(itr);
 }
 
 TPARAMS
 typename TRANSPOSER::const_mapped_reference TRANSPOSER::at_(
   const_key_reference key) const {
-    for(const auto& val : m_keys_)
-        if(m_db_->at(val).get() == key) return const_mapped_reference{&val};
+    auto itr = find_(key);
+    if(itr != m_index_.end()) return const_mapped_reference{&itr->second};
     throw std::out_of_range("Key not found");
 }
 
+TPARAMS
+typename TRANSPOSER::const_mapped_reference TRANSPOSER::try_at_(
+  const_key_reference key) const {
+    auto itr = find_(key);
+    if(itr == m_index_.end()) return const_mapped_reference{};
+    return const_mapped_reference{&itr->second};
+}
+
 TPARAMS
 void TRANSPOSER::dump_() {
     m_db_->dump();
-    m_keys_.clear();
+    m_index_.clear();
+}
+
+TPARAMS
+std::size_t TRANSPOSER::memory_footprint_() const noexcept {
+    return m_db_->memory_footprint();
+}
+
+TPARAMS
+void TRANSPOSER::begin_batch_() { m_db_->begin_batch(); }
+
+TPARAMS
+void TRANSPOSER::commit_batch_() { m_db_->commit_batch(); }
+
+TPARAMS
+void TRANSPOSER::abort_batch_() { m_db_->abort_batch(); }
+
+TPARAMS
+typename TRANSPOSER::index_iterator TRANSPOSER::find_(
+  const_key_reference key) const {
+    auto [begin, end] = m_index_.equal_range(hasher_type{}(key));
+    for(auto itr = begin; itr != end; ++itr) {
+        auto stored = m_db_->try_at(itr->second);
+        if(stored.has_value() && stored.get() == key) return itr;
+    }
+    return m_index_.end();
+}
+
+TPARAMS
+void TRANSPOSER::erase_value_(const mapped_type& value) {
+    if(!m_db_->count(value)) return;
+    auto old_key      = m_db_->at(value);
+    auto [begin, end] = m_index_.equal_range(hasher_type{}(old_key.get()));
+    for(auto itr = begin; itr != end; ++itr) {
+        if(itr->second != value) continue;
+        m_index_.erase(itr);
+        return;
+    }
+}
+
+TPARAMS
+void TRANSPOSER::erase_dropped_(std::size_t hash) {
+    auto [begin, end] = m_index_.equal_range(hash);
+    for(auto itr = begin; itr != end;) {
+        auto next = std::next(itr);
+        if(!m_db_->count(itr->second)) m_index_.erase(itr);
+        itr = next;
+    }
 }
 
 #undef TRANSPOSER
@@ -31,7 +31,10 @@ namespace pluginplay::cache::database {
  *
  *  N.B. Specializations are expected to have a function `convert` which takes
  *       an object of type U (U is const T&, or just T) and returns an object
- *       of type AnyField.
+ *       of type AnyField. Specializations for types which are read back from
+ *       long-term storage (see UUIDMapper::un_proxy) should also have a
+ *       function `revert` which undoes `convert`, i.e., takes a const
+ *       AnyField& and returns a T.
  *
  *  @tparam T The type being type-erased.
  */
@@ -41,6 +44,8 @@ struct MakeAny {
     static auto convert(U&& v) {
         return any::make_any_field<T>(std::forward<U>(v));
     }
+
+    static T revert(const any::AnyField& v) { return any::any_cast<T>(v); }
 };
 
 /** @brief Converts the keys to type-erased objects before storing.
@@ -73,6 +78,9 @@ public:
     /// Type of an object holding a read-only reference
     using typename base_type::const_mapped_reference;
 
+    /// Type of the callback used by find_or_compute
+    using typename base_type::compute_function;
+
     /// Ultimately a typedef of DatabaseAPI::key_set_type
     using typename base_type::key_set_type;
 
@@ -114,12 +122,32 @@ public:
     /// type-erases key, then calls m_db_->insert()
     const_mapped_reference at_(const_key_reference key) const override;
 
+    /// type-erases key, then calls m_db_->try_at
+    const_mapped_reference try_at_(const_key_reference key) const override;
+
+    /// type-erases key, then calls m_db_->find_or_compute
+    const_mapped_reference find_or_compute_(
+      const_key_reference key, const compute_function& fxn) override;
+
+    /// type-erases key, then calls m_db_->try_insert
+    const_mapped_reference try_insert_(key_type key,
+                                       mapped_type value) override;
+
     /// Just calls m_db_->backup()
     void backup_() override { m_db_->backup(); }
 
     /// Just calls m_db_->dump
     void dump_() override { m_db_->dump(); }
 
+    /// Just calls m_db_->begin_batch()
+    void begin_batch_() override { m_db_->begin_batch(); }
+
+    /// Just calls m_db_->commit_batch()
+    void commit_batch_() override { m_db_->commit_batch(); }
+
+    /// Just calls m_db_->abort_batch()
+    void abort_batch_() override { m_db_->abort_batch(); }
+
 private:
     /// Code factorization for type-erasing a read-only reference
     any_type wrap_(const_key_reference key) const;
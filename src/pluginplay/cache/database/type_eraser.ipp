@@ -54,6 +54,24 @@ typename TYPE_ERASER::const_mapped_reference TYPE_ERASER::at_(
     return m_db_->at(wrap_(key));
 }
 
+TPARAMS
+typename TYPE_ERASER::const_mapped_reference TYPE_ERASER::try_at_(
+  const_key_reference key) const {
+    return m_db_->try_at(wrap_(key));
+}
+
+TPARAMS
+typename TYPE_ERASER::const_mapped_reference TYPE_ERASER::find_or_compute_(
+  const_key_reference key, const compute_function& fxn) {
+    return m_db_->find_or_compute(wrap_(key), fxn);
+}
+
+TPARAMS
+typename TYPE_ERASER::const_mapped_reference TYPE_ERASER::try_insert_(
+  key_type key, mapped_type value) {
+    return m_db_->try_insert(wrap_(key), std::move(value));
+}
+
 TPARAMS typename TYPE_ERASER::any_type TYPE_ERASER::wrap_(
   const_key_reference key) const {
     return MakeAny<key_type>::convert(key);
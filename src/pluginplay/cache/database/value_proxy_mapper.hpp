@@ -102,6 +102,15 @@ protected:
     /// backs proxy_mapper up and dumps sub_db
     void dump_() override;
 
+    /// Calls begin_batch on both proxy_mapper and sub_db
+    void begin_batch_() override;
+
+    /// Calls commit_batch on both proxy_mapper and sub_db
+    void commit_batch_() override;
+
+    /// Calls abort_batch on both proxy_mapper and sub_db
+    void abort_batch_() override;
+
 private:
     /// Used to map keys to proxy maps
     proxy_map_maker_pointer m_proxy_mapper_;
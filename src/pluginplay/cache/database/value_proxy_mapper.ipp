@@ -66,6 +66,24 @@ void VALUE_PROXY_MAPPER::dump_() {
     m_sub_db_->dump();
 }
 
+TPARAMS
+void VALUE_PROXY_MAPPER::begin_batch_() {
+    m_proxy_mapper_->begin_batch();
+    m_sub_db_->begin_batch();
+}
+
+TPARAMS
+void VALUE_PROXY_MAPPER::commit_batch_() {
+    m_sub_db_->commit_batch();
+    m_proxy_mapper_->commit_batch();
+}
+
+TPARAMS
+void VALUE_PROXY_MAPPER::abort_batch_() {
+    m_sub_db_->abort_batch();
+    m_proxy_mapper_->abort_batch();
+}
+
 #undef VALUE_PROXY_MAPPER
 #undef TPARAMS
 
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <functional>
+#include <string_view>
+
+namespace pluginplay::cache::database {
+
+/** @brief API for binary databases which can lend out their values' bytes.
+ *
+ *  Databases which store their values as bytes (e.g., RocksDB) can derive
+ *  from this class, in addition to DatabaseAPI, to let callers read a value
+ *  in place instead of receiving a copy of it. Serialized checks whether the
+ *  database it wraps is Viewable and, if so, deserializes directly from the
+ *  database's memory.
+ *
+ *  @tparam KeyType The type of the keys of the database.
+ */
+template<typename KeyType>
+class Viewable {
+public:
+    /// Type of the keys
+    using key_type = KeyType;
+
+    /// Type of a read-only reference to a key
+    using const_key_reference = const key_type&;
+
+    /// Type of a read-only view of a value's bytes
+    using view_type = std::string_view;
+
+    /// Type of the callback which is handed the view
+    using visitor_type = std::function<void(view_type)>;
+
+    /// No-op polymorphic dtor
+    virtual ~Viewable() noexcept = default;
+
+    /** @brief Calls @p fxn with a view of the value associated with @p key.
+     *
+     *  @param[in] key The key of the value to view.
+     *  @param[in] fxn Called with the value's bytes, if @p key is in the
+     *                 database. The view is only valid during the call.
+     *
+     *  @return True if @p key is in the database (and thus @p fxn was called)
+     *          and false otherwise.
+     *
+     *  @throw ??? Throws if the database throws or if @p fxn throws. Same
+     *             throw guarantee.
+     */
+    virtual bool view(const_key_reference key,
+                      const visitor_type& fxn) const = 0;
+};
+
+} // namespace pluginplay::cache::database
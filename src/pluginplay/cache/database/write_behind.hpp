@@ -0,0 +1,231 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "database_api.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace pluginplay::cache::database {
+
+/** @brief Writes to the wrapped database from a background thread.
+ *
+ *  Writing to long-term storage (serializing the value and handing it to,
+ *  e.g., RocksDB) can take much longer than computing a cheap result,
+ *  especially on a shared filesystem. This class makes insert and free
+ *  return right away: the change is queued in memory and a background
+ *  thread applies the queued changes to the wrapped database, in batches.
+ *
+ *  Queued changes are visible immediately, i.e., count, at, and try_at
+ *  first look at the queue and only then at the wrapped database. If a key
+ *  is changed again before its change was written, only the newest change is
+ *  written.
+ *
+ *  The queue is bounded: once the queued values occupy more than the limit
+ *  passed to the ctor, insert and free block until the background thread has
+ *  caught up (a single value bigger than the limit is queued once the queue
+ *  is empty). Hence the memory used by the queue stays bounded and a slow
+ *  wrapped database slows the callers down instead of exhausting memory.
+ *
+ *  Changes are only guaranteed to have reached the wrapped database after a
+ *  call to flush, backup, or dump, or after *this is destroyed. If the
+ *  background thread fails to write a change, the change is dropped and the
+ *  error is rethrown by the next call to flush, backup, or dump.
+ *
+ *  All access to the wrapped database is serialized by *this, so *this may be
+ *  used from several threads at once. Values are returned as copies.
+ *
+ *  @tparam KeyType The type of the keys.
+ *  @tparam ValueType The type of the values.
+ */
+template<typename KeyType, typename ValueType>
+class WriteBehind : public DatabaseAPI<KeyType, ValueType> {
+private:
+    /// Type of the API this class implements
+    using base_type = DatabaseAPI<KeyType, ValueType>;
+
+public:
+    /// Type of the keys, typedef of KeyType
+    using typename base_type::key_type;
+
+    /// Ultimately a typedef of DatabaseAPI::key_set_type
+    using typename base_type::key_set_type;
+
+    /// Type of a read-only reference to a key, typedef of const KeyType&
+    using typename base_type::const_key_reference;
+
+    /// Type that the keys map to, typedef of ValueType
+    using typename base_type::mapped_type;
+
+    /// Type of an object holding a read-only reference
+    using typename base_type::const_mapped_reference;
+
+    /// Type used for sizes
+    using size_type = std::size_t;
+
+    /// Type of a callable which returns the size of a value in bytes
+    using size_function = std::function<size_type(const mapped_type&)>;
+
+    /// Type of the database written to in the background
+    using sub_db_type = DatabaseAPI<key_type, mapped_type>;
+
+    /// Type of a pointer to the database written to in the background
+    using sub_db_pointer = std::unique_ptr<sub_db_type>;
+
+    /** @brief Wraps @p db and starts the background thread.
+     *
+     *  @param[in] db The database changes are written to. Must be non-null.
+     *                All access to @p db must go through the created
+     *                instance.
+     *  @param[in] max_bytes How many bytes the queued values may occupy
+     *                       before insert and free block.
+     *  @param[in] size A callable which returns the size of a value in bytes.
+     *                  Must be non-null.
+     *
+     *  @throw std::runtime_error if @p db or @p size is null. Strong throw
+     *                            guarantee.
+     *  @throw std::system_error if the thread can't be started. Strong throw
+     *                           guarantee.
+     */
+    WriteBehind(sub_db_pointer db, size_type max_bytes, size_function size);
+
+    /// Deleted because the background thread holds a pointer to *this
+    WriteBehind(const WriteBehind&) = delete;
+
+    /// Deleted because the background thread holds a pointer to *this
+    WriteBehind& operator=(const WriteBehind&) = delete;
+
+    /** @brief Writes the queued changes, then stops the background thread.
+     *
+     *  Errors writing the queued changes are ignored.
+     *
+     *  @throw None No throw guarantee.
+     */
+    ~WriteBehind() noexcept override;
+
+    /** @brief Waits until every queued change has been written.
+     *
+     *  @throw ??? Rethrows the first error the background thread ran into
+     *             since the last call to flush (or to a function calling it).
+     *             The changes which failed are lost.
+     */
+    void flush();
+
+    /// The number of bytes the queued values occupy
+    size_type pending_bytes() const noexcept;
+
+protected:
+    /// Waits for the queue to empty, then calls m_db_->keys()
+    key_set_type keys_() const override;
+
+    /// Checks the queue, then the wrapped database
+    bool count_(const_key_reference key) const noexcept override;
+
+    /// Queues the insertion, blocking if the queue is full
+    void insert_(key_type key, mapped_type value) override;
+
+    /// Queues the removal, blocking if the queue is full
+    void free_(const_key_reference key) override;
+
+    /// Like try_at_, but throws if @p key is not present
+    const_mapped_reference at_(const_key_reference key) const override;
+
+    /// Copies the value from the queue or the wrapped database
+    const_mapped_reference try_at_(const_key_reference key) const override;
+
+    /// Flushes, then calls m_db_->backup()
+    void backup_() override;
+
+    /// Flushes, then calls m_db_->dump()
+    void dump_() override;
+
+    /// Calls m_db_->memory_footprint()
+    std::size_t memory_footprint_() const noexcept override;
+
+private:
+    /// A queued change, a null value means the key is being freed
+    struct pending_type {
+        std::shared_ptr<const mapped_type> m_value;
+        size_type m_size;
+        std::uint64_t m_id;
+    };
+
+    /// Type of the queue, newer changes to a key replace older ones
+    using pending_map = std::map<key_type, pending_type>;
+
+    /// Type of the lock used with the condition variable
+    using lock_type = std::unique_lock<std::mutex>;
+
+    /// Type of the lock used for m_db_
+    using db_lock_type = std::lock_guard<std::mutex>;
+
+    /// Waits for room and queues @p change under @p key
+    void enqueue_(key_type key, pending_type change);
+
+    /// Waits until the queue is empty (caller must hold @p lock)
+    void wait_for_writes_(lock_type& lock) const;
+
+    /// What the background thread runs
+    void write_loop_();
+
+    /// Guards the state, but not m_db_
+    mutable std::mutex m_mutex_;
+
+    /// Signals that the queue changed, or that the thread should stop
+    mutable std::condition_variable m_cv_;
+
+    /// The changes waiting to be written
+    pending_map m_pending_;
+
+    /// The number of bytes the values in m_pending_ occupy
+    size_type m_bytes_ = 0;
+
+    /// Used to tell changes to the same key apart
+    std::uint64_t m_next_id_ = 0;
+
+    /// The first error the background thread ran into, if any
+    std::exception_ptr m_error_;
+
+    /// Set by the dtor to stop the background thread
+    bool m_done_ = false;
+
+    /// How many bytes the queue may hold
+    size_type m_max_bytes_;
+
+    /// Computes the sizes of the values
+    size_function m_size_fxn_;
+
+    /// Guards m_db_
+    mutable std::mutex m_db_mutex_;
+
+    /// The database being written to
+    sub_db_pointer m_db_;
+
+    /// The background thread, started last
+    std::thread m_writer_;
+};
+
+} // namespace pluginplay::cache::database
+
+#include "write_behind.ipp"
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// File meant only for inclusion from write_behind.hpp
+
+namespace pluginplay::cache::database {
+
+#define TPARAMS template<typename KeyType, typename ValueType>
+#define WRITE_BEHIND WriteBehind<KeyType, ValueType>
+
+TPARAMS
+WRITE_BEHIND::WriteBehind(sub_db_pointer db, size_type max_bytes,
+                          size_function size) :
+  m_max_bytes_(max_bytes), m_size_fxn_(std::move(size)), m_db_(std::move(db)) {
+    if(!m_db_ || !m_size_fxn_)
+        throw std::runtime_error("Was expecting a database and size function");
+    m_writer_ = std::thread([this]() { write_loop_(); });
+}
+
+TPARAMS
+WRITE_BEHIND::~WriteBehind() noexcept {
+    {
+        lock_type lock(m_mutex_);
+        m_done_ = true;
+    }
+    m_cv_.notify_all();
+    // N.B. the thread writes whatever is still queued before it returns
+    m_writer_.join();
+}
+
+TPARAMS
+void WRITE_BEHIND::flush() {
+    lock_type lock(m_mutex_);
+    wait_for_writes_(lock);
+    if(m_error_) std::rethrow_exception(std::exchange(m_error_, nullptr));
+}
+
+TPARAMS
+typename WRITE_BEHIND::size_type WRITE_BEHIND::pending_bytes() const noexcept {
+    lock_type lock(m_mutex_);
+    return m_bytes_;
+}
+
+TPARAMS
+typename WRITE_BEHIND::key_set_type WRITE_BEHIND::keys_() const {
+    {
+        lock_type lock(m_mutex_);
+        wait_for_writes_(lock);
+    }
+    db_lock_type lock(m_db_mutex_);
+    return m_db_->keys();
+}
+
+TPARAMS
+bool WRITE_BEHIND::count_(const_key_reference key) const noexcept {
+    {
+        lock_type lock(m_mutex_);
+        auto itr = m_pending_.find(key);
+        if(itr != m_pending_.end()) return itr->second.m_value != nullptr;
+    }
+    db_lock_type lock(m_db_mutex_);
+    return m_db_->count(key);
+}
+
+TPARAMS
+void WRITE_BEHIND::insert_(key_type key, mapped_type value) {
+    const auto size = m_size_fxn_(value);
+    auto pvalue     = std::make_shared<const mapped_type>(std::move(value));
+    enqueue_(std::move(key), pending_type{std::move(pvalue), size, 0});
+}
+
+TPARAMS
+void WRITE_BEHIND::free_(const_key_reference key) {
+    enqueue_(key, pending_type{nullptr, 0, 0});
+}
+
+TPARAMS
+typename WRITE_BEHIND::const_mapped_reference WRITE_BEHIND::at_(
+  const_key_reference key) const {
+    auto rv = try_at_(key);
+    if(rv.has_value()) return rv;
+    throw std::out_of_range("Key was not found in the database");
+}
+
+TPARAMS
+typename WRITE_BEHIND::const_mapped_reference WRITE_BEHIND::try_at_(
+  const_key_reference key) const {
+    {
+        lock_type lock(m_mutex_);
+        auto itr = m_pending_.find(key);
+        if(itr != m_pending_.end()) {
+            if(!itr->second.m_value) return const_mapped_reference{};
+            return const_mapped_reference(*itr->second.m_value);
+        }
+    }
+    db_lock_type lock(m_db_mutex_);
+    auto rv = m_db_->try_at(key);
+    if(!rv.has_value()) return const_mapped_reference{};
+    return const_mapped_reference(rv.get());
+}
+
+TPARAMS
+void WRITE_BEHIND::backup_() {
+    flush();
+    db_lock_type lock(m_db_mutex_);
+    m_db_->backup();
+}
+
+TPARAMS
+void WRITE_BEHIND::dump_() {
+    flush();
+    db_lock_type lock(m_db_mutex_);
+    m_db_->dump();
+}
+
+TPARAMS
+std::size_t WRITE_BEHIND::memory_footprint_() const noexcept {
+    db_lock_type lock(m_db_mutex_);
+    return m_db_->memory_footprint();
+}
+
+TPARAMS
+void WRITE_BEHIND::wait_for_writes_(lock_type& lock) const {
+    m_cv_.wait(lock, [this]() { return m_pending_.empty(); });
+}
+
+TPARAMS
+void WRITE_BEHIND::enqueue_(key_type key, pending_type change) {
+    lock_type lock(m_mutex_);
+    // Back-pressure: wait for the writer unless there is room (or nothing to
+    // wait for, so a single value bigger than the limit can still be queued)
+    m_cv_.wait(lock, [this, &change]() {
+        return m_pending_.empty() || m_bytes_ + change.m_size <= m_max_bytes_;
+    });
+
+    change.m_id = m_next_id_++;
+    m_bytes_ += change.m_size;
+    auto [itr, is_new] = m_pending_.try_emplace(std::move(key), change);
+    if(!is_new) {
+        m_bytes_ -= itr->second.m_size;
+        itr->second = std::move(change);
+    }
+    lock.unlock();
+    m_cv_.notify_all();
+}
+
+TPARAMS
+void WRITE_BEHIND::write_loop_() {
+    using batch_type = std::vector<std::pair<key_type, pending_type>>;
+
+    lock_type lock(m_mutex_);
+    while(true) {
+        m_cv_.wait(lock, [this]() { return m_done_ || !m_pending_.empty(); });
+        if(m_pending_.empty()) return; // Only happens if m_done_ is set
+
+        // Changes queued while we write are picked up by the next iteration
+        batch_type batch(m_pending_.begin(), m_pending_.end());
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            db_lock_type db_lock(m_db_mutex_);
+            BatchScope<sub_db_type> scope(*m_db_);
+            for(const auto& [key, change] : batch) {
+                if(change.m_value)
+                    m_db_->insert(key, *change.m_value);
+                else
+                    m_db_->free(key);
+            }
+            scope.commit();
+        } catch(...) { error = std::current_exception(); }
+
+        lock.lock();
+        if(error && !m_error_) m_error_ = error;
+
+        // Dequeue what we wrote, unless the key was changed in the meantime
+        for(const auto& [key, change] : batch) {
+            auto itr = m_pending_.find(key);
+            if(itr == m_pending_.end()) continue;
+            if(itr->second.m_id != change.m_id) continue;
+            m_bytes_ -= itr->second.m_size;
+            m_pending_.erase(itr);
+        }
+        m_cv_.notify_all();
+    }
+}
+
+#undef WRITE_BEHIND
+#undef TPARAMS
+
+} // namespace pluginplay::cache::database
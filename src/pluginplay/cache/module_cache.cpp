@@ -34,7 +34,14 @@ bool ModuleCache::count(const_key_reference key) const {
 }
 
 void ModuleCache::cache(key_type key, mapped_type value) {
-    pimpl_().m_db->insert(std::move(key), std::move(value));
+    auto& p           = pimpl_();
+    auto& db          = *p.m_db;
+    const auto nbytes = database::result_map_footprint(value);
+    // Groups the writes to long-term storage (the UUIDs, proxy maps, etc.)
+    database::BatchScope batch(db);
+    db.insert(std::move(key), std::move(value));
+    batch.commit();
+    p.m_metrics->inserted(nbytes);
 }
 
 typename ModuleCache::mapped_type ModuleCache::uncache(
@@ -43,11 +50,52 @@ typename ModuleCache::mapped_type ModuleCache::uncache(
     return m_pimpl_->m_db->at(key).get();
 }
 
+std::optional<typename ModuleCache::mapped_type> ModuleCache::try_get(
+  const_key_reference key) const {
+    if(!m_pimpl_) return std::nullopt;
+    auto rv = m_pimpl_->m_db->try_at(key);
+    if(!rv.has_value()) return std::nullopt;
+    return rv.get();
+}
+
+typename ModuleCache::mapped_type ModuleCache::find_or_compute(
+  const_key_reference key, const compute_function& fxn) {
+    return pimpl_().find_or_compute(key, fxn);
+}
+
+typename ModuleCache::metrics_type ModuleCache::metrics() const noexcept {
+    if(!m_pimpl_) return metrics_type{};
+    return m_pimpl_->metrics();
+}
+
+typename ModuleCache::size_type ModuleCache::memory_footprint() const noexcept {
+    if(!m_pimpl_) return 0;
+    return m_pimpl_->m_db->memory_footprint();
+}
+
 void ModuleCache::clear() {
     if(!m_pimpl_) return;
     m_pimpl_->m_db->dump();
 }
 
+void ModuleCache::backup() {
+    if(!m_pimpl_) return;
+    m_pimpl_->m_db->backup();
+}
+
+void ModuleCache::set_persistent(bool persistent) noexcept {
+    if(!m_pimpl_) return;
+    // Checked first so runs which don't change it don't write to shared state
+    auto& flag = *m_pimpl_->m_persist;
+    if(flag.load(std::memory_order_relaxed) != persistent)
+        flag.store(persistent, std::memory_order_relaxed);
+}
+
+bool ModuleCache::is_persistent() const noexcept {
+    if(!m_pimpl_) return false;
+    return m_pimpl_->m_persist->load(std::memory_order_relaxed);
+}
+
 void ModuleCache::assert_pimpl_() const {
     if(m_pimpl_) return;
     throw std::runtime_error("ModuleCache does not have a PIMPL. Did you move "
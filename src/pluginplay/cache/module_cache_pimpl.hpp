@@ -15,14 +15,33 @@
  */
 
 #pragma once
+#include "cache_metrics.hpp"
+#include "database/database_api.hpp"
+#include "database/footprint.hpp"
+#include "database/memory_budget.hpp"
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <mutex>
 #include <pluginplay/cache/module_cache.hpp>
+#include <pluginplay/utility/wait_edge.hpp>
+#include <thread>
+#include <unordered_map>
 
 namespace pluginplay::cache::detail_ {
 
 /** @brief The class containing a ModuleCache instance's state.
  *
- *  This is just a thin-wrapper around a database. The PIMPL nature keeps the
- *  details of the database out of the public API.
+ *  This is mostly a thin-wrapper around a database. The PIMPL nature keeps the
+ *  details of the database out of the public API. The PIMPL also implements
+ *  "single-flight" memoization: while a caller is computing the results for a
+ *  set of inputs, other callers asking for equal inputs wait for (and share)
+ *  those results instead of computing them again. Each computation records
+ *  the thread leading it; a caller only waits on the leader if the leader is
+ *  not, directly or through other waiting threads, waiting on the caller
+ *  (see utility::WaitEdge). Otherwise waiting would deadlock and the caller
+ *  computes the results itself.
  */
 struct ModuleCachePIMPL {
     // Type of the class this PIMPL implements
@@ -34,14 +53,184 @@ struct ModuleCachePIMPL {
     // Type of object used as values to parent_type
     using mapped_type = typename parent_type::mapped_type;
 
+    // Type of the callback used to compute values
+    using compute_function = typename parent_type::compute_function;
+
+    // Type of the counters parent_type exposes
+    using metrics_type = typename parent_type::metrics_type;
+
+    // Type of the object recording the metrics
+    using metrics_pointer = std::shared_ptr<CacheMetrics>;
+
+    // Type of the switch saying if results may go to long-term storage
+    using persist_pointer = std::shared_ptr<std::atomic<bool>>;
+
+    // Clock used for timing
+    using clock_type = CacheMetrics::clock_type;
+
+    // Type of the recorded times
+    using duration_type = CacheMetrics::duration_type;
+
     // DatabaseAPI an object must satisfy for us to be able to use it
     using db_type = database::DatabaseAPI<key_type, mapped_type>;
 
     // Pointer to the DB
     using db_pointer_type = std::unique_ptr<db_type>;
 
+    // A computation which is in progress
+    struct flight_type {
+        // The inputs being computed (owned by the computing caller)
+        const key_type* m_key;
+
+        // Where the computing caller will put the results
+        std::shared_future<mapped_type> m_result;
+
+        // The thread computing the results
+        std::thread::id m_leader;
+    };
+
+    // Type of the map from hashes of inputs to in progress computations
+    using flight_map = std::unordered_multimap<std::size_t, flight_type>;
+
+    // Implements ModuleCache::find_or_compute
+    mapped_type find_or_compute(const key_type& key,
+                                const compute_function& fxn) {
+        const auto start = clock_type::now();
+        auto since_start = [&]() {
+            const auto dt = clock_type::now() - start;
+            return std::chrono::duration_cast<duration_type>(dt);
+        };
+
+        // m_db looks key up once, and only calls on_miss if it isn't there.
+        // Any landing after this point may have been for key, see on_miss
+        const auto n_landed = m_n_landed.load();
+        enum class outcome { hit, computed, coalesced } how = outcome::hit;
+        std::size_t hash = 0;
+        std::promise<mapped_type> promise;
+
+        // The time fxn takes is how much evicting its result would cost us
+        duration_type compute_time{0};
+        std::size_t n_bytes = 0;
+        auto timed_fxn      = [&]() {
+            const auto t0 = clock_type::now();
+            auto rv       = fxn();
+            const auto dt = clock_type::now() - t0;
+            compute_time  = std::chrono::duration_cast<duration_type>(dt);
+            n_bytes       = database::result_map_footprint(rv);
+            const std::chrono::duration<double> seconds = dt;
+            database::MemoryBudget::set_recompute_cost(seconds.count());
+            return rv;
+        };
+
+        auto on_miss = [&]() -> mapped_type {
+            hash = hash_inputs(key);
+            std::unique_lock<std::mutex> lock(m_flight_mutex);
+            auto [begin, end] = m_flights.equal_range(hash);
+            for(auto it = begin; it != end; ++it) {
+                if(*it->second.m_key != key) continue;
+
+                // E.g., we lead the flight (the module asked for the same
+                // inputs while running), or a TaskFuture the leader waits on
+                // ran the task which called us on our stack
+                const auto leader = it->second.m_leader;
+                if(utility::WaitEdge::would_deadlock(leader)) break;
+
+                auto result = it->second.m_result;
+                lock.unlock();
+                if(follow_(leader, result)) {
+                    how = outcome::coalesced;
+                    m_metrics->coalesced();
+                    return result.get();
+                }
+                lock.lock();
+                break;
+            }
+
+            // The flight for key may have landed after m_db looked key up
+            if(m_n_landed != n_landed) {
+                auto rv = m_db->try_at(key);
+                if(rv.has_value()) return rv.get();
+            }
+
+            flight_type flight{&key, promise.get_future().share(),
+                               std::this_thread::get_id()};
+            m_flights.emplace(hash, std::move(flight));
+            lock.unlock();
+            how = outcome::computed;
+            return timed_fxn();
+        };
+
+        try {
+            auto value = m_db->find_or_compute(key, on_miss).get();
+            if(how == outcome::hit) {
+                m_metrics->hit(since_start());
+            } else if(how == outcome::computed) {
+                database::MemoryBudget::take_recompute_cost();
+                m_metrics->inserted(n_bytes);
+                m_metrics->computed(since_start() - compute_time, compute_time);
+                promise.set_value(value);
+                land_(hash, key);
+            }
+            return value;
+        } catch(...) {
+            if(how == outcome::computed) {
+                database::MemoryBudget::take_recompute_cost();
+                m_metrics->failed();
+                promise.set_exception(std::current_exception());
+                land_(hash, key);
+            }
+            throw;
+        }
+    }
+
+    /* Waits for @p leader to put the results in @p result. Returns false if,
+     * while we wait, the leader starts waiting on us (e.g., it waits on a
+     * TaskFuture whose task is running on our stack). We then stop waiting so
+     * that the caller can compute the results itself.
+     */
+    static bool follow_(std::thread::id leader,
+                        const std::shared_future<mapped_type>& result) {
+        const auto recheck = std::chrono::milliseconds(1);
+        utility::WaitEdge edge(leader);
+        while(result.wait_for(recheck) != std::future_status::ready)
+            if(utility::WaitEdge::would_deadlock(leader)) return false;
+        return true;
+    }
+
+    // Snapshot of the metrics
+    metrics_type metrics() const noexcept { return m_metrics->snapshot(); }
+
+    // Removes the flight for @p key, which we started
+    void land_(std::size_t hash, const key_type& key) noexcept {
+        std::lock_guard<std::mutex> lock(m_flight_mutex);
+        auto [begin, end] = m_flights.equal_range(hash);
+        for(auto it = begin; it != end; ++it) {
+            if(it->second.m_key != &key) continue;
+            m_flights.erase(it);
+            ++m_n_landed;
+            return;
+        }
+    }
+
     // The database actually powering the ModuleCache
     db_pointer_type m_db;
+
+    // Guards m_flights
+    std::mutex m_flight_mutex;
+
+    // The computations currently in progress
+    flight_map m_flights;
+
+    // How many computations have landed, lets callers tell if one landed
+    // since they looked their inputs up
+    std::atomic<std::size_t> m_n_landed{0};
+
+    // Records the metrics, shared with the KeyProxyMapper in m_db
+    metrics_pointer m_metrics = std::make_shared<CacheMetrics>();
+
+    // May results be written to long-term storage? Shared with m_db, which
+    // consults it as results are inserted
+    persist_pointer m_persist = std::make_shared<std::atomic<bool>>(true);
 };
 
 } // namespace pluginplay::cache::detail_
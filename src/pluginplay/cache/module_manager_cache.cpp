@@ -17,6 +17,7 @@
 #include "database/database_factory.hpp"
 #include "module_cache_pimpl.hpp"
 #include <filesystem>
+#include <mutex>
 #include <pluginplay/cache/module_cache.hpp>
 #include <pluginplay/cache/module_manager_cache.hpp>
 #include <pluginplay/cache/user_cache.hpp>
@@ -37,24 +38,48 @@ struct ModuleManagerCachePIMPL {
 
     using db_factory_type = database::DatabaseFactory;
 
+    using lock_type = std::lock_guard<std::mutex>;
+
+    /// Guards the members of this class (not the caches they point to)
+    std::mutex m_mutex;
+
     database::DatabaseFactory m_db_factory;
 
     std::map<module_cache_key, module_cache_pointer> m_module_caches;
 
     std::map<module_cache_key, user_cache_pointer> m_user_caches;
+
+    /// Is the cache shared with other processes (which requires content
+    /// addressed keys)?
+    bool m_is_shared = false;
 };
 
 } // namespace detail_
 
-ModuleManagerCache::ModuleManagerCache() noexcept = default;
+namespace {
 
-ModuleManagerCache::ModuleManagerCache(path_type disk_location) {
-    change_save_location(std::move(disk_location));
+// Returns the paths of the snapshot files in the directory @p path
+std::pair<std::string, std::string> snapshot_paths(const std::string& path) {
+    std::filesystem::path root_dir(path);
+    auto p = root_dir / std::filesystem::path("cache.snap");
+    auto q = root_dir / std::filesystem::path("uuid.snap");
+    return {p.string(), q.string()};
+}
+
+} // namespace
+
+ModuleManagerCache::ModuleManagerCache() :
+  m_pimpl_(std::make_unique<pimpl_type>()) {}
+
+ModuleManagerCache::ModuleManagerCache(path_type disk_location,
+                                       rocksdb_options options) {
+    change_save_location(std::move(disk_location), std::move(options));
 }
 
 ModuleManagerCache::~ModuleManagerCache() noexcept = default;
 
-void ModuleManagerCache::change_save_location(path_type disk_location) {
+void ModuleManagerCache::change_save_location(path_type disk_location,
+                                              rocksdb_options options) {
     std::filesystem::path root_dir(disk_location);
     if(!std::filesystem::exists(root_dir)) {
         std::filesystem::create_directories(root_dir);
@@ -66,34 +91,122 @@ void ModuleManagerCache::change_save_location(path_type disk_location) {
     auto p = root_dir / cache_dir;
     auto q = root_dir / uuid_dir;
 
-    pimpl_().m_db_factory.set_serialized_pm_to_pm(p.string());
-    m_pimpl_->m_db_factory.set_type_eraser_backend(q.string());
+    detail_::ModuleManagerCachePIMPL::lock_type lock(pimpl_().m_mutex);
+    m_pimpl_->m_db_factory.set_serialized_pm_to_pm(p.string(), options);
+    m_pimpl_->m_db_factory.set_type_eraser_backend(q.string(), options);
+
+    // Other processes only find our entries if they derive the same keys
+    if(options.shared) {
+        m_pimpl_->m_db_factory.set_content_addressed(true);
+        m_pimpl_->m_is_shared = true;
+    }
+}
+
+void ModuleManagerCache::set_memory_budget(size_type max_bytes,
+                                           eviction_policy policy) {
+    detail_::ModuleManagerCachePIMPL::lock_type lock(pimpl_().m_mutex);
+    m_pimpl_->m_db_factory.set_memory_budget(max_bytes, policy);
+}
+
+void ModuleManagerCache::set_content_addressed_keys(bool content_addressed) {
+    detail_::ModuleManagerCachePIMPL::lock_type lock(pimpl_().m_mutex);
+    if(!content_addressed && m_pimpl_->m_is_shared)
+        throw std::runtime_error("Caches shared with other processes (or "
+                                 "ranks) require content-addressed keys");
+    m_pimpl_->m_db_factory.set_content_addressed(content_addressed);
+}
+
+void ModuleManagerCache::set_distributed(const runtime_type& runtime) {
+    detail_::ModuleManagerCachePIMPL::lock_type lock(pimpl_().m_mutex);
+    m_pimpl_->m_db_factory.set_distributed_backend(runtime);
+    m_pimpl_->m_db_factory.set_content_addressed(true);
+    m_pimpl_->m_is_shared = true;
+}
+
+void ModuleManagerCache::backup() {
+    detail_::ModuleManagerCachePIMPL::lock_type lock(pimpl_().m_mutex);
+    for(auto& [_, pcache] : m_pimpl_->m_module_caches) pcache->backup();
+    for(auto& [_, pcache] : m_pimpl_->m_user_caches) pcache->backup();
+}
+
+void ModuleManagerCache::export_snapshot(path_type path) {
+    std::filesystem::create_directories(path);
+    auto [p, q] = snapshot_paths(path);
+
+    backup();
+    detail_::ModuleManagerCachePIMPL::lock_type lock(pimpl_().m_mutex);
+    m_pimpl_->m_db_factory.export_snapshot(p, q);
+}
+
+void ModuleManagerCache::export_snapshot(path_type path,
+                                         const module_cache_key& key) {
+    std::filesystem::create_directories(path);
+    auto [p, q] = snapshot_paths(path);
+
+    detail_::ModuleManagerCachePIMPL::lock_type lock(pimpl_().m_mutex);
+    auto itr = m_pimpl_->m_module_caches.find(key);
+    if(itr != m_pimpl_->m_module_caches.end()) itr->second->backup();
+    m_pimpl_->m_db_factory.export_snapshot(p, q, key);
+}
+
+void ModuleManagerCache::open_snapshot(path_type path) {
+    auto [p, q] = snapshot_paths(path);
+    detail_::ModuleManagerCachePIMPL::lock_type lock(pimpl_().m_mutex);
+    m_pimpl_->m_db_factory.set_snapshot_backend(p, q);
+    m_pimpl_->m_db_factory.set_content_addressed(true);
+    m_pimpl_->m_is_shared = true;
+}
+
+typename ModuleManagerCache::size_type ModuleManagerCache::memory_in_use()
+  const noexcept {
+    if(!m_pimpl_) return 0;
+    return m_pimpl_->m_db_factory.memory_budget().used();
+}
+
+typename ModuleManagerCache::size_type ModuleManagerCache::memory_footprint(
+  const module_cache_key& key) const noexcept {
+    if(!m_pimpl_) return 0;
+    module_cache_pointer pcache;
+    {
+        detail_::ModuleManagerCachePIMPL::lock_type lock(m_pimpl_->m_mutex);
+        auto itr = m_pimpl_->m_module_caches.find(key);
+        if(itr == m_pimpl_->m_module_caches.end()) return 0;
+        pcache = itr->second;
+    }
+    return pcache->memory_footprint();
 }
 
 typename ModuleManagerCache::module_cache_pointer
 ModuleManagerCache::get_or_make_module_cache(module_cache_key key) {
-    if(!pimpl_().m_module_caches.count(key)) {
-        auto p = std::make_shared<module_cache_type>(make_module_cache_(key));
-        m_pimpl_->m_module_caches.emplace(key, p);
-    }
-    return m_pimpl_->m_module_caches.at(key);
+    detail_::ModuleManagerCachePIMPL::lock_type lock(pimpl_().m_mutex);
+    auto itr = m_pimpl_->m_module_caches.find(key);
+    if(itr != m_pimpl_->m_module_caches.end()) return itr->second;
+
+    auto p = std::make_shared<module_cache_type>(make_module_cache_(key));
+    m_pimpl_->m_module_caches.emplace(std::move(key), p);
+    return p;
 }
 
 typename ModuleManagerCache::user_cache_pointer
 ModuleManagerCache::get_or_make_user_cache(module_cache_key key) {
     module_cache_key mangled_key = "__PP__ " + key + "-USER __PP__";
-    if(!pimpl_().m_user_caches.count(mangled_key)) {
-        auto mcache = make_module_cache_(mangled_key);
-        auto p      = std::make_shared<user_cache_type>(std::move(mcache));
-        m_pimpl_->m_user_caches.emplace(mangled_key, p);
-    }
-    return m_pimpl_->m_user_caches.at(mangled_key);
+    detail_::ModuleManagerCachePIMPL::lock_type lock(pimpl_().m_mutex);
+    auto itr = m_pimpl_->m_user_caches.find(mangled_key);
+    if(itr != m_pimpl_->m_user_caches.end()) return itr->second;
+
+    auto mcache = make_module_cache_(mangled_key);
+    auto p      = std::make_shared<user_cache_type>(std::move(mcache));
+    m_pimpl_->m_user_caches.emplace(std::move(mangled_key), p);
+    return p;
 }
 
 typename ModuleManagerCache::module_cache_type
 ModuleManagerCache::make_module_cache_(module_cache_key key) {
-    auto p  = std::make_unique<detail_::ModuleCachePIMPL>();
-    p->m_db = pimpl_().m_db_factory.default_module_db(std::move(key));
+    // N.B. caller is expected to hold m_pimpl_->m_mutex
+    auto p    = std::make_unique<detail_::ModuleCachePIMPL>();
+    auto& dbf = pimpl_().m_db_factory;
+    p->m_db   = dbf.default_module_db(std::move(key), p->m_metrics,
+                                      p->m_persist);
     return module_cache_type(std::move(p));
 }
 
@@ -17,6 +17,7 @@
 #pragma once
 #include "uuid_mapper.hpp"
 #include <map>
+#include <optional>
 namespace pluginplay::cache {
 
 /** @brief This class takes one map-like type and maps it to another.
@@ -122,10 +123,28 @@ public:
      *  @param[in] key The map whose values will be added to the wrapped
      *             UUIDMapper instance.
      *
+     *  @return The proxy map for @p key, i.e., the same object `at(key)` would
+     *          return after this call.
+     *
      *  @throw std::bad_alloc if there is a problem allocaitng memory for the
      *                        new key/value pair. Weak throw guarantee.
      */
-    void insert(const_key_reference key);
+    mapped_type insert(const_key_reference key);
+
+    /** @brief Records that @p proxy is the proxy map of @p key.
+     *
+     *  This is for callers which already proxied @p key with try_at. Unlike
+     *  the other overload, the values in @p key are not looked up again.
+     *
+     *  @param[in] key The map @p proxy was made from.
+     *  @param[in] proxy The proxy map `try_at(key)` returned.
+     *
+     *  @return @p proxy.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating memory for the
+     *                        new key/value pair. Strong throw guarantee.
+     */
+    mapped_type insert(const_key_reference key, mapped_type proxy);
 
     /** @brief Releases the value-to-UUID relationships for each value in @p key
      *
@@ -157,6 +176,35 @@ public:
      */
     mapped_type at(const_key_reference key) const;
 
+    /** @brief Returns the map of key-to-proxy objects, if every value in
+     *         @p key has a proxy.
+     *
+     *  This method combines `count` and `at` so that each value in @p key is
+     *  only looked up once.
+     *
+     *  @param[in] key The map we are mapping to proxies.
+     *
+     *  @return The same map `at(key)` would return if `count(key)` is true,
+     *          and an empty optional otherwise.
+     *
+     *  @throw std::bad_alloc if there is problem making the return. Strong
+     *                        throw guarantee.
+     */
+    std::optional<mapped_type> try_at(const_key_reference key) const;
+
+    /** @brief Maps a proxy map back to the map it was made from.
+     *
+     *  Maps made by *this are remembered. Other maps (e.g., made by another
+     *  process sharing the long-term storage) are rebuilt from the objects
+     *  stored under their UUIDs (see UUIDMapper::un_proxy).
+     *
+     *  @param[in] value The proxy map to map back.
+     *
+     *  @return The map @p value was made from.
+     *
+     *  @throw ??? If @p value was not made by *this and UUIDMapper::un_proxy
+     *             throws. Strong throw guarantee.
+     */
     key_type un_proxy(const_mapped_reference value) const;
 
     /** @brief Saves the contents of the UUIDMapper.
@@ -183,6 +231,15 @@ public:
      */
     void dump() { m_db_->dump(); }
 
+    /// Calls begin_batch on the wrapped UUIDMapper
+    void begin_batch() { m_db_->begin_batch(); }
+
+    /// Calls commit_batch on the wrapped UUIDMapper
+    void commit_batch() { m_db_->commit_batch(); }
+
+    /// Calls abort_batch on the wrapped UUIDMapper
+    void abort_batch() { m_db_->abort_batch(); }
+
 private:
     /// TODO: This is a hack so we can reverse the mapping
     std::map<mapped_type, key_type> m_buffer_;
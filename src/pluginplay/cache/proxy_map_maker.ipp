@@ -42,9 +42,21 @@ TPARAMS bool PROXY_MAP_MAKER::count(const_key_reference key) const {
 }
 
 TPARAMS
-void PROXY_MAP_MAKER::insert(const_key_reference key) {
-    for(const auto& [k, v] : key) { m_db_->insert(v); }
-    m_buffer_.emplace(at(key), key);
+typename PROXY_MAP_MAKER::mapped_type PROXY_MAP_MAKER::insert(
+  const_key_reference key) {
+    mapped_type rv;
+    for(const auto& [k, v] : key) {
+        rv.emplace_hint(rv.end(), k, m_db_->insert(v));
+    }
+    m_buffer_.emplace(rv, key);
+    return rv;
+}
+
+TPARAMS
+typename PROXY_MAP_MAKER::mapped_type PROXY_MAP_MAKER::insert(
+  const_key_reference key, mapped_type proxy) {
+    m_buffer_.emplace(proxy, key);
+    return proxy;
 }
 
 TPARAMS
@@ -60,10 +72,28 @@ typename PROXY_MAP_MAKER::mapped_type PROXY_MAP_MAKER::at(
     return rv;
 }
 
+TPARAMS
+std::optional<typename PROXY_MAP_MAKER::mapped_type> PROXY_MAP_MAKER::try_at(
+  const_key_reference key) const {
+    mapped_type rv;
+    for(const auto& [k, v] : key) {
+        auto uuid = m_db_->try_at(v);
+        if(!uuid.has_value()) return std::nullopt;
+        rv.emplace_hint(rv.end(), k, uuid.get());
+    }
+    return rv;
+}
+
 TPARAMS
 typename PROXY_MAP_MAKER::key_type PROXY_MAP_MAKER::un_proxy(
   const_mapped_reference value) const {
-    return m_buffer_.at(value);
+    auto itr = m_buffer_.find(value);
+    if(itr != m_buffer_.end()) return itr->second;
+
+    key_type rv;
+    for(const auto& [k, uuid] : value)
+        rv.emplace_hint(rv.end(), k, m_db_->un_proxy(uuid));
+    return rv;
 }
 
 #undef PROXY_MAP_MAKER
@@ -16,8 +16,12 @@
 
 #pragma once
 #include "database/database_api.hpp"
+#include "database/type_eraser.hpp"
 #include <memory>
+#include <optional>
+#include <pluginplay/any/digester.hpp>
 #include <pluginplay/utility/uuid.hpp>
+#include <type_traits>
 
 namespace pluginplay::cache {
 
@@ -26,7 +30,24 @@ namespace pluginplay::cache {
  *
  *  The UUIDMapper is responsible for assigning UUIDs to objects and maintaining
  *  a record of this mapping. Conceptually this means that UUIDMapper is
- *  viewable as a DatabasePIMPL<KeyType, boost::uuids::uuid> instance.
+ *  viewable as a DatabasePIMPL<KeyType, utility::binary_uuid_type> instance.
+ *  UUIDs are kept in binary form; they are only formatted for display.
+ *
+ *  By default the assigned UUIDs are random, so the same object gets
+ *  different UUIDs in different processes (and runs). If the UUIDMapper is
+ *  content-addressed, the UUID of an object is instead derived from a digest
+ *  of the object (see utility::generate_binary_uuid), so processes sharing
+ *  an on-disk cache agree on the UUIDs. Objects are digested with their
+ *  `digest` member, if they have one (e.g., AnyField and ModuleInput), or
+ *  with any::Digester. Objects which can not be digested still get random
+ *  UUIDs.
+ *
+ *  The object-to-UUID relationships are only known to the process which made
+ *  them. If the objects are stored (under their UUIDs) somewhere other
+ *  processes can read, the UUIDMapper can also be given read access to that
+ *  database. Content-addressed UUIDMappers then find the UUIDs of objects
+ *  stored by other processes, and any UUIDMapper can turn such a UUID back
+ *  into the object (see un_proxy).
  *
  *  @tparam KeyType The type of the objects having UUIDs assigned to them.
  */
@@ -39,8 +60,8 @@ public:
     /// Read-only reference to one of the objects, typedef of const KeyType&
     using const_key_reference = const key_type&;
 
-    /// Type of the UUIDs, typedef of boost::uuids::uuid
-    using mapped_type = std::string;
+    /// Type of the UUIDs, their 16 raw bytes (see utility::to_string)
+    using mapped_type = utility::binary_uuid_type;
 
     /// Type of the database that UUIDMapper will store UUIDs in
     using db_type = database::DatabaseAPI<key_type, mapped_type>;
@@ -54,15 +75,32 @@ public:
     /// Type of a container holding keys
     using key_set_type = typename db_type::key_set_type;
 
+    /// Type of the database storing the type-erased objects under their UUIDs
+    using value_db_type = database::DatabaseAPI<mapped_type, any::AnyField>;
+
+    /// Type of a pointer to the database storing the objects
+    using value_db_pointer = std::shared_ptr<const value_db_type>;
+
     /** @brief Creates a new UUID instance which stores the UUID mapping in the
      *         provided db
      *
      *  @param[in] db The database that UUID will store object-to-UUID mappings
      *                in.
+     *  @param[in] content_addressed Should UUIDs be derived from the objects
+     *                               (see the class description)? Defaults to
+     *                               false, i.e., random UUIDs.
+     *  @param[in] values The database the objects are stored in under their
+     *                    UUIDs, if other processes may have stored objects in
+     *                    it. Defaults to null, i.e., only objects inserted
+     *                    into *this are known.
      *
      *  @throw std::runtime_error if @p db is a nullptr. Strong throw guarantee.
      */
-    UUIDMapper(db_pointer db);
+    UUIDMapper(db_pointer db, bool content_addressed = false,
+               value_db_pointer values = {});
+
+    /// Are the UUIDs derived from the objects?
+    bool is_content_addressed() const noexcept { return m_content_addressed_; }
 
     /** @brief Overloads insert so that the user doesn't need to provide a UUID.
      *
@@ -80,13 +118,16 @@ public:
      *  @param[in] key The object getting a UUID assigned to it. If @p key
      *                 already has a UUID this is a no-op.
      *
+     *  @return The UUID assigned to @p key (either the newly generated one, or
+     *          the one @p key already had).
+     *
      *  @throw boost::uuids::entropy_error if there is a problem generating the
      *         UUID due to insufficient entropy. Strong throw guarantee.
      *
      *  @throw ??? If the wrapped database's insert method throws. Same throw
      *         gurantee.
      */
-    void insert(key_type key);
+    mapped_type insert(key_type key);
 
     /** @brief Returns the set of objects which have been proxied.
      *
@@ -100,33 +141,106 @@ public:
      */
     key_set_type keys() const { return m_db_->keys(); }
 
-    /// Just calls m_db_->count(key)
+    /// Calls m_db_->count(key), then looks for @p key by content
     bool count(const_key_reference key) const noexcept;
 
     /// Just calls m_db_->free(key)
     void free(const_key_reference key);
 
-    /// Just calls m_db_->at(key)
+    /** @brief Returns the UUID of @p key.
+     *
+     *  @param[in] key The object whose UUID is wanted.
+     *
+     *  @return The UUID of @p key.
+     *
+     *  @throw std::out_of_range if @p key has no UUID. Strong throw guarantee.
+     *  @throw ??? If the databases throw. Same throw guarantee.
+     */
     const_mapped_reference at(const_key_reference key) const;
 
+    /** @brief Returns the UUID of @p key, if it has one.
+     *
+     *  If @p key was not assigned a UUID by *this, but *this is
+     *  content-addressed and was given the database of the objects, @p key's
+     *  UUID is derived from its content. The UUID is returned if an object is
+     *  stored under it (e.g., by another process).
+     *
+     *  @param[in] key The object whose UUID is wanted.
+     *
+     *  @return The UUID of @p key, or an empty value if it has none.
+     *
+     *  @throw ??? If the databases throw. Same throw guarantee.
+     */
+    const_mapped_reference try_at(const_key_reference key) const;
+
+    /** @brief Returns the object whose UUID is @p uuid.
+     *
+     *  The object is read from the database given to the ctor, so this works
+     *  for objects stored by other processes too.
+     *
+     *  @param[in] uuid The UUID of the object.
+     *
+     *  @return A copy of the object.
+     *
+     *  @throw std::runtime_error if *this was not given the database of the
+     *                            objects. Strong throw guarantee.
+     *  @throw std::out_of_range if no object is stored under @p uuid. Strong
+     *                           throw guarantee.
+     *  @throw ??? If the database throws or the object can't be converted
+     *             back to a key_type. Same throw guarantee.
+     */
+    key_type un_proxy(const mapped_type& uuid) const;
+
     /// Just calls m_db_->backup()
     void backup();
 
     /// Just calls m_db_->dump()
     void dump();
 
+    /// Just calls m_db_->begin_batch()
+    void begin_batch();
+
+    /// Just calls m_db_->commit_batch()
+    void commit_batch();
+
+    /// Just calls m_db_->abort_batch()
+    void abort_batch();
+
 private:
-    /** @brief Wraps the process of generating a UUID
+    /** @brief Wraps the process of generating a UUID for @p key
      *
-     *  At the moment this just wraps a call to Boost's random UUID generator.
+     *  If *this is content-addressed and @p key can be digested the UUID is
+     *  derived from @p key's digest. Otherwise this wraps a call to Boost's
+     *  random UUID generator.
      *
      *  @throw boost::uuids::entropy_error if the backend can't generate enough
      *         entropy. Strong throw guarantee.
      */
-    mapped_type uuid_() const;
+    mapped_type uuid_(const_key_reference key) const;
+
+    /// The UUID derived from @p key, if content-addressed and @p key digests
+    std::optional<mapped_type> content_uuid_(const_key_reference key) const;
+
+    /// The UUID of @p key if it is stored in m_values_ (by content)
+    std::optional<mapped_type> find_by_content_(const_key_reference key) const;
+
+    /// Does @p T have a `bool digest(digest_buffer&) const` member?
+    template<typename T, typename = void>
+    struct has_digest : std::false_type {};
+
+    template<typename T>
+    struct has_digest<T, std::void_t<decltype(std::declval<const T&>().digest(
+                           std::declval<any::digest_buffer&>()))>>
+      : std::true_type {};
 
     /// The object-to-UUID relationships we know about
     db_pointer m_db_;
+
+    /// Are the UUIDs derived from the objects?
+    bool m_content_addressed_;
+
+    /// The database the objects are stored in, if other processes may share it
+    value_db_pointer m_values_;
 };
 
 } // namespace pluginplay::cache
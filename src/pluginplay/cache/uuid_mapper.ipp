@@ -22,19 +22,32 @@ namespace pluginplay::cache {
 #define UUID_MAPPER UUIDMapper<KeyType>
 
 TPARAMS
-UUID_MAPPER::UUIDMapper(db_pointer db) : m_db_(std::move(db)) {
+UUID_MAPPER::UUIDMapper(db_pointer db, bool content_addressed,
+                        value_db_pointer values) :
+  m_db_(std::move(db)),
+  m_content_addressed_(content_addressed),
+  m_values_(std::move(values)) {
     if(!m_db_) throw std::runtime_error("Database can not be a nullptr");
 }
 
 TPARAMS
 bool UUID_MAPPER::count(const_key_reference key) const noexcept {
-    return m_db_->count(key);
+    if(m_db_->count(key)) return true;
+    try {
+        return find_by_content_(key).has_value();
+    } catch(...) { return false; }
 }
 
 TPARAMS
-void UUID_MAPPER::insert(key_type key) {
-    if(count(key)) return; // Don't regenerate the UUID
-    m_db_->insert(std::move(key), uuid_());
+typename UUID_MAPPER::mapped_type UUID_MAPPER::insert(key_type key) {
+    // Don't regenerate the UUID
+    auto old_uuid = m_db_->try_at(key);
+    if(old_uuid.has_value()) return old_uuid.get();
+
+    // N.B. try_insert so that if another thread assigned key a UUID since we
+    //      checked, everyone agrees on that UUID
+    auto uuid = uuid_(key);
+    return m_db_->try_insert(std::move(key), std::move(uuid)).get();
 }
 
 TPARAMS
@@ -43,7 +56,31 @@ void UUID_MAPPER::free(const_key_reference key) { m_db_->free(key); }
 TPARAMS
 typename UUID_MAPPER::const_mapped_reference UUID_MAPPER::at(
   const_key_reference key) const {
-    return m_db_->at(key);
+    auto rv = try_at(key);
+    if(rv.has_value()) return rv;
+    throw std::out_of_range("Key was not found in the database");
+}
+
+TPARAMS
+typename UUID_MAPPER::const_mapped_reference UUID_MAPPER::try_at(
+  const_key_reference key) const {
+    auto rv = m_db_->try_at(key);
+    if(rv.has_value()) return rv;
+    auto uuid = find_by_content_(key);
+    if(!uuid) return const_mapped_reference{};
+    return const_mapped_reference(std::move(*uuid));
+}
+
+TPARAMS
+typename UUID_MAPPER::key_type UUID_MAPPER::un_proxy(
+  const mapped_type& uuid) const {
+    if(!m_values_)
+        throw std::runtime_error("Don't know where the objects are stored");
+    auto value = m_values_->at(uuid);
+    if constexpr(std::is_same_v<key_type, any::AnyField>)
+        return value.get();
+    else
+        return database::MakeAny<key_type>::revert(value.get());
 }
 
 TPARAMS
@@ -53,8 +90,49 @@ TPARAMS
 void UUID_MAPPER::dump() { m_db_->dump(); }
 
 TPARAMS
-typename UUID_MAPPER::mapped_type UUID_MAPPER::uuid_() const {
-    return utility::generate_uuid();
+void UUID_MAPPER::begin_batch() { m_db_->begin_batch(); }
+
+TPARAMS
+void UUID_MAPPER::commit_batch() { m_db_->commit_batch(); }
+
+TPARAMS
+void UUID_MAPPER::abort_batch() { m_db_->abort_batch(); }
+
+TPARAMS
+typename UUID_MAPPER::mapped_type UUID_MAPPER::uuid_(
+  const_key_reference key) const {
+    auto uuid = content_uuid_(key);
+    if(uuid) return std::move(*uuid);
+    return utility::generate_binary_uuid();
+}
+
+TPARAMS
+std::optional<typename UUID_MAPPER::mapped_type> UUID_MAPPER::content_uuid_(
+  const_key_reference key) const {
+    if(!m_content_addressed_) return std::nullopt;
+
+    // N.B. the buffer keeps its capacity, so after the first few keys this
+    //      doesn't allocate
+    static thread_local any::digest_buffer buffer;
+    buffer.clear();
+    bool digested = false;
+    if constexpr(has_digest<key_type>::value) {
+        digested = key.digest(buffer);
+    } else if constexpr(any::is_digestible_v<key_type>) {
+        any::Digester<key_type>{}(key, buffer);
+        digested = true;
+    }
+    if(!digested) return std::nullopt;
+    return utility::generate_binary_uuid(buffer.data(), buffer.size());
+}
+
+TPARAMS
+std::optional<typename UUID_MAPPER::mapped_type> UUID_MAPPER::find_by_content_(
+  const_key_reference key) const {
+    if(!m_values_) return std::nullopt;
+    auto uuid = content_uuid_(key);
+    if(!uuid || !m_values_->count(*uuid)) return std::nullopt;
+    return uuid;
 }
 
 #undef UUID_MAPPER
@@ -163,6 +163,31 @@ public:
      */
     bool is_ready() const noexcept { return is_optional() || has_value(); }
 
+    /** @brief Computes a hash of the bound value.
+     *
+     *  The hash only depends on the bound value (see AnyField::hash). It is
+     *  consistent with operator== in that equal instances have equal hashes.
+     *  Whether the input is transparent is not considered here; it is up to
+     *  the caller to skip transparent inputs when hashing for memoization.
+     *
+     *  @return A hash of the bound value, or 0 if no value is bound.
+     *
+     *  @throw None No throw guarantee.
+     */
+    std::size_t hash() const noexcept { return m_value_.hash(); }
+
+    /** @brief Appends a stable byte representation of the bound value.
+     *
+     *  See AnyField::digest.
+     *
+     *  @param[in,out] buffer The buffer to append to.
+     *
+     *  @return True if the bound value was digested and false otherwise.
+     */
+    bool digest(type::any::digest_buffer& buffer) const {
+        return m_value_.digest(buffer);
+    }
+
     /** @brief Used to check if the input can be set to specific value
      *
      *  When a user wants to change a value the pluginplay needs to know if that
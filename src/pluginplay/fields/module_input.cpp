@@ -15,6 +15,7 @@
  */
 
 #include "detail_/module_input_pimpl.hpp"
+#include <cctype>
 #include <pluginplay/fields/module_input.hpp>
 
 namespace pluginplay {
@@ -22,12 +23,15 @@ namespace pluginplay {
 using any_check = typename ModuleInput::any_check;
 
 ModuleInput::ModuleInput() :
-  m_pimpl_(std::make_unique<detail_::ModuleInputPIMPL>()) {}
+  m_pimpl_(std::make_shared<detail_::ModuleInputPIMPL>()) {}
 
 ModuleInput::ModuleInput(const ModuleInput& rhs) :
   m_is_cref_(rhs.m_is_cref_),
   m_is_actually_cref_(rhs.m_is_actually_cref_),
-  m_pimpl_(rhs.m_pimpl_->clone()) {}
+  m_pimpl_(rhs.m_pimpl_) {
+    // The value may be modified through a reference rhs handed out
+    if(!rhs.m_shareable_ && m_pimpl_) m_pimpl_ = m_pimpl_->clone();
+}
 
 ModuleInput::ModuleInput(ModuleInput&& rhs) noexcept = default;
 
@@ -51,34 +55,40 @@ bool ModuleInput::is_transparent() const noexcept {
     return m_pimpl_->is_transparent();
 }
 
+std::size_t ModuleInput::hash() const noexcept { return m_pimpl_->hash(); }
+
+bool ModuleInput::digest(type::any::digest_buffer& buffer) const {
+    return m_pimpl_->digest(buffer);
+}
+
 bool ModuleInput::ready() const noexcept { return m_pimpl_->is_ready(); }
 
 const type::description& ModuleInput::description() const {
     return m_pimpl_->description();
 }
 
-ModuleInput& ModuleInput::set_description(type::description desc) noexcept {
-    m_pimpl_->set_description(std::move(desc));
+ModuleInput& ModuleInput::set_description(type::description desc) {
+    mutable_pimpl_().set_description(std::move(desc));
     return *this;
 }
 
-ModuleInput& ModuleInput::make_optional() noexcept {
-    m_pimpl_->make_optional();
+ModuleInput& ModuleInput::make_optional() {
+    mutable_pimpl_().make_optional();
     return *this;
 }
 
-ModuleInput& ModuleInput::make_required() noexcept {
-    m_pimpl_->make_required();
+ModuleInput& ModuleInput::make_required() {
+    mutable_pimpl_().make_required();
     return *this;
 }
 
-ModuleInput& ModuleInput::make_transparent() noexcept {
-    m_pimpl_->make_transparent();
+ModuleInput& ModuleInput::make_transparent() {
+    mutable_pimpl_().make_transparent();
     return *this;
 }
 
-ModuleInput& ModuleInput::make_opaque() noexcept {
-    m_pimpl_->make_opaque();
+ModuleInput& ModuleInput::make_opaque() {
+    mutable_pimpl_().make_opaque();
     return *this;
 }
 
@@ -87,10 +97,16 @@ typename ModuleInput::bounds_check_desc_t ModuleInput::check_descriptions()
     return m_pimpl_->check_descriptions();
 }
 
+type::any& ModuleInput::get_() {
+    const auto& temp = mutable_pimpl_().value();
+    m_shareable_     = false;
+    return const_cast<type::any&>(temp);
+}
+
 const type::any& ModuleInput::get_() const { return m_pimpl_->value(); }
 
 void ModuleInput::change_(type::any new_value) {
-    m_pimpl_->set_value(std::move(new_value));
+    mutable_pimpl_().set_value(std::move(new_value));
 }
 
 bool ModuleInput::is_valid_(const type::any& new_value) const {
@@ -98,16 +114,36 @@ bool ModuleInput::is_valid_(const type::any& new_value) const {
 }
 
 void ModuleInput::set_type_(const std::type_info& type) {
-    m_pimpl_->set_type(type);
+    mutable_pimpl_().set_type(type);
 }
 
 ModuleInput& ModuleInput::add_check_(any_check check, type::description desc) {
-    m_pimpl_->add_check(std::move(check), std::move(desc));
+    mutable_pimpl_().add_check(std::move(check), std::move(desc));
     return *this;
 }
 
 bool ModuleInput::operator==(const ModuleInput& rhs) const noexcept {
+    if(m_pimpl_ == rhs.m_pimpl_) return true;
     return *m_pimpl_ == *rhs.m_pimpl_;
 }
 
+detail_::ModuleInputPIMPL& ModuleInput::mutable_pimpl_() {
+    // Other instances may still be reading the state, so we copy it first
+    if(m_pimpl_.use_count() > 1) m_pimpl_ = m_pimpl_->clone();
+    return *m_pimpl_;
+}
+
+std::size_t hash_inputs(const type::input_map& inputs) noexcept {
+    std::size_t seed = 0;
+    for(const auto& [key, input] : inputs) {
+        if(input.is_transparent()) continue;
+        std::size_t key_hash = 0;
+        for(const unsigned char c : key)
+            key_hash = any::hash_combine(key_hash, std::tolower(c));
+        seed = any::hash_combine(seed, key_hash);
+        seed = any::hash_combine(seed, input.hash());
+    }
+    return seed;
+}
+
 } // namespace pluginplay
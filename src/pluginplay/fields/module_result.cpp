@@ -25,6 +25,16 @@ using m_pimpl_t  = detail_::ModuleResultPIMPL;
 
 ModuleResult::ModuleResult() : m_pimpl_(std::make_unique<m_pimpl_t>()) {}
 
+ModuleResult::ModuleResult(shared_any value) : ModuleResult() {
+    if(!value || !value->has_value())
+        throw std::runtime_error("Was expecting a value");
+    const auto rtti = value->type();
+    m_pimpl_->set_type_check(
+      [rtti](const type::any& v) { return v.type() == rtti; });
+    m_pimpl_->set_type(rtti);
+    m_pimpl_->set_value(std::move(value));
+}
+
 ModuleResult::ModuleResult(const ModuleResult& rhs) :
   m_pimpl_(rhs.m_pimpl_->clone()) {}
 
@@ -40,6 +50,21 @@ bool ModuleResult::has_type() const noexcept {
 
 bool ModuleResult::has_value() const noexcept { return m_pimpl_->has_value(); }
 
+std::size_t ModuleResult::memory_footprint() const noexcept {
+    if(!has_value()) return 0;
+    return m_pimpl_->value()->memory_footprint();
+}
+
+bool ModuleResult::digest(type::any::digest_buffer& buffer) const {
+    if(!has_value()) return false;
+    return m_pimpl_->value()->digest(buffer);
+}
+
+bool ModuleResult::is_serializable() const noexcept {
+    if(!has_value()) return false;
+    return m_pimpl_->value()->is_serializable();
+}
+
 bool ModuleResult::has_description() const noexcept {
     return m_pimpl_->has_description();
 }
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <pluginplay/module/module_profile.hpp>
+#include <string>
+
+namespace pluginplay::detail_ {
+
+/// Writes @p s to @p os as a JSON string (i.e., quoted and escaped)
+inline void write_json_string(std::ostream& os, const std::string& s) {
+    os << '"';
+    for(const char c : s) {
+        switch(c) {
+            case '"': os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n"; break;
+            case '\t': os << "\\t"; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20) {
+                    os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                       << static_cast<int>(c) << std::dec << std::setfill(' ');
+                } else {
+                    os << c;
+                }
+        }
+    }
+    os << '"';
+}
+
+/// How @p outcome is spelled in exported profiles and traces
+inline const char* outcome_name(ModuleProfile::outcome_type outcome) {
+    using outcome_type = ModuleProfile::outcome_type;
+    switch(outcome) {
+        case outcome_type::cache_hit: return "cache hit";
+        case outcome_type::cache_miss: return "cache miss";
+        default: return "not memoized";
+    }
+}
+
+/** @brief Writes events in the Chrome Trace Event format.
+ *
+ *  Both ModuleProfile (see write_profiles) and ModuleTracer export Chrome
+ *  traces through this class, so their traces have the same layout. Making
+ *  the writer starts the trace, and finish ends it. Time stamps and
+ *  durations are in (fractional) microseconds. Threads are given by the hash
+ *  of their ID and are numbered in the order they first appear in the trace.
+ */
+class ChromeTraceWriter {
+public:
+    /// Type used for counting
+    using size_type = std::size_t;
+
+    /// Type of the time stamps and durations
+    using duration_type = std::chrono::duration<double, std::micro>;
+
+    /// Starts a trace in @p os
+    explicit ChromeTraceWriter(std::ostream& os) : m_os_(os) {
+        m_os_ << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    }
+
+    /** @brief Writes an event.
+     *
+     *  @param[in] name The name of the event (i.e., the module's key).
+     *  @param[in] phase The phase of the event, e.g., 'B' (begin), 'E' (end),
+     *                   or 'X' (complete).
+     *  @param[in] ts When the event happened.
+     *  @param[in] thread Hash of the ID of the thread the event happened on.
+     *  @param[in] dur How long the event lasted, only written for complete
+     *                 events.
+     *  @param[in] arg_name The name of the event's argument.
+     *  @param[in] arg_value The value of the event's argument.
+     *
+     *  @throw std::bad_alloc if there is a problem numbering the thread. Weak
+     *                        throw guarantee.
+     */
+    void event(const std::string& name, char phase, duration_type ts,
+               size_type thread, duration_type dur, const char* arg_name,
+               const std::string& arg_value) {
+        const auto tid = m_tids_.emplace(thread, m_tids_.size() + 1).first;
+        m_os_ << (m_first_ ? "" : ",") << "{\"name\":";
+        m_first_ = false;
+        write_json_string(m_os_, name);
+        m_os_ << ",\"cat\":\"module\",\"ph\":\"" << phase << "\",\"ts\":";
+        write_us_(ts);
+        if(phase == 'X') {
+            m_os_ << ",\"dur\":";
+            write_us_(dur);
+        }
+        m_os_ << ",\"pid\":0,\"tid\":" << tid->second << ",\"args\":{\""
+              << arg_name << "\":";
+        write_json_string(m_os_, arg_value);
+        m_os_ << "}}";
+    }
+
+    /// Ends the trace
+    void finish() { m_os_ << "]}"; }
+
+private:
+    /// Writes @p t with nanosecond precision
+    void write_us_(duration_type t) {
+        m_os_ << std::fixed << std::setprecision(3) << t.count()
+              << std::defaultfloat;
+    }
+
+    /// The stream the trace is written to
+    std::ostream& m_os_;
+
+    /// Is the next event the first one?
+    bool m_first_ = true;
+
+    /// Maps thread hashes to the numbers they appear as
+    std::map<size_type, size_type> m_tids_;
+};
+
+} // namespace pluginplay::detail_
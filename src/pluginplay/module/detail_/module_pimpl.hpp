@@ -15,12 +15,18 @@
  */
 
 #pragma once
+#include <atomic>
 #include <chrono>
+#include <ctime>
 #include <iomanip> // for put_time
+#include <mutex>
+#include <optional>
 #include <pluginplay/cache/module_cache.hpp>
+#include <pluginplay/module/memoization_policy.hpp>
 #include <pluginplay/module/module_base.hpp>
+#include <pluginplay/module/module_profile.hpp>
 #include <pluginplay/types.hpp>
-#include <utilities/timer.hpp>
+#include <pluginplay/utility/uuid.hpp>
 
 namespace pluginplay::detail_ {
 
@@ -31,19 +37,29 @@ namespace pluginplay::detail_ {
  *  wraps the process of making such a string. The resulting string contains
  *  both the date and the time (to millisecond accuracy).
  *
- *  @return A std::string containing the current date and time in the format
+ *  @param[in] now The time to make a time stamp for. Defaults to the current
+ *                 time.
+ *
+ *  @return A std::string containing the date and time in the format
  *          `<day>-<month>-<year> <hour>:<minute>:<second>`
  *
  *  @throw std::bad_alloc if there is insufficient memory to allocate the
  *         string. Strong throw guarantee.
  */
-inline auto time_stamp() {
+inline auto time_stamp(std::chrono::system_clock::time_point now =
+                         std::chrono::system_clock::now()) {
     using namespace std::chrono;
-    const auto now    = system_clock::now();
     const auto now_tt = system_clock::to_time_t(now);
     const auto ms = duration_cast<milliseconds>(now.time_since_epoch()) % 1000;
+    std::tm now_tm;
+    {
+        // std::localtime returns a pointer to storage shared by all threads
+        static std::mutex localtime_mutex;
+        std::lock_guard<std::mutex> lock(localtime_mutex);
+        now_tm = *std::localtime(&now_tt);
+    }
     std::stringstream ss;
-    ss << std::put_time(std::localtime(&now_tt), "%d-%m-%Y %H:%M:%S") << '.'
+    ss << std::put_time(&now_tm, "%d-%m-%Y %H:%M:%S") << '.'
        << std::setfill('0') << std::setw(3) << ms.count();
     return ss.str();
 }
@@ -85,6 +101,15 @@ public:
     /// Type of the submodule key to UUID map
     using submod_uuid_map = std::map<std::string, uuid_type>;
 
+    /// Type of the fingerprint of the submodule tree
+    using fingerprint_type = std::string;
+
+    /// Type of the pool asynchronous runs are submitted to
+    using task_pool_type = typename ModuleBase::task_pool_type;
+
+    /// Type of the tunables of adaptive memoization
+    using memoization_options_type = MemoizationPolicy::options_type;
+
     /** @brief Makes a module with no implementation.
      *
      *  The ModulePIMPL instance resulting from this ctor wraps no algorithm,
@@ -287,6 +312,9 @@ public:
      *  Unlike the calls to the submodules, which know the type that the
      *  module will be run as
      *
+     *  Locking also computes, and stores, the fingerprint of the submodule
+     *  tree (see submod_fingerprint) if all of the submodules are ready.
+     *
      *  @throws std;:runtime_error if a submodule is not ready. Strong throw
      *                             guarantee.
      */
@@ -296,11 +324,35 @@ public:
      *
      *  This will not unlock the submodules because we can not do that safely.
      *  This function is only used internally within the Module class. Users are
-     *  not allowed to unlock modules.
+     *  not allowed to unlock modules. Since the submodules may now change, the
+     *  stored fingerprint of the submodule tree is discarded.
      *
      *  @throw none No throw guarantee.
      */
-    void unlock() noexcept { m_locked_ = false; }
+    void unlock() noexcept {
+        m_lock_done_ = false;
+        m_locked_    = false;
+        m_fingerprint_.reset();
+        m_fingerprint_input_.reset();
+    }
+
+    /** @brief Changes the submodule bound to @p key.
+     *
+     *  This also discards the stored fingerprint of the submodule tree.
+     *
+     *  @param[in] key The callback point to bind the module to.
+     *  @param[in] new_module The module to bind to the callback point.
+     *
+     *  @throw std::runtime_error if there is no implementation. Strong throw
+     *                            guarantee.
+     *  @throw std::out_of_range if @p key does not map to an existing callback
+     *                           point. Strong throw guarantee.
+     *  @throw std::invalid_argument if @p new_module does not satisfy the
+     *                               requested property type. Strong throw
+     *                               guarantee.
+     */
+    void change_submod(const type::key& key,
+                       std::shared_ptr<Module> new_module);
 
     /** @brief Returns the set of results computed by this module.
      *
@@ -451,6 +503,17 @@ public:
      */
     std::string profile_info() const;
 
+    /** @brief The timing data collected for runs of this module.
+     *
+     *  Unlike profile_info, the returned profile only covers this module (the
+     *  submodules have their own profiles).
+     *
+     *  @return A read-only reference to the profile of this module.
+     *
+     *  @throw None No throw guarantee.
+     */
+    const ModuleProfile& profile() const noexcept { return m_profile_; }
+
     /** @brief Checks whether the result of a call is cached.
      *
      *  This function will memoize the provided inputs and determine if the
@@ -463,6 +526,18 @@ public:
      */
     bool is_cached(const type::input_map& in_inputs);
 
+    /** @brief How the cache memoizing this module has been used.
+     *
+     *  @return The metrics of this module's cache. If this object does not
+     *          have a cache all of the metrics are zero.
+     *
+     *  @throw None No throw guarantee.
+     */
+    cache_type::metrics_type cache_metrics() const noexcept {
+        if(!m_cache_) return cache_type::metrics_type{};
+        return m_cache_->metrics();
+    }
+
     /** @brief Resets cache.
      *
      *  This function will reset cache.
@@ -499,6 +574,7 @@ public:
      *
      *  This function will disable memoization for this module. Note that
      *  memoization is on for all modules except lambda_modules by default.
+     *  If memoization was adaptive, it no longer is.
      *
      *  @throw std::runtime_error if the current module does not have an
      *                            implementation. Strong throw guarantee.
@@ -506,6 +582,9 @@ public:
     void turn_off_memoization();
 
     /** @brief Turns on memoization for this module
+     *
+     *  If memoization was adaptive, it no longer is (i.e., every run is
+     *  memoized).
      *
      *  @warning If the module doesn't have a cache, results will not be cached
      *  even if this function is called and `is_memoizable` is true .
@@ -515,6 +594,33 @@ public:
      */
     void turn_on_memoization();
 
+    /** @brief Turns on memoization, but only when it pays off.
+     *
+     *  With adaptive memoization, each run asks a MemoizationPolicy whether
+     *  to go through the cache, and whether the results may go to long-term
+     *  storage. The policy turns memoization off when the hits don't pay for
+     *  the look ups and inserts, and back on when the module gets more
+     *  expensive (see MemoizationPolicy for the details).
+     *  Calling this function again restarts the policy.
+     *
+     *  @param[in] options The tunables of the policy.
+     *
+     *  @throw std::runtime_error if the current module does not have an
+     *                            implementation. Strong throw guarantee.
+     */
+    void turn_on_adaptive_memoization(memoization_options_type options = {});
+
+    /** @brief Is memoization of this module adaptive?
+     *
+     *  @return True if turn_on_adaptive_memoization was called more recently
+     *          than turn_on_memoization and turn_off_memoization.
+     *
+     *  @throw None No throw guarantee.
+     */
+    bool is_memoization_adaptive() const noexcept {
+        return m_policy_.has_value();
+    }
+
     /** @brief Actually runs the module
      *
      *  This is the function with all of the pluginplay magic. Ultimately it
@@ -524,7 +630,13 @@ public:
      * finally calls the wrapped instance. After the call the result will be
      * cached and returned.
      *
+     *  If the wrapped ModuleBase has a tracer, the beginning and the end of the
+     *  run are recorded with it.
+     *
      * @param[in] ps The input parameters set by the user.
+     * @param[in] name The key of the module, used for tracing. May be null.
+     * @param[in] property_type The property type the module is run as, used
+     *                          for tracing. May be null.
      *
      * @return Whatever the module returns.
      *
@@ -534,7 +646,8 @@ public:
      *                           guarantee.
      * @throw ??? If the module throws.
      */
-    auto run(type::input_map ps);
+    type::result_map run(type::input_map ps, const type::key* name = nullptr,
+                         const type::rtti* property_type = nullptr);
 
     /** @brief Compares two ModulePIMPL instances for equality
      *
@@ -598,6 +711,41 @@ public:
 
     submod_uuid_map submod_uuids() const;
 
+    /** @brief Returns a hash identifying the submodule tree.
+     *
+     *  Two modules have the same fingerprint if, and only if, they have the
+     *  same submodule keys bound to modules with the same UUIDs, recursively.
+     *  The fingerprint is what memoization uses to account for the
+     *  submodules. It is computed when *this is locked and then reused until
+     *  *this is unlocked or a submodule is changed, so that running a locked
+     *  module doesn't walk the submodule tree.
+     *
+     *  The fingerprint is the name-based UUID (see
+     *  utility::generate_binary_uuid) of a version number, currently 1,
+     *  followed by, for each submodule in key order,
+     *  `<n>:<key><m>:<uuid>(<fingerprint>)`, where `<n>` and `<m>` are the
+     *  lengths of the key and the UUID, and `<fingerprint>` is the
+     *  submodule's fingerprint. Hence the fingerprint has the same size (36
+     *  characters) however deep the submodule tree is.
+     *
+     *  @return The fingerprint of the submodule tree.
+     *
+     *  @throw std::runtime_error if a submodule is not ready. Strong throw
+     *                            guarantee.
+     *  @throw std::bad_alloc if there is a problem allocating the
+     *                        fingerprint. Strong throw guarantee.
+     */
+    fingerprint_type submod_fingerprint() const;
+
+    /** @brief Returns the pool asynchronous runs of this module use.
+     *
+     *  @return A pointer to the task pool of the wrapped implementation, or
+     *          nullptr if there is no implementation or it has no task pool.
+     *
+     *  @throw None No throw guarantee.
+     */
+    task_pool_type* task_pool() const noexcept;
+
 private:
     /** @brief Code factorization for merging two sets of inputs.
      *
@@ -616,6 +764,9 @@ private:
      */
     type::input_map merge_inputs_(type::input_map in_inputs) const;
 
+    /// The bound inputs which aren't ready, and aren't set by @p in_inputs
+    std::set<type::key> not_set_inputs_(const type::input_map& in_inputs) const;
+
     /// Code factorization for checking if things in a map are ready
     template<typename T>
     std::set<type::key> not_set_guts_(T&& map) const;
@@ -623,6 +774,57 @@ private:
     /// Code factorization for asserting that we have a module pointer
     void assert_mod_() const;
 
+    /// Implements run, sets @p outcome to how the run was satisfied
+    type::result_map run_(type::input_map ps,
+                          ModuleProfile::outcome_type& outcome);
+
+    /// Computes the fingerprint of the submodule tree (see submod_fingerprint)
+    fingerprint_type make_fingerprint_() const;
+
+    /// The input merge_inputs_ adds to hold the submodule tree's fingerprint
+    ModuleInput fingerprint_input_() const;
+
+    /// Wraps @p fingerprint in an input
+    static ModuleInput make_fingerprint_input_(fingerprint_type fingerprint);
+
+    /** @brief A mutex which copies of ModulePIMPL do not share.
+     *
+     *  std::mutex can not be copied or moved, which would prevent ModulePIMPL
+     *  from being copied or moved. Copies/moves of this class just make a
+     *  new mutex.
+     */
+    struct mutex_type {
+        mutex_type() = default;
+        mutex_type(const mutex_type&) {}
+        mutex_type& operator=(const mutex_type&) { return *this; }
+        std::mutex m_mutex;
+    };
+
+    /// Type used to lock m_mutex_
+    using lock_type = std::lock_guard<std::mutex>;
+
+    /** @brief A flag which can be read while another thread sets it.
+     *
+     *  Like mutex_type, this exists so ModulePIMPL can still be copied and
+     *  moved. Setting the flag releases the writes made before it, and
+     *  reading a set flag acquires them.
+     */
+    struct flag_type {
+        flag_type() = default;
+        flag_type(const flag_type& other) noexcept : m_value(other) {}
+        flag_type& operator=(const flag_type& rhs) noexcept {
+            return *this = static_cast<bool>(rhs);
+        }
+        flag_type& operator=(bool value) noexcept {
+            m_value.store(value, std::memory_order_release);
+            return *this;
+        }
+        operator bool() const noexcept {
+            return m_value.load(std::memory_order_acquire);
+        }
+        std::atomic<bool> m_value{false};
+    };
+
     /// Is the current module locked or not?
     bool m_locked_ = false;
 
@@ -644,8 +846,25 @@ private:
     /// The set of property types that his module satisfies
     std::set<type::rtti> m_property_types_;
 
-    /// Timer used to time runs of this module
-    utilities::Timer m_timer_;
+    /// Timing data for the runs of this module
+    ModuleProfile m_profile_;
+
+    /// Decides whether runs are memoized, if memoization is adaptive
+    std::optional<MemoizationPolicy> m_policy_;
+
+    /// Fingerprint of the submodule tree, set while *this is locked
+    std::optional<fingerprint_type> m_fingerprint_;
+
+    /// m_fingerprint_ wrapped in an input, so runs only copy (i.e., share) it
+    std::optional<ModuleInput> m_fingerprint_input_;
+
+    /// Set once lock() has locked *this and stored the fingerprint, after
+    /// which runs use the fingerprint without locking m_mutex_
+    flag_type m_lock_done_;
+
+    /// Guards the lockedness and the fingerprint when *this is locked
+    /// concurrently (the profile has its own lock)
+    mutable mutex_type m_mutex_;
 }; // class ModulePIMPL
 
 } // namespace pluginplay::detail_
@@ -34,12 +34,7 @@ inline auto ModulePIMPL::not_set(const type::input_map& in_inputs) const {
     assert_mod_();
     not_set_type probs;
 
-    // This is all of the not ready inputs
-    auto in_probs = not_set_guts_(m_inputs_);
-
-    // Now pull out those set by the property type
-    for(const auto& [k, v] : in_inputs)
-        if(in_probs.count(k)) in_probs.erase(k);
+    auto in_probs = not_set_inputs_(in_inputs);
     if(!in_probs.empty()) probs.emplace("Inputs", std::move(in_probs));
 
     auto submod_probs = not_set_guts_(m_submods_);
@@ -126,16 +121,39 @@ inline void ModulePIMPL::reset_internal_cache() {
 inline void ModulePIMPL::turn_off_memoization() {
     assert_mod_();
     m_memoizable_ = false;
+    m_policy_.reset();
 }
 
 inline void ModulePIMPL::turn_on_memoization() {
     assert_mod_();
     m_memoizable_ = true;
+    m_policy_.reset();
+}
+
+inline void ModulePIMPL::turn_on_adaptive_memoization(
+  memoization_options_type options) {
+    assert_mod_();
+    m_memoizable_ = true;
+    m_policy_.emplace(options);
 }
 
 inline std::string ModulePIMPL::profile_info() const {
     std::stringstream ss;
-    ss << m_timer_;
+    const auto stats = m_profile_.stats();
+    if(stats.n_calls > 0) {
+        using namespace std::chrono;
+        auto t        = stats.last_duration;
+        const auto hr = duration_cast<hours>(t);
+        t -= hr;
+        const auto min = duration_cast<minutes>(t);
+        t -= min;
+        const auto sec = duration_cast<seconds>(t);
+        t -= sec;
+        const auto ms = duration_cast<milliseconds>(t);
+        ss << time_stamp(stats.last_call) << " : " << hr.count() << " h "
+           << min.count() << " m " << sec.count() << " s " << ms.count()
+           << " ms" << std::endl;
+    }
     std::string tab("  ");
     for(auto [key, submod] : m_submods_) {
         ss << tab << key << std::endl;
@@ -148,43 +166,23 @@ inline std::string ModulePIMPL::profile_info() const {
     return ss.str();
 }
 
-inline auto ModulePIMPL::run(type::input_map ps) {
-    auto time_now = time_stamp();
-    m_timer_.reset();
+inline type::result_map ModulePIMPL::run(type::input_map ps,
+                                         const type::key* name,
+                                         const type::rtti* property_type) {
     assert_mod_();
-    // Check the inputs we were just given
-    for(const auto& [k, v] : ps)
-        if(!v.ready()) throw std::runtime_error("Inputs are not ready");
-
-    // Merge with bound and see if we are ready
-    if(!ready(ps)) {
-        // Make a dummy module with this PIMPL so we can print out why it's not
-        // ready.
-        Module dummy(std::make_unique<ModulePIMPL>(*this));
-        throw std::runtime_error(print_not_ready(dummy, ps));
-    }
-
-    lock();
-
-    ps = merge_inputs_(ps);
-
-    if(is_memoizable() && m_cache_ && m_cache_->count(ps)) {
-        m_timer_.record(time_now);
-        return m_cache_->uncache(ps);
-    }
-
-    // not there so run
-    auto rv = m_base_->run(ps, m_submods_);
-
-    if(!m_cache_ || !is_memoizable()) {
-        m_timer_.record(time_now);
+    ModuleProfile::outcome_type outcome;
+    auto* tracer = m_base_->tracer();
+    if(!tracer) return run_(std::move(ps), outcome);
+
+    tracer->begin(name, property_type);
+    try {
+        auto rv = run_(std::move(ps), outcome);
+        tracer->end(name, property_type, outcome);
         return rv;
+    } catch(...) {
+        tracer->end(name, property_type, std::nullopt);
+        throw;
     }
-
-    // cache result
-    m_cache_->cache(ps, std::move(rv));
-    m_timer_.record(time_now);
-    return m_cache_->uncache(ps);
 }
 
 inline bool ModulePIMPL::operator==(const ModulePIMPL& rhs) const {
@@ -221,24 +219,73 @@ inline typename ModulePIMPL::submod_uuid_map ModulePIMPL::submod_uuids() const {
     return rv;
 }
 
+inline typename ModulePIMPL::fingerprint_type ModulePIMPL::submod_fingerprint()
+  const {
+    if(m_lock_done_) return *m_fingerprint_;
+    {
+        lock_type guard(m_mutex_.m_mutex);
+        if(m_fingerprint_) return *m_fingerprint_;
+    }
+    return make_fingerprint_();
+}
+
+inline void ModulePIMPL::change_submod(const type::key& key,
+                                       std::shared_ptr<Module> new_module) {
+    submods().at(key).change(std::move(new_module));
+    m_lock_done_ = false;
+    m_fingerprint_.reset();
+    m_fingerprint_input_.reset();
+}
+
 inline type::input_map ModulePIMPL::merge_inputs_(
   type::input_map in_inputs) const {
-    for(const auto& [k, v] : m_inputs_)
-        if(!in_inputs.count(k)) in_inputs[k] = v;
+    // N.B. copies of ModuleInput share the bound value, so this doesn't copy
+    // the values themselves
+    for(const auto& [k, v] : m_inputs_) in_inputs.try_emplace(k, v);
 
     // TODO: It probably makes sense to create an Input class which tracks this
     //       and allows using submods as inputs
     std::string submod_key = "__PLUGIN_PLAY__ SUBMOD KEYS __PLUGIN_PLAY__";
-    ModuleInput temp;
-    temp.set_type<submod_uuid_map>();
-    temp.change(submod_uuids());
-    in_inputs.emplace(submod_key, temp);
+    in_inputs.emplace(std::move(submod_key), fingerprint_input_());
     return in_inputs;
 }
 
+inline ModuleInput ModulePIMPL::fingerprint_input_() const {
+    if(m_lock_done_) return *m_fingerprint_input_;
+    {
+        lock_type guard(m_mutex_.m_mutex);
+        if(m_fingerprint_input_) return *m_fingerprint_input_;
+    }
+    return make_fingerprint_input_(make_fingerprint_());
+}
+
+inline ModuleInput ModulePIMPL::make_fingerprint_input_(
+  fingerprint_type fingerprint) {
+    ModuleInput rv;
+    rv.set_type<fingerprint_type>();
+    rv.change(std::move(fingerprint));
+    return rv;
+}
+
 inline void ModulePIMPL::lock() {
+    lock_type guard(m_mutex_.m_mutex);
     for(auto& [k, v] : m_submods_) v.lock();
     m_locked_ = true;
+    if(m_fingerprint_ || !not_set_guts_(m_submods_).empty()) return;
+    m_fingerprint_       = make_fingerprint_();
+    m_fingerprint_input_ = make_fingerprint_input_(*m_fingerprint_);
+    m_lock_done_         = true;
+}
+
+inline std::set<type::key> ModulePIMPL::not_set_inputs_(
+  const type::input_map& in_inputs) const {
+    // This is all of the not ready inputs
+    auto in_probs = not_set_guts_(m_inputs_);
+
+    // Now pull out those set by the property type
+    for(const auto& [k, v] : in_inputs)
+        if(in_probs.count(k)) in_probs.erase(k);
+    return in_probs;
 }
 
 template<typename T>
@@ -249,9 +296,95 @@ std::set<type::key> ModulePIMPL::not_set_guts_(T&& map) const {
     return probs;
 }
 
+inline typename ModulePIMPL::task_pool_type* ModulePIMPL::task_pool()
+  const noexcept {
+    if(!has_module() || !m_base_->has_task_pool()) return nullptr;
+    return &m_base_->get_task_pool();
+}
+
 inline void ModulePIMPL::assert_mod_() const {
     if(has_module()) return;
     throw std::runtime_error("Module does not contain an implementation");
 }
 
+inline type::result_map ModulePIMPL::run_(
+  type::input_map ps, ModuleProfile::outcome_type& outcome) {
+    using outcome_type = ModuleProfile::outcome_type;
+    const auto start   = std::chrono::system_clock::now();
+    const auto t0      = ModuleProfile::clock_type::now();
+    auto record        = [&](outcome_type o) {
+        const auto dt = ModuleProfile::clock_type::now() - t0;
+        m_profile_.record(start, dt, o);
+        outcome = o;
+    };
+
+    // Check the inputs we were just given
+    for(const auto& [k, v] : ps)
+        if(!v.ready()) throw std::runtime_error("Inputs are not ready");
+
+    // Merge with bound and see if we are ready
+    // N.B. Once *this is locked, with the fingerprint stored, its submodules
+    //      were ready and can't change, so only the inputs need checking
+    const bool is_ready =
+      m_lock_done_ ? not_set_inputs_(ps).empty() : ready(ps);
+    if(!is_ready) {
+        // Make a dummy module with this PIMPL so we can print out why it's not
+        // ready.
+        Module dummy(std::make_unique<ModulePIMPL>(*this));
+        throw std::runtime_error(print_not_ready(dummy, ps));
+    }
+
+    // N.B. Once *this is locked, with the fingerprint stored, runs don't
+    //      need to lock it (or its submodules) again
+    if(!m_lock_done_) lock();
+
+    ps = merge_inputs_(std::move(ps));
+
+    if(!m_cache_ || !is_memoizable()) {
+        auto rv = m_base_->run(std::move(ps), m_submods_);
+        record(outcome_type::not_memoized);
+        return rv;
+    }
+
+    // The policy decided the look up costs more than running the module
+    if(m_policy_ && !m_policy_->memoize()) {
+        const auto t1 = ModuleProfile::clock_type::now();
+        auto rv       = m_base_->run(std::move(ps), m_submods_);
+        const auto dt = ModuleProfile::clock_type::now() - t1;
+        using std::chrono::duration_cast;
+        using policy_duration = MemoizationPolicy::duration_type;
+        m_policy_->bypassed(*m_cache_, duration_cast<policy_duration>(dt));
+        record(outcome_type::not_memoized);
+        return rv;
+    }
+
+    // The policy may decide the results aren't worth writing to disk
+    m_cache_->set_persistent(!m_policy_ || m_policy_->persist());
+
+    // Look ps up once, only running the module (and caching) on a miss
+    bool computed = false;
+    auto rv       = m_cache_->find_or_compute(ps, [&]() {
+        computed = true;
+        return m_base_->run(ps, m_submods_);
+    });
+    if(m_policy_) m_policy_->memoized(*m_cache_);
+    record(computed ? outcome_type::cache_miss : outcome_type::cache_hit);
+    return rv;
+}
+
+inline typename ModulePIMPL::fingerprint_type ModulePIMPL::make_fingerprint_()
+  const {
+    // N.B. The submodules' fingerprints are hashes too, so the size of tree
+    //      only depends on the submodules of *this
+    std::string tree("1");
+    for(const auto& [k, v] : m_submods_) {
+        const auto uuid = v.uuid();
+        tree += std::to_string(k.size()) + ":" + k;
+        tree += std::to_string(uuid.size()) + ":" + uuid;
+        tree += "(" + v.value().submod_fingerprint() + ")";
+    }
+    return utility::to_string(
+      utility::generate_binary_uuid(tree.data(), tree.size()));
+}
+
 } // namespace pluginplay::detail_
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pluginplay/module/memoization_policy.hpp>
+
+namespace pluginplay {
+
+MemoizationPolicy::MemoizationPolicy(const MemoizationPolicy& other) {
+    lock_type lock(other.m_mutex_);
+    m_options_        = other.m_options_;
+    m_memoize_        = other.m_memoize_;
+    m_persist_        = other.m_persist_;
+    m_n_runs_         = other.m_n_runs_;
+    m_baseline_       = other.m_baseline_;
+    m_has_baseline_   = other.m_has_baseline_;
+    m_off_compute_    = other.m_off_compute_;
+    m_bypass_compute_ = other.m_bypass_compute_;
+}
+
+MemoizationPolicy& MemoizationPolicy::operator=(const MemoizationPolicy& rhs) {
+    if(this == &rhs) return *this;
+    MemoizationPolicy copy(rhs);
+    lock_type lock(m_mutex_);
+    m_options_        = copy.m_options_;
+    m_memoize_        = copy.m_memoize_;
+    m_persist_        = copy.m_persist_;
+    m_n_runs_         = copy.m_n_runs_;
+    m_baseline_       = copy.m_baseline_;
+    m_has_baseline_   = copy.m_has_baseline_;
+    m_off_compute_    = copy.m_off_compute_;
+    m_bypass_compute_ = copy.m_bypass_compute_;
+    return *this;
+}
+
+bool MemoizationPolicy::memoize() const noexcept {
+    lock_type lock(m_mutex_);
+    return m_memoize_;
+}
+
+bool MemoizationPolicy::persist() const noexcept {
+    lock_type lock(m_mutex_);
+    return m_memoize_ && m_persist_;
+}
+
+void MemoizationPolicy::memoized(const cache_type& cache) noexcept {
+    lock_type lock(m_mutex_);
+    if(!m_has_baseline_) {
+        m_baseline_     = cache.metrics();
+        m_has_baseline_ = true;
+        m_n_runs_       = 0;
+        return;
+    }
+    if(++m_n_runs_ < m_options_.window) return;
+
+    const auto now = cache.metrics();
+    const auto& b  = m_baseline_;
+    const auto n_hits     = now.n_hits - b.n_hits;
+    const auto n_computed = now.n_computed - b.n_computed;
+    const auto bytes      = now.bytes_inserted - b.bytes_inserted;
+    const auto lookup     = now.lookup_time - b.lookup_time;
+    const auto compute    = now.compute_time - b.compute_time;
+    m_baseline_           = now;
+    m_n_runs_             = 0;
+
+    // Without a computation there's nothing to compare the hits against, but
+    // runs which only hit (or coalesced) are clearly worth memoizing
+    if(n_computed == 0) return;
+
+    using rep_type         = typename duration_type::rep;
+    const auto avg_compute = compute / static_cast<rep_type>(n_computed);
+    const double saved     = n_hits * static_cast<double>(avg_compute.count());
+    const double cost =
+      lookup.count() + m_options_.ns_per_byte * static_cast<double>(bytes);
+    if(n_hits > 0 && saved >= cost) {
+        // Writing the results out is only worth it if the hits pay for it too
+        const double persist_cost =
+          m_options_.ns_per_persisted_byte * static_cast<double>(bytes);
+        m_persist_ = saved >= cost + persist_cost;
+        return;
+    }
+
+    m_memoize_        = false;
+    m_has_baseline_   = false;
+    m_off_compute_    = avg_compute;
+    m_bypass_compute_ = duration_type{0};
+}
+
+void MemoizationPolicy::bypassed(const cache_type& cache,
+                                 duration_type compute) noexcept {
+    lock_type lock(m_mutex_);
+    m_bypass_compute_ += compute;
+    if(++m_n_runs_ < m_options_.window) return;
+
+    using rep_type    = typename duration_type::rep;
+    const auto avg    = m_bypass_compute_ / static_cast<rep_type>(m_n_runs_);
+    m_n_runs_         = 0;
+    m_bypass_compute_ = duration_type{0};
+    if(avg.count() <= m_options_.regrowth * m_off_compute_.count()) return;
+
+    // Starts a new window, with the cache's current metrics as the baseline.
+    // Results are only kept in memory until the hits are known to pay off.
+    m_memoize_      = true;
+    m_persist_      = false;
+    m_baseline_     = cache.metrics();
+    m_has_baseline_ = true;
+}
+
+} // namespace pluginplay
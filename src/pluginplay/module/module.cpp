@@ -64,6 +64,10 @@ bool Module::ready(const type::input_map& inps) const {
 
 void Module::reset_cache() { m_pimpl_->reset_cache(); }
 
+cache::ModuleCache::metrics_type Module::cache_metrics() const noexcept {
+    return m_pimpl_->cache_metrics();
+}
+
 void Module::reset_internal_cache() { m_pimpl_->reset_internal_cache(); }
 
 bool Module::is_memoizable() const { return m_pimpl_->is_memoizable(); }
@@ -74,11 +78,20 @@ void Module::turn_on_memoization() { m_pimpl_->turn_on_memoization(); }
 
 void Module::turn_off_memoization() { m_pimpl_->turn_off_memoization(); }
 
+void Module::turn_on_adaptive_memoization(
+  MemoizationPolicy::options_type options) {
+    m_pimpl_->turn_on_adaptive_memoization(options);
+}
+
+bool Module::is_memoization_adaptive() const noexcept {
+    return m_pimpl_->is_memoization_adaptive();
+}
+
 void Module::lock() { m_pimpl_->lock(); }
 
 void Module::change_submod(type::key key, std::shared_ptr<Module> new_module) {
     assert_not_locked_();
-    m_pimpl_->submods().at(key).change(new_module);
+    m_pimpl_->change_submod(key, std::move(new_module));
 }
 
 //-------------------------------Getters----------------------------------------
@@ -94,7 +107,7 @@ const std::set<type::rtti>& Module::property_types() const {
 }
 
 type::result_map Module::run(type::input_map ps) {
-    return m_pimpl_->run(std::move(ps));
+    return run_(std::move(ps), nullptr);
 }
 
 bool Module::operator==(const Module& rhs) const {
@@ -111,6 +124,10 @@ const std::vector<type::description>& Module::citations() const {
 
 std::string Module::profile_info() const { return m_pimpl_->profile_info(); }
 
+const ModuleProfile& Module::profile() const noexcept {
+    return m_pimpl_->profile();
+}
+
 typename Module::uuid_type Module::uuid() const {
     if(!m_pimpl_) return uuid_type{};
     return m_pimpl_->uuid();
@@ -121,6 +138,11 @@ typename Module::submod_uuid_map Module::submod_uuids() const {
     return m_pimpl_->submod_uuids();
 }
 
+typename Module::fingerprint_type Module::submod_fingerprint() const {
+    if(!m_pimpl_) return fingerprint_type{};
+    return m_pimpl_->submod_fingerprint();
+}
+
 //--------------------------- Private Members --------------------------------/
 
 void Module::unlock_() noexcept { m_pimpl_->unlock(); }
@@ -140,6 +162,16 @@ void Module::check_property_type_(type::rtti prop_type) {
     throw std::runtime_error(msg);
 }
 
+utility::TaskPool* Module::task_pool_() const noexcept {
+    return m_pimpl_->task_pool();
+}
+
+type::result_map Module::run_(type::input_map ps,
+                              const type::rtti* prop_type) {
+    const auto* name = has_name() ? &get_name() : nullptr;
+    return m_pimpl_->run(std::move(ps), name, prop_type);
+}
+
 std::string print_not_ready(const Module& mod, const type::input_map& ps,
                             const std::string& indent) {
     std::string rv      = "";
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "detail_/json_writer.hpp"
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <pluginplay/module/module_profile.hpp>
+#include <sstream>
+#include <thread>
+
+namespace pluginplay {
+namespace {
+
+using detail_::outcome_name;
+using detail_::write_json_string;
+using duration_type = ModuleProfile::duration_type;
+
+// Durations are exported in (fractional) milliseconds
+double to_ms(duration_type d) { return d.count() / 1.0E6; }
+
+// Formats @p t as an ISO 8601 time stamp (UTC, millisecond precision)
+std::string iso_8601(ModuleProfile::time_point_type t) {
+    using namespace std::chrono;
+    const auto t_tt = system_clock::to_time_t(t);
+    const auto ms   = duration_cast<milliseconds>(t.time_since_epoch()) % 1000;
+    std::tm t_tm;
+    {
+        // std::gmtime returns a pointer to storage shared by all threads
+        static std::mutex gmtime_mutex;
+        std::lock_guard<std::mutex> lock(gmtime_mutex);
+        t_tm = *std::gmtime(&t_tt);
+    }
+    std::stringstream ss;
+    ss << std::put_time(&t_tm, "%Y-%m-%dT%H:%M:%S") << '.' << std::setfill('0')
+       << std::setw(3) << ms.count() << 'Z';
+    return ss.str();
+}
+
+void write_json(std::ostream& os,
+                const std::map<std::string, const ModuleProfile*>& profiles) {
+    os << '{';
+    bool first = true;
+    for(const auto& [name, profile] : profiles) {
+        const auto stats = profile->stats();
+        os << (first ? "" : ",");
+        first = false;
+        write_json_string(os, name);
+        os << ":{\"n_calls\":" << stats.n_calls
+           << ",\"n_hits\":" << stats.n_hits
+           << ",\"n_misses\":" << stats.n_misses
+           << ",\"total_ms\":" << to_ms(stats.total)
+           << ",\"min_ms\":" << to_ms(stats.min)
+           << ",\"max_ms\":" << to_ms(stats.max)
+           << ",\"p50_ms\":" << to_ms(stats.p50)
+           << ",\"p90_ms\":" << to_ms(stats.p90)
+           << ",\"p99_ms\":" << to_ms(stats.p99);
+        if(stats.n_calls > 0) {
+            os << ",\"first_call\":\"" << iso_8601(stats.first_call) << '"'
+               << ",\"last_call\":\"" << iso_8601(stats.last_call) << '"';
+        }
+        os << '}';
+    }
+    os << '}';
+}
+
+void write_chrome_trace(
+  std::ostream& os,
+  const std::map<std::string, const ModuleProfile*>& profiles) {
+    using us_type = detail_::ChromeTraceWriter::duration_type;
+    detail_::ChromeTraceWriter writer(os);
+    for(const auto& [name, profile] : profiles) {
+        for(const auto& call : profile->recent_calls()) {
+            const us_type ts = call.m_start.time_since_epoch();
+            writer.event(name, 'X', ts, call.m_thread, call.m_duration,
+                         "outcome", outcome_name(call.m_outcome));
+        }
+    }
+    writer.finish();
+}
+
+} // namespace
+
+ModuleProfile::ModuleProfile(const ModuleProfile& other) {
+    lock_type lock(other.m_mutex_);
+    m_stats_     = other.m_stats_;
+    m_histogram_ = other.m_histogram_;
+    m_recent_    = other.m_recent_;
+    m_next_      = other.m_next_;
+}
+
+ModuleProfile& ModuleProfile::operator=(const ModuleProfile& rhs) {
+    if(this == &rhs) return *this;
+    ModuleProfile copy(rhs);
+    lock_type lock(m_mutex_);
+    m_stats_     = copy.m_stats_;
+    m_histogram_ = copy.m_histogram_;
+    m_recent_    = std::move(copy.m_recent_);
+    m_next_      = copy.m_next_;
+    return *this;
+}
+
+void ModuleProfile::record(time_point_type start, duration_type duration,
+                           outcome_type outcome) noexcept {
+    const auto tid    = std::this_thread::get_id();
+    const auto thread = std::hash<std::thread::id>{}(tid);
+    lock_type lock(m_mutex_);
+    auto& s = m_stats_;
+    if(s.n_calls == 0 || duration < s.min) s.min = duration;
+    if(s.n_calls == 0) s.first_call = start;
+    s.max = std::max(s.max, duration);
+    ++s.n_calls;
+    if(outcome == outcome_type::cache_hit) ++s.n_hits;
+    if(outcome == outcome_type::cache_miss) ++s.n_misses;
+    s.total += duration;
+    s.last_call     = start;
+    s.last_duration = duration;
+    m_histogram_.add(duration);
+
+    call_type call{start, duration, outcome, thread};
+    if(m_recent_.size() < max_recent_calls()) {
+        // N.B. this is the only place recording can allocate, and failing to
+        //      keep a recent call isn't worth throwing over
+        try {
+            m_recent_.push_back(call);
+        } catch(...) {}
+        return;
+    }
+    m_recent_[m_next_] = call;
+    m_next_            = (m_next_ + 1) % max_recent_calls();
+}
+
+typename ModuleProfile::stats_type ModuleProfile::stats() const noexcept {
+    lock_type lock(m_mutex_);
+    auto rv = m_stats_;
+    rv.p50  = percentile_(50.0);
+    rv.p90  = percentile_(90.0);
+    rv.p99  = percentile_(99.0);
+    return rv;
+}
+
+typename ModuleProfile::duration_type ModuleProfile::percentile(
+  double p) const noexcept {
+    lock_type lock(m_mutex_);
+    return percentile_(p);
+}
+
+std::vector<typename ModuleProfile::call_type> ModuleProfile::recent_calls()
+  const {
+    lock_type lock(m_mutex_);
+    std::vector<call_type> rv(m_recent_.begin() + m_next_, m_recent_.end());
+    rv.insert(rv.end(), m_recent_.begin(), m_recent_.begin() + m_next_);
+    return rv;
+}
+
+void ModuleProfile::reset() noexcept {
+    lock_type lock(m_mutex_);
+    m_stats_ = stats_type{};
+    m_histogram_.reset();
+    m_recent_.clear();
+    m_next_ = 0;
+}
+
+typename ModuleProfile::duration_type ModuleProfile::percentile_(
+  double p) const noexcept {
+    if(m_stats_.n_calls == 0) return duration_type{0};
+    // Keep the estimate within the observed range
+    return std::clamp(m_histogram_.percentile(p), m_stats_.min, m_stats_.max);
+}
+
+std::ostream& write_profiles(
+  std::ostream& os, const std::map<std::string, const ModuleProfile*>& profiles,
+  ModuleProfile::format_type format) {
+    if(format == ModuleProfile::format_type::json)
+        write_json(os, profiles);
+    else
+        write_chrome_trace(os, profiles);
+    return os;
+}
+
+} // namespace pluginplay
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "detail_/json_writer.hpp"
+#include <map>
+#include <pluginplay/module/module_tracer.hpp>
+#include <thread>
+#include <utilities/printing/demangler.hpp>
+
+namespace pluginplay {
+
+ModuleTracer::ModuleTracer() : m_start_(clock_type::now()) {}
+
+void ModuleTracer::begin(const type::key* name,
+                         const type::rtti* property_type) {
+    record_(phase_type::begin, name, property_type, std::nullopt);
+}
+
+void ModuleTracer::end(const type::key* name, const type::rtti* property_type,
+                       std::optional<outcome_type> outcome) {
+    record_(phase_type::end, name, property_type, outcome);
+}
+
+typename ModuleTracer::size_type ModuleTracer::size() const noexcept {
+    lock_type lock(m_mutex_);
+    return m_events_.size();
+}
+
+std::vector<typename ModuleTracer::event_type> ModuleTracer::events() const {
+    lock_type lock(m_mutex_);
+    return m_events_;
+}
+
+void ModuleTracer::clear() noexcept {
+    lock_type lock(m_mutex_);
+    m_events_.clear();
+}
+
+std::ostream& ModuleTracer::write(std::ostream& os) const {
+    const auto events = this->events();
+
+    // Names are demangled once per property type
+    std::map<type::rtti, std::string> pt_names;
+
+    detail_::ChromeTraceWriter writer(os);
+    for(const auto& event : events) {
+        const auto ts = event.m_time - m_start_;
+        if(event.m_phase == phase_type::end) {
+            const auto& outcome = event.m_outcome;
+            writer.event(event.m_name, 'E', ts, event.m_thread, {}, "outcome",
+                         outcome ? detail_::outcome_name(*outcome) : "error");
+            continue;
+        }
+
+        std::string pt_name;
+        if(event.m_property_type.has_value()) {
+            const auto& pt = *event.m_property_type;
+            auto itr       = pt_names.find(pt);
+            if(itr == pt_names.end()) {
+                const auto name = utilities::printing::Demangler::demangle(pt);
+                itr = pt_names.emplace(pt, name).first;
+            }
+            pt_name = itr->second;
+        }
+        writer.event(event.m_name, 'B', ts, event.m_thread, {},
+                     "property_type", pt_name);
+    }
+    writer.finish();
+    return os;
+}
+
+void ModuleTracer::record_(phase_type phase, const type::key* name,
+                           const type::rtti* property_type,
+                           std::optional<outcome_type> outcome) {
+    const auto time = clock_type::now();
+    const auto tid  = std::this_thread::get_id();
+    std::optional<type::rtti> pt;
+    if(property_type) pt.emplace(*property_type);
+    event_type event{phase,
+                     name ? *name : type::key{},
+                     std::move(pt),
+                     time,
+                     std::hash<std::thread::id>{}(tid),
+                     outcome};
+    lock_type lock(m_mutex_);
+    m_events_.push_back(std::move(event));
+}
+
+} // namespace pluginplay
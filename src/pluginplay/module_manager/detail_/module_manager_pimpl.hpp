@@ -69,6 +69,18 @@ struct ModuleManagerPIMPL {
     /// Type of a pointer to the cache
     using cache_pointer = module_manager_type::cache_pointer;
 
+    /// Type of the pool asynchronous runs are submitted to
+    using task_pool_type = module_manager_type::task_pool_type;
+
+    /// Type of a pointer to the task pool
+    using task_pool_pointer = module_manager_type::task_pool_pointer;
+
+    /// Type of the tracer module runs are recorded with
+    using tracer_type = ModuleTracer;
+
+    /// Type of a pointer to the tracer
+    using tracer_pointer = std::shared_ptr<tracer_type>;
+
     /// Type of a map from key to Python implementation
     // TODO: remove when a more elegant solution is determined
     using py_base_map = std::map<type::key, const_module_base_ptr>;
@@ -79,8 +91,10 @@ struct ModuleManagerPIMPL {
       ModuleManagerPIMPL(std::make_shared<runtime_type>(),
                          std::make_shared<cache_type>()) {}
 
-    ModuleManagerPIMPL(runtime_ptr runtime, cache_pointer cache) :
-      m_pcaches(cache), m_runtime_(runtime) {}
+    ModuleManagerPIMPL(
+      runtime_ptr runtime, cache_pointer cache,
+      task_pool_pointer task_pool = std::make_shared<task_pool_type>()) :
+      m_pcaches(cache), m_runtime_(runtime), m_task_pool_(task_pool) {}
 
     /// Makes a deep copy of this instance on the heap
     // auto clone() { return std::make_unique<ModuleManagerPIMPL>(*this); }
@@ -174,9 +188,23 @@ struct ModuleManagerPIMPL {
 
     runtime_type& get_runtime() const { return *m_runtime_; }
 
+    task_pool_type& get_task_pool() const { return *m_task_pool_; }
+
     ModuleManager::key_container_type keys() const;
 
     bool has_cache() const noexcept { return static_cast<bool>(m_pcaches); }
+
+    /// Starts a new trace, which all modules (current and future) record to
+    void enable_tracing();
+
+    /// Stops recording runs, the trace is kept
+    void disable_tracing() noexcept;
+
+    /// Are module runs being recorded?
+    bool is_tracing() const noexcept { return m_tracing_; }
+
+    /// The most recent trace (null if tracing was never enabled)
+    const tracer_type* tracer() const noexcept { return m_tracer_.get(); }
     ///@}
 
     ///@{
@@ -206,8 +234,20 @@ struct ModuleManagerPIMPL {
 
     // Pointer to this modules current runtime
     runtime_ptr m_runtime_;
+
+    // Pool the modules submit asynchronous runs to
+    task_pool_pointer m_task_pool_;
+
+    // The most recent trace
+    tracer_pointer m_tracer_;
+
+    // Are the modules recording their runs to m_tracer_?
+    bool m_tracing_ = false;
     ///@}
 private:
+    /// Gives @p tracer to all of the module implementations
+    void set_tracer_(tracer_pointer tracer) noexcept;
+
     /// Wraps the check for making sure @p key is not in use.
     void assert_unique_key_(const type::key& key) const {
         if(count(key)) throw std::invalid_argument("Key is in use");
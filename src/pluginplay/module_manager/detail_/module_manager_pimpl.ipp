@@ -33,6 +33,8 @@ inline void ModuleManagerPIMPL::add_module(type::key key,
     assert_unique_key_(key);
     auto uuid = utility::generate_uuid();
     base->set_runtime(m_runtime_);
+    base->set_task_pool(m_task_pool_);
+    if(m_tracing_) base->set_tracer(m_tracer_);
     base->set_uuid(uuid);
 
     cache::ModuleManagerCache::module_cache_pointer module_cache;
@@ -91,6 +93,26 @@ inline ModuleManagerPIMPL::shared_module ModuleManagerPIMPL::at(
     return mod;
 }
 
+inline void ModuleManagerPIMPL::enable_tracing() {
+    m_tracer_  = std::make_shared<tracer_type>();
+    m_tracing_ = true;
+    set_tracer_(m_tracer_);
+}
+
+inline void ModuleManagerPIMPL::disable_tracing() noexcept {
+    m_tracing_ = false;
+    set_tracer_(nullptr);
+}
+
+inline void ModuleManagerPIMPL::set_tracer_(tracer_pointer tracer) noexcept {
+    // N.B. the bases were handed to add_module as non-const, we only store
+    //      them as const to prevent accidental modification
+    for(auto& [_, base] : m_bases)
+        std::const_pointer_cast<ModuleBase>(base)->set_tracer(tracer);
+    for(auto& [_, base] : m_py_bases)
+        std::const_pointer_cast<ModuleBase>(base)->set_tracer(tracer);
+}
+
 inline bool ModuleManagerPIMPL::operator==(
   const ModuleManagerPIMPL& rhs) const {
     // Try to get out early
@@ -30,8 +30,10 @@ using CIM = utilities::CaseInsensitiveMap<T>;
 
 ModuleManager::ModuleManager() :
   pimpl_(std::make_unique<detail_::ModuleManagerPIMPL>()) {}
-ModuleManager::ModuleManager(runtime_ptr runtime, cache_pointer cache) :
-  pimpl_(std::make_unique<detail_::ModuleManagerPIMPL>(runtime, cache)) {}
+ModuleManager::ModuleManager(runtime_ptr runtime, cache_pointer cache,
+                             task_pool_pointer task_pool) :
+  pimpl_(std::make_unique<detail_::ModuleManagerPIMPL>(runtime, cache,
+                                                       task_pool)) {}
 ModuleManager::ModuleManager(ModuleManager&& rhs) noexcept = default;
 ModuleManager& ModuleManager::operator=(ModuleManager&& rhs) noexcept = default;
 ModuleManager::~ModuleManager() noexcept                              = default;
@@ -79,6 +81,10 @@ ModuleManager::runtime_type& ModuleManager::get_runtime() const noexcept {
     return pimpl_->get_runtime();
 };
 
+ModuleManager::task_pool_type& ModuleManager::get_task_pool() const noexcept {
+    return pimpl_->get_task_pool();
+}
+
 ModuleManager::key_container_type ModuleManager::keys() const {
     return pimpl_->keys();
 }
@@ -88,6 +94,31 @@ bool ModuleManager::has_cache() const noexcept {
     return has_pimpl_() && pimpl_->has_cache();
 }
 
+typename ModuleManager::cache_metrics_type ModuleManager::cache_metrics(
+  const type::key& module_key) const {
+    return at(module_key).cache_metrics();
+}
+
+std::ostream& ModuleManager::write_profile(std::ostream& os,
+                                          format_type format) const {
+    std::map<std::string, const ModuleProfile*> profiles;
+    for(const auto& key : keys()) profiles[key] = &at(key).profile();
+    return write_profiles(os, profiles, format);
+}
+
+void ModuleManager::enable_tracing() { pimpl_->enable_tracing(); }
+
+void ModuleManager::disable_tracing() noexcept { pimpl_->disable_tracing(); }
+
+bool ModuleManager::is_tracing() const noexcept {
+    return has_pimpl_() && pimpl_->is_tracing();
+}
+
+std::ostream& ModuleManager::write_trace(std::ostream& os) const {
+    if(auto* tracer = pimpl_->tracer()) return tracer->write(os);
+    return ModuleTracer{}.write(os);
+}
+
 // -----------------------------------------------------------------------------
 // -- Private Methods
 // -----------------------------------------------------------------------------
@@ -21,10 +21,9 @@ namespace pluginplay {
 using module_ptr = typename SubmoduleRequest::module_ptr;
 
 SubmoduleRequest::SubmoduleRequest() :
-  m_pimpl_(std::make_unique<detail_::SubmoduleRequestPIMPL>()) {}
+  m_pimpl_(std::make_shared<detail_::SubmoduleRequestPIMPL>()) {}
 
-SubmoduleRequest::SubmoduleRequest(const SubmoduleRequest& rhs) :
-  m_pimpl_(rhs.m_pimpl_->clone()) {}
+SubmoduleRequest::SubmoduleRequest(const SubmoduleRequest& rhs) = default;
 
 SubmoduleRequest::SubmoduleRequest(SubmoduleRequest&& rhs) noexcept = default;
 
@@ -51,7 +50,7 @@ bool SubmoduleRequest::ready() const noexcept { return m_pimpl_->ready(); }
 
 SubmoduleRequest& SubmoduleRequest::set_type(rtti_type type,
                                              type::input_map inputs) {
-    m_pimpl_->set_type(type, std::move(inputs));
+    mutable_pimpl_().set_type(type, std::move(inputs));
     return *this;
 }
 
@@ -60,16 +59,16 @@ bool SubmoduleRequest::satisfies_property_type(rtti_type type) {
 }
 
 void SubmoduleRequest::change(module_ptr new_mod) {
-    m_pimpl_->set_module(new_mod);
+    mutable_pimpl_().set_module(new_mod);
 }
 
 void SubmoduleRequest::change(const SubmoduleRequest& new_mod) {
-    m_pimpl_->set_module(new_mod.m_pimpl_->data());
+    mutable_pimpl_().set_module(new_mod.m_pimpl_->data());
 }
 
 SubmoduleRequest& SubmoduleRequest::set_description(
-  type::description desc) noexcept {
-    m_pimpl_->set_description(std::move(desc));
+  type::description desc) {
+    mutable_pimpl_().set_description(std::move(desc));
     return *this;
 }
 
@@ -99,7 +98,15 @@ const type::key& SubmoduleRequest::get_name() const {
 void SubmoduleRequest::lock() { m_pimpl_->lock(); }
 
 bool SubmoduleRequest::operator==(const SubmoduleRequest& rhs) const {
+    if(m_pimpl_ == rhs.m_pimpl_) return true;
     return *m_pimpl_ == *rhs.m_pimpl_;
 }
 
+detail_::SubmoduleRequestPIMPL& SubmoduleRequest::mutable_pimpl_() {
+    // N.B. the module is shared by the copies regardless, so lock and value
+    // don't need their own copy of the state
+    if(m_pimpl_.use_count() > 1) m_pimpl_ = m_pimpl_->clone();
+    return *m_pimpl_;
+}
+
 } // namespace pluginplay
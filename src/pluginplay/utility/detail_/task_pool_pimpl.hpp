@@ -0,0 +1,189 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <pluginplay/utility/task_pool.hpp>
+#include <thread>
+#include <vector>
+
+namespace pluginplay::utility::detail_ {
+
+/** @brief Implements the TaskPool class.
+ *
+ *  There is one queue per worker (and always at least one queue, so that a
+ *  pool without workers can still hold tasks for waiting threads to run).
+ *  Each queue is guarded by its own mutex, so workers only contend when
+ *  stealing. Idle workers sleep on a condition variable, which is signaled
+ *  when a task is submitted.
+ */
+class TaskPoolPIMPL {
+public:
+    /// Type the TaskPool uses for counting
+    using size_type = TaskPool::size_type;
+
+    /// Type of a task
+    using task_type = TaskPool::task_type;
+
+    /// Makes the queues, but does not start the workers
+    explicit TaskPoolPIMPL(size_type n_workers) : m_n_workers_(n_workers) {
+        const auto n_queues = std::max(n_workers, size_type{1});
+        for(size_type i = 0; i < n_queues; ++i)
+            m_queues_.emplace_back(std::make_unique<queue_type>());
+    }
+
+    /// Runs any remaining tasks, then stops and joins the workers
+    ~TaskPoolPIMPL() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex_);
+            m_stop_ = true;
+        }
+        m_cv_.notify_all();
+        for(auto& worker : m_workers_) worker.join();
+
+        // Without workers no one else will run the tasks
+        while(run_pending_task()) {}
+    }
+
+    /// The number of workers
+    size_type size() const noexcept { return m_n_workers_; }
+
+    /// Adds @p task to the calling worker's queue, or the next queue
+    void submit(task_type task) {
+        std::call_once(m_start_flag_, [this]() { start_(); });
+
+        const auto& me = current_worker_();
+        const auto n   = m_queues_.size();
+        const auto i   = me.pool == this ? me.index : m_next_queue_++ % n;
+
+        // N.B. we count the task before queueing it so that the count never
+        //      underflows; a worker may briefly see it before the task.
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex_);
+            ++m_n_pending_;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_queues_[i]->m_mutex);
+            m_queues_[i]->m_tasks.push_back(std::move(task));
+        }
+        m_cv_.notify_one();
+    }
+
+    /// Runs one task from our queue if we're a worker, else steals one
+    bool run_pending_task() noexcept {
+        const auto& me = current_worker_();
+        task_type task;
+        const bool is_worker = me.pool == this;
+        if(!pop_(is_worker ? me.index : 0, is_worker, task)) return false;
+        task();
+        return true;
+    }
+
+private:
+    /// A queue of tasks and the mutex guarding it
+    struct queue_type {
+        std::mutex m_mutex;
+        std::deque<task_type> m_tasks;
+    };
+
+    /// Identifies the worker the calling thread is (if any)
+    struct worker_id {
+        const TaskPoolPIMPL* pool = nullptr;
+        size_type index           = 0;
+    };
+
+    /// Worker identity of the calling thread
+    static worker_id& current_worker_() noexcept {
+        static thread_local worker_id id;
+        return id;
+    }
+
+    /// Spawns the workers
+    void start_() {
+        for(size_type i = 0; i < m_n_workers_; ++i)
+            m_workers_.emplace_back([this, i]() { work_(i); });
+    }
+
+    /// What worker @p i does until the pool is stopped
+    void work_(size_type i) {
+        current_worker_() = worker_id{this, i};
+        while(true) {
+            if(run_pending_task()) continue;
+            std::unique_lock<std::mutex> lock(m_sleep_mutex_);
+            m_cv_.wait(lock, [this]() { return m_stop_ || m_n_pending_ > 0; });
+            if(m_stop_ && m_n_pending_ == 0) return;
+        }
+    }
+
+    /** @brief Takes a task out of the queues.
+     *
+     *  Queues are searched starting from @p start. If @p owner is true, the
+     *  first queue is ours and we take its newest task, otherwise (and for
+     *  the remaining queues) we take the oldest task.
+     */
+    bool pop_(size_type start, bool owner, task_type& task) noexcept {
+        const auto n = m_queues_.size();
+        for(size_type offset = 0; offset < n; ++offset) {
+            auto& queue = *m_queues_[(start + offset) % n];
+            std::lock_guard<std::mutex> lock(queue.m_mutex);
+            if(queue.m_tasks.empty()) continue;
+            if(owner && offset == 0) {
+                task = std::move(queue.m_tasks.back());
+                queue.m_tasks.pop_back();
+            } else {
+                task = std::move(queue.m_tasks.front());
+                queue.m_tasks.pop_front();
+            }
+            --m_n_pending_;
+            return true;
+        }
+        return false;
+    }
+
+    /// The number of workers
+    size_type m_n_workers_;
+
+    /// The task queues, one per worker
+    std::vector<std::unique_ptr<queue_type>> m_queues_;
+
+    /// The workers, empty until the first task is submitted
+    std::vector<std::thread> m_workers_;
+
+    /// Ensures the workers are started once
+    std::once_flag m_start_flag_;
+
+    /// Round-robin counter for tasks submitted from outside the pool
+    std::atomic<size_type> m_next_queue_{0};
+
+    /// The number of queued tasks
+    std::atomic<size_type> m_n_pending_{0};
+
+    /// Used by idle workers to wait for tasks
+    std::mutex m_sleep_mutex_;
+
+    /// Signaled when tasks are submitted or the pool is stopped
+    std::condition_variable m_cv_;
+
+    /// Set when the pool is being destroyed
+    bool m_stop_ = false;
+};
+
+} // namespace pluginplay::utility::detail_
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <pluginplay/utility/latency_histogram.hpp>
+
+namespace pluginplay::utility {
+
+using size_type     = LatencyHistogram::size_type;
+using duration_type = LatencyHistogram::duration_type;
+
+size_type LatencyHistogram::bucket(duration_type latency) noexcept {
+    const auto ns = static_cast<std::uint64_t>(std::max<duration_type::rep>(
+      latency.count(), 0));
+    if(ns < 4) return ns;
+
+    // Four buckets per power of two: the leading bit picks the power, the
+    // next two bits pick the bucket
+    size_type msb = 0;
+    for(auto temp = ns; temp >>= 1;) ++msb;
+    return 4 * (msb - 1) + ((ns >> (msb - 2)) & 3);
+}
+
+duration_type LatencyHistogram::lower_bound(size_type bucket) noexcept {
+    if(bucket < 4) return duration_type(bucket);
+    const auto msb = bucket / 4 + 1;
+    const auto sub = bucket % 4;
+    // Past the last bucket a nanosecond count can reach
+    if(msb > 62) return duration_type::max();
+    return duration_type(static_cast<duration_type::rep>(4 + sub) << (msb - 2));
+}
+
+size_type LatencyHistogram::count() const noexcept {
+    size_type rv = 0;
+    for(auto n : counts) rv += n;
+    return rv;
+}
+
+duration_type LatencyHistogram::percentile(double p) const noexcept {
+    const auto n_total = count();
+    if(n_total == 0) return duration_type{0};
+    const auto rank =
+      std::max<size_type>(1, std::ceil(p / 100.0 * n_total));
+
+    size_type n = 0;
+    for(size_type i = 0; i < n_buckets; ++i) {
+        n += counts[i];
+        if(n < rank) continue;
+        const auto lower = lower_bound(i);
+        if(lower == duration_type::max()) return lower;
+        const auto upper = lower_bound(i + 1);
+        return lower + (upper - lower) / 2;
+    }
+    return duration_type::max();
+}
+
+} // namespace pluginplay::utility
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "detail_/task_pool_pimpl.hpp"
+
+namespace pluginplay::utility {
+
+using size_type = typename TaskPool::size_type;
+
+size_type TaskPool::default_size() noexcept {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+TaskPool::TaskPool(size_type n_workers) :
+  m_pimpl_(std::make_unique<detail_::TaskPoolPIMPL>(n_workers)) {}
+
+TaskPool::~TaskPool() noexcept = default;
+
+size_type TaskPool::size() const noexcept { return m_pimpl_->size(); }
+
+bool TaskPool::run_pending_task() noexcept {
+    return m_pimpl_->run_pending_task();
+}
+
+void TaskPool::submit_(task_type task) { m_pimpl_->submit(std::move(task)); }
+
+} // namespace pluginplay::utility
@@ -14,15 +14,48 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <boost/uuid/name_generator_sha1.hpp>
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <pluginplay/utility/uuid.hpp>
 
 namespace pluginplay::utility {
+namespace {
+
+// Copies the bytes of @p uuid
+binary_uuid_type to_binary(const boost::uuids::uuid& uuid) {
+    static_assert(sizeof(boost::uuids::uuid) == sizeof(binary_uuid_type));
+    binary_uuid_type rv;
+    std::copy(uuid.begin(), uuid.end(), rv.begin());
+    return rv;
+}
+
+} // namespace
 
 uuid_type generate_uuid() {
     return boost::uuids::to_string(boost::uuids::random_generator()());
 }
 
+binary_uuid_type generate_binary_uuid() {
+    // N.B. seeding a generator is expensive, so each thread keeps one
+    static thread_local boost::uuids::random_generator gen;
+    return to_binary(gen());
+}
+
+binary_uuid_type generate_binary_uuid(const void* data, std::size_t n) {
+    // PluginPlay's namespace for name-based UUIDs
+    static const boost::uuids::name_generator_sha1 gen(
+      boost::uuids::name_generator_sha1(boost::uuids::ns::url())(
+        "https://github.com/NWChemEx/PluginPlay"));
+    return to_binary(gen(data, n));
+}
+
+uuid_type to_string(const binary_uuid_type& uuid) {
+    boost::uuids::uuid rv;
+    std::copy(uuid.begin(), uuid.end(), rv.begin());
+    return boost::uuids::to_string(rv);
+}
+
 } // namespace pluginplay::utility
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mutex>
+#include <pluginplay/utility/wait_edge.hpp>
+#include <unordered_map>
+
+namespace pluginplay::utility {
+namespace {
+
+using id_type = WaitEdge::id_type;
+
+/// Map from a thread to the thread it waits on, holds only blocked threads
+using graph_type = std::unordered_map<id_type, id_type>;
+
+// N.B. Threads are identified by id, not by thread_local state, so a stale
+//      id (e.g., of a thread which exited) is harmless; at worst a reused id
+//      makes a thread compute something instead of waiting for it.
+
+std::mutex& graph_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+graph_type& graph() {
+    static graph_type g;
+    return g;
+}
+
+} // namespace
+
+WaitEdge::WaitEdge(id_type waitee) : m_previous_(exchange_(waitee)) {}
+
+WaitEdge::~WaitEdge() noexcept {
+    // Only allocates if *this removed the previous edge. If that fails, the
+    // calling thread merely looks like it isn't waiting on anything.
+    try {
+        exchange_(m_previous_);
+    } catch(...) {}
+}
+
+bool WaitEdge::would_deadlock(id_type waitee) noexcept {
+    const auto me = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(graph_mutex());
+    const auto& g = graph();
+
+    // Each blocked thread has one edge, so this walks a path. A path can end
+    // in a cycle which doesn't include us, hence the bound on its length.
+    for(std::size_t i = 0; i <= g.size(); ++i) {
+        if(waitee == me) return true;
+        auto itr = g.find(waitee);
+        if(itr == g.end()) return false;
+        waitee = itr->second;
+    }
+    return false;
+}
+
+id_type WaitEdge::exchange_(id_type waitee) {
+    const auto me = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(graph_mutex());
+    auto& g = graph();
+    auto itr = g.find(me);
+    const id_type old = itr == g.end() ? id_type{} : itr->second;
+    if(waitee == id_type{}) {
+        if(itr != g.end()) g.erase(itr);
+    } else if(itr != g.end()) {
+        itr->second = waitee;
+    } else {
+        g.emplace(me, waitee);
+    }
+    return old;
+}
+
+} // namespace pluginplay::utility
@@ -28,7 +28,8 @@ void export_any_field(py_module_reference m) {
       .def(pybind11::self == pybind11::self)
       .def(pybind11::self != pybind11::self)
       .def("has_value", &AnyField::has_value)
-      .def("owns_value", &AnyField::owns_value);
+      .def("owns_value", &AnyField::owns_value)
+      .def("memory_footprint", &AnyField::memory_footprint);
 }
 
 } // namespace pluginplay::any
@@ -19,10 +19,12 @@
 
 namespace pluginplay {
 
+void export_module_cache(py_module_reference m);
 void export_module_manager_cache(py_module_reference m);
 
 inline void export_cache(py_module_reference m) {
     auto m_cache = m.def_submodule("cache");
+    export_module_cache(m_cache);
     export_module_manager_cache(m_cache);
 }
 
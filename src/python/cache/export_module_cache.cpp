@@ -0,0 +1,53 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "export_cache.hpp"
+#include <pluginplay/cache/module_cache.hpp>
+#include <pybind11/chrono.h>
+#include <pybind11/stl.h>
+
+namespace pluginplay {
+
+void export_module_cache(py_module_reference m) {
+    using cache::ModuleCache;
+    using histogram_type = ModuleCache::histogram_type;
+    using metrics_type   = ModuleCache::metrics_type;
+
+    py_class_type<histogram_type>(m, "LatencyHistogram")
+      .def(pybind11::init<>())
+      .def_readonly("counts", &histogram_type::counts)
+      .def("count", &histogram_type::count)
+      .def("percentile", &histogram_type::percentile);
+
+    py_class_type<metrics_type>(m, "ModuleCacheMetrics")
+      .def(pybind11::init<>())
+      .def_readonly("n_hits", &metrics_type::n_hits)
+      .def_readonly("n_misses", &metrics_type::n_misses)
+      .def_readonly("n_computed", &metrics_type::n_computed)
+      .def_readonly("n_coalesced", &metrics_type::n_coalesced)
+      .def_readonly("n_inserts", &metrics_type::n_inserts)
+      .def_readonly("bytes_inserted", &metrics_type::bytes_inserted)
+      .def_readonly("lookup_time", &metrics_type::lookup_time)
+      .def_readonly("proxy_time", &metrics_type::proxy_time)
+      .def_readonly("backend_time", &metrics_type::backend_time)
+      .def_readonly("compute_time", &metrics_type::compute_time)
+      .def_readonly("lookup_latency", &metrics_type::lookup_latency)
+      .def_readonly("proxy_latency", &metrics_type::proxy_latency)
+      .def_readonly("backend_latency", &metrics_type::backend_latency);
+}
+
+} // namespace pluginplay
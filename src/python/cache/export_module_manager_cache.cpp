@@ -22,7 +22,9 @@ void export_module_manager_cache(py_module_reference m) {
     py_class_type<cache::ModuleManagerCache,
                   std::shared_ptr<cache::ModuleManagerCache>>(
       m, "ModuleManagerCache")
-      .def(pybind11::init<>());
+      .def(pybind11::init<>())
+      .def("memory_in_use", &cache::ModuleManagerCache::memory_in_use)
+      .def("memory_footprint", &cache::ModuleManagerCache::memory_footprint);
 }
 
 } // namespace pluginplay
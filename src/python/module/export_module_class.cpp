@@ -35,6 +35,15 @@ pybind11::object py_module_run_as(Module& self, pybind11::object pt,
 void export_module_class(py_module_reference m) {
     using ready_fxn         = bool (Module::*)(const type::input_map&) const;
     using change_submod_fxn = void (Module::*)(type::key, Module);
+    using options_type      = MemoizationPolicy::options_type;
+
+    py_class_type<options_type>(m, "MemoizationOptions")
+      .def(pybind11::init<>())
+      .def_readwrite("window", &options_type::window)
+      .def_readwrite("regrowth", &options_type::regrowth)
+      .def_readwrite("ns_per_byte", &options_type::ns_per_byte)
+      .def_readwrite("ns_per_persisted_byte",
+                     &options_type::ns_per_persisted_byte);
 
     py_class_type<Module>(m, "Module")
       .def(pybind11::init<>())
@@ -57,6 +66,10 @@ void export_module_class(py_module_reference m) {
       .def("is_memoizable", &Module::is_memoizable)
       .def("turn_off_memoization", &Module::turn_off_memoization)
       .def("turn_on_memoization", &Module::turn_on_memoization)
+      .def("turn_on_adaptive_memoization",
+           &Module::turn_on_adaptive_memoization,
+           pybind11::arg("options") = options_type{})
+      .def("is_memoization_adaptive", &Module::is_memoization_adaptive)
       .def("lock", &Module::lock)
       .def("results", &Module::results)
       .def("inputs", &Module::inputs)
@@ -94,6 +107,7 @@ void export_module_class(py_module_reference m) {
       .def("run", &Module::run)
       .def("profile_info", &Module::profile_info)
       .def("submod_uuids", &Module::submod_uuids)
+      .def("submod_fingerprint", &Module::submod_fingerprint)
       .def("uuid", &Module::uuid)
       .def(pybind11::self == pybind11::self)
       .def(pybind11::self != pybind11::self);
@@ -21,6 +21,7 @@
 #include <pluginplay/module_manager/module_manager.hpp>
 #include <pluginplay/python/python_wrapper.hpp>
 #include <pybind11/stl.h>
+#include <sstream>
 
 namespace pluginplay {
 
@@ -72,6 +73,27 @@ void export_module_manager_class(py_module_reference m) {
            pybind11::return_value_policy::reference_internal)
       .def("keys", &ModuleManager::keys)
       .def("has_cache", &ModuleManager::has_cache)
+      .def("cache_metrics", &ModuleManager::cache_metrics)
+      .def(
+        "write_profile",
+        [](const ModuleManager& self, const std::string& format) {
+            using format_type = ModuleProfile::format_type;
+            std::stringstream ss;
+            self.write_profile(ss, format == "chrome_trace" ?
+                                     format_type::chrome_trace :
+                                     format_type::json);
+            return ss.str();
+        },
+        pybind11::arg("format") = "json")
+      .def("enable_tracing", &ModuleManager::enable_tracing)
+      .def("disable_tracing", &ModuleManager::disable_tracing)
+      .def("is_tracing", &ModuleManager::is_tracing)
+      .def("write_trace",
+           [](const ModuleManager& self) {
+               std::stringstream ss;
+               self.write_trace(ss);
+               return ss.str();
+           })
       .def("__getitem__", [](ModuleManager& self, const type::key& key) {
           return self.at(key);
       });
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <pluginplay/any/any.hpp>
+#include <pluginplay/fields/module_input.hpp>
+#include <string>
+
+using namespace pluginplay::any;
+
+/* These benchmarks measure wrapping small values, which is what building the
+ * inputs of a module call mostly consists of. Small values are stored inline,
+ * so wrapping one costs a single allocation (the wrapper and its reference
+ * count).
+ */
+TEST_CASE("make_any_field (small values)") {
+    BENCHMARK("int") { return make_any_field<int>(42); };
+    BENCHMARK("double") { return make_any_field<double>(3.14); };
+    BENCHMARK("std::string") {
+        return make_any_field<std::string>(std::string("Hello"));
+    };
+
+    pluginplay::ModuleInput input;
+    input.set_type<int>();
+    int i = 0;
+    BENCHMARK("ModuleInput::change") { input.change(i++); };
+}
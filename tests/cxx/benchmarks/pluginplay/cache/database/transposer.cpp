@@ -0,0 +1,51 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <pluginplay/any/any.hpp>
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/database/transposer.hpp>
+#include <string>
+
+using namespace pluginplay::cache::database;
+
+/* This benchmark measures how the cost of looking up the UUID of a value
+ * scales with the number of values the Transposer knows about. This is the
+ * lookup every memoized call performs for each of its inputs, so it should not
+ * depend on the size of the cache.
+ */
+TEST_CASE("Transposer<AnyField, uuid>") {
+    using any_type        = pluginplay::any::AnyField;
+    using uuid_type       = std::string;
+    using wrapped_db_type = Native<uuid_type, any_type>;
+    using db_type         = Transposer<any_type, uuid_type>;
+
+    for(int n : {10, 100, 1000, 10000}) {
+        db_type db(std::make_unique<wrapped_db_type>());
+        for(int i = 0; i < n; ++i)
+            db.insert(pluginplay::any::make_any_field<int>(i),
+                      std::to_string(i));
+
+        auto hit          = pluginplay::any::make_any_field<int>(n / 2);
+        auto miss         = pluginplay::any::make_any_field<int>(n);
+        const auto suffix = " (n = " + std::to_string(n) + ")";
+
+        BENCHMARK("count hit" + suffix) { return db.count(hit); };
+        BENCHMARK("count miss" + suffix) { return db.count(miss); };
+        BENCHMARK("at" + suffix) { return db.at(hit).get(); };
+    }
+}
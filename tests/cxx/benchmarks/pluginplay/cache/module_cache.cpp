@@ -0,0 +1,79 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <pluginplay/cache/module_cache.hpp>
+#include <pluginplay/cache/module_manager_cache.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pluginplay::cache;
+
+/* This benchmark measures how concurrent cache hits scale with the number of
+ * threads. Each thread performs the same number of hits, so if hits do not
+ * serialize on each other the time per benchmark run should stay roughly flat
+ * as the number of threads grows (until we run out of cores).
+ *
+ * "shared" has every thread hit the same ModuleCache, "distinct" gives each
+ * thread its own ModuleCache (they still share the UUID database).
+ */
+TEST_CASE("ModuleCache thread scaling") {
+    using key_type    = ModuleCache::key_type;
+    using val_type    = ModuleCache::mapped_type;
+    using input_type  = key_type::mapped_type;
+    using result_type = val_type::mapped_type;
+
+    const std::size_t n_hits = 1000;
+
+    input_type input;
+    input.set_type<int>().change(int{1});
+    key_type inputs{{"Option 1", input}};
+
+    result_type result;
+    result.set_type<int>();
+    result.change(int{2});
+    val_type results{{"Result 1", result}};
+
+    const auto max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    ModuleManagerCache caches;
+    std::vector<ModuleManagerCache::module_cache_pointer> pcaches;
+    for(unsigned int t = 0; t < max_threads; ++t) {
+        pcaches.push_back(caches.get_or_make_module_cache(std::to_string(t)));
+        pcaches.back()->cache(inputs, results);
+    }
+
+    auto run = [&](unsigned int n_threads, bool shared) {
+        std::vector<std::thread> threads;
+        for(unsigned int t = 0; t < n_threads; ++t) {
+            auto& pcache = pcaches[shared ? 0 : t];
+            threads.emplace_back([&]() {
+                for(std::size_t i = 0; i < n_hits; ++i)
+                    pcache->try_get(inputs);
+            });
+        }
+        for(auto& thread : threads) thread.join();
+    };
+
+    for(unsigned int n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        const auto suffix = " (threads = " + std::to_string(n_threads) + ")";
+        BENCHMARK("shared" + suffix) { return run(n_threads, true); };
+        BENCHMARK("distinct" + suffix) { return run(n_threads, false); };
+    }
+}
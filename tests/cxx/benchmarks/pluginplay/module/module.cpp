@@ -0,0 +1,192 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <pluginplay/pluginplay.hpp>
+#include <vector>
+
+namespace {
+
+DECLARE_PROPERTY_TYPE(CheapPT);
+PROPERTY_TYPE_INPUTS(CheapPT) {
+    return pluginplay::declare_input().add_field<int>("Option 1");
+}
+PROPERTY_TYPE_RESULTS(CheapPT) {
+    return pluginplay::declare_result().add_field<int>("Result 1");
+}
+
+// A module which does essentially no work, so run time is all overhead
+DECLARE_MODULE(CheapModule);
+inline MODULE_CTOR(CheapModule) { satisfies_property_type<CheapPT>(); }
+inline MODULE_RUN(CheapModule) {
+    const auto& [i] = CheapPT::unwrap_inputs(inputs);
+    auto rv         = results();
+    return CheapPT::wrap_results(rv, i + 1);
+}
+
+// A module which does a fixed amount of busy work
+DECLARE_MODULE(SpinModule);
+inline MODULE_CTOR(SpinModule) { satisfies_property_type<CheapPT>(); }
+inline MODULE_RUN(SpinModule) {
+    const auto& [i] = CheapPT::unwrap_inputs(inputs);
+    volatile int x  = i;
+    for(int j = 0; j < 100000; ++j) x = x * 3 + 1;
+    auto rv = results();
+    return CheapPT::wrap_results(rv, int{x});
+}
+
+// Runs "Submodule 1" on 0, 1, ..., n - 1, one after the other
+DECLARE_MODULE(SerialFanOut);
+inline MODULE_CTOR(SerialFanOut) {
+    satisfies_property_type<CheapPT>();
+    add_submodule<CheapPT>("Submodule 1");
+}
+inline MODULE_RUN(SerialFanOut) {
+    const auto& [n] = CheapPT::unwrap_inputs(inputs);
+    int sum         = 0;
+    for(int i = 0; i < n; ++i)
+        sum += submods.at("Submodule 1").run_as<CheapPT>(i);
+    auto rv = results();
+    return CheapPT::wrap_results(rv, sum);
+}
+
+// Runs "Submodule 1" on 0, 1, ..., n - 1 asynchronously
+DECLARE_MODULE(AsyncFanOut);
+inline MODULE_CTOR(AsyncFanOut) {
+    satisfies_property_type<CheapPT>();
+    add_submodule<CheapPT>("Submodule 1");
+}
+inline MODULE_RUN(AsyncFanOut) {
+    const auto& [n] = CheapPT::unwrap_inputs(inputs);
+    std::vector<pluginplay::utility::TaskFuture<int>> futures;
+    for(int i = 0; i < n; ++i)
+        futures.push_back(submods.at("Submodule 1").run_as_async<CheapPT>(i));
+    int sum = 0;
+    for(auto& f : futures) sum += f.get();
+    auto rv = results();
+    return CheapPT::wrap_results(rv, sum);
+}
+
+DECLARE_PROPERTY_TYPE(BigInputPT);
+PROPERTY_TYPE_INPUTS(BigInputPT) {
+    return pluginplay::declare_input().add_field<std::vector<double>>(
+      "Big Input");
+}
+PROPERTY_TYPE_RESULTS(BigInputPT) {
+    return pluginplay::declare_result().add_field<double>("Result 1");
+}
+
+// A module whose input is expected to be large
+DECLARE_MODULE(BigInputModule);
+inline MODULE_CTOR(BigInputModule) { satisfies_property_type<BigInputPT>(); }
+inline MODULE_RUN(BigInputModule) {
+    const auto& [v] = BigInputPT::unwrap_inputs(inputs);
+    auto rv         = results();
+    return BigInputPT::wrap_results(rv, v.empty() ? 0.0 : v.front());
+}
+
+} // namespace
+
+/* These benchmarks measure the overhead of calling a module whose run_ member
+ * does essentially no work. "memoized hit" is dominated by looking the inputs
+ * up in the module's cache, "memoized miss" additionally pays for storing the
+ * result, and "not memoized" is the baseline cost of the call machinery.
+ *
+ * The "ModuleCache" benchmarks compare the two-probe pattern modules used to
+ * rely on (count, then uncache) to the single-probe find_or_compute.
+ */
+TEST_CASE("Module::run_as (cheap module)") {
+    pluginplay::ModuleManager mm;
+    mm.add_module<CheapModule>("cheap");
+    auto& mod = mm.at("cheap");
+    mod.run_as<CheapPT>(int{1});
+
+    BENCHMARK("memoized hit") { return mod.run_as<CheapPT>(int{1}); };
+
+    int i = 2;
+    BENCHMARK("memoized miss") { return mod.run_as<CheapPT>(i++); };
+
+    mm.add_module<CheapModule>("cheap (not memoized)");
+    auto& no_memo = mm.at("cheap (not memoized)");
+    no_memo.turn_off_memoization();
+    BENCHMARK("not memoized") { return no_memo.run_as<CheapPT>(int{1}); };
+}
+
+TEST_CASE("ModuleCache (cheap module)") {
+    using pluginplay::cache::ModuleCache;
+
+    pluginplay::cache::ModuleManagerCache caches;
+    auto pcache = caches.get_or_make_module_cache("cheap");
+
+    pluginplay::ModuleInput input;
+    input.set_type<int>().change(int{1});
+    ModuleCache::key_type inputs{{"Option 1", input}};
+
+    pluginplay::ModuleResult result;
+    result.set_type<int>().change(int{2});
+    ModuleCache::mapped_type results{{"Result 1", result}};
+    pcache->cache(inputs, results);
+
+    BENCHMARK("count + uncache") {
+        if(pcache->count(inputs)) return pcache->uncache(inputs);
+        return results;
+    };
+    BENCHMARK("try_get") { return pcache->try_get(inputs); };
+    BENCHMARK("find_or_compute") {
+        return pcache->find_or_compute(inputs, [&]() { return results; });
+    };
+}
+
+/* These benchmarks compare running independent submodules one after the other
+ * to running them asynchronously. Memoization is turned off so that every run
+ * does the work. On a node with at least n cores the asynchronous version
+ * should take roughly the time of a single submodule call.
+ */
+TEST_CASE("Submodule fan out (n = 8)") {
+    pluginplay::ModuleManager mm;
+    mm.add_module<SpinModule>("spin");
+    mm.at("spin").turn_off_memoization();
+    mm.add_module<SerialFanOut>("serial");
+    mm.add_module<AsyncFanOut>("async");
+    mm.change_submod("serial", "Submodule 1", "spin");
+    mm.change_submod("async", "Submodule 1", "spin");
+
+    auto& serial = mm.at("serial");
+    auto& async  = mm.at("async");
+    BENCHMARK("run_as") { return serial.run_as<CheapPT>(int{8}); };
+    BENCHMARK("run_as_async") { return async.run_as<CheapPT>(int{8}); };
+}
+
+/* These benchmarks measure copying a module with a large (8 MB) bound input.
+ * Copies share the bound value, so neither copy should scale with the size of
+ * the input. "copy and run" additionally merges the bound input into the
+ * inputs of a run.
+ */
+TEST_CASE("Module copy (large bound input)") {
+    pluginplay::ModuleManager mm;
+    mm.add_module<BigInputModule>("big");
+    auto& mod = mm.at("big");
+    mod.turn_off_memoization();
+    mod.change_input("Big Input", std::vector<double>(1 << 20, 1.0));
+
+    BENCHMARK("Module copy ctor") { return pluginplay::Module(mod); };
+    BENCHMARK("unlocked_copy") { return mod.unlocked_copy(); };
+    BENCHMARK("copy and run") {
+        auto copy = mod.unlocked_copy();
+        return copy.run();
+    };
+}
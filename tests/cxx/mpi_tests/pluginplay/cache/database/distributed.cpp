@@ -0,0 +1,111 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <mpi.h>
+#include <pluginplay/cache/database/distributed.hpp>
+#include <string>
+
+using namespace pluginplay::cache::database;
+
+/* Testing Strategy:
+ *
+ * These tests are part of the MPI test executable, which CTest also runs under
+ * mpiexec with several ranks. Every rank inserts keys, so with more than one
+ * rank most of the keys are owned by another rank and the tests exercise the
+ * forwarding.
+ *
+ * N.B. Distributed instances are collective, so every rank must run the same
+ *      sections in the same order.
+ */
+
+namespace {
+
+bool has_thread_multiple() {
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    return provided == MPI_THREAD_MULTIPLE;
+}
+
+} // namespace
+
+TEST_CASE("Distributed", "[mpi]") {
+    using db_type = Distributed;
+
+    parallelzone::runtime::RuntimeView rt;
+    auto comm = rt.mpi_comm();
+
+    int n_ranks = 1;
+    MPI_Comm_size(comm, &n_ranks);
+
+    if(n_ranks > 1 && !has_thread_multiple()) {
+        REQUIRE_THROWS_AS(db_type(rt), std::runtime_error);
+        return;
+    }
+
+    db_type db(rt);
+    const auto rank = std::to_string(db.rank());
+
+    SECTION("rank/size") {
+        REQUIRE(db.size() == static_cast<std::size_t>(n_ranks));
+        REQUIRE(db.rank() < db.size());
+    }
+
+    SECTION("owner") {
+        std::string key("Hello World");
+        REQUIRE(db.owner(key) < db.size());
+        REQUIRE(db.owner(key) == db.owner(key));
+    }
+
+    SECTION("insert/count/at") {
+        for(int i = 0; i < 10; ++i) {
+            auto key = "rank-" + rank + "-" + std::to_string(i);
+            db.insert(key, "value " + std::to_string(i));
+        }
+        MPI_Barrier(comm);
+
+        // Every rank sees the keys of every rank
+        for(int r = 0; r < n_ranks; ++r) {
+            for(int i = 0; i < 10; ++i) {
+                auto r_str = std::to_string(r);
+                auto key   = "rank-" + r_str + "-" + std::to_string(i);
+                REQUIRE(db.count(key));
+                REQUIRE(db.at(key).get() == "value " + std::to_string(i));
+                REQUIRE(db.try_at(key).get() == "value " + std::to_string(i));
+            }
+        }
+        REQUIRE_FALSE(db.count("not a key"));
+        MPI_Barrier(comm);
+    }
+
+    SECTION("at throws for missing key") {
+        REQUIRE_THROWS_AS(db.at("not a key"), std::out_of_range);
+        REQUIRE_FALSE(db.try_at("not a key").has_value());
+    }
+
+    SECTION("free") {
+        auto key = "rank-" + rank;
+        db.insert(key, "value");
+        REQUIRE(db.count(key));
+        db.free(key);
+        REQUIRE_FALSE(db.count(key));
+
+        // No-op if key DNE
+        db.free(key);
+        REQUIRE_FALSE(db.count(key));
+        MPI_Barrier(comm);
+    }
+}
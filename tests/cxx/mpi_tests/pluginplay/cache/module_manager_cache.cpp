@@ -0,0 +1,84 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <mpi.h>
+#include <pluginplay/cache/module_cache.hpp>
+#include <pluginplay/cache/module_manager_cache.hpp>
+#include <stdexcept>
+using namespace pluginplay::cache;
+
+namespace {
+
+using key_type    = ModuleCache::key_type;
+using val_type    = ModuleCache::mapped_type;
+using result_type = val_type::mapped_type;
+
+// The inputs {"i" : i}
+key_type make_inputs(int i) {
+    key_type::mapped_type input;
+    input.set_type<int>().change(i);
+    return key_type{{"i", input}};
+}
+
+// The results {"i + 1" : i + 1}
+val_type make_results(int i) {
+    result_type result;
+    result.set_type<int>();
+    result.change(i + 1);
+    return val_type{{"i + 1", result}};
+}
+
+} // namespace
+
+TEST_CASE("ModuleManagerCache : set_distributed", "[mpi]") {
+    parallelzone::runtime::RuntimeView rt;
+    int n_ranks = 1, rank = 0, provided = MPI_THREAD_SINGLE;
+    MPI_Comm_size(rt.mpi_comm(), &n_ranks);
+    MPI_Comm_rank(rt.mpi_comm(), &rank);
+    MPI_Query_thread(&provided);
+
+    ModuleManagerCache cache;
+    if(n_ranks > 1 && provided != MPI_THREAD_MULTIPLE) {
+        REQUIRE_THROWS_AS(cache.set_distributed(rt), std::runtime_error);
+        return;
+    }
+
+    cache.set_distributed(rt);
+    auto pcache = cache.get_or_make_module_cache("hello");
+
+    // N.B. CHECK, not REQUIRE, so a failing rank still reaches the barriers
+    //      (and the collective dtors) instead of hanging the others
+
+    // Only rank 0 computes the result...
+    if(rank == 0) {
+        auto compute = []() { return make_results(1); };
+        CHECK(pcache->find_or_compute(make_inputs(1), compute) ==
+              make_results(1));
+    }
+    MPI_Barrier(rt.mpi_comm());
+
+    // ...and every rank gets it from the cache
+    auto fxn = []() -> val_type {
+        throw std::runtime_error("Should have been a hit");
+    };
+    val_type results;
+    try {
+        results = pcache->find_or_compute(make_inputs(1), fxn);
+    } catch(const std::runtime_error&) {}
+    CHECK(results == make_results(1));
+    MPI_Barrier(rt.mpi_comm());
+}
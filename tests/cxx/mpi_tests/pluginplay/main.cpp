@@ -0,0 +1,36 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch_session.hpp>
+#include <mpi.h>
+#include <parallelzone/runtime/runtime_view.hpp>
+
+int main(int argc, char* argv[]) {
+    // The distributed cache serves requests from a separate thread
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+
+    int res;
+    {
+        auto rt = parallelzone::runtime::RuntimeView(argc, argv);
+
+        res = Catch::Session().run(argc, argv);
+    }
+
+    MPI_Finalize();
+    return res;
+}
@@ -257,6 +257,28 @@ TEMPLATE_LIST_TEST_CASE("AnyField", "", testing::types2test) {
         REQUIRE_FALSE(by_value.are_equal(diff));
     }
 
+    SECTION("hash") {
+        // Two default AnyFields
+        REQUIRE(defaulted.hash() == AnyField{}.hash());
+
+        // AnyFields with same values
+        REQUIRE(by_value.hash() == make_any_field<type>(value).hash());
+
+        // AnyFields that hold the value differently
+        REQUIRE(by_value.hash() == by_cval.hash());
+        REQUIRE(by_value.hash() == by_cref.hash());
+
+        // std::hash just calls hash
+        REQUIRE(std::hash<AnyField>{}(by_value) == by_value.hash());
+    }
+
+    SECTION("memory_footprint") {
+        REQUIRE(defaulted.memory_footprint() == 0);
+        REQUIRE(by_value.memory_footprint() == memory_footprint(value));
+        REQUIRE(by_cval.memory_footprint() == memory_footprint(value));
+        REQUIRE(by_cref.memory_footprint() == 0);
+    }
+
     SECTION("print") {
         std::stringstream ss;
 
@@ -293,6 +315,46 @@ TEMPLATE_LIST_TEST_CASE("AnyField", "", testing::types2test) {
         REQUIRE(by_cval.owns_value());
         REQUIRE_FALSE(by_cref.owns_value());
     }
+
+    SECTION("shares_value") {
+        REQUIRE_FALSE(defaulted.shares_value(AnyField(defaulted)));
+        REQUIRE_FALSE(by_value.shares_value(default_val));
+
+        // Copies of owned values share them
+        AnyField val_copy(by_value);
+        REQUIRE(val_copy.shares_value(by_value));
+        REQUIRE(&any_cast<const type&>(val_copy) ==
+                &any_cast<const type&>(by_value));
+
+        AnyField val_assigned;
+        val_assigned = by_value;
+        REQUIRE(val_assigned.shares_value(by_value));
+
+        // Copies of aliased values do not
+        AnyField cref_copy(by_cref);
+        REQUIRE_FALSE(cref_copy.shares_value(by_cref));
+
+        SECTION("Read/write reference unshares") {
+            auto& rw_value = any_cast<type&>(val_copy);
+            REQUIRE_FALSE(val_copy.shares_value(by_value));
+            REQUIRE(&rw_value != &any_cast<const type&>(by_value));
+            REQUIRE(rw_value == value);
+
+            rw_value = type{};
+            REQUIRE(any_cast<const type&>(by_value) == value);
+
+            // rw_value may still be used, so copies are deep again
+            AnyField copy_of_copy(val_copy);
+            REQUIRE_FALSE(copy_of_copy.shares_value(val_copy));
+        }
+
+        SECTION("Read-only access keeps sharing") {
+            const auto& cval_copy = val_copy;
+            any_cast<const type&>(cval_copy);
+            any_cast<type>(val_copy);
+            REQUIRE(val_copy.shares_value(by_value));
+        }
+    }
 }
 
 namespace {
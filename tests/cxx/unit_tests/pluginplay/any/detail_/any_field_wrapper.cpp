@@ -141,6 +141,28 @@ TEMPLATE_LIST_TEST_CASE("AnyFieldWrapper", "", testing::types2test) {
         REQUIRE_FALSE(const_val.value_equal(diff));
     }
 
+    SECTION("hash") {
+        // Consistent with value_equal
+        REQUIRE(defaulted.hash() == wrapper_type(default_value).hash());
+        REQUIRE(has_value.hash() == wrapper_type(value).hash());
+        REQUIRE(has_value.hash() == const_val.hash());
+        REQUIRE(has_value.hash() == const_ref.hash());
+
+        // All of the types in types2test can be hashed
+        REQUIRE(has_value.hash() == pluginplay::any::Hasher<type>{}(value));
+        REQUIRE(has_value.hash() != defaulted.hash());
+    }
+
+    SECTION("memory_footprint") {
+        using pluginplay::any::memory_footprint;
+        REQUIRE(has_value.memory_footprint() == memory_footprint(value));
+        REQUIRE(const_val.memory_footprint() == memory_footprint(value));
+        REQUIRE(has_value.memory_footprint() >= sizeof(type));
+
+        // Not owned, so not counted
+        REQUIRE(const_ref.memory_footprint() == 0);
+    }
+
     SECTION("type") {
         REQUIRE(defaulted.type() == rtti);
         REQUIRE(has_value.type() == rtti);
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_any.hpp"
+#include "pluginplay/any/detail_/small_any.hpp"
+#include <array>
+#include <functional>
+#include <map>
+
+using namespace pluginplay::any::detail_;
+
+namespace {
+
+// Too big to be stored inline
+using big_type = std::array<double, 16>;
+
+} // namespace
+
+TEST_CASE("SmallAny : stored_inline_v") {
+    STATIC_REQUIRE(SmallAny::stored_inline_v<int>);
+    STATIC_REQUIRE(SmallAny::stored_inline_v<double>);
+    STATIC_REQUIRE(SmallAny::stored_inline_v<std::vector<double>>);
+    STATIC_REQUIRE(SmallAny::stored_inline_v<std::reference_wrapper<int>>);
+    STATIC_REQUIRE_FALSE(SmallAny::stored_inline_v<big_type>);
+}
+
+TEMPLATE_LIST_TEST_CASE("SmallAny", "", testing::types2test) {
+    using type     = TestType;
+    using map_type = std::map<int, double>; // Type we know it won't contain
+
+    auto value = testing::non_default_value<type>();
+
+    SmallAny defaulted;
+    SmallAny has_value(value);
+    SmallAny big(big_type{1.0});
+
+    SECTION("Ctors") {
+        SECTION("Default") {
+            REQUIRE_FALSE(defaulted.has_value());
+            REQUIRE_FALSE(defaulted.stored_inline());
+            REQUIRE(defaulted.type() == typeid(void));
+        }
+
+        SECTION("Value") {
+            REQUIRE(has_value.has_value());
+            REQUIRE(has_value.type() == typeid(type));
+            REQUIRE(has_value.stored_inline() ==
+                    SmallAny::stored_inline_v<type>);
+            REQUIRE(small_any_cast<const type&>(has_value) == value);
+
+            REQUIRE(big.has_value());
+            REQUIRE_FALSE(big.stored_inline());
+            REQUIRE(small_any_cast<const big_type&>(big)[0] == 1.0);
+        }
+
+        SECTION("Copy") {
+            SmallAny copy(has_value);
+            REQUIRE(small_any_cast<const type&>(copy) == value);
+            REQUIRE(small_any_cast<type>(&copy) !=
+                    small_any_cast<type>(&has_value));
+
+            SmallAny big_copy(big);
+            REQUIRE(small_any_cast<const big_type&>(big_copy)[0] == 1.0);
+
+            SmallAny default_copy(defaulted);
+            REQUIRE_FALSE(default_copy.has_value());
+        }
+
+        SECTION("Move") {
+            SmallAny moved(std::move(has_value));
+            REQUIRE(small_any_cast<const type&>(moved) == value);
+            REQUIRE_FALSE(has_value.has_value());
+
+            const auto* pbig = small_any_cast<big_type>(&big);
+            SmallAny big_moved(std::move(big));
+            REQUIRE(small_any_cast<big_type>(&big_moved) == pbig);
+        }
+
+        SECTION("Copy assignment") {
+            SmallAny copy(big);
+            auto p = &(copy = has_value);
+            REQUIRE(p == &copy);
+            REQUIRE(small_any_cast<const type&>(copy) == value);
+        }
+
+        SECTION("Move assignment") {
+            SmallAny moved(big);
+            auto p = &(moved = std::move(has_value));
+            REQUIRE(p == &moved);
+            REQUIRE(small_any_cast<const type&>(moved) == value);
+            REQUIRE_FALSE(has_value.has_value());
+        }
+    }
+
+    SECTION("swap") {
+        has_value.swap(big);
+        REQUIRE(small_any_cast<const type&>(big) == value);
+        REQUIRE(small_any_cast<const big_type&>(has_value)[0] == 1.0);
+    }
+
+    SECTION("reset") {
+        has_value.reset();
+        REQUIRE_FALSE(has_value.has_value());
+        big.reset();
+        REQUIRE_FALSE(big.has_value());
+    }
+
+    SECTION("small_any_cast") {
+        REQUIRE(small_any_cast<type>(has_value) == value);
+        REQUIRE(small_any_cast<const type>(has_value) == value);
+        REQUIRE(small_any_cast<const type&>(std::as_const(has_value)) == value);
+        REQUIRE_THROWS_AS(small_any_cast<map_type>(has_value), std::bad_cast);
+        REQUIRE_THROWS_AS(small_any_cast<type>(defaulted), std::bad_cast);
+
+        REQUIRE(small_any_cast<map_type>(&has_value) == nullptr);
+        REQUIRE(small_any_cast<type>(&defaulted) == nullptr);
+        REQUIRE(small_any_cast<type>(static_cast<SmallAny*>(nullptr)) ==
+                nullptr);
+
+        // Modifying through a reference modifies the held value
+        small_any_cast<type&>(has_value) = type{};
+        REQUIRE(small_any_cast<const type&>(has_value) == type{});
+    }
+}
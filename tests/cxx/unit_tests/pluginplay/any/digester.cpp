@@ -0,0 +1,136 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_any.hpp"
+#include <map>
+#include <pluginplay/any/any.hpp>
+#include <pluginplay/any/digester.hpp>
+
+using namespace pluginplay::any;
+
+namespace {
+
+// Not digestible out of the box
+struct NotDigestible {
+    int value = 0;
+    bool operator==(const NotDigestible& rhs) const {
+        return value == rhs.value;
+    }
+    bool operator<(const NotDigestible& rhs) const {
+        return value < rhs.value;
+    }
+};
+
+// Will have a user-provided Digester specialization
+struct UserDigestible {
+    int value = 0;
+    bool operator==(const UserDigestible& rhs) const {
+        return value == rhs.value;
+    }
+    bool operator<(const UserDigestible& rhs) const {
+        return value < rhs.value;
+    }
+};
+
+// Digests @p value with Digester<T>
+template<typename T>
+digest_buffer digest(const T& value) {
+    digest_buffer buffer;
+    Digester<T>{}(value, buffer);
+    return buffer;
+}
+
+} // namespace
+
+template<>
+struct pluginplay::any::Digester<UserDigestible> {
+    void operator()(const UserDigestible& v, digest_buffer& buffer) const {
+        Digester<int>{}(v.value, buffer);
+    }
+};
+
+TEST_CASE("Digester") {
+    SECTION("is_digestible_v") {
+        STATIC_REQUIRE(is_digestible_v<int>);
+        STATIC_REQUIRE(is_digestible_v<std::string>);
+        STATIC_REQUIRE(is_digestible_v<std::vector<double>>);
+        STATIC_REQUIRE(is_digestible_v<std::vector<std::vector<int>>>);
+        STATIC_REQUIRE(is_digestible_v<std::pair<int, std::string>>);
+        STATIC_REQUIRE(is_digestible_v<std::map<std::string, double>>);
+        STATIC_REQUIRE(is_digestible_v<UserDigestible>);
+        STATIC_REQUIRE_FALSE(is_digestible_v<NotDigestible>);
+        STATIC_REQUIRE_FALSE(is_digestible_v<std::vector<NotDigestible>>);
+        STATIC_REQUIRE_FALSE(is_digestible_v<std::pair<int, NotDigestible>>);
+    }
+
+    SECTION("Arithmetic types") {
+        REQUIRE(digest(int{42}).size() == sizeof(int));
+        REQUIRE(digest(int{42}) == digest(int{42}));
+        REQUIRE(digest(int{42}) != digest(int{43}));
+    }
+
+    SECTION("Containers") {
+        using vector_type = std::vector<double>;
+        vector_type v{1.2, 2.3, 3.4};
+        REQUIRE(digest(v) == digest(vector_type{1.2, 2.3, 3.4}));
+        REQUIRE(digest(v) != digest(vector_type{}));
+        REQUIRE(digest(v) != digest(vector_type{3.4, 2.3, 1.2}));
+
+        // The sizes are part of the digest
+        using nested_type = std::vector<std::vector<int>>;
+        REQUIRE(digest(nested_type{{1, 2}, {3}}) !=
+                digest(nested_type{{1}, {2, 3}}));
+
+        REQUIRE(digest(std::string{"ab"}) != digest(std::string{"ba"}));
+    }
+
+    SECTION("Maps") {
+        using map_type = std::map<std::string, int>;
+        map_type m{{"a", 1}, {"b", 2}};
+        REQUIRE(digest(m) == digest(map_type{{"b", 2}, {"a", 1}}));
+        REQUIRE(digest(m) != digest(map_type{{"a", 1}, {"b", 3}}));
+    }
+
+    SECTION("User specialization") {
+        REQUIRE(digest(UserDigestible{3}) == digest(int{3}));
+    }
+
+    SECTION("Used by AnyField") {
+        digest_buffer a_buffer;
+        auto a = make_any_field<UserDigestible>(UserDigestible{3});
+        REQUIRE(a.digest(a_buffer));
+        REQUIRE_FALSE(a_buffer.empty());
+
+        // Doesn't depend on how the value is held, but does on its type
+        digest_buffer cref_buffer;
+        UserDigestible value{3};
+        auto cref = make_any_field<const UserDigestible&>(value);
+        REQUIRE(cref.digest(cref_buffer));
+        REQUIRE(cref_buffer == a_buffer);
+
+        digest_buffer int_buffer;
+        REQUIRE(make_any_field<int>(3).digest(int_buffer));
+        REQUIRE(int_buffer != a_buffer);
+
+        // Types which can't be digested leave the buffer alone
+        digest_buffer b_buffer;
+        auto b = make_any_field<NotDigestible>(NotDigestible{1});
+        REQUIRE_FALSE(b.digest(b_buffer));
+        REQUIRE(b_buffer.empty());
+
+        REQUIRE_FALSE(AnyField{}.digest(b_buffer));
+    }
+}
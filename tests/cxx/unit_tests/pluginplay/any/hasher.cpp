@@ -0,0 +1,128 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_any.hpp"
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <pluginplay/any/any.hpp>
+#include <pluginplay/any/hasher.hpp>
+
+using namespace pluginplay::any;
+
+namespace {
+
+// Not hashable out of the box
+struct NotHashable {
+    int value = 0;
+    bool operator==(const NotHashable& rhs) const { return value == rhs.value; }
+    bool operator<(const NotHashable& rhs) const { return value < rhs.value; }
+};
+
+// Will have a user-provided Hasher specialization
+struct UserHashable {
+    int value = 0;
+    bool operator==(const UserHashable& rhs) const {
+        return value == rhs.value;
+    }
+    bool operator<(const UserHashable& rhs) const { return value < rhs.value; }
+};
+
+} // namespace
+
+template<>
+struct pluginplay::any::Hasher<UserHashable> {
+    std::size_t operator()(const UserHashable& v) const noexcept {
+        return v.value;
+    }
+};
+
+TEST_CASE("Hasher") {
+    SECTION("is_hashable_v") {
+        STATIC_REQUIRE(is_hashable_v<int>);
+        STATIC_REQUIRE(is_hashable_v<std::string>);
+        STATIC_REQUIRE(is_hashable_v<std::vector<double>>);
+        STATIC_REQUIRE(is_hashable_v<std::vector<std::vector<int>>>);
+        STATIC_REQUIRE(is_hashable_v<std::pair<int, std::string>>);
+        STATIC_REQUIRE(is_hashable_v<std::map<std::string, double>>);
+        STATIC_REQUIRE(is_hashable_v<std::unordered_set<int>>);
+        STATIC_REQUIRE(is_hashable_v<UserHashable>);
+        STATIC_REQUIRE_FALSE(is_hashable_v<NotHashable>);
+        STATIC_REQUIRE_FALSE(is_hashable_v<std::vector<NotHashable>>);
+        STATIC_REQUIRE_FALSE(is_hashable_v<std::pair<int, NotHashable>>);
+    }
+
+    SECTION("std::hash-able types") {
+        REQUIRE(Hasher<int>{}(42) == std::hash<int>{}(42));
+        std::string s{"Hello World"};
+        REQUIRE(Hasher<std::string>{}(s) == std::hash<std::string>{}(s));
+    }
+
+    SECTION("Containers") {
+        using vector_type = std::vector<double>;
+        Hasher<vector_type> h;
+        vector_type v{1.2, 2.3, 3.4};
+        REQUIRE(h(v) == h(vector_type{1.2, 2.3, 3.4}));
+        REQUIRE(h(v) != h(vector_type{}));
+        REQUIRE(h(v) != h(vector_type{3.4, 2.3, 1.2}));
+    }
+
+    SECTION("Maps") {
+        using map_type = std::map<std::string, int>;
+        Hasher<map_type> h;
+        map_type m{{"a", 1}, {"b", 2}};
+        REQUIRE(h(m) == h(map_type{{"b", 2}, {"a", 1}}));
+        REQUIRE(h(m) != h(map_type{{"a", 1}, {"b", 3}}));
+    }
+
+    SECTION("Unordered containers") {
+        using set_type = std::unordered_set<int>;
+        Hasher<set_type> h;
+        set_type s0{1, 2, 3};
+
+        // Same elements, but (likely) a different iteration order
+        set_type s1(100);
+        for(int i = 3; i > 0; --i) s1.insert(i);
+        REQUIRE(s0 == s1);
+        REQUIRE(h(s0) == h(s1));
+        REQUIRE(h(s0) != h(set_type{1, 2, 4}));
+
+        using map_type = std::unordered_map<std::string, int>;
+        Hasher<map_type> hm;
+        map_type m0{{"a", 1}, {"b", 2}, {"c", 3}};
+        map_type m1(100);
+        m1.emplace("c", 3);
+        m1.emplace("b", 2);
+        m1.emplace("a", 1);
+        REQUIRE(m0 == m1);
+        REQUIRE(hm(m0) == hm(m1));
+        REQUIRE(hm(m0) != hm(map_type{{"a", 1}, {"b", 3}, {"c", 3}}));
+    }
+
+    SECTION("User specialization") {
+        REQUIRE(Hasher<UserHashable>{}(UserHashable{3}) == 3);
+    }
+
+    SECTION("Used by AnyField") {
+        auto a = make_any_field<UserHashable>(UserHashable{3});
+        REQUIRE(a.hash() == 3);
+
+        // Unhashable types fall back to their RTTI
+        auto b = make_any_field<NotHashable>(NotHashable{1});
+        auto c = make_any_field<NotHashable>(NotHashable{2});
+        REQUIRE(b.hash() == c.hash());
+    }
+}
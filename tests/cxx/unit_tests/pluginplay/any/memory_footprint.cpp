@@ -0,0 +1,122 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_any.hpp"
+#include <array>
+#include <list>
+#include <map>
+#include <pluginplay/any/any.hpp>
+#include <pluginplay/any/memory_footprint.hpp>
+
+using namespace pluginplay::any;
+
+namespace {
+
+// Owns a buffer the defaults can't see
+struct UserSized {
+    std::size_t n = 0;
+    bool operator==(const UserSized& rhs) const { return n == rhs.n; }
+};
+
+} // namespace
+
+template<>
+struct pluginplay::any::MemoryFootprint<UserSized> {
+    std::size_t operator()(const UserSized& v) const noexcept {
+        return sizeof(UserSized) + v.n;
+    }
+};
+
+TEST_CASE("MemoryFootprint") {
+    SECTION("Default") {
+        REQUIRE(memory_footprint(42) == sizeof(int));
+        REQUIRE(memory_footprint(3.14) == sizeof(double));
+    }
+
+    SECTION("Contiguous containers") {
+        std::vector<double> v{1.2, 2.3, 3.4};
+        const auto corr = sizeof(v) + v.capacity() * sizeof(double);
+        REQUIRE(memory_footprint(v) == corr);
+
+        std::vector<double> empty;
+        REQUIRE(memory_footprint(empty) == sizeof(empty));
+    }
+
+    SECTION("Strings") {
+        std::string s(100, 'a');
+        REQUIRE(memory_footprint(s) == sizeof(s) + s.capacity());
+
+        // Short strings may live inside the std::string object
+        std::string empty;
+        REQUIRE(memory_footprint(empty) <= sizeof(empty) + empty.capacity());
+    }
+
+    SECTION("Nested containers") {
+        std::vector<std::string> v{std::string(100, 'a'), std::string()};
+        auto corr = sizeof(v) + v.capacity() * sizeof(std::string);
+        for(const auto& s : v) corr += memory_footprint(s) - sizeof(s);
+        REQUIRE(memory_footprint(v) == corr);
+    }
+
+    SECTION("std::array") {
+        std::array<int, 3> a{1, 2, 3};
+        REQUIRE(memory_footprint(a) == sizeof(a));
+
+        std::array<std::string, 2> s{std::string(100, 'a'), std::string()};
+        const auto owned = memory_footprint(s[0]) - sizeof(std::string);
+        REQUIRE(memory_footprint(s) == sizeof(s) + owned);
+    }
+
+    SECTION("Node-based containers") {
+        std::list<int> l{1, 2, 3};
+        REQUIRE(memory_footprint(l) == sizeof(l) + 3 * sizeof(int));
+
+        using map_type   = std::map<int, std::string>;
+        using value_type = typename map_type::value_type;
+        map_type m{{1, std::string(100, 'a')}, {2, std::string()}};
+        auto corr = sizeof(m);
+        for(const auto& x : m) corr += memory_footprint(x);
+        REQUIRE(memory_footprint(m) == corr);
+        REQUIRE(corr >= sizeof(m) + 2 * sizeof(value_type) + 100);
+    }
+
+    SECTION("Pairs") {
+        std::pair<int, std::string> p{1, std::string(100, 'a')};
+        const auto owned = memory_footprint(p.second) - sizeof(std::string);
+        REQUIRE(memory_footprint(p) == sizeof(p) + owned);
+    }
+
+    SECTION("User specialization") {
+        REQUIRE(memory_footprint(UserSized{10}) == sizeof(UserSized) + 10);
+
+        std::vector<UserSized> v{UserSized{10}, UserSized{20}};
+        const auto corr = sizeof(v) + v.capacity() * sizeof(UserSized) + 30;
+        REQUIRE(memory_footprint(v) == corr);
+    }
+
+    SECTION("Used by AnyField") {
+        REQUIRE(make_any_field<UserSized>(UserSized{10}).memory_footprint() ==
+                sizeof(UserSized) + 10);
+
+        std::vector<double> v(10, 1.0);
+        REQUIRE(make_any_field<std::vector<double>>(v).memory_footprint() ==
+                memory_footprint(v));
+
+        // Values held by const reference are not owned
+        REQUIRE(make_any_field<const std::vector<double>&>(v)
+                  .memory_footprint() == 0);
+    }
+}
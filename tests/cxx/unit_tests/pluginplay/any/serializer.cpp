@@ -0,0 +1,168 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_any.hpp"
+#include <map>
+#include <parallelzone/serialization.hpp>
+#include <pluginplay/any/any.hpp>
+#include <pluginplay/any/serializer.hpp>
+#include <set>
+#include <sstream>
+
+using namespace pluginplay::any;
+
+namespace {
+
+// Not serializable out of the box
+struct NotSerializable {
+    int value = 0;
+    bool operator==(const NotSerializable& rhs) const {
+        return value == rhs.value;
+    }
+    bool operator<(const NotSerializable& rhs) const {
+        return value < rhs.value;
+    }
+};
+
+// Will have a user-provided Serializer specialization
+struct UserSerializable {
+    int value = 0;
+    bool operator==(const UserSerializable& rhs) const {
+        return value == rhs.value;
+    }
+    bool operator<(const UserSerializable& rhs) const {
+        return value < rhs.value;
+    }
+};
+
+// Saves @p value with Serializer<T> and loads it back
+template<typename T>
+T round_trip(const T& value) {
+    serial_buffer buffer;
+    Serializer<T>{}.save(value, buffer);
+    serial_view bytes(buffer);
+    auto rv = Serializer<T>{}.load(bytes);
+    REQUIRE(bytes.empty());
+    return rv;
+}
+
+// Saves @p value to a cereal archive and loads it back
+AnyField archive_round_trip(const AnyField& value) {
+    std::stringstream ss;
+    {
+        cereal::BinaryOutputArchive ar(ss);
+        ar << value;
+    }
+    cereal::BinaryInputArchive ar(ss);
+    AnyField rv;
+    ar >> rv;
+    return rv;
+}
+
+} // namespace
+
+template<>
+struct pluginplay::any::Serializer<UserSerializable> {
+    void save(const UserSerializable& v, serial_buffer& buffer) const {
+        Serializer<int>{}.save(v.value, buffer);
+    }
+    UserSerializable load(serial_view& bytes) const {
+        return UserSerializable{Serializer<int>{}.load(bytes)};
+    }
+};
+
+TEST_CASE("Serializer") {
+    SECTION("is_serializable_v") {
+        STATIC_REQUIRE(is_serializable_v<int>);
+        STATIC_REQUIRE(is_serializable_v<std::string>);
+        STATIC_REQUIRE(is_serializable_v<std::vector<double>>);
+        STATIC_REQUIRE(is_serializable_v<std::vector<std::vector<int>>>);
+        STATIC_REQUIRE(is_serializable_v<std::pair<int, std::string>>);
+        STATIC_REQUIRE(is_serializable_v<std::map<std::string, double>>);
+        STATIC_REQUIRE(is_serializable_v<std::set<int>>);
+        STATIC_REQUIRE(is_serializable_v<UserSerializable>);
+        STATIC_REQUIRE_FALSE(is_serializable_v<NotSerializable>);
+        STATIC_REQUIRE_FALSE(is_serializable_v<std::vector<NotSerializable>>);
+        using pair_type = std::pair<int, NotSerializable>;
+        STATIC_REQUIRE_FALSE(is_serializable_v<pair_type>);
+    }
+
+    SECTION("Arithmetic types") {
+        REQUIRE(round_trip(int{42}) == 42);
+        REQUIRE(round_trip(double{3.14}) == 3.14);
+        REQUIRE(round_trip(true));
+    }
+
+    SECTION("Containers") {
+        using vector_type = std::vector<double>;
+        vector_type v{1.2, 2.3, 3.4};
+        REQUIRE(round_trip(v) == v);
+        REQUIRE(round_trip(vector_type{}).empty());
+
+        using nested_type = std::vector<std::vector<int>>;
+        nested_type nested{{1, 2}, {3}};
+        REQUIRE(round_trip(nested) == nested);
+
+        REQUIRE(round_trip(std::string{"hello"}) == "hello");
+        REQUIRE(round_trip(std::vector<bool>{true, false}) ==
+                std::vector<bool>{true, false});
+        REQUIRE(round_trip(std::set<int>{3, 1, 2}) == std::set<int>{1, 2, 3});
+    }
+
+    SECTION("Maps") {
+        using map_type = std::map<std::string, int>;
+        map_type m{{"a", 1}, {"b", 2}};
+        REQUIRE(round_trip(m) == m);
+    }
+
+    SECTION("User specialization") {
+        REQUIRE(round_trip(UserSerializable{3}) == UserSerializable{3});
+    }
+
+    SECTION("Not enough bytes") {
+        serial_buffer buffer;
+        Serializer<std::vector<int>>{}.save(std::vector<int>{1, 2}, buffer);
+        buffer.pop_back();
+        serial_view bytes(buffer);
+        using e = std::runtime_error;
+        REQUIRE_THROWS_AS(Serializer<std::vector<int>>{}.load(bytes), e);
+    }
+
+    SECTION("Used by AnyField") {
+        auto a = make_any_field<UserSerializable>(UserSerializable{3});
+        REQUIRE(a.is_serializable());
+        auto a_copy = archive_round_trip(a);
+        REQUIRE(a_copy == a);
+        REQUIRE(a_copy.owns_value());
+
+        // Values held by const reference come back owning their value
+        std::vector<double> v{1.2, 2.3};
+        auto cref      = make_any_field<const std::vector<double>&>(v);
+        auto cref_copy = archive_round_trip(cref);
+        REQUIRE(cref_copy == cref);
+        REQUIRE(cref_copy.owns_value());
+        REQUIRE(cref_copy.type() == cref.type());
+
+        // Empty AnyFields can be saved too
+        REQUIRE_FALSE(AnyField{}.is_serializable());
+        REQUIRE_FALSE(archive_round_trip(AnyField{}).has_value());
+
+        // Types which can't be serialized can't be saved
+        auto b = make_any_field<NotSerializable>(NotSerializable{1});
+        REQUIRE_FALSE(b.is_serializable());
+        REQUIRE_THROWS_AS(archive_round_trip(b), std::runtime_error);
+    }
+}
@@ -0,0 +1,315 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../test_cache.hpp"
+#include <pluginplay/cache/database/bounded.hpp>
+#include <pluginplay/cache/database/native.hpp>
+
+using namespace pluginplay::cache;
+using namespace pluginplay::cache::database;
+
+/* Testing Strategy:
+ *
+ * Bounded is Native plus eviction, so we test the DatabaseAPI the same way as
+ * for Native and then focus on when entries are evicted and where they go. For
+ * simplicity, the size of an entry is the length of its value.
+ */
+
+TEST_CASE("Bounded") {
+    using db_type      = Bounded<int, std::string>;
+    using native_type  = Native<int, std::string>;
+    using key_set_type = typename db_type::key_set_type;
+
+    auto size   = [](const std::string& s) { return s.size(); };
+    auto budget = std::make_shared<MemoryBudget>();
+
+    auto spill   = std::make_unique<native_type>();
+    auto pspill  = spill.get();
+    auto backup  = std::make_unique<native_type>();
+    auto pbackup = backup.get();
+
+    db_type dropping(budget, size);
+    db_type spilling(budget, size, std::move(spill), std::move(backup));
+
+    SECTION("CTor") {
+        using e = std::runtime_error;
+        REQUIRE_THROWS_AS(db_type(nullptr, size), e);
+        REQUIRE_THROWS_AS(db_type(budget, nullptr), e);
+    }
+
+    SECTION("insert/count/at/try_at/size") {
+        dropping.insert(1, "one");
+        REQUIRE(dropping.count(1));
+        REQUIRE_FALSE(dropping.count(2));
+        REQUIRE(dropping.at(1).get() == "one");
+        REQUIRE(dropping.try_at(1).get() == "one");
+        REQUIRE_FALSE(dropping.try_at(2).has_value());
+        REQUIRE(dropping.size() == 3);
+        REQUIRE(dropping.memory_footprint() == 3);
+        REQUIRE(budget->used() == 3);
+
+        // Overwriting updates the size
+        dropping.insert(1, "three");
+        REQUIRE(dropping.at(1).get() == "three");
+        REQUIRE(dropping.size() == 5);
+        REQUIRE(budget->used() == 5);
+    }
+
+    SECTION("free") {
+        dropping.insert(1, "one");
+        dropping.free(1);
+        REQUIRE_FALSE(dropping.count(1));
+        REQUIRE(budget->used() == 0);
+    }
+
+    SECTION("LRU eviction without spilling") {
+        budget->set_limit(6, EvictionPolicy::lru);
+        dropping.insert(1, "one");
+        dropping.insert(2, "two");
+        REQUIRE(dropping.at(1).get() == "one"); // 2 is now the LRU entry
+        dropping.insert(3, "six");
+        REQUIRE(dropping.count(1));
+        REQUIRE_FALSE(dropping.count(2));
+        REQUIRE(dropping.count(3));
+        REQUIRE(budget->used() == 6);
+    }
+
+    SECTION("Values are shared, not copied") {
+        dropping.insert(1, "one");
+        auto value = dropping.at(1);
+        REQUIRE_FALSE(value.is_alias());
+        REQUIRE(&dropping.try_at(1).get() == &value.get());
+
+        // Shared values outlive their eviction
+        budget->set_limit(3, EvictionPolicy::lru);
+        dropping.insert(2, "two");
+        REQUIRE_FALSE(dropping.count(1));
+        REQUIRE(value.get() == "one");
+    }
+
+    SECTION("Newest entry is never evicted") {
+        budget->set_limit(2, EvictionPolicy::lru);
+        dropping.insert(1, "one");
+        REQUIRE(dropping.at(1).get() == "one");
+        dropping.insert(2, "two");
+        REQUIRE_FALSE(dropping.count(1));
+        REQUIRE(dropping.at(2).get() == "two");
+    }
+
+    SECTION("Eviction across databases sharing a budget") {
+        budget->set_limit(7, EvictionPolicy::lru);
+        dropping.insert(1, "one");
+        dropping.insert(4, "f");
+        spilling.insert(2, "two");
+        spilling.insert(3, "six");
+        REQUIRE_FALSE(dropping.count(1));
+        REQUIRE(dropping.count(4));
+        REQUIRE(spilling.size() == 6);
+    }
+
+    SECTION("Cost-aware eviction") {
+        budget->set_limit(8, EvictionPolicy::cost_aware);
+        MemoryBudget::set_recompute_cost(10.0);
+        dropping.insert(1, "expensive");
+        MemoryBudget::set_recompute_cost(1.0);
+        dropping.insert(2, "cheap");
+        // Over budget, but 2 is the newest, so 1 had to go
+        REQUIRE_FALSE(dropping.count(1));
+
+        dropping.free(2);
+        MemoryBudget::set_recompute_cost(10.0);
+        dropping.insert(1, "pricy");
+        MemoryBudget::set_recompute_cost(1.0);
+        dropping.insert(2, "thr");
+        MemoryBudget::set_recompute_cost(1.0);
+        dropping.insert(3, "fr");
+        // Evicts the cheapest per byte, even though 1 is the oldest
+        REQUIRE(dropping.count(1));
+        REQUIRE_FALSE(dropping.count(2));
+        REQUIRE(dropping.count(3));
+
+        // Databases told not to use the cost leave it for the next one
+        db_type no_cost(budget, size, nullptr, nullptr, nullptr, false);
+        MemoryBudget::set_recompute_cost(10.0);
+        no_cost.insert(1, "a");
+        REQUIRE(MemoryBudget::take_recompute_cost() == 10.0);
+    }
+
+    SECTION("Spilling") {
+        budget->set_limit(6, EvictionPolicy::lru);
+        spilling.insert(1, "one");
+        spilling.insert(2, "two");
+        spilling.insert(3, "six");
+
+        // 1 was moved to the spill database, but is still in spilling
+        REQUIRE(pspill->count(1));
+        REQUIRE(spilling.count(1));
+        REQUIRE(spilling.keys().size() == 3);
+        REQUIRE(spilling.size() == 6);
+
+        // Reading it brings it back into memory, which evicts 2
+        REQUIRE(spilling.at(1).get() == "one");
+        REQUIRE(pspill->count(2));
+        REQUIRE(spilling.size() == 6);
+
+        // Freeing removes it from the spill database too
+        spilling.free(2);
+        REQUIRE_FALSE(pspill->count(2));
+        REQUIRE_FALSE(spilling.count(2));
+    }
+
+    SECTION("Values which can't spill never leave memory") {
+        // Values starting with "p" are "pinned" to memory
+        auto can_spill = [](const std::string& s) { return s[0] != 'p'; };
+        auto pspill2   = std::make_unique<native_type>();
+        auto pbackup2  = std::make_unique<native_type>();
+        auto p         = pspill2.get();
+        auto pb        = pbackup2.get();
+        db_type pinning(budget, size, std::move(pspill2), std::move(pbackup2),
+                        can_spill);
+
+        pinning.insert(1, "pin");
+        pinning.insert(2, "two");
+
+        // Not backed up, and dump keeps it
+        pinning.dump();
+        REQUIRE_FALSE(pb->count(1));
+        REQUIRE(pb->count(2));
+        REQUIRE(pinning.size() == 3);
+        REQUIRE(pinning.at(1).get() == "pin");
+
+        // Evicting drops it, rather than spilling it
+        budget->set_limit(6, EvictionPolicy::lru);
+        pinning.insert(3, "six");
+        pinning.insert(4, "for");
+        REQUIRE_FALSE(pinning.count(1));
+        REQUIRE_FALSE(p->count(1));
+        REQUIRE(p->keys().empty());
+        REQUIRE(pinning.size() == 6);
+
+        // Same without a spill database
+        db_type no_spill(budget, size, nullptr, nullptr, can_spill);
+        no_spill.insert(5, "pin");
+        no_spill.insert(6, "eleven");
+        REQUIRE_FALSE(no_spill.count(5));
+    }
+
+    SECTION("Budget made up only of values which can't spill") {
+        auto can_spill = [](const std::string&) { return false; };
+        auto pspill2   = std::make_unique<native_type>();
+        auto p         = pspill2.get();
+        db_type pinning(budget, size, std::move(pspill2), nullptr, can_spill);
+
+        budget->set_limit(9, EvictionPolicy::lru);
+        for(int i = 0; i < 10; ++i) pinning.insert(i, "pin");
+
+        // The budget is enforced, by dropping the oldest values
+        REQUIRE(pinning.size() == 9);
+        REQUIRE(budget->used() <= 9);
+        REQUIRE(pinning.keys() == key_set_type{7, 8, 9});
+        REQUIRE(p->keys().empty());
+    }
+
+    SECTION("Writing through to the spill database") {
+        auto can_spill = [](const std::string& s) { return s[0] != 'p'; };
+        auto pspill2   = std::make_unique<native_type>();
+        auto p         = pspill2.get();
+        db_type writing(budget, size, std::move(pspill2), nullptr, can_spill,
+                        true, true);
+
+        // Written right away, unless it can't spill
+        writing.insert(1, "one");
+        writing.insert(2, "pin");
+        REQUIRE(p->at(1).get() == "one");
+        REQUIRE_FALSE(p->count(2));
+        REQUIRE(writing.size() == 6);
+
+        // Evicting merely drops it from memory
+        budget->set_limit(6, EvictionPolicy::lru);
+        writing.insert(3, "six");
+        REQUIRE(writing.size() == 6);
+        REQUIRE(p->at(1).get() == "one");
+        REQUIRE(writing.at(1).get() == "one");
+
+        // Without a spill database there's nothing to write to
+        db_type no_spill(budget, size, nullptr, nullptr, nullptr, true, true);
+        no_spill.insert(4, "f");
+        REQUIRE(no_spill.at(4).get() == "f");
+    }
+
+    SECTION("keys") {
+        REQUIRE(dropping.keys() == key_set_type{});
+        dropping.insert(1, "one");
+        REQUIRE(dropping.keys() == key_set_type{1});
+    }
+
+    SECTION("backup") {
+        spilling.insert(1, "one");
+        spilling.backup();
+        REQUIRE(pbackup->at(1).get() == "one");
+        REQUIRE_FALSE(pspill->count(1));
+
+        // Without a backup database, backs up to the spill database
+        auto pspill2 = std::make_unique<native_type>();
+        auto p       = pspill2.get();
+        db_type no_backup(budget, size, std::move(pspill2));
+        no_backup.insert(1, "one");
+        no_backup.backup();
+        REQUIRE(p->at(1).get() == "one");
+    }
+
+    SECTION("dump") {
+        spilling.insert(1, "one");
+        spilling.dump();
+        REQUIRE(pbackup->at(1).get() == "one");
+        REQUIRE(spilling.size() == 0);
+        REQUIRE(budget->used() == 0);
+    }
+
+    SECTION("batches") {
+        using counter_type = testing::BatchCounter<int, std::string>;
+        auto counter       = std::make_unique<counter_type>();
+        auto pcounter      = counter.get();
+        db_type batched(budget, size, std::move(counter));
+
+        batched.begin_batch();
+        batched.commit_batch();
+        REQUIRE(pcounter->n_begun == 1);
+        REQUIRE(pcounter->n_committed == 1);
+
+        // Backing up is one batch
+        batched.insert(1, "one");
+        batched.insert(2, "two");
+        batched.backup();
+        REQUIRE(pcounter->n_begun == 2);
+        REQUIRE(pcounter->n_committed == 2);
+        REQUIRE(pcounter->at(2).get() == "two");
+
+        // No sub databases is a no-op
+        dropping.begin_batch();
+        dropping.commit_batch();
+    }
+
+    SECTION("DTor returns memory to the budget") {
+        {
+            db_type temp(budget, size);
+            temp.insert(1, "one");
+            REQUIRE(budget->used() == 3);
+        }
+        REQUIRE(budget->used() == 0);
+    }
+}
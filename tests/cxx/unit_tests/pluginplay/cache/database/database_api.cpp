@@ -14,7 +14,7 @@
  * limitations under the License.
  */
 
-#include "../../catch.hpp"
+#include "../test_cache.hpp"
 #include <pluginplay/cache/database/database_api.hpp>
 #include <pluginplay/cache/database/native.hpp>
 
@@ -27,7 +27,12 @@ using namespace pluginplay::cache::database;
  * DatabasePIMPL to ensure they work. The exception to this is the `at` method,
  * which relies on count to determine if a key exists before retrieving the
  * value. If count_ and at_ work, then we only need to test that the logic in
- * at is setup correctly so that it throws when a value isn't found.
+ * at is setup correctly so that it throws when a value isn't found. Similarly,
+ * the default implementation of find_or_compute relies on try_at_, insert_,
+ * and at_, so we test that it only calls the callback on a miss, and the
+ * default implementation of try_insert must not overwrite existing values.
+ * Batches are no-ops by default; we test that BatchScope begins exactly one
+ * batch and either commits or aborts it.
  */
 
 TEST_CASE("DatabasePIMPL") {
@@ -38,4 +43,103 @@ TEST_CASE("DatabasePIMPL") {
         REQUIRE(m.at("Hello").get() == "World");
         REQUIRE_THROWS_AS(m.at("Not a key"), std::out_of_range);
     }
+
+    SECTION("find_or_compute") {
+        std::size_t n_calls = 0;
+        auto fxn            = [&]() {
+            ++n_calls;
+            return std::string("Computed");
+        };
+
+        // Hit doesn't call fxn
+        REQUIRE(m.find_or_compute("Hello", fxn).get() == "World");
+        REQUIRE(n_calls == 0);
+
+        // Miss calls fxn and stores the result
+        REQUIRE(m.find_or_compute("Not a key", fxn).get() == "Computed");
+        REQUIRE(n_calls == 1);
+        REQUIRE(m.at("Not a key").get() == "Computed");
+
+        // Now it's a hit
+        REQUIRE(m.find_or_compute("Not a key", fxn).get() == "Computed");
+        REQUIRE(n_calls == 1);
+    }
+
+    SECTION("find_or_compute (callback throws)") {
+        auto fxn = []() -> std::string { throw std::runtime_error("Oops"); };
+        REQUIRE_THROWS_AS(m.find_or_compute("Not a key", fxn),
+                          std::runtime_error);
+        REQUIRE_FALSE(m.count("Not a key"));
+    }
+
+    SECTION("try_insert") {
+        // Existing key isn't overwritten
+        REQUIRE(m.try_insert("Hello", "Universe").get() == "World");
+        REQUIRE(m.at("Hello").get() == "World");
+
+        // New key is added
+        REQUIRE(m.try_insert("Not a key", "Added").get() == "Added");
+        REQUIRE(m.at("Not a key").get() == "Added");
+    }
+}
+
+TEST_CASE("BatchScope") {
+    testing::BatchCounter<std::string, std::string> db;
+
+    SECTION("Default batches are no-ops") {
+        Native<std::string, std::string> m;
+        m.begin_batch();
+        m.insert("Hello", "World");
+        m.commit_batch();
+        REQUIRE(m.at("Hello").get() == "World");
+    }
+
+    SECTION("commit") {
+        BatchScope batch(db);
+        REQUIRE(db.n_begun == 1);
+        batch.commit();
+        REQUIRE(db.n_committed == 1);
+
+        // Only commits once
+        batch.commit();
+        REQUIRE(db.n_committed == 1);
+    }
+
+    SECTION("DTor doesn't abort a committed batch") {
+        {
+            BatchScope batch(db);
+            batch.commit();
+        }
+        REQUIRE(db.n_committed == 1);
+        REQUIRE(db.n_aborted == 0);
+    }
+
+    SECTION("DTor aborts") {
+        {
+            BatchScope batch(db);
+            REQUIRE(db.n_aborted == 0);
+        }
+        REQUIRE(db.n_committed == 0);
+        REQUIRE(db.n_aborted == 1);
+    }
+
+    SECTION("Aborts when an exception is thrown") {
+        try {
+            BatchScope batch(db);
+            throw std::runtime_error("Oops");
+        } catch(const std::runtime_error&) {}
+        REQUIRE(db.n_committed == 0);
+        REQUIRE(db.n_aborted == 1);
+    }
+
+    SECTION("commit throws") {
+        db.throw_on_commit = true;
+        {
+            BatchScope batch(db);
+            REQUIRE_THROWS_AS(batch.commit(), std::runtime_error);
+            batch.commit(); // Considered committed
+        }
+        REQUIRE(db.n_committed == 1);
+        REQUIRE(db.n_aborted == 0);
+    }
 }
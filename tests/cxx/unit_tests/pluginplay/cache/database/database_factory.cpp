@@ -15,12 +15,31 @@
  */
 
 #include "../../catch.hpp"
+#include <atomic>
 #include <filesystem>
 #include <pluginplay/cache/database/database_factory.hpp>
+#include <pluginplay/config/config.hpp>
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/database/snapshot.hpp>
 
 using namespace pluginplay;
 using namespace pluginplay::cache::database;
 
+namespace {
+
+// Can be cached, but can't be serialized
+struct NotSerializable {
+    int value = 0;
+    bool operator==(const NotSerializable& rhs) const {
+        return value == rhs.value;
+    }
+    bool operator<(const NotSerializable& rhs) const {
+        return value < rhs.value;
+    }
+};
+
+} // namespace
+
 /* These tests serve as integration tests for the Database backend of the cache.
  * It is assumed that the pieces of the Database have been individually unit
  * tested, and found to work. The tests here focus on using the objects returned
@@ -78,3 +97,202 @@ TEST_CASE("DatabaseFactory : No long-term storage") {
     REQUIRE(pdb->count(inputs));
     REQUIRE(pdb->at(inputs).get() == results);
 }
+
+TEST_CASE("DatabaseFactory : Snapshots") {
+    using input_map_type     = typename DatabaseFactory::input_map_type;
+    using module_input_type  = typename DatabaseFactory::module_input_type;
+    using result_map_type    = typename DatabaseFactory::result_map_type;
+    using module_result_type = typename DatabaseFactory::module_result_type;
+    using native_type        = Native<std::string, std::string>;
+
+    auto root_dir = std::filesystem::temp_directory_path() / "dbf_snapshots";
+    std::filesystem::remove_all(root_dir);
+    std::filesystem::create_directories(root_dir);
+    auto cache_path = (root_dir / "cache.snap").string();
+    auto uuid_path  = (root_dir / "uuid.snap").string();
+    auto out_cache  = (root_dir / "out_cache.snap").string();
+    auto out_uuid   = (root_dir / "out_uuid.snap").string();
+
+    module_input_type i0, i1;
+    i0.set_type<int>();
+    i0.change(42);
+    i1.set_type<int>();
+    i1.change(43);
+    module_result_type r0;
+    r0.set_type<double>();
+    r0.change(3.14);
+
+    input_map_type inputs0{{"field", i0}};
+    input_map_type inputs1{{"field", i1}};
+    result_map_type results{{"field", r0}};
+
+    DatabaseFactory factory;
+
+    // Opens the exported snapshot in a new factory
+    auto reopen = [&]() {
+        auto pother = std::make_unique<DatabaseFactory>();
+        pother->set_snapshot_backend(out_cache, out_uuid);
+        pother->set_content_addressed(true);
+        return pother;
+    };
+
+    SECTION("No long-term storage") {
+        using e = std::runtime_error;
+        REQUIRE_THROWS_AS(factory.export_snapshot(out_cache, out_uuid), e);
+        REQUIRE_THROWS_AS(factory.set_snapshot_backend(cache_path, uuid_path),
+                          e);
+    }
+
+    SECTION("Export") {
+        // Start from empty snapshots
+        Snapshot::write(cache_path, native_type{});
+        Snapshot::write(uuid_path, native_type{});
+        factory.set_snapshot_backend(cache_path, uuid_path);
+
+        // Random UUIDs could never be found again
+        using e = std::runtime_error;
+        REQUIRE_THROWS_AS(factory.export_snapshot(out_cache, out_uuid), e);
+        factory.set_content_addressed(true);
+
+        auto pfoo = factory.default_module_db("foo");
+        auto pbar = factory.default_module_db("bar");
+        pfoo->insert(inputs0, results);
+        pbar->insert(inputs1, results);
+        REQUIRE(pfoo->at(inputs0).get() == results);
+        pfoo->backup();
+        pbar->backup();
+
+        // The snapshots we started from are not modified
+        REQUIRE(Snapshot(cache_path).size() == 0);
+
+        SECTION("Everything") {
+            factory.export_snapshot(out_cache, out_uuid);
+            REQUIRE(Snapshot(out_cache).size() == 2);
+            REQUIRE(Snapshot(out_uuid).size() > 0);
+
+            auto pother = reopen();
+            REQUIRE(pother->default_module_db("foo")->at(inputs0).get() ==
+                    results);
+            REQUIRE(pother->default_module_db("bar")->at(inputs1).get() ==
+                    results);
+        }
+
+        SECTION("Results which shouldn't persist") {
+            auto persist = std::make_shared<std::atomic<bool>>(false);
+            auto pbaz    = factory.default_module_db("baz", {}, persist);
+
+            // Cached in memory, but never written to long-term storage
+            pbaz->insert(inputs0, results);
+            REQUIRE(pbaz->at(inputs0).get() == results);
+            pbaz->backup();
+            factory.export_snapshot(out_cache, out_uuid, "baz");
+            REQUIRE(Snapshot(out_cache).size() == 0);
+
+            // Results inserted once persisting is back on are written out
+            persist->store(true);
+            pbaz->insert(inputs1, results);
+            pbaz->backup();
+            factory.export_snapshot(out_cache, out_uuid, "baz");
+            REQUIRE(Snapshot(out_cache).size() == 1);
+            auto pother = reopen();
+            auto pbaz2  = pother->default_module_db("baz");
+            REQUIRE(pbaz2->at(inputs1).get() == results);
+            REQUIRE_FALSE(pbaz2->count(inputs0));
+        }
+
+        SECTION("One module") {
+            factory.export_snapshot(out_cache, out_uuid, "foo");
+            REQUIRE(Snapshot(out_cache).size() == 1);
+            REQUIRE(Snapshot(out_uuid).size() > 0);
+
+            // A new factory is served from the exported snapshot
+            auto pother = reopen();
+            auto pfoo2  = pother->default_module_db("foo");
+            REQUIRE(pfoo2->at(inputs0).get() == results);
+            REQUIRE_FALSE(pfoo2->count(inputs1));
+            REQUIRE_FALSE(pother->default_module_db("bar")->count(inputs1));
+        }
+    }
+
+    std::filesystem::remove_all(root_dir);
+}
+
+TEST_CASE("DatabaseFactory : Spilling to long-term storage") {
+    using input_map_type     = typename DatabaseFactory::input_map_type;
+    using module_input_type  = typename DatabaseFactory::module_input_type;
+    using result_map_type    = typename DatabaseFactory::result_map_type;
+    using module_result_type = typename DatabaseFactory::module_result_type;
+    using native_type        = Native<std::string, std::string>;
+    using vector_type        = std::vector<double>;
+
+    auto root_dir = std::filesystem::temp_directory_path() / "dbf_spilling";
+    std::filesystem::remove_all(root_dir);
+    std::filesystem::create_directories(root_dir);
+    auto cache_path = (root_dir / "cache").string();
+    auto uuid_path  = (root_dir / "uuid").string();
+
+    module_input_type i0, i1, i2;
+    i0.set_type<vector_type>();
+    i0.change(vector_type(1000, 1.0));
+    i1.set_type<vector_type>();
+    i1.change(vector_type(1000, 2.0));
+    i2.set_type<vector_type>();
+    i2.change(vector_type(1000, 3.0));
+    module_result_type r0, r1, r2;
+    r0.set_type<vector_type>();
+    r0.change(vector_type(1000, 4.0));
+    r1.set_type<vector_type>();
+    r1.change(vector_type(1000, 5.0));
+    r2.set_type<NotSerializable>();
+    r2.change(NotSerializable{6});
+
+    input_map_type inputs0{{"field", i0}};
+    input_map_type inputs1{{"field", i1}};
+    input_map_type inputs2{{"field", i2}};
+    result_map_type results0{{"field", r0}};
+    result_map_type results1{{"field", r1}};
+    result_map_type results2{{"field", r2}};
+
+    auto spill_and_read_back = [&](DatabaseFactory& factory) {
+        auto pdb = factory.default_module_db("foo");
+        pdb->insert(inputs0, results0);
+        const auto used = factory.memory_budget().used();
+
+        // Only the newest entries fit, so inputs0/results0 are evicted, which
+        // keeps the memory in use from doubling
+        factory.set_memory_budget(1, cache::EvictionPolicy::lru);
+        pdb->insert(inputs1, results1);
+        REQUIRE(factory.memory_budget().used() <= used);
+
+        // Read back from long-term storage (evicting inputs1/results1)
+        REQUIRE(pdb->at(inputs0).get() == results0);
+        REQUIRE(pdb->at(inputs1).get() == results1);
+
+        // Results which can't be serialized are dropped when evicted, so the
+        // budget still holds (a cache would recompute them)
+        pdb->insert(inputs2, results2);
+        REQUIRE(pdb->at(inputs2).get() == results2);
+        pdb->insert(inputs0, results0);
+        REQUIRE(factory.memory_budget().used() <= used);
+        REQUIRE_FALSE(pdb->count(inputs2));
+        REQUIRE(pdb->at(inputs1).get() == results1);
+    };
+
+    SECTION("RocksDB") {
+        if(pluginplay::with_rocksdb()) {
+            DatabaseFactory factory(cache_path, uuid_path);
+            spill_and_read_back(factory);
+        }
+    }
+
+    SECTION("Snapshot") {
+        // Entries spill into the snapshots' in-memory overlays
+        Snapshot::write(cache_path, native_type{});
+        Snapshot::write(uuid_path, native_type{});
+        DatabaseFactory factory;
+        factory.set_snapshot_backend(cache_path, uuid_path);
+        spill_and_read_back(factory);
+    }
+
+    std::filesystem::remove_all(root_dir);
+}
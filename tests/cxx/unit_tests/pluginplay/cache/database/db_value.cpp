@@ -43,16 +43,36 @@ TEMPLATE_LIST_TEST_CASE("DBValue", "", type_list) {
     test_type four{4};
     value_type by_val(test_type{4});
     value_type by_ref(&four);
+    auto pshared = std::make_shared<test_type>(4);
+    value_type by_shared(pshared);
 
     SECTION("has_value") {
         REQUIRE_FALSE(defaulted.has_value());
         REQUIRE(by_val.has_value());
         REQUIRE(by_ref.has_value());
+        REQUIRE(by_shared.has_value());
+    }
+
+    SECTION("is_alias") {
+        REQUIRE_FALSE(defaulted.is_alias());
+        REQUIRE_FALSE(by_val.is_alias());
+        REQUIRE(by_ref.is_alias());
+        REQUIRE_FALSE(by_shared.is_alias());
+    }
+
+    SECTION("Shared values outlive the original owner") {
+        auto* p = pshared.get();
+        pshared.reset();
+        value_type copy(by_shared);
+        by_shared = value_type{};
+        REQUIRE(&copy.get() == p);
+        REQUIRE(copy.get() == four);
     }
 
     SECTION("get()") {
         REQUIRE(&by_ref.get() == &four);
         REQUIRE(by_val.get() == four);
+        REQUIRE(&by_shared.get() == pshared.get());
     }
 
     SECTION("get()const") {
@@ -94,6 +94,44 @@ TEMPLATE_LIST_TEST_CASE("KeyProxyMapper", "", testing::test_types) {
         REQUIRE(psub_db->at(pmapper->at(key1)).get() == value1);
     }
 
+    SECTION("try_at") {
+        REQUIRE(db.try_at(key0).get() == value0);
+        REQUIRE_FALSE(db.try_at(key1).has_value());
+
+        // Proxy exists, but nothing is stored under it
+        db.free(key0);
+        REQUIRE_FALSE(db.try_at(key0).has_value());
+    }
+
+    SECTION("find_or_compute") {
+        std::size_t n_calls = 0;
+        auto fxn            = [&]() {
+            ++n_calls;
+            return value1;
+        };
+
+        // Hit, doesn't call fxn
+        REQUIRE(db.find_or_compute(key0, fxn).get() == value0);
+        REQUIRE(n_calls == 0);
+
+        // Miss, calls fxn and stores the result under the proxied key
+        REQUIRE(db.find_or_compute(key1, fxn).get() == value1);
+        REQUIRE(n_calls == 1);
+        REQUIRE(db.at(key1).get() == value1);
+        REQUIRE(psub_db->at(pmapper->at(key1)).get() == value1);
+
+        // Now it's a hit
+        REQUIRE(db.find_or_compute(key1, fxn).get() == value1);
+        REQUIRE(n_calls == 1);
+    }
+
+    SECTION("find_or_compute (callback throws)") {
+        auto fxn = []() -> value_type { throw std::runtime_error("Oops"); };
+        REQUIRE_THROWS_AS(db.find_or_compute(key1, fxn), std::runtime_error);
+        REQUIRE_FALSE(db.count(key1));
+        REQUIRE_FALSE(pmapper->count(key1));
+    }
+
     SECTION("free") {
         db.free(key0);
         // No longer used by outermost database
@@ -142,3 +180,43 @@ TEMPLATE_LIST_TEST_CASE("KeyProxyMapper", "", testing::test_types) {
         REQUIRE(psub_sub_db->count(mapped_key0));
     }
 }
+
+TEST_CASE("KeyProxyMapper : find_or_compute batches its writes") {
+    using key_type    = std::map<std::string, int>;
+    using value_type  = std::map<std::string, double>;
+    using mapper_type = KeyProxyMapper<key_type, value_type>;
+    using sub_db_type = typename mapper_type::sub_db_type;
+    using counter     = BatchCounter<typename sub_db_type::key_type,
+                                 typename sub_db_type::mapped_type>;
+
+    auto [p0, p1, p2, mapper] =
+      make_proxy_map_maker<typename mapper_type::proxy_map_maker::key_type>();
+    auto wrapped_mapper =
+      std::make_unique<typename mapper_type::proxy_map_maker>(
+        std::move(mapper));
+    auto sub_db  = std::make_unique<counter>();
+    auto psub_db = sub_db.get();
+    mapper_type db(std::move(wrapped_mapper), std::move(sub_db));
+
+    key_type key{{"Hello", 1}};
+    value_type value{{"foo", 1.23}};
+
+    SECTION("A miss writes the proxy and the value in one batch") {
+        REQUIRE(db.find_or_compute(key, [&]() { return value; }).get() ==
+                value);
+        REQUIRE(psub_db->n_begun == 1);
+        REQUIRE(psub_db->n_committed == 1);
+        REQUIRE(psub_db->n_aborted == 0);
+
+        // A hit doesn't write anything
+        REQUIRE(db.find_or_compute(key, [&]() { return value; }).get() ==
+                value);
+        REQUIRE(psub_db->n_begun == 1);
+    }
+
+    SECTION("No batch is made if the callback throws") {
+        auto fxn = []() -> value_type { throw std::runtime_error("Oops"); };
+        REQUIRE_THROWS_AS(db.find_or_compute(key, fxn), std::runtime_error);
+        REQUIRE(psub_db->n_begun == 0);
+    }
+}
@@ -124,8 +124,9 @@ TEST_CASE("MakeAny<ModuleResult>") {
         // Value is correct
         REQUIRE(*corr == rv);
 
-        // Is a copy
-        REQUIRE(&any::any_cast<ref>(*corr) != &any::any_cast<ref>(rv));
+        // Is a copy, which shares the (read-only) value
+        REQUIRE(rv.shares_value(*corr));
+        REQUIRE(&any::any_cast<ref>(*corr) == &any::any_cast<ref>(rv));
     }
 
     SECTION("std::vector<int>") {
@@ -140,8 +141,9 @@ TEST_CASE("MakeAny<ModuleResult>") {
         // Value is correct
         REQUIRE(*corr == rv);
 
-        // Is a copy
-        REQUIRE(&any::any_cast<ref>(*corr) != &any::any_cast<ref>(rv));
+        // Is a copy, which shares the (read-only) value
+        REQUIRE(rv.shares_value(*corr));
+        REQUIRE(&any::any_cast<ref>(*corr) == &any::any_cast<ref>(rv));
     }
 }
 
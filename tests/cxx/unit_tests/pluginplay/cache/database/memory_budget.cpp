@@ -0,0 +1,134 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../../catch.hpp"
+#include <pluginplay/cache/database/memory_budget.hpp>
+#include <vector>
+
+using namespace pluginplay::cache;
+using namespace pluginplay::cache::database;
+
+namespace {
+
+// Evictable holding a list of (priority, size) pairs, lowest priority first
+struct FakeDB : Evictable {
+    explicit FakeDB(MemoryBudget& budget) : m_budget(budget) {}
+
+    bool lowest_priority(priority_type& p) const noexcept override {
+        if(m_entries.empty()) return false;
+        p = m_entries.front().first;
+        return true;
+    }
+
+    size_type evict_lowest() override {
+        auto size = m_entries.front().second;
+        m_entries.erase(m_entries.begin());
+        m_budget.remove(size);
+        return size;
+    }
+
+    void add(priority_type p, size_type size) {
+        m_entries.emplace_back(p, size);
+        m_budget.add(size);
+    }
+
+    MemoryBudget& m_budget;
+    std::vector<std::pair<priority_type, size_type>> m_entries;
+};
+
+} // namespace
+
+TEST_CASE("MemoryBudget") {
+    MemoryBudget defaulted;
+    MemoryBudget limited(10, EvictionPolicy::cost_aware);
+
+    SECTION("CTors") {
+        REQUIRE(defaulted.limit() == 0);
+        REQUIRE(defaulted.policy() == EvictionPolicy::lru);
+        REQUIRE(defaulted.used() == 0);
+
+        REQUIRE(limited.limit() == 10);
+        REQUIRE(limited.policy() == EvictionPolicy::cost_aware);
+    }
+
+    SECTION("set_limit") {
+        defaulted.set_limit(5, EvictionPolicy::cost_aware);
+        REQUIRE(defaulted.limit() == 5);
+        REQUIRE(defaulted.policy() == EvictionPolicy::cost_aware);
+    }
+
+    SECTION("add/remove") {
+        defaulted.add(4);
+        defaulted.add(3);
+        REQUIRE(defaulted.used() == 7);
+        defaulted.remove(4);
+        REQUIRE(defaulted.used() == 3);
+    }
+
+    SECTION("priority") {
+        // LRU priorities increase with every use
+        auto p0 = defaulted.priority(1, 100.0);
+        auto p1 = defaulted.priority(100, 0.0);
+        REQUIRE(p0 < p1);
+
+        // Cost-aware priorities favor expensive, small entries
+        auto p2 = limited.priority(10, 1.0);
+        auto p3 = limited.priority(1, 1.0);
+        auto p4 = limited.priority(1, 2.0);
+        REQUIRE(p2 < p3);
+        REQUIRE(p3 < p4);
+    }
+
+    SECTION("reclaim") {
+        FakeDB db0(limited), db1(limited);
+        limited.register_db(&db0);
+        limited.register_db(&db1);
+        db0.add(1.0, 4);
+        db1.add(2.0, 4);
+        db0.add(3.0, 4);
+
+        // Over the limit, evicts the lowest priorities across both DBs
+        limited.reclaim();
+        REQUIRE(limited.used() == 8);
+        REQUIRE(db0.m_entries.size() == 1);
+        REQUIRE(db1.m_entries.size() == 1);
+
+        // Evicting raises the priority of new cost-aware entries
+        REQUIRE(limited.priority(1, 0.0) == 1.0);
+
+        // No limit, nothing is evicted
+        FakeDB db2(defaulted);
+        defaulted.register_db(&db2);
+        db2.add(1.0, 100);
+        defaulted.reclaim();
+        REQUIRE(db2.m_entries.size() == 1);
+
+        // Unregistered DBs are not evicted from
+        limited.unregister_db(&db0);
+        db1.add(4.0, 20);
+        limited.reclaim();
+        REQUIRE(db0.m_entries.size() == 1);
+        REQUIRE(db1.m_entries.empty());
+    }
+
+    SECTION("recompute cost") {
+        REQUIRE(MemoryBudget::take_recompute_cost() == 0.0);
+        MemoryBudget::set_recompute_cost(1.5);
+        REQUIRE(MemoryBudget::take_recompute_cost() == 1.5);
+        REQUIRE(MemoryBudget::take_recompute_cost() == 0.0);
+    }
+}
@@ -14,7 +14,7 @@
  * limitations under the License.
  */
 
-#include "../../catch.hpp"
+#include "../test_cache.hpp"
 #include <pluginplay/cache/database/native.hpp>
 
 using namespace pluginplay::cache::database;
@@ -79,6 +79,12 @@ TEMPLATE_LIST_TEST_CASE("Map", "", test_types) {
         REQUIRE(has_backup.at(default_key).get() == default_value);
     }
 
+    SECTION("try_at") {
+        REQUIRE_FALSE(defaulted.try_at(default_key).has_value());
+        REQUIRE(has_val.try_at(default_key).get() == default_value);
+        REQUIRE(has_backup.try_at(default_key).get() == default_value);
+    }
+
     SECTION("backup") {
         has_backup.backup();
         REQUIRE(has_backup.count(default_key));
@@ -96,3 +102,31 @@ TEMPLATE_LIST_TEST_CASE("Map", "", test_types) {
         REQUIRE(pbackup->at(default_key).get() == default_value);
     }
 }
+
+TEST_CASE("Native : batches") {
+    using counter_type = testing::BatchCounter<int, int>;
+    auto backup        = std::make_unique<counter_type>();
+    auto pbackup       = backup.get();
+    Native<int, int> db(std::move(backup));
+    db.insert(1, 2);
+
+    SECTION("Forwards to the backup") {
+        db.begin_batch();
+        db.commit_batch();
+        REQUIRE(pbackup->n_begun == 1);
+        REQUIRE(pbackup->n_committed == 1);
+    }
+
+    SECTION("backup is one batch") {
+        db.backup();
+        REQUIRE(pbackup->n_begun == 1);
+        REQUIRE(pbackup->n_committed == 1);
+        REQUIRE(pbackup->at(1).get() == 2);
+    }
+
+    SECTION("No backup") {
+        Native<int, int> no_backup;
+        no_backup.begin_batch();
+        no_backup.commit_batch();
+    }
+}
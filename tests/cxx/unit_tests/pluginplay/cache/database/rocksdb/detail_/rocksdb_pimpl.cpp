@@ -16,8 +16,14 @@
 
 #ifdef BUILD_ROCKS_DB
 #include "../../../../catch.hpp"
+#include <cstdlib>
 #include <filesystem>
+#include <future>
 #include <pluginplay/cache/database/rocksdb/detail_/rocksdb_pimpl.hpp>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
 using namespace pluginplay::cache::database::detail_;
 
 /* Testing notes:
@@ -81,6 +87,245 @@ TEST_CASE("RocksDBPIMPL") {
         REQUIRE_FALSE(db.count("Hello"));
     }
 
+    SECTION("batches") {
+        REQUIRE_THROWS_AS(db.commit_batch(), std::runtime_error);
+
+        db.begin_batch();
+        db.insert("Batched", "Value");
+        db.free("Hello");
+
+        // Staged writes are visible
+        REQUIRE(db.count("Batched"));
+        REQUIRE(db.at("Batched").get() == "Value");
+        REQUIRE_FALSE(db.count("Hello"));
+
+        // Nested batches only commit with the outermost batch
+        db.begin_batch();
+        db.insert("Nested", "Value");
+        db.commit_batch();
+        db.commit_batch();
+
+        // A fresh instance only sees committed writes
+        db.free("Batched");
+        db.free("Nested");
+        pluginplay::cache::RocksDBOptions options;
+        options.sync_writes = true;
+        RocksDBPIMPL synced(p.string() + "_sync", options);
+        synced.begin_batch();
+        synced.insert("Hello", "World");
+        synced.commit_batch();
+        REQUIRE(synced.at("Hello").get() == "World");
+    }
+
+    SECTION("batches belong to a thread") {
+        db.begin_batch();
+        db.insert("Batched", "Value");
+
+        // Other threads can't commit our batch, don't see it, and don't
+        // write into it. N.B. Catch's macros aren't thread-safe.
+        auto other = std::async(std::launch::async, [&db]() {
+            bool threw = false;
+            try {
+                db.commit_batch();
+            } catch(const std::runtime_error&) { threw = true; }
+            db.insert("Unbatched", "Value");
+            return threw && !db.count("Batched");
+        });
+        REQUIRE(other.get());
+
+        // The other thread's write went straight to the database
+        REQUIRE(db.count("Unbatched"));
+        db.commit_batch();
+        REQUIRE(db.count("Batched"));
+        db.free("Batched");
+        db.free("Unbatched");
+    }
+
+    SECTION("aborted batches") {
+        REQUIRE_THROWS_AS(db.abort_batch(), std::runtime_error);
+
+        // Aborting discards the staged writes
+        db.begin_batch();
+        db.insert("Batched", "Value");
+        db.free("Hello");
+        db.abort_batch();
+        REQUIRE_FALSE(db.count("Batched"));
+        REQUIRE(db.at("Hello").get() == "World");
+
+        // Aborting a nested batch discards the enclosing batch too
+        db.begin_batch();
+        db.insert("Outer", "Value");
+        db.begin_batch();
+        db.insert("Inner", "Value");
+        db.abort_batch();
+        REQUIRE(db.count("Outer"));
+        db.commit_batch();
+        REQUIRE_FALSE(db.count("Outer"));
+        REQUIRE_FALSE(db.count("Inner"));
+
+        // Once the batch ends writes go straight to the database again
+        REQUIRE_THROWS_AS(db.commit_batch(), std::runtime_error);
+        db.insert("Unbatched", "Value");
+        REQUIRE(db.count("Unbatched"));
+        db.free("Unbatched");
+    }
+
+    SECTION("options") {
+        using compression_type = pluginplay::cache::RocksDBOptions::Compression;
+        pluginplay::cache::RocksDBOptions options;
+        options.block_cache_size   = 1024 * 1024;
+        options.bloom_bits_per_key = 0;
+        options.compression        = compression_type::none;
+        options.write_buffer_size  = 1024 * 1024;
+        options.parallelism        = 2;
+        RocksDBPIMPL tuned(p.string() + "_tuned", options);
+        tuned.insert("Hello", "World");
+        REQUIRE(tuned.count("Hello"));
+        REQUIRE_FALSE(tuned.count("not a key"));
+        REQUIRE(tuned.at("Hello").get() == "World");
+    }
+
+    SECTION("chunked values") {
+        pluginplay::cache::RocksDBOptions options;
+        options.chunk_size = 4;
+        auto chunked_path  = p.string() + "_chunked";
+        std::string value("Hello World!"); // Three chunks
+        {
+            RocksDBPIMPL chunked(chunked_path, options);
+            chunked.insert("Large", value);
+            REQUIRE(chunked.count("Large"));
+            REQUIRE(chunked.at("Large").get() == value);
+
+            // Can replace a chunked value with a small value and back
+            chunked.insert("Large", "Hi");
+            REQUIRE(chunked.at("Large").get() == "Hi");
+            chunked.insert("Large", value);
+
+            // Can stream values in and out
+            std::istringstream is(value + value);
+            chunked.write_stream("Streamed", is);
+            std::ostringstream os;
+            chunked.read_stream("Streamed", os);
+            REQUIRE(os.str() == value + value);
+            REQUIRE(chunked.at("Streamed").get() == value + value);
+
+            std::istringstream small("Hi");
+            chunked.write_stream("Small", small);
+            REQUIRE(chunked.at("Small").get() == "Hi");
+
+            std::ostringstream not_used;
+            REQUIRE_THROWS_AS(chunked.read_stream("Not a key", not_used),
+                              std::out_of_range);
+        }
+
+        // Chunked values survive reopening the database
+        RocksDBPIMPL reopened(chunked_path, options);
+        REQUIRE(reopened.at("Large").get() == value);
+        REQUIRE(reopened.at("Streamed").get() == value + value);
+
+        reopened.free("Large");
+        reopened.free("Streamed");
+        reopened.free("Small");
+        REQUIRE_FALSE(reopened.count("Large"));
+        REQUIRE_FALSE(reopened.count("Streamed"));
+    }
+
+    SECTION("shared") {
+        pluginplay::cache::RocksDBOptions options;
+        options.shared          = true;
+        options.chunk_size      = 4;
+        options.peer_refresh_ms = 0; // So writes are seen right away
+        auto shared_path        = p.string() + "_shared";
+        std::filesystem::remove_all(shared_path);
+
+        // Each instance gets its own writer database, even in one process
+        RocksDBPIMPL a(shared_path, options);
+        RocksDBPIMPL b(shared_path, options);
+        REQUIRE(std::filesystem::exists(shared_path + "/writer-0"));
+        REQUIRE(std::filesystem::exists(shared_path + "/writer-1"));
+
+        // Writes are seen by the other instance
+        a.insert("Hello", "World");
+        b.insert("Large", "Hello World!");
+        REQUIRE(b.count("Hello"));
+        REQUIRE(b.at("Hello").get() == "World");
+        REQUIRE(a.at("Large").get() == "Hello World!");
+        std::ostringstream os;
+        a.read_stream("Large", os);
+        REQUIRE(os.str() == "Hello World!");
+        REQUIRE_FALSE(a.count("Not a key"));
+
+        // Writers appearing later are found too
+        RocksDBPIMPL c(shared_path, options);
+        c.insert("Late", "Value");
+        REQUIRE(a.at("Late").get() == "Value");
+
+        // Freeing only affects the instance's own database
+        b.free("Hello");
+        REQUIRE(b.count("Hello"));
+        a.free("Hello");
+        REQUIRE_FALSE(b.count("Hello"));
+    }
+
+    SECTION("shared, refreshing at most once per interval") {
+        pluginplay::cache::RocksDBOptions options;
+        options.shared          = true;
+        options.peer_refresh_ms = 3600000;
+        auto shared_path        = p.string() + "_refresh";
+        std::filesystem::remove_all(shared_path);
+
+        RocksDBPIMPL a(shared_path, options);
+        RocksDBPIMPL b(shared_path, options);
+        a.insert("Hello", "World");
+
+        // The first miss refreshes, so b sees what a wrote so far...
+        REQUIRE(b.count("Hello"));
+
+        // ...but not what a writes until the next refresh is due
+        a.insert("Late", "Value");
+        REQUIRE_FALSE(b.count("Late"));
+        REQUIRE(a.count("Late"));
+    }
+
+    SECTION("shared by several processes") {
+        auto shared_path = p.string() + "_processes";
+        std::filesystem::remove_all(shared_path);
+
+        // Runs the hidden test case below in n_procs concurrent processes
+        const int n_procs = 4;
+        setenv("PLUGINPLAY_SHARED_DB", shared_path.c_str(), 1);
+        std::vector<pid_t> pids;
+        for(int i = 0; i < n_procs; ++i) {
+            const auto key = std::to_string(i);
+            setenv("PLUGINPLAY_SHARED_KEY", key.c_str(), 1);
+            auto pid = fork();
+            REQUIRE(pid >= 0);
+            if(pid == 0) {
+                execl("/proc/self/exe", "/proc/self/exe",
+                      "RocksDBPIMPL shared writer", nullptr);
+                _exit(EXIT_FAILURE);
+            }
+            pids.push_back(pid);
+        }
+        unsetenv("PLUGINPLAY_SHARED_DB");
+        unsetenv("PLUGINPLAY_SHARED_KEY");
+        for(auto pid : pids) {
+            int status = 0;
+            REQUIRE(waitpid(pid, &status, 0) == pid);
+            REQUIRE(WIFEXITED(status));
+            REQUIRE(WEXITSTATUS(status) == EXIT_SUCCESS);
+        }
+
+        // This process sees what each of the others wrote
+        pluginplay::cache::RocksDBOptions options;
+        options.shared = true;
+        RocksDBPIMPL reader(shared_path, options);
+        for(int i = 0; i < n_procs; ++i) {
+            const auto key = std::to_string(i);
+            REQUIRE(reader.at(key).get() == "Written by process " + key);
+        }
+    }
+
     if(do_large_value) {
         // We note that the problem presumably comes from using 32 bit integers,
         // which themselves can only express offsets of 2^2 * 2^30, where 2^30
@@ -110,4 +355,20 @@ TEST_CASE("RocksDBPIMPL") {
         REQUIRE(val.get() == buffer);
     }
 }
+
+/* Hidden test case, run by the "shared by several processes" section in
+ * separate processes. Writes a value to the shared database from the
+ * environment.
+ */
+TEST_CASE("RocksDBPIMPL shared writer", "[.]") {
+    const char* path = std::getenv("PLUGINPLAY_SHARED_DB");
+    const char* key  = std::getenv("PLUGINPLAY_SHARED_KEY");
+    if(path == nullptr || key == nullptr) return;
+
+    pluginplay::cache::RocksDBOptions options;
+    options.shared = true;
+    RocksDBPIMPL db(path, options);
+    db.insert(key, std::string("Written by process ") + key);
+    REQUIRE(db.count(key));
+}
 #endif
@@ -15,8 +15,10 @@
  */
 
 #include "../../../catch.hpp"
+#include <algorithm>
 #include <filesystem>
 #include <pluginplay/cache/database/rocksdb/rocksdb.hpp>
+#include <sstream>
 using namespace pluginplay::cache::database;
 
 #ifdef BUILD_ROCKS_DB
@@ -77,6 +79,58 @@ TEST_CASE("RocksDB") {
         REQUIRE_THROWS_AS(defaulted.free(""), std::runtime_error);
     }
 
+    SECTION("batches") {
+        db.begin_batch();
+        db.insert("Batched", "Value");
+        REQUIRE(db.at("Batched").get() == "Value");
+        db.commit_batch();
+        REQUIRE(db.at("Batched").get() == "Value");
+        db.free("Batched");
+
+        // A BatchScope which isn't committed discards its writes
+        {
+            BatchScope batch(db);
+            db.insert("Batched", "Value");
+            REQUIRE(db.count("Batched"));
+        }
+        REQUIRE_FALSE(db.count("Batched"));
+
+        REQUIRE_THROWS_AS(defaulted.begin_batch(), std::runtime_error);
+        REQUIRE_THROWS_AS(defaulted.abort_batch(), std::runtime_error);
+    }
+
+    SECTION("streams") {
+        std::istringstream is("Streamed value");
+        db.write_stream("Streamed", is);
+        std::ostringstream os;
+        db.read_stream("Streamed", os);
+        REQUIRE(os.str() == "Streamed value");
+        db.free("Streamed");
+
+        REQUIRE_THROWS_AS(db.read_stream("Streamed", os), std::out_of_range);
+        REQUIRE_THROWS_AS(defaulted.write_stream("", is), std::runtime_error);
+        REQUIRE_THROWS_AS(defaulted.read_stream("", os), std::runtime_error);
+    }
+
+    SECTION("keys") {
+        auto has_key = [&](const std::string& key) {
+            auto keys = db.keys();
+            return std::find(keys.begin(), keys.end(), key) != keys.end();
+        };
+        REQUIRE(has_key("Hello"));
+        REQUIRE_FALSE(has_key("not a key"));
+
+        // Staged writes are included
+        db.begin_batch();
+        db.insert("Batched", "Value");
+        REQUIRE(has_key("Batched"));
+        db.commit_batch();
+        db.free("Batched");
+        REQUIRE_FALSE(has_key("Batched"));
+
+        REQUIRE_THROWS_AS(defaulted.keys(), std::runtime_error);
+    }
+
     SECTION("backup") {}
 
     SECTION("dump") {}
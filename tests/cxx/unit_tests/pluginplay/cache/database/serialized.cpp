@@ -102,3 +102,33 @@ TEMPLATE_LIST_TEST_CASE("Serialized", "", test_types) {
         REQUIRE_FALSE(smap.count(key0));
     }
 }
+
+namespace {
+
+// Native database which also lends out its values' bytes
+struct ViewableNative : Native<std::string, std::string>,
+                        Viewable<std::string> {
+    bool view(const std::string& key, const visitor_type& fxn) const override {
+        ++m_n_views;
+        if(!count(key)) return false;
+        fxn(at(key).get());
+        return true;
+    }
+    mutable std::size_t m_n_views = 0;
+};
+
+} // namespace
+
+TEST_CASE("Serialized : Viewable sub database") {
+    auto pdb    = std::make_unique<ViewableNative>();
+    auto* pview = pdb.get();
+    Serialized<std::string, std::string> smap(std::move(pdb));
+
+    smap.insert("Hello", "World");
+
+    // Values are read through view
+    REQUIRE(smap.at("Hello").get() == "World");
+    REQUIRE(pview->m_n_views == 1);
+
+    REQUIRE_THROWS_AS(smap.at("Not a key"), std::out_of_range);
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../catch.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/database/snapshot.hpp>
+
+using namespace pluginplay::cache::database;
+
+TEST_CASE("Snapshot") {
+    using db_type     = Snapshot;
+    using native_type = Native<std::string, std::string>;
+
+    auto root_dir = std::filesystem::temp_directory_path() / "snapshot_test";
+    std::filesystem::remove_all(root_dir);
+    std::filesystem::create_directories(root_dir);
+    auto path       = (root_dir / "values.snap").string();
+    auto empty_path = (root_dir / "empty.snap").string();
+
+    // Values of many sizes, so some of them cross alignment boundaries
+    native_type values;
+    for(std::size_t i = 0; i < 100; ++i)
+        values.insert("key " + std::to_string(i), std::string(i, 'a' + i % 26));
+    db_type::write(path, values);
+    db_type::write(empty_path, native_type{});
+
+    db_type db(path);
+    db_type empty(empty_path);
+
+    SECTION("CTor") {
+        REQUIRE(db.size() == 100);
+        REQUIRE(empty.size() == 0);
+
+        using e = std::runtime_error;
+        REQUIRE_THROWS_AS(db_type((root_dir / "not_a_file").string()), e);
+
+        auto not_a_snapshot = (root_dir / "not_a_snapshot").string();
+        std::ofstream(not_a_snapshot) << std::string(128, 'x');
+        REQUIRE_THROWS_AS(db_type(not_a_snapshot), e);
+    }
+
+    SECTION("write") {
+        // No temporary files are left behind
+        using dir_itr = std::filesystem::directory_iterator;
+        REQUIRE(std::distance(dir_itr(root_dir), dir_itr{}) == 2);
+
+        // Replacing the file doesn't affect instances which mapped it
+        db_type::write(path, native_type{});
+        REQUIRE(db.count("key 1"));
+        REQUIRE(db_type(path).size() == 0);
+    }
+
+    SECTION("keys") {
+        REQUIRE(db.keys().size() == 100);
+        REQUIRE(empty.keys().empty());
+    }
+
+    SECTION("count") {
+        REQUIRE(db.count("key 0"));
+        REQUIRE(db.count("key 99"));
+        REQUIRE_FALSE(db.count("key 100"));
+        REQUIRE_FALSE(empty.count("key 0"));
+    }
+
+    SECTION("at/try_at") {
+        for(std::size_t i = 0; i < 100; ++i) {
+            auto key = "key " + std::to_string(i);
+            REQUIRE(db.at(key).get() == values.at(key).get());
+            REQUIRE(db.try_at(key).get() == values.at(key).get());
+        }
+        REQUIRE_THROWS_AS(db.at("key 100"), std::out_of_range);
+        REQUIRE_FALSE(db.try_at("key 100").has_value());
+    }
+
+    SECTION("view") {
+        std::string_view value;
+        REQUIRE(db.view("key 42", [&](std::string_view v) { value = v; }));
+        REQUIRE(value == std::string(42, 'a' + 42 % 26));
+
+        // Straight from the mapping, so the value is aligned
+        auto address = reinterpret_cast<std::uintptr_t>(value.data());
+        REQUIRE(address % 64 == 0);
+
+        REQUIRE_FALSE(db.view("key 100", [](std::string_view) {}));
+    }
+
+    SECTION("insert") {
+        db.insert("new key", "new value");
+        REQUIRE(db.at("new key").get() == "new value");
+
+        // Shadows the file
+        db.insert("key 1", "new value");
+        REQUIRE(db.at("key 1").get() == "new value");
+        REQUIRE(db.keys().size() == 101);
+
+        // The file is not modified
+        REQUIRE_FALSE(db_type(path).count("new key"));
+    }
+
+    SECTION("free") {
+        db.free("key 1");
+        REQUIRE_FALSE(db.count("key 1"));
+        REQUIRE(db.keys().size() == 99);
+
+        db.insert("key 1", "new value");
+        REQUIRE(db.at("key 1").get() == "new value");
+
+        // No-op if key DNE
+        db.free("key 100");
+        REQUIRE_FALSE(db.count("key 100"));
+    }
+
+    SECTION("backup/dump") {
+        db.insert("new key", "new value");
+        db.backup();
+        db.dump();
+        REQUIRE(db.count("new key"));
+        REQUIRE(db.count("key 1"));
+    }
+
+    std::filesystem::remove_all(root_dir);
+}
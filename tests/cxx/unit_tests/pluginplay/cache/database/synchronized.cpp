@@ -0,0 +1,155 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_cache.hpp"
+#include <pluginplay/cache/database/bounded.hpp>
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/database/synchronized.hpp>
+#include <thread>
+#include <vector>
+
+using namespace pluginplay::cache::database;
+
+/* Testing Strategy:
+ *
+ * Synchronized forwards every call to the database it wraps, so we test that
+ * it does so faithfully through the DatabaseAPI. We additionally check that
+ * values are returned as copies (so they remain valid after the key is freed)
+ * and hammer a shared instance from several threads to make sure concurrent
+ * reads and writes work.
+ */
+
+TEST_CASE("Synchronized") {
+    using wrapped_type = Native<int, std::string>;
+    using db_type      = Synchronized<int, std::string>;
+    using key_set_type = typename db_type::key_set_type;
+
+    auto pwrapped = std::make_unique<wrapped_type>();
+    auto pnative  = pwrapped.get();
+    db_type db(std::move(pwrapped));
+    db.insert(1, "one");
+
+    SECTION("CTor") {
+        REQUIRE_THROWS_AS(db_type(nullptr), std::runtime_error);
+    }
+
+    SECTION("keys") { REQUIRE(db.keys() == key_set_type{1}); }
+
+    SECTION("count") {
+        REQUIRE(db.count(1));
+        REQUIRE_FALSE(db.count(2));
+    }
+
+    SECTION("insert/at") {
+        REQUIRE(pnative->at(1).get() == "one");
+        db.insert(2, "two");
+        REQUIRE(db.at(2).get() == "two");
+        REQUIRE(pnative->at(2).get() == "two");
+    }
+
+    SECTION("try_insert") {
+        REQUIRE(db.try_insert(1, "uno").get() == "one");
+        REQUIRE(db.try_insert(2, "two").get() == "two");
+        REQUIRE(pnative->at(1).get() == "one");
+        REQUIRE(pnative->at(2).get() == "two");
+    }
+
+    SECTION("Values are copies") {
+        auto value = db.at(1);
+        REQUIRE(&value.get() != &pnative->at(1).get());
+        db.free(1);
+        REQUIRE(value.get() == "one");
+    }
+
+    SECTION("try_at") {
+        REQUIRE(db.try_at(1).get() == "one");
+        REQUIRE_FALSE(db.try_at(2).has_value());
+    }
+
+    SECTION("find_or_compute") {
+        std::size_t n_calls = 0;
+        auto fxn            = [&]() {
+            ++n_calls;
+            return std::string("two");
+        };
+        REQUIRE(db.find_or_compute(1, fxn).get() == "one");
+        REQUIRE(n_calls == 0);
+        REQUIRE(db.find_or_compute(2, fxn).get() == "two");
+        REQUIRE(n_calls == 1);
+        REQUIRE(pnative->at(2).get() == "two");
+    }
+
+    SECTION("free") {
+        db.free(1);
+        REQUIRE_FALSE(db.count(1));
+        REQUIRE_FALSE(pnative->count(1));
+    }
+
+    SECTION("memory_footprint") {
+        // Native doesn't know the size of its entries
+        REQUIRE(db.memory_footprint() == 0);
+
+        auto budget   = std::make_shared<MemoryBudget>();
+        auto size     = [](const std::string& s) { return s.size(); };
+        using bounded = Bounded<int, std::string>;
+        db_type bounded_db(std::make_unique<bounded>(budget, size));
+        bounded_db.insert(1, "one");
+        REQUIRE(bounded_db.memory_footprint() == 3);
+    }
+
+    SECTION("batches") {
+        using counter_type = testing::BatchCounter<int, std::string>;
+        auto counter       = std::make_unique<counter_type>();
+        auto pcounter      = counter.get();
+        db_type batched(std::move(counter));
+        batched.begin_batch();
+        batched.commit_batch();
+        REQUIRE(pcounter->n_begun == 1);
+        REQUIRE(pcounter->n_committed == 1);
+    }
+
+    SECTION("dump") {
+        db.dump();
+        REQUIRE_FALSE(pnative->count(1));
+    }
+
+    SECTION("Concurrent access") {
+        // N.B. keys 100 to 100 + n_keys are computed, larger keys are inserted
+        const int n_threads = 8;
+        const int n_keys    = 200;
+        auto compute        = [](int i) { return std::to_string(i); };
+
+        std::vector<std::thread> threads;
+        for(int t = 0; t < n_threads; ++t) {
+            threads.emplace_back([&, t]() {
+                for(int i = 0; i < n_keys; ++i) {
+                    db.find_or_compute(100 + i, [&]() { return compute(i); });
+                    db.insert(1000 + t, compute(t));
+                    db.try_insert(100 + i, compute(i));
+                    db.count(1);
+                    db.try_at(100 + i);
+                }
+            });
+        }
+        for(auto& thread : threads) thread.join();
+
+        for(int i = 0; i < n_keys; ++i)
+            REQUIRE(db.at(100 + i).get() == compute(i));
+        for(int t = 0; t < n_threads; ++t)
+            REQUIRE(db.at(1000 + t).get() == compute(t));
+        REQUIRE(db.at(1).get() == "one");
+    }
+}
@@ -21,6 +21,25 @@
 
 using namespace pluginplay::cache::database;
 
+namespace {
+
+// A key type whose hashes always collide
+struct CollidingKey {
+    int value = 0;
+    bool operator==(const CollidingKey& rhs) const { return value == rhs.value; }
+};
+
+} // namespace
+
+namespace std {
+
+template<>
+struct hash<CollidingKey> {
+    std::size_t operator()(const CollidingKey&) const noexcept { return 0; }
+};
+
+} // namespace std
+
 using id_pair    = std::pair<int, double>;
 using si_pair    = std::pair<std::string, int>;
 using test_types = std::tuple<id_pair, si_pair>;
@@ -95,3 +114,67 @@ TEMPLATE_LIST_TEST_CASE("Transposer", "", test_types) {
         REQUIRE(pbackup->at(val0).get() == key0);
     }
 }
+
+TEST_CASE("Transposer with colliding hashes") {
+    using key_type        = CollidingKey;
+    using db_type         = Transposer<key_type, std::string>;
+    using wrapped_db_type = Native<std::string, key_type>;
+
+    db_type db(std::make_unique<wrapped_db_type>());
+    key_type key0{0}, key1{1}, key2{2};
+    db.insert(key0, "zero");
+    db.insert(key1, "one");
+
+    SECTION("count") {
+        REQUIRE(db.count(key0));
+        REQUIRE(db.count(key1));
+        REQUIRE_FALSE(db.count(key2));
+    }
+
+    SECTION("at") {
+        REQUIRE(db.at(key0).get() == "zero");
+        REQUIRE(db.at(key1).get() == "one");
+    }
+
+    SECTION("try_at") {
+        REQUIRE(db.try_at(key0).get() == "zero");
+        REQUIRE(db.try_at(key1).get() == "one");
+        REQUIRE_FALSE(db.try_at(key2).has_value());
+    }
+
+    SECTION("free") {
+        db.free(key0);
+        REQUIRE_FALSE(db.count(key0));
+        REQUIRE(db.at(key1).get() == "one");
+    }
+
+    SECTION("Overwrite value of key") {
+        db.insert(key0, "two");
+        REQUIRE(db.at(key0).get() == "two");
+        REQUIRE(db.keys().size() == 2);
+    }
+
+    SECTION("Reuse value") {
+        db.insert(key2, "zero");
+        REQUIRE_FALSE(db.count(key0));
+        REQUIRE(db.at(key2).get() == "zero");
+        REQUIRE(db.keys().size() == 2);
+    }
+
+    SECTION("Entries the wrapped database dropped") {
+        auto wrapped = std::make_shared<wrapped_db_type>();
+        db_type db2(wrapped);
+        db2.insert(key0, "zero");
+        db2.insert(key1, "one");
+
+        // E.g., a Bounded database evicted it
+        wrapped->free("zero");
+        REQUIRE_FALSE(db2.count(key0));
+        REQUIRE_FALSE(db2.try_at(key0).has_value());
+        REQUIRE(db2.keys() == db_type::key_set_type{key1});
+
+        db2.insert(key0, "two");
+        REQUIRE(db2.at(key0).get() == "two");
+        REQUIRE(db2.at(key1).get() == "one");
+    }
+}
@@ -76,6 +76,11 @@ TEMPLATE_LIST_TEST_CASE("TypeEraser", "", test_types) {
         REQUIRE(db.at(key1).get() == value1);
     }
 
+    SECTION("try_at") {
+        REQUIRE(db.try_at(key0).get() == value0);
+        REQUIRE_FALSE(db.try_at(key1).has_value());
+    }
+
     SECTION("free") {
         db.free(key0);
         REQUIRE_FALSE(db.count(key0));
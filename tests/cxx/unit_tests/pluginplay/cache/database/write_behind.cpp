@@ -0,0 +1,192 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_cache.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/database/write_behind.hpp>
+
+using namespace pluginplay::cache::database;
+
+/* Testing Strategy:
+ *
+ * WriteBehind is tested through the DatabaseAPI with a Native database as the
+ * wrapped database. The wrapped database is only inspected after a durability
+ * point (flush, backup, dump, or the dtor). To control when the background
+ * thread gets to write, the wrapped database's writes wait on a "gate", which
+ * also records what was written so it can be inspected after the wrapped
+ * database is gone. For simplicity, the size of a value is its length.
+ */
+
+namespace {
+
+// Shared by the test and a GatedNative; writes wait while the gate is closed
+struct Gate {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool open = true;
+    std::map<int, std::string> written;
+
+    void set_open(bool is_open) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            open = is_open;
+        }
+        cv.notify_all();
+    }
+};
+
+struct GatedNative : Native<int, std::string> {
+    explicit GatedNative(std::shared_ptr<Gate> g) : gate(std::move(g)) {}
+
+    void insert_(int key, std::string value) override {
+        {
+            std::unique_lock<std::mutex> lock(gate->mutex);
+            gate->cv.wait(lock, [this]() { return gate->open; });
+            gate->written[key] = value;
+        }
+        Native<int, std::string>::insert_(key, std::move(value));
+    }
+
+    std::shared_ptr<Gate> gate;
+};
+
+} // namespace
+
+TEST_CASE("WriteBehind") {
+    using db_type      = WriteBehind<int, std::string>;
+    using key_set_type = typename db_type::key_set_type;
+
+    auto size = [](const std::string& s) { return s.size(); };
+    auto gate = std::make_shared<Gate>();
+
+    auto pwrapped = std::make_unique<GatedNative>(gate);
+    auto pnative  = pwrapped.get();
+    db_type db(std::move(pwrapped), 8, size);
+    db.insert(1, "one");
+
+    SECTION("CTor") {
+        using e = std::runtime_error;
+        REQUIRE_THROWS_AS(db_type(nullptr, 5, size), e);
+        auto pdb = std::make_unique<Native<int, std::string>>();
+        REQUIRE_THROWS_AS(db_type(std::move(pdb), 5, nullptr), e);
+    }
+
+    SECTION("keys") {
+        db.insert(2, "two");
+        REQUIRE(db.keys() == key_set_type{1, 2});
+    }
+
+    SECTION("insert/count/at/try_at") {
+        REQUIRE(db.count(1));
+        REQUIRE_FALSE(db.count(2));
+        REQUIRE(db.at(1).get() == "one");
+        REQUIRE(db.try_at(1).get() == "one");
+        REQUIRE_FALSE(db.try_at(2).has_value());
+        REQUIRE_THROWS_AS(db.at(2), std::out_of_range);
+
+        db.flush();
+        REQUIRE(pnative->at(1).get() == "one");
+        REQUIRE(db.pending_bytes() == 0);
+        REQUIRE(db.at(1).get() == "one");
+    }
+
+    SECTION("Queued values are visible right away") {
+        db.flush();
+        gate->set_open(false);
+        db.insert(2, "two");
+        REQUIRE(db.at(2).get() == "two");
+
+        // Newer values replace queued values
+        db.insert(2, "dos");
+        REQUIRE(db.at(2).get() == "dos");
+        gate->set_open(true);
+
+        db.flush();
+        REQUIRE(pnative->at(2).get() == "dos");
+        REQUIRE(gate->written.at(2) == "dos");
+    }
+
+    SECTION("free") {
+        db.free(1);
+        REQUIRE_FALSE(db.count(1));
+        REQUIRE_FALSE(db.try_at(1).has_value());
+        db.flush();
+        REQUIRE_FALSE(pnative->count(1));
+
+        // No-op if key DNE
+        db.free(2);
+        db.flush();
+        REQUIRE_FALSE(db.count(2));
+    }
+
+    SECTION("Back-pressure") {
+        db.flush();
+        gate->set_open(false);
+        db.insert(2, "two");
+        REQUIRE(db.pending_bytes() == 3);
+
+        // "eleven" does not fit, so inserting it waits for the writer
+        auto insert    = [&db]() { db.insert(3, "eleven"); };
+        auto inserting = std::async(std::launch::async, insert);
+        auto status = inserting.wait_for(std::chrono::milliseconds(50));
+        REQUIRE(status == std::future_status::timeout);
+
+        gate->set_open(true);
+        inserting.get();
+        db.flush();
+        REQUIRE(pnative->at(2).get() == "two");
+        REQUIRE(pnative->at(3).get() == "eleven");
+    }
+
+    SECTION("Errors are rethrown by flush") {
+        using counter_type = testing::BatchCounter<int, std::string>;
+        auto counter       = std::make_unique<counter_type>();
+
+        counter->throw_on_commit = true;
+        db_type failing(std::move(counter), 5, size);
+
+        failing.insert(1, "one");
+        REQUIRE_THROWS_AS(failing.flush(), std::runtime_error);
+        REQUIRE_NOTHROW(failing.flush());
+    }
+
+    SECTION("backup") {
+        db.backup();
+        REQUIRE(pnative->at(1).get() == "one");
+        REQUIRE(db.at(1).get() == "one");
+    }
+
+    SECTION("dump") {
+        // The value is written before the wrapped database dumps it
+        db.dump();
+        REQUIRE(gate->written.at(1) == "one");
+        REQUIRE_FALSE(pnative->count(1));
+    }
+
+    SECTION("DTor writes queued values") {
+        {
+            auto ptemp = std::make_unique<GatedNative>(gate);
+            db_type temp(std::move(ptemp), 5, size);
+            temp.insert(4, "four");
+        }
+        REQUIRE(gate->written.at(4) == "four");
+    }
+}
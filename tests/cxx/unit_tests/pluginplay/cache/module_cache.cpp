@@ -16,8 +16,14 @@
 
 #include "../catch.hpp"
 #include "test_cache.hpp"
+#include <pluginplay/cache/database/footprint.hpp>
 #include <pluginplay/cache/module_cache.hpp>
 #include <pluginplay/cache/module_manager_cache.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
 
 using namespace pluginplay::cache;
 
@@ -96,6 +102,140 @@ TEMPLATE_LIST_TEST_CASE("ModuleCache", "", testing::test_types) {
         REQUIRE(mod_cache->uncache(inputs1) == results0);
     }
 
+    SECTION("try_get") {
+        REQUIRE_FALSE(default_mod_cache.try_get(inputs0).has_value());
+
+        REQUIRE(mod_cache->try_get(inputs0) == results0);
+        REQUIRE_FALSE(mod_cache->try_get(inputs1).has_value());
+    }
+
+    SECTION("find_or_compute") {
+        std::size_t n_calls = 0;
+        auto fxn            = [&]() {
+            ++n_calls;
+            return results1;
+        };
+
+        using e0 = std::runtime_error;
+        REQUIRE_THROWS_AS(default_mod_cache.find_or_compute(inputs0, fxn), e0);
+
+        // Hit, doesn't call fxn
+        REQUIRE(mod_cache->find_or_compute(inputs0, fxn) == results0);
+        REQUIRE(n_calls == 0);
+
+        // Miss, calls fxn and caches the result
+        REQUIRE(mod_cache->find_or_compute(inputs1, fxn) == results1);
+        REQUIRE(n_calls == 1);
+        REQUIRE(mod_cache->uncache(inputs1) == results1);
+
+        // Now it's a hit
+        REQUIRE(mod_cache->find_or_compute(inputs1, fxn) == results1);
+        REQUIRE(n_calls == 1);
+
+        // Throwing doesn't cache anything, and the next call tries again
+        auto bad = [&]() -> val_type { throw std::runtime_error("bad"); };
+        mod_cache->clear();
+        REQUIRE_THROWS_AS(mod_cache->find_or_compute(inputs1, bad), e0);
+        REQUIRE_FALSE(mod_cache->count(inputs1));
+        REQUIRE(mod_cache->find_or_compute(inputs1, fxn) == results1);
+        REQUIRE(n_calls == 2);
+    }
+
+    SECTION("metrics") {
+        auto fxn = [&]() { return results1; };
+
+        auto m = default_mod_cache.metrics();
+        REQUIRE(m.n_hits == 0);
+        REQUIRE(m.n_computed == 0);
+        REQUIRE(m.n_coalesced == 0);
+
+        mod_cache->find_or_compute(inputs0, fxn);
+        mod_cache->find_or_compute(inputs1, fxn);
+        mod_cache->find_or_compute(inputs1, fxn);
+        m = mod_cache->metrics();
+        REQUIRE(m.n_hits == 2);
+        REQUIRE(m.n_misses == 1);
+        REQUIRE(m.n_computed == 1);
+        REQUIRE(m.n_coalesced == 0);
+
+        // results0 was inserted with cache, results1 by find_or_compute
+        using database::result_map_footprint;
+        REQUIRE(m.n_inserts == 2);
+        REQUIRE(m.bytes_inserted ==
+                result_map_footprint(results0) + result_map_footprint(results1));
+
+        // Every look up proxies the inputs and then hits the backend
+        REQUIRE(m.lookup_latency.count() == 3);
+        REQUIRE(m.proxy_latency.count() >= 3);
+        REQUIRE(m.backend_latency.count() >= 3);
+        REQUIRE(m.proxy_time > ModuleCache::duration_type{0});
+        REQUIRE(m.backend_time > ModuleCache::duration_type{0});
+
+        // Not reset by clear
+        mod_cache->clear();
+        REQUIRE(mod_cache->metrics().n_hits == 2);
+    }
+
+    SECTION("find_or_compute proxies the inputs once") {
+        auto fxn       = [&]() { return results1; };
+        auto n_proxied = [&]() {
+            return mod_cache->metrics().proxy_latency.count();
+        };
+        const auto n0 = n_proxied();
+
+        // A hit looks the proxies up
+        mod_cache->find_or_compute(inputs0, fxn);
+        REQUIRE(n_proxied() == n0 + 1);
+
+        // A miss looks them up and then assigns them
+        mod_cache->find_or_compute(inputs1, fxn);
+        REQUIRE(n_proxied() == n0 + 3);
+
+        // Inputs with proxies reuse them for the insert
+        mod_cache->clear();
+        mod_cache->find_or_compute(inputs1, fxn);
+        REQUIRE(n_proxied() == n0 + 5);
+        REQUIRE(mod_cache->find_or_compute(inputs1, fxn) == results1);
+    }
+
+    SECTION("metrics of a failed computation") {
+        auto bad = [&]() -> val_type { throw std::runtime_error("bad"); };
+        REQUIRE_THROWS(mod_cache->find_or_compute(inputs1, bad));
+        auto m = mod_cache->metrics();
+        REQUIRE(m.n_misses == 1);
+        REQUIRE(m.n_computed == 0);
+        REQUIRE(m.n_inserts == 1);
+    }
+
+    SECTION("memory_footprint") {
+        REQUIRE(default_mod_cache.memory_footprint() == 0);
+
+        const auto one_result = mod_cache->memory_footprint();
+        REQUIRE(one_result > 0);
+
+        mod_cache->cache(inputs1, results1);
+        REQUIRE(mod_cache->memory_footprint() > one_result);
+
+        mod_cache->clear();
+        REQUIRE(mod_cache->memory_footprint() == 0);
+    }
+
+    SECTION("set_persistent/is_persistent") {
+        REQUIRE_FALSE(default_mod_cache.is_persistent());
+        default_mod_cache.set_persistent(true);
+        REQUIRE_FALSE(default_mod_cache.is_persistent());
+
+        REQUIRE(mod_cache->is_persistent());
+        mod_cache->set_persistent(false);
+        REQUIRE_FALSE(mod_cache->is_persistent());
+
+        // Results are still cached, just not written to long-term storage
+        mod_cache->cache(inputs1, results1);
+        REQUIRE(mod_cache->uncache(inputs1) == results1);
+        mod_cache->set_persistent(true);
+        REQUIRE(mod_cache->is_persistent());
+    }
+
     SECTION("clear") {
         default_mod_cache.clear();
         REQUIRE_FALSE(default_mod_cache.count(inputs0));
@@ -106,3 +246,246 @@ TEMPLATE_LIST_TEST_CASE("ModuleCache", "", testing::test_types) {
         REQUIRE_FALSE(mod_cache->count(inputs1));
     }
 }
+
+/* This is a stress test of the cache stack. Several threads share a
+ * ModuleManagerCache (and thus the UUID database) and memoize into both a
+ * shared ModuleCache and one ModuleCache per thread. Each "call" maps the input
+ * i to the result i + 1, so any corruption shows up as a wrong result.
+ */
+TEST_CASE("ModuleCache : concurrent access") {
+    using key_type    = ModuleCache::key_type;
+    using input_type  = key_type::mapped_type;
+    using val_type    = ModuleCache::mapped_type;
+    using result_type = val_type::mapped_type;
+
+    auto make_inputs = [](int i) {
+        input_type input;
+        input.set_type<int>().change(i);
+        return key_type{{"i", input}};
+    };
+
+    auto make_results = [](int i) {
+        result_type result;
+        result.set_type<int>();
+        result.change(i + 1);
+        return val_type{{"i + 1", result}};
+    };
+
+    const int n_threads = 8;
+    const int n_inputs  = 50;
+
+    ModuleManagerCache cache;
+    auto shared = cache.get_or_make_module_cache("shared");
+
+    // Pre-populate half of the inputs so we have hits from the start
+    for(int i = 0; i < n_inputs; i += 2)
+        shared->cache(make_inputs(i), make_results(i));
+
+    std::vector<std::thread> threads;
+    std::vector<int> n_wrong(n_threads, 0);
+    for(int t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            auto mine = cache.get_or_make_module_cache(std::to_string(t));
+            for(int rep = 0; rep < 4; ++rep) {
+                for(int i = 0; i < n_inputs; ++i) {
+                    auto inputs = make_inputs(i);
+                    auto fxn    = [&]() { return make_results(i); };
+                    auto corr   = make_results(i);
+                    auto rv0    = shared->find_or_compute(inputs, fxn);
+                    auto rv1    = mine->find_or_compute(inputs, fxn);
+                    auto rv2    = shared->try_get(inputs);
+                    if(rv0 != corr || rv1 != corr) ++n_wrong[t];
+                    if(!rv2 || *rv2 != corr) ++n_wrong[t];
+                }
+            }
+        });
+    }
+    for(auto& thread : threads) thread.join();
+
+    for(int t = 0; t < n_threads; ++t) REQUIRE(n_wrong[t] == 0);
+    for(int i = 0; i < n_inputs; ++i)
+        REQUIRE(shared->uncache(make_inputs(i)) == make_results(i));
+}
+
+/* Many threads ask for the same inputs while the first caller is still
+ * computing them. The first caller blocks until every other thread has at
+ * least started its call, so either a thread finds the results cached or it
+ * coalesces with the first caller; in no case may fxn run twice.
+ */
+TEST_CASE("ModuleCache : single-flight") {
+    using key_type    = ModuleCache::key_type;
+    using input_type  = key_type::mapped_type;
+    using val_type    = ModuleCache::mapped_type;
+    using result_type = val_type::mapped_type;
+
+    input_type input;
+    input.set_type<int>().change(1);
+    key_type inputs{{"i", input}};
+
+    result_type result;
+    result.set_type<int>();
+    result.change(2);
+    val_type results{{"i + 1", result}};
+
+    ModuleManagerCache cache;
+    auto mod_cache = cache.get_or_make_module_cache("single-flight");
+
+    SECTION("Concurrent callers") {
+        const std::size_t n_threads = 8;
+        std::atomic<std::size_t> n_calls{0};
+        std::atomic<std::size_t> n_started{0};
+        auto fxn = [&]() {
+            ++n_calls;
+            while(n_started < n_threads) std::this_thread::yield();
+            return results;
+        };
+
+        std::vector<std::thread> threads;
+        std::vector<val_type> rvs(n_threads);
+        for(std::size_t t = 0; t < n_threads; ++t) {
+            threads.emplace_back([&, t]() {
+                // Make sure the first thread is the one that computes
+                if(t > 0)
+                    while(n_calls == 0) std::this_thread::yield();
+                ++n_started;
+                rvs[t] = mod_cache->find_or_compute(inputs, fxn);
+            });
+        }
+        for(auto& thread : threads) thread.join();
+
+        REQUIRE(n_calls == 1);
+        for(const auto& rv : rvs) REQUIRE(rv == results);
+
+        auto m = mod_cache->metrics();
+        REQUIRE(m.n_computed == 1);
+        REQUIRE(m.n_hits + m.n_coalesced == n_threads - 1);
+    }
+
+    SECTION("Followers get the leader's exception") {
+        std::atomic<bool> leader_started{false};
+        std::atomic<bool> follower_started{false};
+        auto bad = [&]() -> val_type {
+            leader_started = true;
+            while(!follower_started) std::this_thread::yield();
+            // Give the follower a chance to find the flight
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            throw std::runtime_error("bad");
+        };
+
+        bool leader_threw = false;
+        std::thread leader([&]() {
+            try {
+                mod_cache->find_or_compute(inputs, bad);
+            } catch(const std::runtime_error&) { leader_threw = true; }
+        });
+
+        // The follower either coalesces (and throws) or arrives after the
+        // leader landed (and computes), it never sees a cached result
+        bool follower_threw = false;
+        val_type follower_rv;
+        std::thread follower([&]() {
+            while(!leader_started) std::this_thread::yield();
+            follower_started = true;
+            try {
+                follower_rv = mod_cache->find_or_compute(inputs, [&]() {
+                    return results;
+                });
+            } catch(const std::runtime_error&) { follower_threw = true; }
+        });
+        leader.join();
+        follower.join();
+
+        REQUIRE(leader_threw);
+        REQUIRE((follower_threw || follower_rv == results));
+        auto m = mod_cache->metrics();
+        REQUIRE(m.n_hits == 0);
+        REQUIRE(m.n_coalesced + m.n_computed == 1);
+    }
+
+    SECTION("Recursive call on the same thread does not deadlock") {
+        std::size_t depth = 0;
+        std::function<val_type()> fxn = [&]() {
+            if(++depth < 3) return mod_cache->find_or_compute(inputs, fxn);
+            return results;
+        };
+        REQUIRE(mod_cache->find_or_compute(inputs, fxn) == results);
+        REQUIRE(depth == 3);
+        REQUIRE(mod_cache->metrics().n_coalesced == 0);
+    }
+
+    /* Thread A computes k1 and, while doing so, asks for k2, which thread B
+     * is computing. B is not waiting on A, so A waits for B's results
+     * instead of computing k2 again.
+     */
+    SECTION("Leaders wait on leaders which don't wait on them") {
+        input_type input2;
+        input2.set_type<int>().change(2);
+        key_type inputs2{{"i", input2}};
+
+        std::atomic<std::size_t> n_calls{0};
+        std::atomic<bool> b_leads{false};
+        std::atomic<bool> a_leads{false};
+        auto slow = [&]() {
+            ++n_calls;
+            b_leads = true;
+            while(!a_leads) std::this_thread::yield();
+            // Give A a chance to find B's flight
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            return results;
+        };
+
+        val_type rv1, rv2;
+        std::thread b(
+          [&]() { rv2 = mod_cache->find_or_compute(inputs2, slow); });
+        std::thread a([&]() {
+            while(!b_leads) std::this_thread::yield();
+            rv1 = mod_cache->find_or_compute(inputs, [&]() {
+                a_leads = true;
+                return mod_cache->find_or_compute(inputs2, slow);
+            });
+        });
+        a.join();
+        b.join();
+
+        REQUIRE(rv1 == results);
+        REQUIRE(rv2 == results);
+        REQUIRE(n_calls == 1);
+        REQUIRE(mod_cache->metrics().n_coalesced == 1);
+    }
+
+    /* Thread A computes k1 and, while doing so, asks for k2 (e.g., because
+     * waiting on a TaskFuture ran an unrelated task on A's stack). Thread B
+     * computes k2 and, while doing so, asks for k1. If both waited on the
+     * other, neither would ever finish. At most one of them waits; the other
+     * sees that and computes the inputs it asked for itself.
+     */
+    SECTION("Cross dependency between two threads does not deadlock") {
+        input_type input2;
+        input2.set_type<int>().change(2);
+        key_type inputs2{{"i", input2}};
+
+        std::atomic<std::size_t> n_started{0};
+        auto fxn = [&](const key_type& other) {
+            ++n_started;
+            while(n_started < 2) std::this_thread::yield();
+            mod_cache->find_or_compute(other, [&]() { return results; });
+            return results;
+        };
+
+        val_type rv1, rv2;
+        std::thread a([&]() {
+            rv1 = mod_cache->find_or_compute(inputs,
+                                             [&]() { return fxn(inputs2); });
+        });
+        std::thread b([&]() {
+            rv2 = mod_cache->find_or_compute(inputs2,
+                                             [&]() { return fxn(inputs); });
+        });
+        a.join();
+        b.join();
+
+        REQUIRE(rv1 == results);
+        REQUIRE(rv2 == results);
+        REQUIRE(mod_cache->metrics().n_coalesced <= 1);
+    }
+}
@@ -15,9 +15,17 @@
  */
 
 #include "../catch.hpp"
+#include <cstdlib>
 #include <filesystem>
+#include <pluginplay/cache/database/native.hpp>
+#include <pluginplay/cache/database/snapshot.hpp>
+#include <pluginplay/cache/module_cache.hpp>
 #include <pluginplay/cache/module_manager_cache.hpp>
 #include <pluginplay/config/config.hpp>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 using namespace pluginplay::cache;
 
 /* Testing Strategy:
@@ -28,6 +36,29 @@ using namespace pluginplay::cache;
  * that the ModuleCache and UserCache instances work as intended.
  */
 
+namespace {
+
+using key_type    = ModuleCache::key_type;
+using val_type    = ModuleCache::mapped_type;
+using result_type = val_type::mapped_type;
+
+// The inputs {"i" : i}
+key_type make_inputs(int i) {
+    key_type::mapped_type input;
+    input.set_type<int>().change(i);
+    return key_type{{"i", input}};
+}
+
+// The results {"i + 1" : i + 1}
+val_type make_results(int i) {
+    result_type result;
+    result.set_type<int>();
+    result.change(i + 1);
+    return val_type{{"i + 1", result}};
+}
+
+} // namespace
+
 TEST_CASE("ModuleManagerCache") {
     auto root_dir   = std::filesystem::temp_directory_path();
     auto cache_dir  = std::filesystem::path("mmcache_test");
@@ -54,6 +85,87 @@ TEST_CASE("ModuleManagerCache") {
         }
     }
 
+    SECTION("Path CTor with RocksDB options") {
+        if(std::filesystem::exists(cache_path))
+            std::filesystem::remove_all(cache_path);
+
+        using options_type = ModuleManagerCache::rocksdb_options;
+        options_type options;
+        options.block_cache_size = 1024 * 1024;
+        options.compression      = options_type::Compression::lz4;
+
+        if(pluginplay::with_rocksdb()) {
+            ModuleManagerCache disk(cache_path, options);
+            REQUIRE(std::filesystem::exists(cache_path));
+            REQUIRE(disk.get_or_make_module_cache("foo") != nullptr);
+        } else {
+            using e = std::runtime_error;
+            REQUIRE_THROWS_AS(ModuleManagerCache(cache_path, options), e);
+        }
+    }
+
+    SECTION("Path CTor shared by several instances") {
+        if(std::filesystem::exists(cache_path))
+            std::filesystem::remove_all(cache_path);
+
+        ModuleManagerCache::rocksdb_options options;
+        options.shared = true;
+
+        if(pluginplay::with_rocksdb()) {
+            // N.B. Without the shared option the second instance can't lock
+            //      the databases
+            ModuleManagerCache disk(cache_path, options);
+            ModuleManagerCache other(cache_path, options);
+            REQUIRE(disk.get_or_make_module_cache("foo") != nullptr);
+            REQUIRE(other.get_or_make_module_cache("foo") != nullptr);
+            REQUIRE(std::filesystem::exists(cache_path / "cache" / "writer-1"));
+            REQUIRE(std::filesystem::exists(cache_path / "uuid" / "writer-1"));
+
+            // Processes sharing the cache must agree on the keys
+            using e = std::runtime_error;
+            REQUIRE_THROWS_AS(disk.set_content_addressed_keys(false), e);
+        } else {
+            using e = std::runtime_error;
+            REQUIRE_THROWS_AS(ModuleManagerCache(cache_path, options), e);
+        }
+    }
+
+    SECTION("Path CTor shared by several processes") {
+        if(pluginplay::with_rocksdb()) {
+            std::filesystem::remove_all(cache_path);
+            ModuleManagerCache::rocksdb_options options;
+            options.shared          = true;
+            options.peer_refresh_ms = 0;
+
+            // Opened first, so the other process has to write elsewhere
+            ModuleManagerCache disk(cache_path, options);
+            auto pcache = disk.get_or_make_module_cache("foo");
+
+            // Runs the hidden test case below in another process
+            setenv("PLUGINPLAY_SHARED_CACHE", cache_path.c_str(), 1);
+            auto pid = fork();
+            REQUIRE(pid >= 0);
+            if(pid == 0) {
+                execl("/proc/self/exe", "/proc/self/exe",
+                      "ModuleManagerCache shared writer", nullptr);
+                _exit(EXIT_FAILURE);
+            }
+            unsetenv("PLUGINPLAY_SHARED_CACHE");
+            int status = 0;
+            REQUIRE(waitpid(pid, &status, 0) == pid);
+            REQUIRE(WIFEXITED(status));
+            REQUIRE(WEXITSTATUS(status) == EXIT_SUCCESS);
+
+            // We get the other process's result, without computing it
+            auto fxn = []() -> val_type {
+                throw std::runtime_error("Should have been a hit");
+            };
+            REQUIRE(pcache->find_or_compute(make_inputs(1), fxn) ==
+                    make_results(1));
+            REQUIRE_FALSE(pcache->count(make_inputs(2)));
+        }
+    }
+
     SECTION("change_save_location") {
         if(std::filesystem::exists(cache_path))
             std::filesystem::remove_all(cache_path);
@@ -78,6 +190,200 @@ TEST_CASE("ModuleManagerCache") {
         }
     }
 
+    SECTION("set_memory_budget/memory_in_use") {
+        using key_type    = ModuleCache::key_type;
+        using val_type    = ModuleCache::mapped_type;
+        using result_type = val_type::mapped_type;
+
+        auto make_inputs = [](int i) {
+            key_type::mapped_type input;
+            input.set_type<int>().change(i);
+            return key_type{{"i", input}};
+        };
+        result_type result;
+        result.set_type<int>();
+        result.change(1);
+        val_type results{{"r", result}};
+
+        REQUIRE(ModuleManagerCache{}.memory_in_use() == 0);
+
+        auto pcache = memory_only.get_or_make_module_cache("hello");
+        pcache->cache(make_inputs(0), results);
+        const auto one_result = memory_only.memory_in_use();
+        REQUIRE(one_result > 0);
+
+        // Budget for two results, the oldest result gets evicted
+        memory_only.set_memory_budget(2 * one_result);
+        pcache->cache(make_inputs(1), results);
+        REQUIRE(memory_only.memory_in_use() == 2 * one_result);
+
+        // Budget applies across module caches
+        auto pcache2 = memory_only.get_or_make_module_cache("world");
+        pcache2->cache(make_inputs(2), results);
+        REQUIRE(memory_only.memory_in_use() == 2 * one_result);
+        REQUIRE_FALSE(pcache->count(make_inputs(0)));
+        REQUIRE(pcache->count(make_inputs(1)));
+        REQUIRE(pcache2->count(make_inputs(2)));
+
+        // Removing the limit stops evictions
+        memory_only.set_memory_budget(0, EvictionPolicy::cost_aware);
+        pcache->cache(make_inputs(3), results);
+        REQUIRE(pcache->count(make_inputs(1)));
+        REQUIRE(memory_only.memory_in_use() == 3 * one_result);
+    }
+
+    SECTION("memory_footprint") {
+        using key_type    = ModuleCache::key_type;
+        using val_type    = ModuleCache::mapped_type;
+        using result_type = val_type::mapped_type;
+
+        key_type::mapped_type input;
+        input.set_type<int>().change(1);
+        result_type result;
+        result.set_type<std::vector<double>>();
+        result.change(std::vector<double>(100, 1.0));
+
+        // Doesn't make the cache
+        REQUIRE(ModuleManagerCache{}.memory_footprint("hello") == 0);
+        REQUIRE(memory_only.memory_footprint("hello") == 0);
+
+        auto pcache = memory_only.get_or_make_module_cache("hello");
+        REQUIRE(memory_only.memory_footprint("hello") == 0);
+        pcache->cache(key_type{{"i", input}}, val_type{{"r", result}});
+
+        const auto footprint = memory_only.memory_footprint("hello");
+        REQUIRE(footprint == pcache->memory_footprint());
+        REQUIRE(footprint > 100 * sizeof(double));
+        REQUIRE(memory_only.memory_footprint("world") == 0);
+    }
+
+    SECTION("set_content_addressed_keys") {
+        using key_type    = ModuleCache::key_type;
+        using val_type    = ModuleCache::mapped_type;
+        using result_type = val_type::mapped_type;
+
+        auto make_inputs = [](std::string s) {
+            key_type::mapped_type input;
+            input.set_type<std::string>().change(std::move(s));
+            return key_type{{"s", input}};
+        };
+        result_type result;
+        result.set_type<int>();
+        result.change(1);
+        val_type results{{"r", result}};
+
+        memory_only.set_content_addressed_keys();
+        auto pcache = memory_only.get_or_make_module_cache("hello");
+        pcache->cache(make_inputs("Hello"), results);
+        REQUIRE(pcache->count(make_inputs("Hello")));
+        REQUIRE_FALSE(pcache->count(make_inputs("World")));
+        REQUIRE(pcache->uncache(make_inputs("Hello")) == results);
+    }
+
+    SECTION("backup") {
+        // Purely in memory, so there's nothing to write
+        memory_only.get_or_make_module_cache("hello");
+        memory_only.backup();
+
+        if(pluginplay::with_rocksdb()) {
+            using key_type    = ModuleCache::key_type;
+            using val_type    = ModuleCache::mapped_type;
+            using result_type = val_type::mapped_type;
+
+            key_type::mapped_type input;
+            input.set_type<int>().change(1);
+            result_type result;
+            result.set_type<int>();
+            result.change(2);
+            key_type inputs{{"i", input}};
+            val_type results{{"r", result}};
+
+            // Results are written in the background
+            ModuleManagerCache::rocksdb_options options;
+            options.write_behind_limit = 1024;
+            std::filesystem::remove_all(cache_path);
+            ModuleManagerCache disk(cache_path, options);
+            auto pcache = disk.get_or_make_module_cache("hello");
+            pcache->cache(inputs, results);
+            REQUIRE(pcache->count(inputs));
+            disk.backup();
+            REQUIRE(pcache->count(inputs));
+        }
+    }
+
+    SECTION("export_snapshot/open_snapshot") {
+        auto snapshot_path = root_dir / "mmcache_snapshot_test";
+        std::filesystem::remove_all(snapshot_path);
+
+        // Purely in memory, so there's nothing to export
+        using e = std::runtime_error;
+        REQUIRE_THROWS_AS(memory_only.export_snapshot(snapshot_path), e);
+        REQUIRE_THROWS_AS(memory_only.open_snapshot(snapshot_path), e);
+
+        // Snapshots of caches with random keys could never be hit
+        if(pluginplay::with_rocksdb()) {
+            std::filesystem::remove_all(cache_path);
+            ModuleManagerCache disk(cache_path);
+            disk.get_or_make_module_cache("hello")->cache(make_inputs(1),
+                                                          make_results(1));
+            REQUIRE_THROWS_AS(disk.export_snapshot(snapshot_path), e);
+        }
+
+        // Start from an empty snapshot, so the writer needs no RocksDB
+        auto empty_path = root_dir / "mmcache_empty_snapshot_test";
+        std::filesystem::remove_all(empty_path);
+        std::filesystem::create_directories(empty_path);
+        using native_type = database::Native<std::string, std::string>;
+        for(auto name : {"cache.snap", "uuid.snap"})
+            database::Snapshot::write((empty_path / name).string(),
+                                      native_type{});
+
+        ModuleManagerCache writer;
+        writer.open_snapshot(empty_path);
+        auto compute = []() { return make_results(1); };
+        writer.get_or_make_module_cache("hello")->find_or_compute(
+          make_inputs(1), compute);
+        writer.get_or_make_module_cache("world")->cache(make_inputs(2),
+                                                        make_results(2));
+
+        // Opening the snapshot requires content-addressed keys
+        REQUIRE_THROWS_AS(writer.set_content_addressed_keys(false), e);
+
+        auto fxn = []() -> val_type {
+            throw std::runtime_error("Should have been a hit");
+        };
+
+        SECTION("Everything") {
+            writer.export_snapshot(snapshot_path);
+            REQUIRE(std::filesystem::exists(snapshot_path / "cache.snap"));
+            REQUIRE(std::filesystem::exists(snapshot_path / "uuid.snap"));
+
+            ModuleManagerCache reader;
+            reader.open_snapshot(snapshot_path);
+            auto phello = reader.get_or_make_module_cache("hello");
+            auto pworld = reader.get_or_make_module_cache("world");
+            REQUIRE(phello->find_or_compute(make_inputs(1), fxn) ==
+                    make_results(1));
+            REQUIRE(pworld->find_or_compute(make_inputs(2), fxn) ==
+                    make_results(2));
+            REQUIRE_FALSE(phello->count(make_inputs(2)));
+        }
+
+        SECTION("One module") {
+            writer.export_snapshot(snapshot_path, "hello");
+
+            ModuleManagerCache reader;
+            reader.open_snapshot(snapshot_path);
+            auto phello = reader.get_or_make_module_cache("hello");
+            auto pworld = reader.get_or_make_module_cache("world");
+            REQUIRE(phello->find_or_compute(make_inputs(1), fxn) ==
+                    make_results(1));
+            REQUIRE_FALSE(pworld->count(make_inputs(2)));
+        }
+        std::filesystem::remove_all(empty_path);
+        std::filesystem::remove_all(snapshot_path);
+    }
+
     SECTION("get_or_make_module_cache") {
         auto pcache = memory_only.get_or_make_module_cache("hello");
 
@@ -102,3 +408,44 @@ TEST_CASE("ModuleManagerCache") {
         REQUIRE(pcache.get() == pcache2.get());
     }
 }
+
+/* Hidden test case, run by the "Path CTor shared by several processes" section
+ * in a separate process. Caches a result in the shared cache from the
+ * environment.
+ */
+TEST_CASE("ModuleManagerCache shared writer", "[.]") {
+    const char* path = std::getenv("PLUGINPLAY_SHARED_CACHE");
+    if(path == nullptr) return;
+
+    ModuleManagerCache::rocksdb_options options;
+    options.shared = true;
+    ModuleManagerCache disk(path, options);
+    disk.get_or_make_module_cache("foo")->cache(make_inputs(1),
+                                                make_results(1));
+    disk.backup();
+}
+
+TEST_CASE("ModuleManagerCache : concurrent access") {
+    ModuleManagerCache cache;
+
+    const std::size_t n_threads = 8;
+    using pointer_type = ModuleManagerCache::module_cache_pointer;
+    std::vector<pointer_type> mod_caches(n_threads);
+    std::vector<ModuleManagerCache::user_cache_pointer> user_caches(n_threads);
+
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            mod_caches[t]  = cache.get_or_make_module_cache("shared");
+            user_caches[t] = cache.get_or_make_user_cache("shared");
+            cache.get_or_make_module_cache(std::to_string(t));
+        });
+    }
+    for(auto& thread : threads) thread.join();
+
+    // Every thread got the same cache
+    for(std::size_t t = 0; t < n_threads; ++t) {
+        REQUIRE(mod_caches[t].get() == mod_caches[0].get());
+        REQUIRE(user_caches[t].get() == user_caches[0].get());
+    }
+}
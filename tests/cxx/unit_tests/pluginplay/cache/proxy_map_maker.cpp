@@ -55,13 +55,50 @@ TEMPLATE_LIST_TEST_CASE("ProxyMapMaker", "", testing::test_types) {
         REQUIRE(psub->at(default_value).get() == uuid);
         REQUIRE(db.at(key0) == value0);
 
-        db.insert(key1);
+        auto proxy = db.insert(key1);
         REQUIRE(db.count(key1));
         value_type value1{{"hello", psub->at(other_value).get()}};
         REQUIRE(db.at(key1) == value1);
+        REQUIRE(proxy == value1);
+
+        // Inserting again doesn't assign new proxies
+        REQUIRE(db.insert(key1) == value1);
+    }
+
+    SECTION("insert (with a proxy)") {
+        // The proxy is recorded, key1's values aren't looked up
+        value_type proxy1{{"hello", uuid}};
+        REQUIRE(db.insert(key1, proxy1) == proxy1);
+        REQUIRE_FALSE(psub->count(other_value));
+        REQUIRE(db.un_proxy(proxy1) == key1);
     }
 
-    SECTION("un_proxy") { REQUIRE(db.un_proxy(value0) == key0); }
+    SECTION("try_at") {
+        REQUIRE(db.try_at(key0) == value0);
+        REQUIRE_FALSE(db.try_at(key1).has_value());
+    }
+
+    SECTION("un_proxy") {
+        REQUIRE(db.un_proxy(value0) == key0);
+
+        // Proxy maps made elsewhere are rebuilt from the stored objects
+        using any_type    = pluginplay::any::AnyField;
+        using uuid_type   = typename value_type::mapped_type;
+        using values_type = Native<uuid_type, any_type>;
+        auto pvalues      = std::make_shared<values_type>();
+        const auto uuid1  = pluginplay::utility::generate_binary_uuid();
+        pvalues->insert(uuid1, pluginplay::any::make_any_field<TestType>(
+                                 other_value));
+
+        using uuid_mapper_type = UUIDMapper<TestType>;
+        auto [p, sub_db]       = make_nested_native<TestType, uuid_type>();
+        auto psub_db2 = std::make_unique<decltype(sub_db)>(std::move(sub_db));
+        auto pmapper  = std::make_unique<uuid_mapper_type>(std::move(psub_db2),
+                                                          false, pvalues);
+        db_type other(std::move(pmapper));
+        REQUIRE(other.un_proxy(value_type{{"hello", uuid1}}) == key1);
+        REQUIRE_THROWS_AS(other.un_proxy(value0), std::out_of_range);
+    }
 
     SECTION("free") {
         db.free(key0);
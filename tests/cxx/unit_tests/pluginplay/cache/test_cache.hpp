@@ -28,6 +28,29 @@ namespace testing {
 /// Set of types we test as keys
 using test_types = std::tuple<int, char, std::string>;
 
+/** @brief A Native DB which records the batches it is asked to make.
+ *
+ *  Used to test that databases forward begin_batch/commit_batch/abort_batch
+ *  to the databases they wrap.
+ *
+ *  @tparam KeyType The type of the keys.
+ *  @tparam ValueType The type of the values.
+ */
+template<typename KeyType, typename ValueType>
+struct BatchCounter : pluginplay::cache::database::Native<KeyType, ValueType> {
+    std::size_t n_begun     = 0;
+    std::size_t n_committed = 0;
+    std::size_t n_aborted   = 0;
+    bool throw_on_commit    = false;
+
+    void begin_batch_() override { ++n_begun; }
+    void commit_batch_() override {
+        ++n_committed;
+        if(throw_on_commit) throw std::runtime_error("Oops");
+    }
+    void abort_batch_() override { ++n_aborted; }
+};
+
 /** @brief Creates a Native DB that backs up to another NativeDB
  *
  *  Native databases have an API DatabaseAPI<key, value> and can optionally
@@ -53,7 +53,8 @@ TEMPLATE_LIST_TEST_CASE("UUIDMapper", "", testing::test_types) {
 
     SECTION("insert/at") {
         // Note the generated values should be different every time this runs
-        uuid_db.insert(key1);
+        auto v1 = uuid_db.insert(key1);
+        REQUIRE(v1 == uuid_db.at(key1).get());
 
         auto v0 = uuid_db.at(key0).get();
 
@@ -61,10 +62,15 @@ TEMPLATE_LIST_TEST_CASE("UUIDMapper", "", testing::test_types) {
         REQUIRE(uuid_db.at(key0).get() != uuid_db.at(key1).get());
 
         // and that calling insert again doesn't generate a new UUID
-        uuid_db.insert(key0);
+        REQUIRE(uuid_db.insert(key0) == v0);
         REQUIRE(v0 == uuid_db.at(key0).get());
     }
 
+    SECTION("try_at") {
+        REQUIRE(uuid_db.try_at(key0).get() == uuid_db.at(key0).get());
+        REQUIRE_FALSE(uuid_db.try_at(key1).has_value());
+    }
+
     SECTION("free") {
         uuid_db.free(key0);
         REQUIRE_FALSE(uuid_db.count(key0));
@@ -89,6 +95,68 @@ TEMPLATE_LIST_TEST_CASE("UUIDMapper", "", testing::test_types) {
         REQUIRE_FALSE(uuid_db.count(key0));
         REQUIRE(pinner->count(key0));
     }
+
+    SECTION("content-addressed") {
+        REQUIRE_FALSE(uuid_db.is_content_addressed());
+
+        auto make_ca_db = []() {
+            auto [p, db] = testing::make_nested_native<key_type, uuid_type>();
+            auto pdb     = std::make_unique<decltype(db)>(std::move(db));
+            return uuid_db_type(std::move(pdb), true);
+        };
+
+        // Two independent mappers agree on the UUIDs
+        auto ca_db    = make_ca_db();
+        auto other_db = make_ca_db();
+        REQUIRE(ca_db.is_content_addressed());
+
+        auto v0 = ca_db.insert(key0);
+        auto v1 = ca_db.insert(key1);
+        REQUIRE(v0 != v1);
+        REQUIRE(other_db.insert(key1) == v1);
+        REQUIRE(other_db.insert(key0) == v0);
+
+        // but not with a random mapper
+        REQUIRE(uuid_db.at(key0).get() != v0);
+    }
+
+    SECTION("Objects stored by another process") {
+        using any_type    = pluginplay::any::AnyField;
+        using values_type = Native<uuid_type, any_type>;
+        auto pvalues      = std::make_shared<values_type>();
+
+        auto make_db = [&](bool content_addressed) {
+            auto [p, db] = testing::make_nested_native<key_type, uuid_type>();
+            auto pdb     = std::make_unique<decltype(db)>(std::move(db));
+            return uuid_db_type(std::move(pdb), content_addressed, pvalues);
+        };
+
+        // The other process stores key1 under its UUID
+        auto writer = make_db(true);
+        auto v1     = writer.insert(key1);
+        pvalues->insert(v1, pluginplay::any::make_any_field<key_type>(key1));
+
+        // Content-addressed mappers find it without having inserted it
+        auto reader = make_db(true);
+        REQUIRE(reader.count(key1));
+        REQUIRE(reader.try_at(key1).get() == v1);
+        REQUIRE(reader.at(key1).get() == v1);
+        REQUIRE(reader.un_proxy(v1) == key1);
+
+        // but only if it is stored
+        REQUIRE_FALSE(reader.count(key0));
+        REQUIRE_FALSE(reader.try_at(key0).has_value());
+        REQUIRE_THROWS_AS(reader.at(key0), std::out_of_range);
+
+        // Random mappers can't find it, but can still un-proxy its UUID
+        auto random = make_db(false);
+        REQUIRE_FALSE(random.count(key1));
+        REQUIRE(random.un_proxy(v1) == key1);
+
+        // Can't un-proxy without the database of the objects
+        REQUIRE_THROWS_AS(uuid_db.un_proxy(v1), std::runtime_error);
+        REQUIRE_THROWS_AS(reader.un_proxy(uuid_type{}), std::out_of_range);
+    }
 }
 
 /* Acceptance test for UUIDMapper
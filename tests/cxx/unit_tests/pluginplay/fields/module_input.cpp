@@ -34,6 +34,47 @@ TEST_CASE("ModuleInput") {
         REQUIRE_FALSE(i.ready());
     }
 
+    SECTION("copy ctor") {
+        ModuleInput i;
+        i.set_type<int>();
+        i.change(int{3});
+        ModuleInput copy(i);
+        REQUIRE(copy == i);
+
+        // The copies share the value until one of them is modified
+        SECTION("change") {
+            copy.change(int{4});
+            REQUIRE(copy.value<int>() == 4);
+            REQUIRE(i.value<int>() == 3);
+        }
+        SECTION("read/write reference") {
+            copy.value<int&>() = 4;
+            REQUIRE(copy.value<int>() == 4);
+            REQUIRE(i.value<int>() == 3);
+        }
+        SECTION("metadata") {
+            copy.make_transparent();
+            copy.set_description("Hello World");
+            REQUIRE(copy.is_transparent());
+            REQUIRE_FALSE(i.is_transparent());
+            REQUIRE_FALSE(i.has_description());
+        }
+        SECTION("original") {
+            i.change(int{4});
+            REQUIRE(copy.value<int>() == 3);
+        }
+        SECTION("copies made after handing out a reference") {
+            auto& value = i.value<int&>();
+            ModuleInput copy2(i);
+            ModuleInput copy3;
+            copy3 = i;
+            value = 4;
+            REQUIRE(i.value<int>() == 4);
+            REQUIRE(copy2.value<int>() == 3);
+            REQUIRE(copy3.value<int>() == 3);
+        }
+    }
+
     SECTION("has_type") {
         ModuleInput i;
         SECTION("No type") { REQUIRE_FALSE(i.has_type()); }
@@ -80,6 +121,28 @@ TEST_CASE("ModuleInput") {
         }
     }
 
+    SECTION("hash") {
+        ModuleInput i, i2;
+        SECTION("No value") { REQUIRE(i.hash() == i2.hash()); }
+        SECTION("Same value") {
+            i.set_type<int>().change(int{3});
+            i2.set_type<int>().change(int{3});
+            REQUIRE(i.hash() == i2.hash());
+            REQUIRE(i.hash() == std::hash<ModuleInput>{}(i2));
+        }
+        SECTION("Different values") {
+            i.set_type<int>().change(int{3});
+            i2.set_type<int>().change(int{4});
+            REQUIRE(i.hash() != i2.hash());
+        }
+        SECTION("Only depends on value") {
+            i.set_type<int>().change(int{3});
+            i2.set_type<int>().change(int{3});
+            i2.make_transparent().set_description("hello world");
+            REQUIRE(i.hash() == i2.hash());
+        }
+    }
+
     SECTION("ready") {
         ModuleInput i;
         SECTION("Not ready") { REQUIRE_FALSE(i.ready()); }
@@ -465,3 +528,40 @@ TEST_CASE("ModuleInput") {
         }
     }
 }
+
+TEST_CASE("hash_inputs") {
+    ModuleInput i, i2;
+    i.set_type<int>().change(int{3});
+    i2.set_type<int>().change(int{4});
+
+    type::input_map inputs{{"Option 1", i}};
+
+    SECTION("Empty") {
+        REQUIRE(hash_inputs(type::input_map{}) == hash_inputs({}));
+    }
+    SECTION("Same inputs") {
+        type::input_map copy(inputs);
+        REQUIRE(hash_inputs(inputs) == hash_inputs(copy));
+    }
+    SECTION("Keys are case-insensitive") {
+        type::input_map other{{"OPTION 1", i}};
+        REQUIRE(hash_inputs(inputs) == hash_inputs(other));
+    }
+    SECTION("Different keys") {
+        type::input_map other{{"Option 2", i}};
+        REQUIRE(hash_inputs(inputs) != hash_inputs(other));
+    }
+    SECTION("Different opaque values") {
+        type::input_map other{{"Option 1", i2}};
+        REQUIRE(hash_inputs(inputs) != hash_inputs(other));
+    }
+    SECTION("Transparent inputs are skipped") {
+        auto other = inputs;
+        other["Option 2"] = ModuleInput(i2).make_transparent();
+        REQUIRE(hash_inputs(inputs) == hash_inputs(other));
+
+        auto other2 = inputs;
+        other2["Option 2"] = ModuleInput(i).make_transparent();
+        REQUIRE(hash_inputs(other) == hash_inputs(other2));
+    }
+}
@@ -16,6 +16,7 @@
 
 #include "../catch.hpp"
 #include <pluginplay/fields/module_result.hpp>
+#include <vector>
 using namespace pluginplay;
 
 TEST_CASE("ModuleResult : default ctor") {
@@ -25,6 +26,25 @@ TEST_CASE("ModuleResult : default ctor") {
     REQUIRE_FALSE(p.has_description());
 }
 
+TEST_CASE("ModuleResult : value ctor") {
+    using shared_any = typename ModuleResult::shared_any;
+    auto value = std::make_shared<const type::any>(any::make_any_field<int>(3));
+    ModuleResult p(value);
+
+    ModuleResult corr;
+    corr.set_type<int>();
+    corr.change(3);
+    REQUIRE(p == corr);
+    REQUIRE(p.value<shared_any>() == value);
+
+    // The type is checked like set_type's is
+    REQUIRE_THROWS_AS(p.change(double{3.14}), std::invalid_argument);
+
+    using e = std::runtime_error;
+    REQUIRE_THROWS_AS(ModuleResult(shared_any{}), e);
+    REQUIRE_THROWS_AS(ModuleResult(std::make_shared<const type::any>()), e);
+}
+
 TEST_CASE("ModuleResult : has_type") {
     ModuleResult p;
     SECTION("No type") { REQUIRE_FALSE(p.has_type()); }
@@ -44,6 +64,17 @@ TEST_CASE("ModuleResult : has_value") {
     }
 }
 
+TEST_CASE("ModuleResult : memory_footprint") {
+    ModuleResult p;
+    SECTION("No value") { REQUIRE(p.memory_footprint() == 0); }
+    SECTION("Has a value") {
+        std::vector<double> v(10, 1.0);
+        p.set_type<std::vector<double>>();
+        p.change(v);
+        REQUIRE(p.memory_footprint() == pluginplay::any::memory_footprint(v));
+    }
+}
+
 TEST_CASE("ModuleResult : has_description") {
     ModuleResult p;
     SECTION("No description") { REQUIRE_FALSE(p.has_description()); }
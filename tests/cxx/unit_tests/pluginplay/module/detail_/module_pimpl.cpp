@@ -17,7 +17,9 @@
 #include "../../catch.hpp"
 #include "../../test_common.hpp"
 #include "pluginplay/module/detail_/module_pimpl.hpp"
+#include <chrono>
 #include <regex>
+#include <thread>
 
 using namespace pluginplay;
 using namespace pluginplay::detail_;
@@ -46,6 +48,17 @@ struct NullModule2 : ModuleBase {
     }
 };
 
+// Takes long enough to run that its cache hits pay off
+struct SlowModule : ModuleBase {
+    SlowModule() : ModuleBase(this) { satisfies_property_type<OneIn>(); }
+    pluginplay::type::result_map run_(
+      pluginplay::type::input_map,
+      pluginplay::type::submodule_map) const override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return results();
+    }
+};
+
 TEST_CASE("ModulePIMPL") {
     SECTION("CTors") {
         SECTION("default ctor") {
@@ -376,6 +389,61 @@ TEST_CASE("ModulePIMPL") {
         REQUIRE(submods.submod_uuids() == corr);
     }
 
+    SECTION("submod_fingerprint") {
+        const std::string submod_key = "Submodule 1";
+        auto hash                    = [](const std::string& tree) {
+            using namespace pluginplay::utility;
+            return to_string(generate_binary_uuid(tree.data(), tree.size()));
+        };
+
+        // No submodules
+        ModulePIMPL no_submod = make_module_pimpl<NullModule>();
+        const auto leaf       = hash("1");
+        REQUIRE(no_submod.submod_fingerprint() == leaf);
+
+        // Submods
+        ModulePIMPL submods = make_module_pimpl<SubModModule>();
+        auto submod_ptr     = make_module_with_cache<NullModule>();
+        submods.change_submod(submod_key, submod_ptr);
+
+        const auto uuid = submod_ptr->uuid();
+        auto corr       = hash("1" + std::to_string(submod_key.size()) + ":" +
+                               submod_key + std::to_string(uuid.size()) + ":" +
+                               uuid + "(" + leaf + ")");
+        REQUIRE(submods.submod_fingerprint() == corr);
+
+        // Stored when locked, and discarded when a submodule changes
+        submods.lock();
+        REQUIRE(submods.submod_fingerprint() == corr);
+        auto submod_ptr2 = make_module_with_cache<NullModule>();
+        submods.change_submod(submod_key, submod_ptr2);
+        REQUIRE(submods.submod_fingerprint() != corr);
+
+        // Same submodule UUIDs means same fingerprint
+        ModulePIMPL submods2 = make_module_pimpl<SubModModule>();
+        submods2.change_submod(submod_key, submod_ptr2);
+        REQUIRE(submods2.submod_fingerprint() == submods.submod_fingerprint());
+
+        // Submod w/ Submod
+        auto submod_ptr3 = make_module_with_cache<SubModModule>();
+        submod_ptr3->change_submod(submod_key, submod_ptr);
+        submods2.change_submod(submod_key, submod_ptr3);
+        const auto fp    = submods2.submod_fingerprint();
+        const auto uuid3 = submod_ptr3->uuid();
+        REQUIRE(fp == hash("1" + std::to_string(submod_key.size()) + ":" +
+                           submod_key + std::to_string(uuid3.size()) + ":" +
+                           uuid3 + "(" + corr + ")"));
+
+        // The fingerprint doesn't grow with the depth of the tree
+        REQUIRE(fp.size() == corr.size());
+
+        // Unlocking discards the stored fingerprint
+        submods2.lock();
+        submods2.unlock();
+        submods2.change_submod(submod_key, submod_ptr2);
+        REQUIRE(submods2.submod_fingerprint() == submods.submod_fingerprint());
+    }
+
     SECTION("is_cached") {
         SECTION("No cache") {
             auto mod = make_module_pimpl<NullModule>();
@@ -458,6 +526,72 @@ TEST_CASE("ModulePIMPL") {
         }
     }
 
+    SECTION("adaptive memoization") {
+        auto mod = make_module_pimpl_with_cache<NotReadyModule>();
+        REQUIRE_FALSE(mod.is_memoization_adaptive());
+
+        MemoizationPolicy::options_type opts;
+        opts.window = 2;
+        mod.turn_off_memoization();
+        mod.turn_on_adaptive_memoization(opts);
+        REQUIRE(mod.is_memoization_adaptive());
+        REQUIRE(mod.is_memoizable());
+
+        // Every run misses, so after the first window the cache is bypassed
+        auto inps = mod.inputs();
+        for(int i = 0; i < 5; ++i) {
+            inps.at("Option 1").change(i);
+            mod.run(inps);
+        }
+        const auto m = mod.cache_metrics();
+        REQUIRE(m.n_misses == 3);
+        REQUIRE(m.n_hits == 0);
+        REQUIRE(mod.profile().stats().n_misses == 3);
+        REQUIRE(mod.profile().stats().n_calls == 5);
+
+        SECTION("turn_on_memoization ends it") {
+            mod.turn_on_memoization();
+            REQUIRE_FALSE(mod.is_memoization_adaptive());
+            inps.at("Option 1").change(5);
+            mod.run(inps);
+            REQUIRE(mod.cache_metrics().n_misses == 4);
+        }
+        SECTION("turn_off_memoization ends it") {
+            mod.turn_off_memoization();
+            REQUIRE_FALSE(mod.is_memoization_adaptive());
+            REQUIRE_FALSE(mod.is_memoizable());
+        }
+    }
+
+    SECTION("memoized runs tell the cache whether to persist") {
+        auto pbase = std::make_shared<SlowModule>();
+        pbase->set_uuid(pluginplay::utility::generate_uuid());
+        pluginplay::cache::ModuleManagerCache caches;
+        auto pcache = caches.get_or_make_module_cache("persist");
+        ModulePIMPL mod(pbase, pcache);
+
+        // Without a policy the results always may be persisted
+        pcache->set_persistent(false);
+        auto inps = mod.inputs();
+        inps.at("Option 1").change(1);
+        mod.run(inps);
+        REQUIRE(pcache->is_persistent());
+
+        // A policy which finds persisting too expensive turns it off, but
+        // keeps memoizing (the few misses are expensive, the rest hit)
+        MemoizationPolicy::options_type opts;
+        opts.window                = 4;
+        opts.ns_per_persisted_byte = 1e12;
+        mod.turn_on_adaptive_memoization(opts);
+        for(int i = 0; i < 12; ++i) {
+            inps.at("Option 1").change(i % 3);
+            mod.run(inps);
+        }
+        mod.run(inps);
+        REQUIRE_FALSE(pcache->is_persistent());
+        REQUIRE(mod.cache_metrics().n_hits > 0);
+    }
+
     SECTION("run") {
         SECTION("Throws if no implementation") {
             ModulePIMPL p;
@@ -477,6 +611,14 @@ TEST_CASE("ModulePIMPL") {
                     4);
             SECTION("Locks module") { REQUIRE(mod.locked()); }
         }
+        SECTION("Locked modules still check their inputs") {
+            auto mod = make_module_pimpl<NotReadyModule>();
+            auto in  = mod.inputs();
+            in.at("Option 1").change(1);
+            mod.run(in);
+            REQUIRE(mod.locked());
+            REQUIRE_THROWS_AS(mod.run(type::input_map{}), std::runtime_error);
+        }
     }
 
     SECTION("comparisons") {
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <chrono>
+#include <pluginplay/cache/module_manager_cache.hpp>
+#include <pluginplay/module/memoization_policy.hpp>
+#include <thread>
+
+using namespace pluginplay;
+
+namespace {
+
+using duration_type = MemoizationPolicy::duration_type;
+using key_type      = cache::ModuleCache::key_type;
+using val_type      = cache::ModuleCache::mapped_type;
+
+// Inputs whose only value is @p i
+key_type make_inputs(int i) {
+    ModuleInput input;
+    input.set_type<int>();
+    input.change(i);
+    return key_type{{"i", input}};
+}
+
+// Runs @p policy's module with input @p i through @p cache, taking @p dt
+void run(MemoizationPolicy& policy, cache::ModuleCache& cache, int i,
+         duration_type dt = duration_type{0}) {
+    if(!policy.memoize()) {
+        policy.bypassed(cache, dt);
+        return;
+    }
+    cache.find_or_compute(make_inputs(i), [dt]() {
+        std::this_thread::sleep_for(dt);
+        return val_type{};
+    });
+    policy.memoized(cache);
+}
+
+} // namespace
+
+TEST_CASE("MemoizationPolicy") {
+    cache::ModuleManagerCache caches;
+    auto mod_cache = caches.get_or_make_module_cache("my module");
+
+    MemoizationPolicy::options_type opts;
+    opts.window = 4;
+    MemoizationPolicy policy(opts);
+    const int window = static_cast<int>(opts.window);
+
+    SECTION("Defaults") {
+        MemoizationPolicy defaulted;
+        REQUIRE(defaulted.memoize());
+        REQUIRE(defaulted.persist());
+        REQUIRE(defaulted.options().window == 16);
+        REQUIRE(defaulted.options().regrowth == 2.0);
+        REQUIRE(defaulted.options().ns_per_persisted_byte == 1.0);
+    }
+
+    SECTION("Starts out memoizing") {
+        REQUIRE(policy.memoize());
+        REQUIRE(policy.options().window == 4);
+    }
+
+    SECTION("Keeps memoizing if the hits pay off") {
+        // The few misses are expensive, the remaining runs hit
+        const duration_type dt = std::chrono::milliseconds(2);
+        for(int i = 0; i < 3 * window; ++i)
+            run(policy, *mod_cache, i % (window - 1), dt);
+        REQUIRE(policy.memoize());
+        REQUIRE(policy.persist());
+    }
+
+    SECTION("Only persists if the hits pay for writing the results") {
+        // Writing the results out costs more than the hits save
+        opts.ns_per_persisted_byte = 1e12;
+        MemoizationPolicy memory_only(opts);
+        const duration_type dt = std::chrono::milliseconds(2);
+        for(int i = 0; i < 3 * window; ++i)
+            run(memory_only, *mod_cache, i % (window - 1), dt);
+        REQUIRE(memory_only.memoize());
+        REQUIRE_FALSE(memory_only.persist());
+    }
+
+    SECTION("Stops memoizing if there are no hits") {
+        // The first run only reads the baseline
+        for(int i = 0; i <= window; ++i) run(policy, *mod_cache, i);
+        REQUIRE_FALSE(policy.memoize());
+        REQUIRE_FALSE(policy.persist());
+
+        SECTION("Stays off while the module is cheap") {
+            for(int i = 0; i < 2 * window; ++i)
+                run(policy, *mod_cache, i, duration_type{0});
+            REQUIRE_FALSE(policy.memoize());
+        }
+
+        SECTION("Turns back on when the module gets more expensive") {
+            const duration_type dt = std::chrono::seconds(1);
+            for(int i = 0; i < window; ++i) {
+                REQUIRE_FALSE(policy.memoize());
+                run(policy, *mod_cache, i, dt);
+            }
+            REQUIRE(policy.memoize());
+
+            // Results are kept in memory until the hits pay for persisting
+            REQUIRE_FALSE(policy.persist());
+        }
+
+        SECTION("Copies the state") {
+            MemoizationPolicy copy(policy);
+            REQUIRE_FALSE(copy.memoize());
+
+            MemoizationPolicy assigned;
+            assigned = policy;
+            REQUIRE_FALSE(assigned.memoize());
+            REQUIRE(assigned.options().window == 4);
+        }
+    }
+}
@@ -413,6 +413,43 @@ TEST_CASE("Module : run_as") {
     }
 }
 
+TEST_CASE("Module : run_as_async") {
+    SECTION("Throws if it module doesn't satisfy property type") {
+        Module p;
+        auto f = p.run_as_async<NullPT>();
+        REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+    }
+    SECTION("No task pool runs it now") {
+        auto mod = make_module<ReadyModule>();
+        auto f   = mod->run_as_async<OptionalInput>(42);
+        REQUIRE(f.ready());
+        REQUIRE(f.get() == 42);
+    }
+    SECTION("Uses the task pool") {
+        auto base = std::make_shared<ReadyModule>();
+        auto pool = std::make_shared<utility::TaskPool>(0);
+        base->set_task_pool(pool);
+        Module mod(std::make_unique<detail_::ModulePIMPL>(base));
+
+        auto f = mod.run_as_async<OptionalInput>(42);
+        REQUIRE_FALSE(f.ready()); // Pool has no workers, so it's queued
+        REQUIRE(f.get() == 42);
+        REQUIRE(mod.locked());
+    }
+    SECTION("Arguments are copied") {
+        auto base = std::make_shared<ReadyModule>();
+        auto pool = std::make_shared<utility::TaskPool>(0);
+        base->set_task_pool(pool);
+        Module mod(std::make_unique<detail_::ModulePIMPL>(base));
+
+        auto f = [&]() {
+            int i = 42;
+            return mod.run_as_async<OptionalInput>(i);
+        }();
+        REQUIRE(f.get() == 42);
+    }
+}
+
 TEST_CASE("Module : run") {
     SECTION("Throws if no implementation") {
         Module p;
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../catch.hpp"
+#include <pluginplay/module/module_profile.hpp>
+#include <sstream>
+
+using namespace pluginplay;
+
+namespace {
+
+using duration_type = ModuleProfile::duration_type;
+using outcome_type  = ModuleProfile::outcome_type;
+using format_type   = ModuleProfile::format_type;
+
+// Records a run of @p ns nanoseconds with outcome @p o
+void record(ModuleProfile& p, long ns,
+            outcome_type o = outcome_type::not_memoized) {
+    p.record(std::chrono::system_clock::now(), duration_type(ns), o);
+}
+
+} // namespace
+
+TEST_CASE("ModuleProfile") {
+    ModuleProfile p;
+
+    SECTION("Default state") {
+        const auto stats = p.stats();
+        REQUIRE(stats.n_calls == 0);
+        REQUIRE(stats.total == duration_type(0));
+        REQUIRE(p.percentile(50.0) == duration_type(0));
+        REQUIRE(p.recent_calls().empty());
+    }
+
+    SECTION("record") {
+        record(p, 10, outcome_type::cache_miss);
+        record(p, 30, outcome_type::cache_hit);
+        record(p, 20);
+        const auto stats = p.stats();
+        REQUIRE(stats.n_calls == 3);
+        REQUIRE(stats.n_hits == 1);
+        REQUIRE(stats.n_misses == 1);
+        REQUIRE(stats.total == duration_type(60));
+        REQUIRE(stats.min == duration_type(10));
+        REQUIRE(stats.max == duration_type(30));
+        REQUIRE(stats.last_duration == duration_type(20));
+        REQUIRE(stats.first_call <= stats.last_call);
+    }
+
+    SECTION("percentile") {
+        for(long i = 1; i <= 1000; ++i) record(p, i * 1000);
+        // Buckets are at most 25% wide
+        const auto p50 = p.percentile(50.0).count();
+        const auto p99 = p.percentile(99.0).count();
+        REQUIRE(p50 > 0.8 * 500000);
+        REQUIRE(p50 < 1.2 * 500000);
+        REQUIRE(p99 > 0.8 * 990000);
+        REQUIRE(p99 <= 1000000);
+        REQUIRE(p.percentile(0.0) == duration_type(1000));
+        REQUIRE(p.percentile(100.0) <= duration_type(1000000));
+        REQUIRE(p.stats().p50 == p.percentile(50.0));
+
+        // Always within the observed range
+        ModuleProfile p2;
+        record(p2, 5);
+        REQUIRE(p2.percentile(50.0) == duration_type(5));
+    }
+
+    SECTION("recent_calls") {
+        const auto n = ModuleProfile::max_recent_calls();
+        for(std::size_t i = 0; i < n + 2; ++i) record(p, i);
+        auto calls = p.recent_calls();
+        REQUIRE(calls.size() == n);
+        REQUIRE(calls.front().m_duration == duration_type(2));
+        REQUIRE(calls.back().m_duration == duration_type(n + 1));
+        REQUIRE(p.stats().n_calls == n + 2);
+    }
+
+    SECTION("reset") {
+        record(p, 10);
+        p.reset();
+        REQUIRE(p.stats().n_calls == 0);
+        REQUIRE(p.recent_calls().empty());
+    }
+
+    SECTION("copy") {
+        record(p, 10);
+        ModuleProfile p2(p);
+        REQUIRE(p2.stats().n_calls == 1);
+        ModuleProfile p3;
+        p3 = p;
+        REQUIRE(p3.recent_calls().size() == 1);
+    }
+}
+
+TEST_CASE("write_profiles") {
+    ModuleProfile p;
+    std::map<std::string, const ModuleProfile*> profiles{{"a \"mod\"", &p}};
+
+    SECTION("No runs") {
+        std::stringstream ss;
+        write_profiles(ss, profiles);
+        REQUIRE(ss.str() ==
+                "{\"a \\\"mod\\\"\":{\"n_calls\":0,\"n_hits\":0,\"n_misses\":0,"
+                "\"total_ms\":0,\"min_ms\":0,\"max_ms\":0,\"p50_ms\":0,"
+                "\"p90_ms\":0,\"p99_ms\":0}}");
+    }
+
+    SECTION("JSON") {
+        record(p, 2000000, outcome_type::cache_hit);
+        std::stringstream ss;
+        write_profiles(ss, profiles, format_type::json);
+        const auto json = ss.str();
+        REQUIRE(json.find("\"n_calls\":1,\"n_hits\":1") != std::string::npos);
+        REQUIRE(json.find("\"total_ms\":2,") != std::string::npos);
+        REQUIRE(json.find("\"first_call\":\"") != std::string::npos);
+        REQUIRE(json.find("Z\"}}") != std::string::npos);
+    }
+
+    SECTION("Chrome trace") {
+        record(p, 2000, outcome_type::cache_miss);
+        std::stringstream ss;
+        write_profiles(ss, profiles, format_type::chrome_trace);
+        const auto trace = ss.str();
+        REQUIRE(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[{") ==
+                0);
+        REQUIRE(trace.find("\"ph\":\"X\"") != std::string::npos);
+        REQUIRE(trace.find("\"dur\":2.000,\"pid\":0,\"tid\":1,") !=
+                std::string::npos);
+        REQUIRE(trace.find("\"outcome\":\"cache miss\"") != std::string::npos);
+    }
+}
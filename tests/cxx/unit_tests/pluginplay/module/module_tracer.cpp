@@ -0,0 +1,85 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../catch.hpp"
+#include <pluginplay/module/module_tracer.hpp>
+#include <sstream>
+#include <stdexcept>
+
+using namespace pluginplay;
+
+TEST_CASE("ModuleTracer") {
+    using phase_type   = ModuleTracer::phase_type;
+    using outcome_type = ModuleTracer::outcome_type;
+
+    ModuleTracer t;
+    const type::key name("a module");
+    const type::rtti pt(typeid(int));
+
+    SECTION("Default state") {
+        REQUIRE(t.size() == 0);
+        std::stringstream ss;
+        t.write(ss);
+        REQUIRE(ss.str() == "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}");
+    }
+
+    SECTION("begin/end") {
+        t.begin(&name, &pt);
+        t.end(&name, &pt, outcome_type::cache_hit);
+        t.begin(nullptr, nullptr);
+        t.end(nullptr, nullptr, std::nullopt);
+        REQUIRE(t.size() == 4);
+
+        auto events = t.events();
+        REQUIRE(events[0].m_phase == phase_type::begin);
+        REQUIRE(events[0].m_name == name);
+        REQUIRE(events[0].m_property_type == pt);
+        REQUIRE(events[1].m_phase == phase_type::end);
+        REQUIRE(events[1].m_outcome == outcome_type::cache_hit);
+        REQUIRE(events[0].m_time <= events[1].m_time);
+        REQUIRE(events[0].m_thread == events[1].m_thread);
+        REQUIRE(events[2].m_name.empty());
+        REQUIRE_FALSE(events[2].m_property_type.has_value());
+        REQUIRE_FALSE(events[3].m_outcome.has_value());
+    }
+
+    SECTION("clear") {
+        t.begin(&name, &pt);
+        t.clear();
+        REQUIRE(t.size() == 0);
+    }
+
+    SECTION("write") {
+        t.begin(&name, &pt);
+        t.end(&name, &pt, outcome_type::cache_miss);
+        t.begin(&name, nullptr);
+        t.end(&name, nullptr, std::nullopt);
+        std::stringstream ss;
+        t.write(ss);
+        const auto trace = ss.str();
+        REQUIRE(trace.find("{\"name\":\"a module\",\"cat\":\"module\","
+                           "\"ph\":\"B\",\"ts\":") != std::string::npos);
+        REQUIRE(trace.find("\"pid\":0,\"tid\":1,\"args\":{\"property_type\":"
+                           "\"") != std::string::npos);
+        REQUIRE(trace.find("\"args\":{\"outcome\":\"cache miss\"}}") !=
+                std::string::npos);
+        REQUIRE(trace.find("\"args\":{\"property_type\":\"\"}}") !=
+                std::string::npos);
+        REQUIRE(trace.find("\"args\":{\"outcome\":\"error\"}}]}") !=
+                std::string::npos);
+    }
+}
@@ -16,7 +16,80 @@
 
 #include "../catch.hpp"
 #include "test_common.hpp"
+#include <atomic>
+#include <chrono>
 #include <pluginplay/module_manager/module_manager.hpp>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using testing::OptionalInput;
+
+// Number of times DoubleModule actually ran
+std::atomic<int> n_runs = 0;
+
+// Returns twice its input
+DECLARE_MODULE(DoubleModule);
+inline MODULE_CTOR(DoubleModule) { satisfies_property_type<OptionalInput>(); }
+inline MODULE_RUN(DoubleModule) {
+    ++n_runs;
+    auto [i] = OptionalInput::unwrap_inputs(inputs);
+    auto rv  = results();
+    return OptionalInput::wrap_results(rv, 2 * i);
+}
+
+// Asynchronously runs its submodule twice on each of 0, 1, ..., n - 1 and
+// returns the sum of the results
+DECLARE_MODULE(FanOutModule);
+inline MODULE_CTOR(FanOutModule) {
+    satisfies_property_type<OptionalInput>();
+    add_submodule<OptionalInput>("Submodule 1");
+}
+inline MODULE_RUN(FanOutModule) {
+    auto [n] = OptionalInput::unwrap_inputs(inputs);
+    auto& submod = submods.at("Submodule 1");
+    std::vector<pluginplay::utility::TaskFuture<int>> futures;
+    for(int rep = 0; rep < 2; ++rep)
+        for(int i = 0; i < n; ++i)
+            futures.push_back(submod.run_as_async<OptionalInput>(i));
+    int sum = 0;
+    for(auto& f : futures) sum += f.get();
+    auto rv = results();
+    return OptionalInput::wrap_results(rv, sum);
+}
+
+// Number of times ExpensiveModule actually ran
+std::atomic<int> n_expensive_runs = 0;
+
+// Slowly returns twice its input
+DECLARE_MODULE(ExpensiveModule);
+inline MODULE_CTOR(ExpensiveModule) {
+    satisfies_property_type<OptionalInput>();
+}
+inline MODULE_RUN(ExpensiveModule) {
+    ++n_expensive_runs;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto [i] = OptionalInput::unwrap_inputs(inputs);
+    auto rv  = results();
+    return OptionalInput::wrap_results(rv, 2 * i);
+}
+
+// Asynchronously runs its submodule on its input and returns the result
+DECLARE_MODULE(ParentModule);
+inline MODULE_CTOR(ParentModule) {
+    satisfies_property_type<OptionalInput>();
+    add_submodule<OptionalInput>("Submodule 1");
+}
+inline MODULE_RUN(ParentModule) {
+    auto [i]  = OptionalInput::unwrap_inputs(inputs);
+    auto f    = submods.at("Submodule 1").run_as_async<OptionalInput>(i);
+    auto rv   = results();
+    return OptionalInput::wrap_results(rv, f.get());
+}
+
+} // namespace
 
 TEST_CASE("ModuleManager") {
     pluginplay::ModuleManager mm;
@@ -61,6 +134,17 @@ TEST_CASE("ModuleManager") {
         REQUIRE(mm.get_runtime() == parallelzone::runtime::RuntimeView());
     }
 
+    SECTION("get_task_pool") {
+        REQUIRE(mm.get_task_pool().size() ==
+                pluginplay::utility::TaskPool::default_size());
+
+        auto ppool = std::make_shared<pluginplay::utility::TaskPool>(2);
+        pluginplay::ModuleManager mm2(
+          std::make_shared<parallelzone::runtime::RuntimeView>(),
+          std::make_shared<pluginplay::cache::ModuleManagerCache>(), ppool);
+        REQUIRE(&mm2.get_task_pool() == ppool.get());
+    }
+
     SECTION("keys") {
         using mod_t = testing::NoPTModule; // Type of the Module we're adding
 
@@ -77,4 +161,150 @@ TEST_CASE("ModuleManager") {
         pluginplay::ModuleManager no_cache(nullptr, nullptr);
         REQUIRE_FALSE(no_cache.has_cache());
     }
+
+    SECTION("cache_metrics") {
+        REQUIRE_THROWS_AS(mm.cache_metrics("not a key"), std::out_of_range);
+
+        mm.add_module<DoubleModule>("double");
+        REQUIRE(mm.cache_metrics("double").n_hits == 0);
+        mm.run_as<OptionalInput>("double", 3);
+        mm.run_as<OptionalInput>("double", 3);
+        auto m = mm.cache_metrics("double");
+        REQUIRE(m.n_hits == 1);
+        REQUIRE(m.n_misses == 1);
+        REQUIRE(m.n_inserts == 1);
+        REQUIRE(m.bytes_inserted > 0);
+
+        // Copies share the cache
+        mm.copy_module("double", "double 2");
+        REQUIRE(mm.cache_metrics("double 2").n_hits == 1);
+    }
+
+    SECTION("write_profile") {
+        using format_type = pluginplay::ModuleManager::format_type;
+        mm.add_module<DoubleModule>("double");
+        mm.run_as<OptionalInput>("double", 1);
+        mm.run_as<OptionalInput>("double", 1);
+
+        const auto& stats = mm.at("double").profile().stats();
+        REQUIRE(stats.n_calls == 2);
+        REQUIRE(stats.n_misses == 1);
+        REQUIRE(stats.n_hits == 1);
+
+        std::stringstream json;
+        mm.write_profile(json);
+        REQUIRE(json.str().find("\"double\":{\"n_calls\":2,\"n_hits\":1,"
+                                "\"n_misses\":1,") != std::string::npos);
+
+        std::stringstream trace;
+        mm.write_profile(trace, format_type::chrome_trace);
+        REQUIRE(trace.str().find("\"outcome\":\"cache hit\"") !=
+                std::string::npos);
+    }
+}
+
+TEST_CASE("ModuleManager : run_as_async") {
+    auto ppool = std::make_shared<pluginplay::utility::TaskPool>(4);
+    pluginplay::ModuleManager mm(
+      std::make_shared<parallelzone::runtime::RuntimeView>(),
+      std::make_shared<pluginplay::cache::ModuleManagerCache>(), ppool);
+    mm.add_module<DoubleModule>("double");
+    mm.add_module<FanOutModule>("fan out");
+    mm.change_submod("fan out", "Submodule 1", "double");
+
+    n_runs      = 0;
+    const int n = 50;
+    // 2 reps * sum_{i=0}^{n-1} 2i
+    const int corr = 2 * n * (n - 1);
+    REQUIRE(mm.run_as<OptionalInput>("fan out", n) == corr);
+
+    // Concurrent requests for the same inputs share one run
+    REQUIRE(n_runs == n);
+    auto& submod = mm.at("double");
+    for(int i = 0; i < n; ++i)
+        REQUIRE(submod.run_as<OptionalInput>(i) == 2 * i);
+
+    // Every submodule result is cached now, so rerunning the parent (without
+    // memoizing it) doesn't rerun the submodule
+    const int n_runs_before = n_runs;
+    auto fan_out            = mm.at("fan out").unlocked_copy();
+    fan_out.turn_off_memoization();
+    REQUIRE(fan_out.run_as<OptionalInput>(n) == corr);
+    REQUIRE(n_runs == n_runs_before);
+}
+
+/* Two parents, run concurrently, share an expensive submodule. Whichever
+ * asks for the submodule's results second must wait for the first one's run,
+ * even though it is itself computing (the parent's results) and waiting on a
+ * TaskFuture.
+ */
+TEST_CASE("ModuleManager : concurrent parents share a submodule run") {
+    auto ppool = std::make_shared<pluginplay::utility::TaskPool>(4);
+    pluginplay::ModuleManager mm(
+      std::make_shared<parallelzone::runtime::RuntimeView>(),
+      std::make_shared<pluginplay::cache::ModuleManagerCache>(), ppool);
+    mm.add_module<ExpensiveModule>("expensive");
+    mm.add_module<ParentModule>("parent a");
+    mm.add_module<ParentModule>("parent b");
+    mm.change_submod("parent a", "Submodule 1", "expensive");
+    mm.change_submod("parent b", "Submodule 1", "expensive");
+
+    n_expensive_runs = 0;
+    auto& a = mm.at("parent a");
+    auto& b = mm.at("parent b");
+    a.lock();
+    b.lock();
+    auto fa = a.run_as_async<OptionalInput>(21);
+    auto fb = b.run_as_async<OptionalInput>(21);
+    REQUIRE(fa.get() == 42);
+    REQUIRE(fb.get() == 42);
+    REQUIRE(n_expensive_runs == 1);
+}
+
+TEST_CASE("ModuleManager : tracing") {
+    pluginplay::ModuleManager mm;
+    mm.add_module<DoubleModule>("double");
+
+    // Counts the occurrences of @p what in @p str
+    auto count = [](const std::string& str, const std::string& what) {
+        std::size_t n = 0;
+        for(auto i = str.find(what); i != std::string::npos;
+            i      = str.find(what, i + 1))
+            ++n;
+        return n;
+    };
+
+    SECTION("Off by default") {
+        REQUIRE_FALSE(mm.is_tracing());
+        mm.run_as<OptionalInput>("double", 1);
+        std::stringstream ss;
+        mm.write_trace(ss);
+        REQUIRE(ss.str() == "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}");
+    }
+
+    SECTION("Records module runs") {
+        mm.enable_tracing();
+        REQUIRE(mm.is_tracing());
+
+        // Added after tracing was enabled, calls "double" as a submodule
+        mm.add_module<FanOutModule>("fan out");
+        mm.change_submod("fan out", "Submodule 1", "double");
+        mm.run_as<OptionalInput>("fan out", 2);
+        mm.disable_tracing();
+        REQUIRE_FALSE(mm.is_tracing());
+        mm.run_as<OptionalInput>("double", 5);
+
+        std::stringstream ss;
+        mm.write_trace(ss);
+        const auto trace = ss.str();
+        // fan out + 2 reps * 2 inputs of double
+        REQUIRE(count(trace, "\"ph\":\"B\"") == 5);
+        REQUIRE(count(trace, "\"ph\":\"E\"") == 5);
+        REQUIRE(count(trace, "{\"name\":\"fan out\"") == 2);
+        REQUIRE(count(trace, "{\"name\":\"double\"") == 8);
+        REQUIRE(count(trace, "\"outcome\":\"cache miss\"") >= 3);
+        REQUIRE(count(trace, "\"property_type\":\"") == 5);
+        REQUIRE(trace.find("{\"name\":\"fan out\"") ==
+                trace.find("\"traceEvents\":[") + 15);
+    }
 }
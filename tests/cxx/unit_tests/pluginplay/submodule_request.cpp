@@ -33,6 +33,26 @@ TEST_CASE("SubmoduleRequest : default ctor") {
     REQUIRE_FALSE(r.has_name());
 }
 
+TEST_CASE("SubmoduleRequest : copy ctor") {
+    SubmoduleRequest r;
+    r.set_type<testing::NullPT>();
+    auto mod = testing::make_module<testing::NullModule>();
+    r.change(mod);
+    SubmoduleRequest copy(r);
+    REQUIRE(copy == r);
+
+    // The module is shared, the rest of the state is copied on write
+    REQUIRE(&copy.value() == &r.value());
+    copy.set_description("Hello World");
+    REQUIRE(copy.has_description());
+    REQUIRE_FALSE(r.has_description());
+
+    auto mod2 = testing::make_module<testing::NullModule>();
+    copy.change(mod2);
+    REQUIRE(&copy.value() == mod2.get());
+    REQUIRE(&r.value() == mod.get());
+}
+
 TEST_CASE("SubmoduleRequest : has_type") {
     SubmoduleRequest r;
     SECTION("No type") { REQUIRE_FALSE(r.has_type()); }
@@ -281,6 +301,29 @@ TEST_CASE("SubmoduleRequest : run_as") {
     }
 }
 
+TEST_CASE("SubmoduleRequest : run_as_async") {
+    SubmoduleRequest r;
+    SECTION("Throws if type is not set") {
+        REQUIRE_THROWS_AS(r.run_as_async<testing::NullPT>(),
+                          std::bad_optional_access);
+    }
+    SECTION("Throws if type is different") {
+        r.set_type<testing::NullPT>();
+        REQUIRE_THROWS_AS(r.run_as_async<testing::OneIn>(3),
+                          std::invalid_argument);
+    }
+    SECTION("Throws if module is not set") {
+        r.set_type<testing::NullPT>();
+        REQUIRE_THROWS_AS(r.run_as_async<testing::NullPT>(),
+                          std::runtime_error);
+    }
+    SECTION("Works") {
+        r.set_type<testing::OptionalInput>();
+        r.change(testing::make_module<testing::ReadyModule>());
+        REQUIRE(r.run_as_async<testing::OptionalInput>(42).get() == 42);
+    }
+}
+
 TEST_CASE("SubmoduleRequest : comparisons") {
     SubmoduleRequest r, r2;
 
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <pluginplay/utility/latency_histogram.hpp>
+
+using namespace pluginplay::utility;
+
+TEST_CASE("LatencyHistogram") {
+    using duration_type = LatencyHistogram::duration_type;
+    LatencyHistogram h;
+
+    SECTION("bucket") {
+        REQUIRE(LatencyHistogram::bucket(duration_type(-1)) == 0);
+        REQUIRE(LatencyHistogram::bucket(duration_type(0)) == 0);
+        REQUIRE(LatencyHistogram::bucket(duration_type(3)) == 3);
+        REQUIRE(LatencyHistogram::bucket(duration_type(4)) == 4);
+        REQUIRE(LatencyHistogram::bucket(duration_type(7)) == 7);
+        REQUIRE(LatencyHistogram::bucket(duration_type(8)) == 8);
+        REQUIRE(LatencyHistogram::bucket(duration_type(1024)) == 36);
+        REQUIRE(LatencyHistogram::bucket(duration_type(1279)) == 36);
+        REQUIRE(LatencyHistogram::bucket(duration_type(1280)) == 37);
+        const auto last = LatencyHistogram::bucket(duration_type::max());
+        REQUIRE(last < LatencyHistogram::n_buckets);
+    }
+
+    SECTION("lower_bound") {
+        for(std::size_t i = 0; i < 248; ++i) {
+            const auto lower = LatencyHistogram::lower_bound(i);
+            REQUIRE(LatencyHistogram::bucket(lower) == i);
+        }
+        REQUIRE(LatencyHistogram::lower_bound(248) == duration_type::max());
+    }
+
+    SECTION("add/count/reset") {
+        REQUIRE(h.count() == 0);
+        h.add(duration_type(1024));
+        h.add(duration_type(1024));
+        REQUIRE(h.count() == 2);
+        REQUIRE(h.counts[36] == 2);
+        h.reset();
+        REQUIRE(h.count() == 0);
+    }
+
+    SECTION("percentile") {
+        REQUIRE(h.percentile(50.0) == duration_type(0));
+
+        for(int i = 0; i < 9; ++i) h.add(duration_type(2));
+        h.add(duration_type(1024));
+        REQUIRE(h.percentile(0.0) == duration_type(2));
+        REQUIRE(h.percentile(50.0) == duration_type(2));
+        REQUIRE(h.percentile(90.0) == duration_type(2));
+        // Middle of the [1024, 1280) bucket
+        REQUIRE(h.percentile(100.0) == duration_type(1152));
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <atomic>
+#include <pluginplay/utility/task_pool.hpp>
+#include <stdexcept>
+#include <vector>
+
+using namespace pluginplay::utility;
+
+TEST_CASE("TaskPool") {
+    SECTION("default_size") { REQUIRE(TaskPool::default_size() >= 1); }
+
+    SECTION("CTor") {
+        TaskPool defaulted;
+        REQUIRE(defaulted.size() == TaskPool::default_size());
+
+        TaskPool two(2);
+        REQUIRE(two.size() == 2);
+    }
+
+    SECTION("async") {
+        TaskPool pool(2);
+
+        SECTION("Returns result") {
+            auto f = pool.async([]() { return 42; });
+            REQUIRE(f.valid());
+            REQUIRE(f.get() == 42);
+            REQUIRE_FALSE(f.valid());
+        }
+
+        SECTION("void tasks") {
+            int x  = 0;
+            auto f = pool.async([&x]() { x = 42; });
+            f.get();
+            REQUIRE(x == 42);
+        }
+
+        SECTION("Exceptions are rethrown by get") {
+            auto f = pool.async([]() -> int { throw std::runtime_error(""); });
+            REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+        }
+
+        SECTION("Many tasks") {
+            std::atomic<int> n_run = 0;
+            std::vector<TaskFuture<int>> fs;
+            for(int i = 0; i < 1000; ++i)
+                fs.push_back(pool.async([&n_run, i]() {
+                    ++n_run;
+                    return i;
+                }));
+            for(int i = 0; i < 1000; ++i) REQUIRE(fs[i].get() == i);
+            REQUIRE(n_run == 1000);
+        }
+    }
+
+    SECTION("Nested tasks don't deadlock") {
+        // Every worker waits on tasks queued behind it, so the waiting
+        // workers must run them
+        TaskPool pool(1);
+        auto outer = pool.async([&pool]() {
+            std::vector<TaskFuture<int>> fs;
+            for(int i = 0; i < 4; ++i)
+                fs.push_back(pool.async([&pool, i]() {
+                    return pool.async([i]() { return i; }).get();
+                }));
+            int sum = 0;
+            for(auto& f : fs) sum += f.get();
+            return sum;
+        });
+        REQUIRE(outer.get() == 6);
+    }
+
+    SECTION("No workers") {
+        TaskPool pool(0);
+        REQUIRE(pool.size() == 0);
+        auto f = pool.async([]() { return 42; });
+        REQUIRE_FALSE(f.ready());
+        REQUIRE(f.get() == 42); // Run by get
+    }
+
+    SECTION("run_pending_task") {
+        TaskPool pool(0);
+        REQUIRE_FALSE(pool.run_pending_task());
+        auto f = pool.async([]() { return 42; });
+        REQUIRE(pool.run_pending_task());
+        REQUIRE(f.ready());
+        REQUIRE(f.get() == 42);
+    }
+
+    SECTION("DTor runs remaining tasks") {
+        int x = 0;
+        {
+            TaskPool pool(0);
+            pool.async([&x]() { x = 42; });
+        }
+        REQUIRE(x == 42);
+    }
+}
+
+TEST_CASE("TaskFuture") {
+    SECTION("Invalid") {
+        TaskFuture<int> f{std::future<int>{}};
+        REQUIRE_FALSE(f.valid());
+        REQUIRE_THROWS_AS(f.ready(), std::future_error);
+    }
+}
+
+TEST_CASE("run_inline") {
+    SECTION("Returns result") {
+        auto f = run_inline([]() { return 42; });
+        REQUIRE(f.ready());
+        REQUIRE(f.get() == 42);
+    }
+
+    SECTION("Exceptions are rethrown by get") {
+        auto f = run_inline([]() -> int { throw std::runtime_error(""); });
+        REQUIRE(f.ready());
+        REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <pluginplay/utility/uuid.hpp>
+#include <string>
+
+using namespace pluginplay::utility;
+
+TEST_CASE("generate_binary_uuid") {
+    SECTION("Random") {
+        REQUIRE(generate_binary_uuid() != generate_binary_uuid());
+    }
+
+    SECTION("Content") {
+        const std::string hello("Hello"), world("World");
+        auto uuid = generate_binary_uuid(hello.data(), hello.size());
+        REQUIRE(uuid == generate_binary_uuid(hello.data(), hello.size()));
+        REQUIRE(uuid != generate_binary_uuid(world.data(), world.size()));
+        REQUIRE(uuid != generate_binary_uuid());
+    }
+}
+
+TEST_CASE("to_string") {
+    REQUIRE(to_string(binary_uuid_type{}) ==
+            "00000000-0000-0000-0000-000000000000");
+
+    // Formatted UUIDs have the same form as those from generate_uuid
+    auto uuid = to_string(generate_binary_uuid());
+    REQUIRE(uuid.size() == generate_uuid().size());
+    REQUIRE(uuid.size() == 36);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2024 NWChemEx-Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../catch.hpp"
+#include <atomic>
+#include <pluginplay/utility/wait_edge.hpp>
+#include <thread>
+
+using namespace pluginplay::utility;
+
+TEST_CASE("WaitEdge") {
+    const auto me = std::this_thread::get_id();
+
+    SECTION("Waiting on ourselves deadlocks") {
+        REQUIRE(WaitEdge::would_deadlock(me));
+    }
+
+    SECTION("Waiting on a thread which isn't waiting doesn't") {
+        std::thread other([]() {});
+        const auto id = other.get_id();
+        REQUIRE_FALSE(WaitEdge::would_deadlock(id));
+        other.join();
+    }
+
+    SECTION("Waiting on a thread waiting on us deadlocks") {
+        std::atomic<int> stage{0};
+        bool other_would_deadlock = false;
+        std::thread other([&]() {
+            WaitEdge edge(me);
+            stage = 1;
+            while(stage < 2) std::this_thread::yield();
+            other_would_deadlock = WaitEdge::would_deadlock(me);
+        });
+        const auto id = other.get_id();
+        while(stage < 1) std::this_thread::yield();
+        REQUIRE(WaitEdge::would_deadlock(id));
+        {
+            // Other checks if it can wait on us while we wait on it
+            WaitEdge edge(id);
+            stage = 2;
+            other.join();
+        }
+        REQUIRE(other_would_deadlock);
+        REQUIRE_FALSE(WaitEdge::would_deadlock(id));
+    }
+
+    SECTION("Edges nest") {
+        // x and y record, in each round, whether waiting on us would deadlock
+        std::atomic<int> round{0};
+        std::atomic<int> n_done{0};
+        bool x_sees[3] = {false, false, false};
+        bool y_sees[3] = {false, false, false};
+        auto observe = [&](bool* sees) {
+            for(int i = 0; i < 3; ++i) {
+                while(round <= i) std::this_thread::yield();
+                sees[i] = WaitEdge::would_deadlock(me);
+                ++n_done;
+            }
+        };
+        std::thread x(observe, x_sees);
+        std::thread y(observe, y_sees);
+        auto next_round = [&]() {
+            const int n = ++round;
+            while(n_done < 2 * n) std::this_thread::yield();
+        };
+
+        {
+            WaitEdge outer(x.get_id());
+            next_round();
+            {
+                WaitEdge inner(y.get_id());
+                next_round();
+            }
+            next_round();
+        }
+        x.join();
+        y.join();
+
+        REQUIRE(x_sees[0]);
+        REQUIRE_FALSE(y_sees[0]);
+        REQUIRE_FALSE(x_sees[1]);
+        REQUIRE(y_sees[1]);
+        REQUIRE(x_sees[2]);
+        REQUIRE_FALSE(y_sees[2]);
+    }
+}
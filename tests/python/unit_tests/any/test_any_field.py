@@ -72,6 +72,11 @@ class TestAnyField(unittest.TestCase):
         self.assertTrue(self.has_vector.owns_value())
         self.assertTrue(self.has_list.owns_value())
 
+    def test_memory_footprint(self):
+        self.assertEqual(self.defaulted.memory_footprint(), 0)
+        self.assertGreater(self.has_vector.memory_footprint(), 0)
+        self.assertGreater(self.has_list.memory_footprint(), 0)
+
     def setUp(self):
         self.defaulted = pp.any.AnyField()
         self.has_vector = test_pp.get_vector()
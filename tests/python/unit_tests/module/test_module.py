@@ -132,6 +132,16 @@ class TestModule(unittest.TestCase):
         self.has_desc.turn_on_memoization()
         self.assertTrue(self.has_desc.is_memoizable())
 
+    def test_turn_on_adaptive_memoization(self):
+        self.assertFalse(self.has_desc.is_memoization_adaptive())
+        options = pp.MemoizationOptions()
+        options.window = 4
+        self.has_desc.turn_on_adaptive_memoization(options)
+        self.assertTrue(self.has_desc.is_memoization_adaptive())
+        self.assertTrue(self.has_desc.is_memoizable())
+        self.has_desc.turn_on_memoization()
+        self.assertFalse(self.has_desc.is_memoization_adaptive())
+
     def test_lock(self):
         # See issue #301
         # self.assertRaises(Exception, self.defaulted.lock)
@@ -195,6 +195,21 @@ class TestModuleManager(unittest.TestCase):
         rv = fxn2test(pt, mod_key, 1)
         self.assertEqual(rv, 1)
 
+    def test_cache_metrics(self):
+        # Throws if it's a bad module key
+        self.assertRaises(Exception, self.has_mods.cache_metrics, 'not a key')
+
+        pt = test_pp.OneInOneOut()
+        mod_key = 'C++ module using every feature'
+        self.has_mods.run_as(pt, mod_key, 1)
+        self.has_mods.run_as(pt, mod_key, 1)
+        metrics = self.has_mods.cache_metrics(mod_key)
+        self.assertEqual(metrics.n_hits, 1)
+        self.assertEqual(metrics.n_misses, 1)
+        self.assertEqual(metrics.n_inserts, 1)
+        self.assertGreater(metrics.bytes_inserted, 0)
+        self.assertEqual(metrics.lookup_latency.count(), 2)
+
     def test_pluginplay_309(self):
         ''' This regression test is in response to issue #309.
 